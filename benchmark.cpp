@@ -0,0 +1,433 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include "benchmark.h"
+
+
+bool CameraPath::load(std::string const& path, std::string& error)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        error = "can't open " + path;
+        return false;
+    }
+
+    keys.clear();
+    std::string line;
+    for (int lineNumber = 1; std::getline(in, line); lineNumber++)
+    {
+        auto comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+
+        std::istringstream fields(line);
+        CameraKey key;
+        if (!(fields >> key.time))
+            continue;
+        if (!(fields >> key.position[0] >> key.position[1] >> key.position[2] >> key.yaw >> key.pitch))
+        {
+            error = path + ":" + std::to_string(lineNumber) + ": expected time x y z yaw pitch";
+            return false;
+        }
+        if (!keys.empty() && key.time <= keys.back().time)
+        {
+            error = path + ":" + std::to_string(lineNumber) + ": key times must increase";
+            return false;
+        }
+        keys.push_back(key);
+    }
+
+    if (keys.empty())
+    {
+        error = path + ": no camera keys";
+        return false;
+    }
+    return true;
+}
+
+void CameraPath::addKey(CameraKey const& key)
+{
+    keys.push_back(key);
+}
+
+static float catmullRom(float p0, float p1, float p2, float p3, float u)
+{
+    return 0.5f * (2.0f * p1 + (p2 - p0) * u +
+        (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * u * u +
+        (3.0f * p1 - p0 - 3.0f * p2 + p3) * u * u * u);
+}
+
+CameraPose CameraPath::evaluate(float time) const
+{
+    CameraPose pose = {};
+    if (keys.empty())
+        return pose;
+
+    time = std::min(std::max(time, keys.front().time), keys.back().time);
+    size_t i = 0;
+    while (i + 2 < keys.size() && keys[i + 1].time <= time)
+        i++;
+
+    auto const& k0 = keys[i > 0 ? i - 1 : 0];
+    auto const& k1 = keys[i];
+    auto const& k2 = keys[std::min(i + 1, keys.size() - 1)];
+    auto const& k3 = keys[std::min(i + 2, keys.size() - 1)];
+
+    auto span = k2.time - k1.time;
+    auto u = span > 0.0f ? (time - k1.time) / span : 0.0f;
+    for (int c = 0; c < 3; c++)
+        pose.position[c] = catmullRom(k0.position[c], k1.position[c], k2.position[c], k3.position[c], u);
+    pose.yaw = catmullRom(k0.yaw, k1.yaw, k2.yaw, k3.yaw, u);
+    pose.pitch = catmullRom(k0.pitch, k1.pitch, k2.pitch, k3.pitch, u);
+    return pose;
+}
+
+CameraPath CameraPath::defaultPath()
+{
+    // the grid is centered at z = 30
+    const float center[3] = { 0.0f, 0.0f, 30.0f };
+    const float radius = 70.0f;
+    const int steps = 8;
+    const float secondsPerStep = 2.5f;
+
+    CameraPath path;
+    for (int i = 0; i <= steps; i++)
+    {
+        // start behind the grid like the default camera, then circle it
+        auto angle = -90.0f + 360.0f * i / steps;
+        auto rad = angle * 3.14159265f / 180.0f;
+        auto height = 15.0f * std::sin(2.0f * rad);
+
+        CameraKey key;
+        key.time = i * secondsPerStep;
+        key.position[0] = center[0] + radius * std::cos(rad);
+        key.position[1] = center[1] + height;
+        key.position[2] = center[2] + radius * std::sin(rad);
+        // look at the center
+        key.yaw = angle + 180.0f;
+        key.pitch = -std::atan2(height, radius) * 180.0f / 3.14159265f;
+        path.addKey(key);
+    }
+    return path;
+}
+
+std::vector<std::string> splitCommandLine(std::string const& commandLine)
+{
+    std::vector<std::string> args;
+    std::string current;
+    bool quoted = false, any = false;
+    for (auto c : commandLine)
+    {
+        if (c == '"')
+        {
+            quoted = !quoted;
+            any = true;
+        }
+        else if (!quoted && (c == ' ' || c == '\t'))
+        {
+            if (any)
+                args.push_back(current);
+            current.clear();
+            any = false;
+        }
+        else
+        {
+            current += c;
+            any = true;
+        }
+    }
+    if (any)
+        args.push_back(current);
+    return args;
+}
+
+static bool parseUInt(std::string const& s, uint32_t& value)
+{
+    char* end = nullptr;
+    auto v = strtoul(s.c_str(), &end, 10);
+    if (s.empty() || *end)
+        return false;
+    value = static_cast<uint32_t>(v);
+    return true;
+}
+
+bool parseBenchmarkArgs(std::vector<std::string> const& args, BenchmarkSettings& settings, std::string& error)
+{
+    for (size_t i = 0; i < args.size(); i++)
+    {
+        auto const& arg = args[i];
+        auto value = [&](std::string& out) {
+            if (i + 1 >= args.size())
+            {
+                error = arg + " needs a value";
+                return false;
+            }
+            out = args[++i];
+            return true;
+        };
+        auto number = [&](uint32_t& out) {
+            std::string s;
+            if (!value(s))
+                return false;
+            if (!parseUInt(s, out))
+            {
+                error = arg + ": not a number: " + s;
+                return false;
+            }
+            return true;
+        };
+
+        bool ok = true;
+        if (arg == "--benchmark")
+            settings.enabled = true;
+        else if (arg == "--resolution")
+        {
+            std::string s;
+            ok = value(s);
+            auto x = s.find('x');
+            if (ok && (x == std::string::npos || !parseUInt(s.substr(0, x), settings.width) ||
+                !parseUInt(s.substr(x + 1), settings.height) || !settings.width || !settings.height))
+            {
+                error = "--resolution expects WIDTHxHEIGHT, got " + s;
+                ok = false;
+            }
+        }
+        else if (arg == "--grid")
+            ok = number(settings.gridSize);
+        else if (arg == "--lights")
+            ok = number(settings.lightCount);
+        else if (arg == "--warmup")
+            ok = number(settings.warmupFrames);
+        else if (arg == "--frames")
+            ok = number(settings.measuredFrames);
+        else if (arg == "--camera-path")
+            ok = value(settings.cameraPath);
+        else if (arg == "--csv")
+            ok = value(settings.csvPath);
+        else if (arg == "--json")
+            ok = value(settings.jsonPath);
+
+        if (!ok)
+            return false;
+    }
+
+    if (settings.measuredFrames == 0)
+    {
+        error = "--frames must be at least 1";
+        return false;
+    }
+    return true;
+}
+
+TimingSummary summarize(std::vector<double> samples)
+{
+    TimingSummary summary;
+    if (samples.empty())
+        return summary;
+
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double p) {
+        return samples[std::min(samples.size() - 1, static_cast<size_t>(p * (samples.size() - 1) + 0.5))];
+    };
+
+    double sum = 0.0;
+    for (auto s : samples)
+        sum += s;
+
+    summary.mean = sum / samples.size();
+    summary.p50 = at(0.50);
+    summary.p95 = at(0.95);
+    summary.p99 = at(0.99);
+    summary.min = samples.front();
+    summary.max = samples.back();
+    summary.samples = static_cast<uint32_t>(samples.size());
+    return summary;
+}
+
+Benchmark::Benchmark(BenchmarkSettings const& settings, CameraPath const& path) :
+    settings(settings), path(path.empty() ? CameraPath::defaultPath() : path)
+{
+    // keep every measured frame plus the ones rendered while draining
+    Profiler::get().setHistorySize(settings.measuredFrames + 16);
+}
+
+bool Benchmark::isMeasuring() const
+{
+    return frame >= settings.warmupFrames && frame < settings.warmupFrames + settings.measuredFrames;
+}
+
+bool Benchmark::nextFrame(CameraPose& pose)
+{
+    auto duration = path.duration();
+    if (frame < settings.warmupFrames)
+    {
+        // a quick pass over the path warms up caches and streaming
+        pose = path.evaluate(duration * frame / settings.warmupFrames);
+        return true;
+    }
+    if (isMeasuring())
+    {
+        // frame based, not wall clock based, so every run renders the same images
+        pose = path.evaluate(duration * (frame - settings.warmupFrames) / settings.measuredFrames);
+        return true;
+    }
+
+    // GPU timings are read back a few frames late
+    const uint32_t maxDrainFrames = 8;
+    bool gpuDone = true;
+    if (settings.waitForGpu)
+        for (auto const& f : Profiler::get().history())
+            if (f.index >= firstProfilerFrame && f.index <= lastProfilerFrame && !f.gpuReady)
+                gpuDone = false;
+
+    if (gpuDone || drainFrames >= maxDrainFrames)
+        return false;
+
+    drainFrames++;
+    pose = path.evaluate(duration);
+    return true;
+}
+
+void Benchmark::frameDone()
+{
+    auto profilerFrame = Profiler::get().frameIndex() - 1;
+    if (frame == settings.warmupFrames)
+        firstProfilerFrame = profilerFrame;
+    if (isMeasuring())
+        lastProfilerFrame = profilerFrame;
+    frame++;
+}
+
+Benchmark::PassTimings& Benchmark::pass(char const* name)
+{
+    for (auto& p : passes)
+        if (p.name == name)
+            return p;
+    passes.push_back({ name, {}, {} });
+    return passes.back();
+}
+
+void Benchmark::collect()
+{
+    passes.clear();
+    frameTimes.clear();
+    gpuFrameTimes.clear();
+
+    for (auto const& f : Profiler::get().history())
+    {
+        if (f.index < firstProfilerFrame || f.index > lastProfilerFrame)
+            continue;
+
+        frameTimes.push_back((f.end - f.start) / 1e6);
+
+        // a pass may be recorded several times per frame, one sample is their sum
+        std::vector<std::pair<char const*, double>> cpu, gpu;
+        auto add = [](std::vector<std::pair<char const*, double>>& sums, ProfileEvent const& e) {
+            for (auto& s : sums)
+            {
+                if (!strcmp(s.first, e.name))
+                {
+                    s.second += (e.end - e.start) / 1e6;
+                    return;
+                }
+            }
+            sums.push_back({ e.name, (e.end - e.start) / 1e6 });
+        };
+        for (auto const& e : f.cpu)
+            add(cpu, e);
+        for (auto const& e : f.gpu)
+            add(gpu, e);
+
+        for (auto const& s : cpu)
+            pass(s.first).cpu.push_back(s.second);
+        for (auto const& s : gpu)
+            pass(s.first).gpu.push_back(s.second);
+
+        if (!f.gpu.empty())
+        {
+            uint64_t start = f.gpu.front().start, end = 0;
+            for (auto const& e : f.gpu)
+            {
+                start = std::min(start, e.start);
+                end = std::max(end, e.end);
+            }
+            gpuFrameTimes.push_back((end - start) / 1e6);
+        }
+    }
+}
+
+bool Benchmark::writeCSV(std::string const& path) const
+{
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out)
+        return false;
+
+    fprintf(out, "pass,cpu_samples,cpu_mean_ms,cpu_p50_ms,cpu_p95_ms,cpu_p99_ms,cpu_max_ms,"
+        "gpu_samples,gpu_mean_ms,gpu_p50_ms,gpu_p95_ms,gpu_p99_ms,gpu_max_ms\n");
+    auto row = [out](std::string const& name, TimingSummary const& cpu, TimingSummary const& gpu) {
+        fprintf(out, "\"%s\",%u,%.4f,%.4f,%.4f,%.4f,%.4f,%u,%.4f,%.4f,%.4f,%.4f,%.4f\n", name.c_str(),
+            cpu.samples, cpu.mean, cpu.p50, cpu.p95, cpu.p99, cpu.max,
+            gpu.samples, gpu.mean, gpu.p50, gpu.p95, gpu.p99, gpu.max);
+    };
+
+    row("Frame", summarize(frameTimes), summarize(gpuFrameTimes));
+    for (auto const& p : passes)
+        row(p.name, summarize(p.cpu), summarize(p.gpu));
+
+    return fclose(out) == 0;
+}
+
+static void writeSummary(FILE* out, char const* key, TimingSummary const& s)
+{
+    fprintf(out, "\"%s\":{\"samples\":%u,\"mean\":%.4f,\"p50\":%.4f,\"p95\":%.4f,\"p99\":%.4f,\"min\":%.4f,\"max\":%.4f}",
+        key, s.samples, s.mean, s.p50, s.p95, s.p99, s.min, s.max);
+}
+
+bool Benchmark::writeJSON(std::string const& path) const
+{
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out)
+        return false;
+
+    fprintf(out, "{\n  \"settings\":{\"width\":%u,\"height\":%u,\"grid\":%u,\"lights\":%u,"
+        "\"warmupFrames\":%u,\"measuredFrames\":%u,\"cameraPath\":\"%s\"},\n",
+        settings.width, settings.height, settings.gridSize, settings.lightCount,
+        settings.warmupFrames, settings.measuredFrames,
+        settings.cameraPath.empty() ? "default" : settings.cameraPath.c_str());
+
+    fprintf(out, "  \"frame\":{");
+    writeSummary(out, "cpu", summarize(frameTimes));
+    fprintf(out, ",");
+    writeSummary(out, "gpu", summarize(gpuFrameTimes));
+    fprintf(out, "},\n  \"passes\":[");
+
+    for (size_t i = 0; i < passes.size(); i++)
+    {
+        fprintf(out, "%s\n    {\"name\":\"%s\",", i ? "," : "", passes[i].name.c_str());
+        writeSummary(out, "cpu", summarize(passes[i].cpu));
+        fprintf(out, ",");
+        writeSummary(out, "gpu", summarize(passes[i].gpu));
+        fprintf(out, "}");
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    return fclose(out) == 0;
+}
+
+void Benchmark::print(FILE* out) const
+{
+    auto cpu = summarize(frameTimes);
+    auto gpu = summarize(gpuFrameTimes);
+    fprintf(out, "%u frames at %ux%u, grid %u, %u lights\n",
+        cpu.samples, settings.width, settings.height, settings.gridSize, settings.lightCount);
+    fprintf(out, "frame CPU: mean %.3f ms, p50 %.3f, p95 %.3f, p99 %.3f, max %.3f\n",
+        cpu.mean, cpu.p50, cpu.p95, cpu.p99, cpu.max);
+    if (gpu.samples)
+        fprintf(out, "frame GPU: mean %.3f ms, p50 %.3f, p95 %.3f, p99 %.3f, max %.3f\n",
+            gpu.mean, gpu.p50, gpu.p95, gpu.p99, gpu.max);
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "profiler.h"
+
+// Portable benchmark driver: a scripted camera path, fixed warmup and measured
+// frame counts, and per-pass CPU/GPU timings aggregated from the Profiler
+// history into CSV and JSON reports.
+
+struct CameraKey
+{
+    // seconds along the path
+    float time;
+    float position[3];
+    // degrees, as Camera uses them
+    float yaw;
+    float pitch;
+};
+
+struct CameraPose
+{
+    float position[3];
+    float yaw;
+    float pitch;
+};
+
+// Catmull-Rom spline through the keys
+class CameraPath
+{
+public:
+    // text file, one "time x y z yaw pitch" key per line, '#' starts a comment
+    bool load(std::string const& path, std::string& error);
+    void addKey(CameraKey const& key);
+
+    CameraPose evaluate(float time) const;
+    float duration() const { return keys.empty() ? 0.0f : keys.back().time; }
+    bool empty() const { return keys.empty(); }
+
+    // orbit around the sphere grid
+    static CameraPath defaultPath();
+
+private:
+    std::vector<CameraKey> keys;
+};
+
+struct BenchmarkSettings
+{
+    bool enabled = false;
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    uint32_t gridSize = 8;
+    uint32_t lightCount = 3;
+    uint32_t warmupFrames = 60;
+    uint32_t measuredFrames = 600;
+    // empty for the default orbit
+    std::string cameraPath;
+    std::string csvPath = "benchmark.csv";
+    std::string jsonPath = "benchmark.json";
+    // keep rendering after the last measured frame until its GPU timings are read back
+    bool waitForGpu = true;
+};
+
+// "--benchmark" turns the mode on, unknown arguments are left for the caller
+bool parseBenchmarkArgs(std::vector<std::string> const& args, BenchmarkSettings& settings, std::string& error);
+// split a command line on whitespace, double quotes group
+std::vector<std::string> splitCommandLine(std::string const& commandLine);
+
+struct TimingSummary
+{
+    // milliseconds
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    uint32_t samples = 0;
+};
+
+TimingSummary summarize(std::vector<double> samples);
+
+class Benchmark
+{
+public:
+    Benchmark(BenchmarkSettings const& settings, CameraPath const& path);
+
+    // camera for the next frame, false once all frames ran and GPU timings arrived
+    bool nextFrame(CameraPose& pose);
+    // call after Profiler::endFrame
+    void frameDone();
+
+    bool isMeasuring() const;
+    uint32_t frameIndex() const { return frame; }
+
+    // aggregate the measured frames from the profiler history
+    void collect();
+    bool writeCSV(std::string const& path) const;
+    bool writeJSON(std::string const& path) const;
+    // short summary for the console
+    void print(FILE* out) const;
+
+private:
+    struct PassTimings
+    {
+        std::string name;
+        std::vector<double> cpu;
+        std::vector<double> gpu;
+    };
+
+    PassTimings& pass(char const* name);
+
+    BenchmarkSettings settings;
+    CameraPath path;
+
+    uint32_t frame = 0;
+    // frames rendered after the last measured one while waiting for GPU queries
+    uint32_t drainFrames = 0;
+    uint64_t firstProfilerFrame = 0;
+    uint64_t lastProfilerFrame = 0;
+
+    std::vector<PassTimings> passes;
+    std::vector<double> frameTimes;
+    std::vector<double> gpuFrameTimes;
+};
@@ -30,6 +30,10 @@ XMMATRIX Camera::view() const {
     return viewMatrix;
 }
 
+XMMATRIX Camera::viewFrom(XMVECTOR eye) const {
+    return XMMatrixLookAtLH(eye, XMVectorAdd(eye, direction), { 0.f, 1.f, 0.f, 0.f });
+}
+
 XMMATRIX Camera::projection() const {
     return projectionMatrix;
 }
@@ -54,6 +58,13 @@ void Camera::rotate(float dx, float dy) {
     updateViewMatrix();
 }
 
+void Camera::setPose(XMVECTOR position, float yaw, float pitch) {
+    this->position = position;
+    this->yaw = yaw;
+    this->pitch = pitch < -89.0f ? -89.0f : pitch > 89.0f ? 89.0f : pitch;
+    updateViewMatrix();
+}
+
 XMVECTOR Camera::getRight() const {
     return XMVector3Normalize(XMVector3Cross({ 0.0f, 1.0f, 0.0f, 0.0f }, direction));
 }
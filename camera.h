@@ -31,6 +31,8 @@ public:
 	Camera();
 
 	XMMATRIX view() const;
+	// view matrix with the current direction from another eye position
+	XMMATRIX viewFrom(XMVECTOR eye) const;
 	XMMATRIX projection() const;
 
 	XMVECTOR getRight() const;
@@ -41,5 +43,7 @@ public:
 	void setAspectRatio(const float aspectRatio);
 	void move(XMVECTOR delta);
 	void rotate(float dx, float dy);
+	// absolute placement, angles in degrees
+	void setPose(XMVECTOR position, float yaw, float pitch);
 };
 
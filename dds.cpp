@@ -0,0 +1,322 @@
+#include <cstring>
+#include <algorithm>
+#include "dds.h"
+
+
+namespace {
+
+// subset of DXGI_FORMAT used by the legacy header conversion
+enum : uint32_t {
+    FMT_R32G32B32A32_FLOAT = 2,
+    FMT_R16G16B16A16_FLOAT = 10,
+    FMT_R16G16B16A16_UNORM = 11,
+    FMT_R16G16B16A16_SNORM = 13,
+    FMT_R32G32_FLOAT = 16,
+    FMT_R10G10B10A2_UNORM = 24,
+    FMT_R8G8B8A8_UNORM = 28,
+    FMT_R16G16_FLOAT = 34,
+    FMT_R16G16_UNORM = 35,
+    FMT_R32_FLOAT = 41,
+    FMT_R8G8_UNORM = 49,
+    FMT_R16_FLOAT = 54,
+    FMT_R16_UNORM = 56,
+    FMT_R8_UNORM = 61,
+    FMT_A8_UNORM = 65,
+    FMT_BC1_UNORM = 71,
+    FMT_BC2_UNORM = 74,
+    FMT_BC3_UNORM = 77,
+    FMT_BC4_UNORM = 80,
+    FMT_BC4_SNORM = 81,
+    FMT_BC5_UNORM = 83,
+    FMT_BC5_SNORM = 84,
+    FMT_B5G6R5_UNORM = 85,
+    FMT_B5G5R5A1_UNORM = 86,
+    FMT_B8G8R8A8_UNORM = 87,
+    FMT_B8G8R8X8_UNORM = 88,
+    FMT_B4G4R4A4_UNORM = 115,
+};
+
+bool isBitMask(DDSPixelFormat const& pf, uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+{
+    return pf.RBitMask == r && pf.GBitMask == g && pf.BBitMask == b && pf.ABitMask == a;
+}
+
+// Convert a pre-DX10 pixel format into a DXGI format, 0 if unknown
+uint32_t formatFromPixelFormat(DDSPixelFormat const& pf)
+{
+    if (pf.flags & DDS_RGB)
+    {
+        switch (pf.RGBBitCount)
+        {
+        case 32:
+            if (isBitMask(pf, 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000))
+                return FMT_R8G8B8A8_UNORM;
+            if (isBitMask(pf, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000))
+                return FMT_B8G8R8A8_UNORM;
+            if (isBitMask(pf, 0x00ff0000, 0x0000ff00, 0x000000ff, 0))
+                return FMT_B8G8R8X8_UNORM;
+            // D3DX writes this one swapped, see DirectXTex
+            if (isBitMask(pf, 0x3ff00000, 0x000ffc00, 0x000003ff, 0xc0000000))
+                return FMT_R10G10B10A2_UNORM;
+            if (isBitMask(pf, 0x0000ffff, 0xffff0000, 0, 0))
+                return FMT_R16G16_UNORM;
+            if (isBitMask(pf, 0xffffffff, 0, 0, 0))
+                return FMT_R32_FLOAT;
+            break;
+        case 16:
+            if (isBitMask(pf, 0x7c00, 0x03e0, 0x001f, 0x8000))
+                return FMT_B5G5R5A1_UNORM;
+            if (isBitMask(pf, 0xf800, 0x07e0, 0x001f, 0))
+                return FMT_B5G6R5_UNORM;
+            if (isBitMask(pf, 0x0f00, 0x00f0, 0x000f, 0xf000))
+                return FMT_B4G4R4A4_UNORM;
+            break;
+        }
+        return 0;
+    }
+
+    if (pf.flags & DDS_LUMINANCE)
+    {
+        if (pf.RGBBitCount == 8 && isBitMask(pf, 0xff, 0, 0, 0))
+            return FMT_R8_UNORM;
+        if (pf.RGBBitCount == 16 && isBitMask(pf, 0xffff, 0, 0, 0))
+            return FMT_R16_UNORM;
+        if (pf.RGBBitCount == 16 && isBitMask(pf, 0x00ff, 0, 0, 0xff00))
+            return FMT_R8G8_UNORM;
+        return 0;
+    }
+
+    if ((pf.flags & DDS_ALPHAPIXELS) && pf.RGBBitCount == 8)
+        return FMT_A8_UNORM;
+
+    if (pf.flags & DDS_FOURCC)
+    {
+        switch (pf.fourCC)
+        {
+        case makeFourCC('D', 'X', 'T', '1'): return FMT_BC1_UNORM;
+        case makeFourCC('D', 'X', 'T', '2'):
+        case makeFourCC('D', 'X', 'T', '3'): return FMT_BC2_UNORM;
+        case makeFourCC('D', 'X', 'T', '4'):
+        case makeFourCC('D', 'X', 'T', '5'): return FMT_BC3_UNORM;
+        case makeFourCC('A', 'T', 'I', '1'):
+        case makeFourCC('B', 'C', '4', 'U'): return FMT_BC4_UNORM;
+        case makeFourCC('B', 'C', '4', 'S'): return FMT_BC4_SNORM;
+        case makeFourCC('A', 'T', 'I', '2'):
+        case makeFourCC('B', 'C', '5', 'U'): return FMT_BC5_UNORM;
+        case makeFourCC('B', 'C', '5', 'S'): return FMT_BC5_SNORM;
+        // D3DFMT values stored directly in fourCC
+        case 36: return FMT_R16G16B16A16_UNORM;
+        case 110: return FMT_R16G16B16A16_SNORM;
+        case 111: return FMT_R16_FLOAT;
+        case 112: return FMT_R16G16_FLOAT;
+        case 113: return FMT_R16G16B16A16_FLOAT;
+        case 114: return FMT_R32_FLOAT;
+        case 115: return FMT_R32G32_FLOAT;
+        case 116: return FMT_R32G32B32A32_FLOAT;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+
+bool isBlockCompressed(uint32_t format)
+{
+    return (format >= 70 && format <= 84) || (format >= 94 && format <= 99);
+}
+
+uint32_t bytesPerBlock(uint32_t format)
+{
+    if ((format >= 70 && format <= 72) || (format >= 79 && format <= 81))
+        return 8;  // BC1, BC4
+    if (isBlockCompressed(format))
+        return 16; // BC2, BC3, BC5, BC6H, BC7
+    return 0;
+}
+
+uint32_t bitsPerPixel(uint32_t format)
+{
+    if (format >= 1 && format <= 4)
+        return 128;
+    if (format >= 5 && format <= 8)
+        return 96;
+    if (format >= 9 && format <= 22)
+        return 64;
+    if ((format >= 23 && format <= 47) || (format >= 67 && format <= 69) ||
+        (format >= 87 && format <= 93))
+        return 32;
+    if ((format >= 48 && format <= 59) || format == 85 || format == 86 || format == 115)
+        return 16;
+    if (format >= 60 && format <= 65)
+        return 8;
+    if ((format >= 70 && format <= 72) || (format >= 79 && format <= 81))
+        return 4;
+    if (isBlockCompressed(format))
+        return 8;
+    return 0;
+}
+
+bool surfaceInfo(uint32_t width, uint32_t height, uint32_t format,
+    uint32_t& rowPitch, uint32_t& rowCount)
+{
+    uint64_t pitch, rows;
+    if (isBlockCompressed(format))
+    {
+        uint64_t blocksWide = std::max<uint64_t>(1, (uint64_t(width) + 3) / 4);
+        uint64_t blocksHigh = std::max<uint64_t>(1, (uint64_t(height) + 3) / 4);
+        pitch = blocksWide * bytesPerBlock(format);
+        rows = blocksHigh;
+    }
+    // packed 4:2:2 formats store two pixels per 32-bit word
+    else if (format == 68 || format == 69)
+    {
+        pitch = ((uint64_t(width) + 1) >> 1) * 4;
+        rows = height;
+    }
+    else
+    {
+        uint32_t bpp = bitsPerPixel(format);
+        if (bpp == 0)
+            return false;
+        pitch = (uint64_t(width) * bpp + 7) / 8;
+        rows = height;
+    }
+
+    if (pitch > UINT32_MAX || rows > UINT32_MAX)
+        return false;
+    rowPitch = static_cast<uint32_t>(pitch);
+    rowCount = static_cast<uint32_t>(rows);
+    return true;
+}
+
+bool parseDDS(uint8_t const* data, size_t size, DDSInfo& info)
+{
+    info = DDSInfo();
+
+    if (!data || size < sizeof(uint32_t) + sizeof(DDSFileHeader))
+        return false;
+
+    uint32_t magic;
+    memcpy(&magic, data, sizeof(magic));
+    if (magic != DDS_MAGIC)
+        return false;
+
+    DDSFileHeader header;
+    memcpy(&header, data + sizeof(uint32_t), sizeof(header));
+    if (header.size != sizeof(DDSFileHeader) || header.ddspf.size != sizeof(DDSPixelFormat))
+        return false;
+
+    size_t offset = sizeof(uint32_t) + sizeof(DDSFileHeader);
+
+    info.width = header.width;
+    info.height = header.height;
+    info.depth = 1;
+    info.mipCount = header.mipMapCount ? header.mipMapCount : 1;
+
+    if ((header.ddspf.flags & DDS_FOURCC) && header.ddspf.fourCC == makeFourCC('D', 'X', '1', '0'))
+    {
+        if (size < offset + sizeof(DDSFileHeaderDXT10))
+            return false;
+
+        DDSFileHeaderDXT10 dx10;
+        memcpy(&dx10, data + offset, sizeof(dx10));
+        offset += sizeof(DDSFileHeaderDXT10);
+
+        info.hasDX10Header = true;
+        info.format = dx10.dxgiFormat;
+        info.arraySize = dx10.arraySize;
+        info.dimension = dx10.resourceDimension;
+        if (info.arraySize == 0 || info.arraySize > DDS_MAX_ARRAY_SIZE)
+            return false;
+
+        switch (info.dimension)
+        {
+        case DDS_DIMENSION_TEXTURE1D:
+            info.height = 1;
+            break;
+        case DDS_DIMENSION_TEXTURE2D:
+            if (dx10.miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE)
+            {
+                info.isCubemap = true;
+                info.arraySize *= 6;
+            }
+            break;
+        case DDS_DIMENSION_TEXTURE3D:
+            if (!(header.flags & DDS_HEADER_FLAGS_VOLUME) || info.arraySize != 1)
+                return false;
+            info.depth = header.depth;
+            break;
+        default:
+            return false;
+        }
+    }
+    else
+    {
+        info.format = formatFromPixelFormat(header.ddspf);
+
+        if (header.flags & DDS_HEADER_FLAGS_VOLUME)
+        {
+            info.dimension = DDS_DIMENSION_TEXTURE3D;
+            info.depth = header.depth;
+        }
+        else if (header.caps2 & DDS_CUBEMAP)
+        {
+            // partial cubemaps are not supported by D3D11
+            if ((header.caps2 & DDS_CUBEMAP_ALLFACES) != DDS_CUBEMAP_ALLFACES)
+                return false;
+            info.isCubemap = true;
+            info.arraySize = 6;
+        }
+    }
+
+    if (info.format == 0 || bitsPerPixel(info.format) == 0)
+        return false;
+    if (info.width == 0 || info.height == 0 || info.depth == 0)
+        return false;
+    if (info.width > DDS_MAX_DIMENSION || info.height > DDS_MAX_DIMENSION || info.depth > DDS_MAX_DEPTH)
+        return false;
+
+    // a chain longer than log2(max dim) + 1 is malformed
+    uint32_t maxDim = std::max(std::max(info.width, info.height), info.depth);
+    uint32_t maxMips = 1;
+    while (maxDim > 1) {
+        maxDim >>= 1;
+        maxMips++;
+    }
+    if (info.mipCount > maxMips)
+        return false;
+
+    info.surfaces.reserve(static_cast<size_t>(info.arraySize) * info.mipCount);
+    for (uint32_t slice = 0; slice < info.arraySize; slice++)
+    {
+        uint32_t w = info.width, h = info.height, d = info.depth;
+        for (uint32_t mip = 0; mip < info.mipCount; mip++)
+        {
+            DDSSurface surf;
+            if (!surfaceInfo(w, h, info.format, surf.rowPitch, surf.rowCount))
+                return false;
+
+            uint64_t slicePitch = uint64_t(surf.rowPitch) * surf.rowCount;
+            uint64_t surfSize = slicePitch * d;
+            if (slicePitch > UINT32_MAX || surfSize > size || offset > size - surfSize)
+                return false;
+
+            surf.slicePitch = static_cast<uint32_t>(slicePitch);
+            surf.width = w;
+            surf.height = h;
+            surf.depth = d;
+            surf.offset = offset;
+            surf.size = static_cast<size_t>(surfSize);
+
+            offset += surf.size;
+            info.surfaces.push_back(surf);
+
+            w = std::max<uint32_t>(1, w >> 1);
+            h = std::max<uint32_t>(1, h >> 1);
+            d = std::max<uint32_t>(1, d >> 1);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Portable DDS header parser: no D3D headers are used here so the
+// layout math can be reused by offline tools. Formats are stored as
+// raw DXGI_FORMAT values.
+
+struct DDSPixelFormat
+{
+    uint32_t size;
+    uint32_t flags;
+    uint32_t fourCC;
+    uint32_t RGBBitCount;
+    uint32_t RBitMask;
+    uint32_t GBitMask;
+    uint32_t BBitMask;
+    uint32_t ABitMask;
+};
+
+struct DDSFileHeader
+{
+    uint32_t size;
+    uint32_t flags;
+    uint32_t height;
+    uint32_t width;
+    uint32_t pitchOrLinearSize;
+    uint32_t depth;
+    uint32_t mipMapCount;
+    uint32_t reserved1[11];
+    DDSPixelFormat ddspf;
+    uint32_t caps;
+    uint32_t caps2;
+    uint32_t caps3;
+    uint32_t caps4;
+    uint32_t reserved2;
+};
+
+struct DDSFileHeaderDXT10
+{
+    uint32_t dxgiFormat;
+    uint32_t resourceDimension;
+    uint32_t miscFlag;
+    uint32_t arraySize;
+    uint32_t miscFlags2;
+};
+
+constexpr uint32_t DDS_MAGIC = 0x20534444; // "DDS "
+
+constexpr uint32_t DDS_FOURCC = 0x00000004;
+constexpr uint32_t DDS_RGB = 0x00000040;
+constexpr uint32_t DDS_LUMINANCE = 0x00020000;
+constexpr uint32_t DDS_ALPHAPIXELS = 0x00000001;
+
+constexpr uint32_t DDS_HEADER_FLAGS_VOLUME = 0x00800000;
+constexpr uint32_t DDS_CUBEMAP = 0x00000200;
+constexpr uint32_t DDS_CUBEMAP_ALLFACES = 0x0000FE00;
+
+// D3D11_RESOURCE_DIMENSION values used by the DX10 header
+constexpr uint32_t DDS_DIMENSION_TEXTURE1D = 2;
+constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+constexpr uint32_t DDS_DIMENSION_TEXTURE3D = 4;
+
+// D3D11_RESOURCE_MISC_TEXTURECUBE
+constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+// D3D11 feature level 11 limits; larger headers are rejected before any
+// layout math so hostile values cannot overflow the pitch computation
+constexpr uint32_t DDS_MAX_DIMENSION = 16384;  // width/height
+constexpr uint32_t DDS_MAX_DEPTH = 2048;
+constexpr uint32_t DDS_MAX_ARRAY_SIZE = 2048;  // DX10 arraySize, before the x6 for cubes
+
+constexpr uint32_t makeFourCC(char c0, char c1, char c2, char c3)
+{
+    return static_cast<uint32_t>(static_cast<uint8_t>(c0))
+        | (static_cast<uint32_t>(static_cast<uint8_t>(c1)) << 8)
+        | (static_cast<uint32_t>(static_cast<uint8_t>(c2)) << 16)
+        | (static_cast<uint32_t>(static_cast<uint8_t>(c3)) << 24);
+}
+
+// One mip of one array slice (cube face) inside the file
+struct DDSSurface
+{
+    size_t offset;    // from the beginning of the file
+    size_t size;
+    uint32_t rowPitch;
+    uint32_t slicePitch;
+    uint32_t rowCount;
+    uint32_t width;
+    uint32_t height;
+    uint32_t depth;
+};
+
+struct DDSInfo
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t depth = 1;
+    uint32_t mipCount = 1;
+    // number of 2D slices, cube faces included (6 per cube)
+    uint32_t arraySize = 1;
+    uint32_t dimension = DDS_DIMENSION_TEXTURE2D;
+    uint32_t format = 0;
+    bool isCubemap = false;
+    bool hasDX10Header = false;
+
+    // surfaces are stored slice-major: surfaces[slice * mipCount + mip]
+    std::vector<DDSSurface> surfaces;
+
+    DDSSurface const& surface(uint32_t mip, uint32_t slice) const
+    {
+        return surfaces[slice * mipCount + mip];
+    }
+};
+
+// returns false on truncated/unsupported files
+bool parseDDS(uint8_t const* data, size_t size, DDSInfo& info);
+
+// DXGI_FORMAT helpers
+bool isBlockCompressed(uint32_t format);
+uint32_t bitsPerPixel(uint32_t format);
+// bytes per 4x4 block for BC formats, 0 otherwise
+uint32_t bytesPerBlock(uint32_t format);
+
+// row pitch/row count of a single w x h image, false if the pitch does not fit 32 bits
+bool surfaceInfo(uint32_t width, uint32_t height, uint32_t format,
+    uint32_t& rowPitch, uint32_t& rowCount);
@@ -0,0 +1,341 @@
+#include <algorithm>
+
+#include "frame_graph.h"
+#include "dds.h"
+
+
+static uint64_t textureBytes(FrameGraphTextureDesc const& desc)
+{
+    return static_cast<uint64_t>(desc.width) * desc.height * bitsPerPixel(desc.format) / 8;
+}
+
+void* FrameGraphResources::texture(FrameGraphHandle handle) const
+{
+    auto const& resource = graph.resources[graph.nodes[handle].resource];
+    if (resource.imported)
+        return resource.imported;
+    return resource.slot != ~0u ? graph.slots[resource.slot].texture : nullptr;
+}
+
+FrameGraphHandle FrameGraphPassBuilder::create(std::string const& name, FrameGraphTextureDesc const& desc)
+{
+    FrameGraph::Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    graph.resources.push_back(resource);
+    return graph.addNode(static_cast<uint32_t>(graph.resources.size() - 1), 0, FrameGraph::NoPass);
+}
+
+FrameGraphHandle FrameGraphPassBuilder::read(FrameGraphHandle handle)
+{
+    graph.passes[pass].reads.push_back(handle);
+    graph.nodes[handle].readers.push_back(pass);
+    return handle;
+}
+
+FrameGraphHandle FrameGraphPassBuilder::write(FrameGraphHandle handle)
+{
+    auto const& node = graph.nodes[handle];
+    auto written = graph.addNode(node.resource, node.version + 1, pass);
+    graph.passes[pass].overwrites.push_back(handle);
+    graph.passes[pass].writes.push_back(written);
+    return written;
+}
+
+void FrameGraphPassBuilder::setSideEffect()
+{
+    graph.passes[pass].sideEffect = true;
+}
+
+void FrameGraphPassBuilder::execute(ExecuteFunc func)
+{
+    graph.passes[pass].execute = func;
+}
+
+FrameGraphPassBuilder FrameGraph::addPass(std::string const& name)
+{
+    Pass pass;
+    pass.name = name;
+    passes.push_back(pass);
+    return FrameGraphPassBuilder(*this, static_cast<uint32_t>(passes.size() - 1));
+}
+
+FrameGraphHandle FrameGraph::import(std::string const& name, FrameGraphTextureDesc const& desc, void* texture)
+{
+    Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    resource.imported = texture;
+    resources.push_back(resource);
+    return addNode(static_cast<uint32_t>(resources.size() - 1), 0, NoPass);
+}
+
+void FrameGraph::setOutput(FrameGraphHandle handle)
+{
+    outputs.push_back(handle);
+}
+
+FrameGraphHandle FrameGraph::addNode(uint32_t resource, uint32_t version, uint32_t producer)
+{
+    nodes.push_back({ resource, version, producer, {} });
+    return static_cast<FrameGraphHandle>(nodes.size() - 1);
+}
+
+bool FrameGraph::compile()
+{
+    order.clear();
+    slots.clear();
+    _stats = FrameGraphStats();
+    for (auto& pass : passes)
+    {
+        pass.acquire.clear();
+        pass.release.clear();
+    }
+    for (auto& resource : resources)
+    {
+        resource.first = ~0u;
+        resource.last = 0;
+        resource.slot = ~0u;
+    }
+
+    cull();
+    if (!sort())
+        return false;
+    assignSlots();
+
+    _stats.passCount = static_cast<uint32_t>(passes.size());
+    _stats.culledCount = static_cast<uint32_t>(passes.size() - order.size());
+    return true;
+}
+
+void FrameGraph::cull()
+{
+    std::vector<uint32_t> stack;
+    for (auto handle : outputs)
+        if (nodes[handle].producer != NoPass)
+            stack.push_back(nodes[handle].producer);
+    for (uint32_t i = 0; i < passes.size(); i++)
+    {
+        passes[i].culled = true;
+        if (passes[i].sideEffect)
+            stack.push_back(i);
+    }
+
+    // walk back from the outputs through everything the passes consume
+    while (!stack.empty())
+    {
+        auto& pass = passes[stack.back()];
+        stack.pop_back();
+        if (!pass.culled)
+            continue;
+        pass.culled = false;
+
+        for (auto const* handles : { &pass.reads, &pass.overwrites })
+            for (auto handle : *handles)
+                if (nodes[handle].producer != NoPass && passes[nodes[handle].producer].culled)
+                    stack.push_back(nodes[handle].producer);
+    }
+}
+
+bool FrameGraph::sort()
+{
+    std::vector<std::vector<uint32_t>> successors(passes.size());
+    std::vector<uint32_t> inDegree(passes.size(), 0);
+    std::vector<uint32_t> writers(nodes.size(), 0);
+
+    auto addEdge = [&](uint32_t from, uint32_t to) {
+        if (from == NoPass || from == to)
+            return;
+        successors[from].push_back(to);
+        inDegree[to]++;
+    };
+
+    for (uint32_t i = 0; i < passes.size(); i++)
+    {
+        auto const& pass = passes[i];
+        if (pass.culled)
+            continue;
+
+        for (auto handle : pass.reads)
+            addEdge(nodes[handle].producer, i);
+
+        for (auto handle : pass.overwrites)
+        {
+            // two live passes drawing over the same version would race
+            if (++writers[handle] > 1)
+                return false;
+
+            addEdge(nodes[handle].producer, i);
+            // the old contents are gone after this pass, readers go first
+            for (auto reader : nodes[handle].readers)
+                if (!passes[reader].culled)
+                    addEdge(reader, i);
+        }
+    }
+
+    // Kahn, ties resolved by declaration order
+    std::vector<bool> done(passes.size(), false);
+    uint32_t liveCount = 0;
+    for (auto const& pass : passes)
+        if (!pass.culled)
+            liveCount++;
+
+    while (order.size() < liveCount)
+    {
+        uint32_t next = NoPass;
+        for (uint32_t i = 0; i < passes.size(); i++)
+        {
+            if (!passes[i].culled && !done[i] && inDegree[i] == 0)
+            {
+                next = i;
+                break;
+            }
+        }
+        if (next == NoPass)
+            return false;
+
+        done[next] = true;
+        order.push_back(next);
+        for (auto successor : successors[next])
+            inDegree[successor]--;
+    }
+    return true;
+}
+
+void FrameGraph::assignSlots()
+{
+    for (uint32_t i = 0; i < order.size(); i++)
+    {
+        auto const& pass = passes[order[i]];
+        for (auto const* handles : { &pass.reads, &pass.overwrites, &pass.writes })
+            for (auto handle : *handles)
+            {
+                auto& resource = resources[nodes[handle].resource];
+                resource.first = std::min(resource.first, i);
+                resource.last = std::max(resource.last, i);
+            }
+    }
+
+    std::vector<uint32_t> transient;
+    for (uint32_t i = 0; i < resources.size(); i++)
+        if (!resources[i].imported && resources[i].first <= resources[i].last)
+            transient.push_back(i);
+    std::stable_sort(transient.begin(), transient.end(), [this](uint32_t a, uint32_t b) {
+        return resources[a].first < resources[b].first;
+    });
+
+    // first fit: D3D11 has no placed resources, so only identical textures can share memory
+    for (auto index : transient)
+    {
+        auto& resource = resources[index];
+        for (uint32_t s = 0; s < slots.size(); s++)
+        {
+            if (slots[s].desc == resource.desc && slots[s].last < resource.first)
+            {
+                resource.slot = s;
+                break;
+            }
+        }
+
+        if (resource.slot == ~0u)
+        {
+            resource.slot = static_cast<uint32_t>(slots.size());
+            slots.push_back({ resource.desc, resource.last, nullptr });
+            passes[order[resource.first]].acquire.push_back(resource.slot);
+            _stats.allocatedBytes += textureBytes(resource.desc);
+        }
+        slots[resource.slot].last = resource.last;
+        _stats.unaliasedBytes += textureBytes(resource.desc);
+    }
+
+    for (uint32_t s = 0; s < slots.size(); s++)
+        passes[order[slots[s].last]].release.push_back(s);
+
+    for (uint32_t i = 0; i < order.size(); i++)
+    {
+        uint64_t live = 0;
+        for (auto index : transient)
+            if (resources[index].first <= i && i <= resources[index].last)
+                live += textureBytes(resources[index].desc);
+        _stats.peakBytes = std::max(_stats.peakBytes, live);
+    }
+
+    _stats.transientCount = static_cast<uint32_t>(transient.size());
+    _stats.physicalCount = static_cast<uint32_t>(slots.size());
+}
+
+bool FrameGraph::execute(FrameGraphBackend& backend)
+{
+    FrameGraphResources res(*this);
+    bool ok = true;
+
+    for (auto index : order)
+    {
+        auto& pass = passes[index];
+        for (auto s : pass.acquire)
+        {
+            slots[s].texture = backend.acquire(slots[s].desc);
+            if (!slots[s].texture)
+                ok = false;
+        }
+        if (!ok)
+            break;
+
+        backend.beginPass(pass.name);
+        if (pass.execute)
+            pass.execute(res);
+        backend.endPass();
+
+        // inputs may be bound as render targets by a later pass or next frame
+        if (!pass.reads.empty())
+            backend.unbindInputs(static_cast<uint32_t>(pass.reads.size()));
+
+        for (auto s : pass.release)
+        {
+            backend.release(slots[s].texture);
+            slots[s].texture = nullptr;
+        }
+    }
+
+    // give back whatever is still held after a failure
+    for (auto& slot : slots)
+    {
+        if (slot.texture)
+            backend.release(slot.texture);
+        slot.texture = nullptr;
+    }
+    return ok;
+}
+
+void FrameGraph::print(FILE* out) const
+{
+    auto mb = [](uint64_t bytes) { return bytes / 1048576.0; };
+
+    fprintf(out, "%u passes, %u culled\n", _stats.passCount, _stats.culledCount);
+    for (uint32_t i = 0; i < order.size(); i++)
+    {
+        auto const& pass = passes[order[i]];
+        fprintf(out, "  %2u %-20s", i, pass.name.c_str());
+        for (auto handle : pass.reads)
+            fprintf(out, " <%s", resources[nodes[handle].resource].name.c_str());
+        for (auto handle : pass.writes)
+            fprintf(out, " >%s", resources[nodes[handle].resource].name.c_str());
+        fprintf(out, "\n");
+    }
+    for (auto const& pass : passes)
+        if (pass.culled)
+            fprintf(out, "  -- %s (culled)\n", pass.name.c_str());
+
+    fprintf(out, "%u transient textures in %u slots\n", _stats.transientCount, _stats.physicalCount);
+    for (auto const& resource : resources)
+    {
+        if (resource.imported || resource.first > resource.last)
+            continue;
+        fprintf(out, "  %-20s %5ux%-5u format %2u  passes %2u..%-2u  slot %u  %.2f MB\n",
+            resource.name.c_str(), resource.desc.width, resource.desc.height, resource.desc.format,
+            resource.first, resource.last, resource.slot, mb(textureBytes(resource.desc)));
+    }
+
+    fprintf(out, "transient memory: %.2f MB unaliased, %.2f MB allocated, %.2f MB peak\n",
+        mb(_stats.unaliasedBytes), mb(_stats.allocatedBytes), mb(_stats.peakBytes));
+}
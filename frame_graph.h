@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+
+// Portable declarative frame graph. Passes declare the textures they create,
+// read and write; compile() orders them, culls passes that don't contribute
+// to the output and assigns transient textures to physical slots, sharing a
+// slot between textures of the same description with disjoint lifetimes.
+// GPU objects are provided by a FrameGraphBackend.
+
+struct FrameGraphTextureDesc
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    // DXGI_FORMAT value
+    uint32_t format = 0;
+
+    bool operator==(FrameGraphTextureDesc const& other) const
+    {
+        return width == other.width && height == other.height && format == other.format;
+    }
+};
+
+// one version of a resource, every write produces a new version
+using FrameGraphHandle = uint32_t;
+constexpr FrameGraphHandle InvalidFrameGraphHandle = ~0u;
+
+class FrameGraphBackend
+{
+public:
+    virtual ~FrameGraphBackend() = default;
+
+    // texture for a physical slot, nullptr on failure
+    virtual void* acquire(FrameGraphTextureDesc const& desc) = 0;
+    virtual void release(void* texture) = 0;
+    // clear the first count shader input slots after a pass that read textures
+    virtual void unbindInputs(uint32_t count) = 0;
+
+    virtual void beginPass(std::string const& /*name*/) {}
+    virtual void endPass() {}
+};
+
+class FrameGraph;
+
+class FrameGraphResources
+{
+public:
+    // backend texture behind the handle
+    template<typename T>
+    T* get(FrameGraphHandle handle) const { return static_cast<T*>(texture(handle)); }
+
+private:
+    explicit FrameGraphResources(FrameGraph const& graph) : graph(graph) {}
+    void* texture(FrameGraphHandle handle) const;
+
+    FrameGraph const& graph;
+
+    friend class FrameGraph;
+};
+
+// declares the resources of one pass, returned by FrameGraph::addPass
+class FrameGraphPassBuilder
+{
+public:
+    using ExecuteFunc = std::function<void(FrameGraphResources const&)>;
+
+    // new transient texture, it has to be written before it can be read
+    FrameGraphHandle create(std::string const& name, FrameGraphTextureDesc const& desc);
+    FrameGraphHandle read(FrameGraphHandle handle);
+    // draw on top of the given version, returns the new one
+    FrameGraphHandle write(FrameGraphHandle handle);
+    // the pass is never culled
+    void setSideEffect();
+    void execute(ExecuteFunc func);
+
+private:
+    FrameGraphPassBuilder(FrameGraph& graph, uint32_t pass) : graph(graph), pass(pass) {}
+
+    FrameGraph& graph;
+    uint32_t pass;
+
+    friend class FrameGraph;
+};
+
+struct FrameGraphStats
+{
+    uint32_t passCount = 0;
+    uint32_t culledCount = 0;
+    uint32_t transientCount = 0;
+    uint32_t physicalCount = 0;
+    // every transient texture in its own allocation
+    uint64_t unaliasedBytes = 0;
+    // textures of the physical slots
+    uint64_t allocatedBytes = 0;
+    // most transient bytes alive at the same time
+    uint64_t peakBytes = 0;
+};
+
+class FrameGraph
+{
+public:
+    FrameGraphPassBuilder addPass(std::string const& name);
+    // external texture, e.g. the swapchain
+    FrameGraphHandle import(std::string const& name, FrameGraphTextureDesc const& desc, void* texture);
+    // the graph only keeps passes needed to produce the outputs
+    void setOutput(FrameGraphHandle handle);
+
+    // false if the graph has a cycle or a version is written twice
+    bool compile();
+    // false if a transient texture could not be acquired
+    bool execute(FrameGraphBackend& backend);
+
+    FrameGraphStats const& stats() const { return _stats; }
+    // execution order, lifetimes and memory, for debugging
+    void print(FILE* out) const;
+
+private:
+    struct Resource
+    {
+        std::string name;
+        FrameGraphTextureDesc desc;
+        void* imported = nullptr;
+        // compiled lifetime in execution order, first > last if unused
+        uint32_t first = ~0u;
+        uint32_t last = 0;
+        uint32_t slot = ~0u;
+    };
+
+    struct Node
+    {
+        uint32_t resource;
+        uint32_t version;
+        uint32_t producer;
+        std::vector<uint32_t> readers;
+    };
+
+    struct Pass
+    {
+        std::string name;
+        std::vector<FrameGraphHandle> reads;
+        // previous versions of the written resources
+        std::vector<FrameGraphHandle> overwrites;
+        std::vector<FrameGraphHandle> writes;
+        FrameGraphPassBuilder::ExecuteFunc execute;
+        bool sideEffect = false;
+        bool culled = true;
+        // slots acquired before and released after the pass
+        std::vector<uint32_t> acquire;
+        std::vector<uint32_t> release;
+    };
+
+    struct Slot
+    {
+        FrameGraphTextureDesc desc;
+        uint32_t last = 0;
+        void* texture = nullptr;
+    };
+
+    static constexpr uint32_t NoPass = ~0u;
+
+    FrameGraphHandle addNode(uint32_t resource, uint32_t version, uint32_t producer);
+    void cull();
+    bool sort();
+    void assignSlots();
+
+    std::vector<Resource> resources;
+    std::vector<Node> nodes;
+    std::vector<Pass> passes;
+    std::vector<FrameGraphHandle> outputs;
+
+    std::vector<uint32_t> order;
+    std::vector<Slot> slots;
+    FrameGraphStats _stats;
+
+    friend class FrameGraphPassBuilder;
+    friend class FrameGraphResources;
+};
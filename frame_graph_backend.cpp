@@ -0,0 +1,39 @@
+#include <algorithm>
+
+#include "frame_graph_backend.h"
+
+
+RenderTargetBackend::RenderTargetBackend(RenderTargetPool& pool, ID3D11DeviceContext* context,
+    GpuProfiler* profiler) :
+    pool(pool), context(context), profiler(profiler)
+{
+}
+
+void* RenderTargetBackend::acquire(FrameGraphTextureDesc const& desc)
+{
+    auto target = pool.acquire(desc.width, desc.height, static_cast<DXGI_FORMAT>(desc.format));
+    return const_cast<RenderTarget*>(target);
+}
+
+void RenderTargetBackend::release(void* texture)
+{
+    pool.release(static_cast<RenderTarget const*>(texture));
+}
+
+void RenderTargetBackend::unbindInputs(uint32_t count)
+{
+    ID3D11ShaderResourceView* views[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT] = { nullptr };
+    context->PSSetShaderResources(0, std::min<UINT>(count, ARRAYSIZE(views)), views);
+}
+
+void RenderTargetBackend::beginPass(std::string const& name)
+{
+    if (profiler)
+        profiler->begin(Profiler::get().intern(name));
+}
+
+void RenderTargetBackend::endPass()
+{
+    if (profiler)
+        profiler->end();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <d3d11_1.h>
+
+#include "frame_graph.h"
+#include "render_target_pool.h"
+#include "gpu_profiler.h"
+
+
+// Frame graph textures backed by pooled render targets, graph handles resolve to RenderTarget
+class RenderTargetBackend : public FrameGraphBackend
+{
+public:
+    // passes are profiled when a GPU profiler is given
+    RenderTargetBackend(RenderTargetPool& pool, ID3D11DeviceContext* context,
+        GpuProfiler* profiler = nullptr);
+
+    void* acquire(FrameGraphTextureDesc const& desc) override;
+    void release(void* texture) override;
+    void unbindInputs(uint32_t count) override;
+
+    void beginPass(std::string const& name) override;
+    void endPass() override;
+
+private:
+    RenderTargetPool& pool;
+    ID3D11DeviceContext* context;
+    GpuProfiler* profiler;
+};
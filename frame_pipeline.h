@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <thread>
+
+#include "game_loop.h"
+
+// Portable two-stage frame pipeline. A simulation thread fills a snapshot and
+// publishes it, a render thread takes the newest published one. The handoff is
+// a lock-free triple buffer: the producer writes the back slot, publishing
+// swaps it with the middle slot, and the consumer swaps its front slot with the
+// middle one when that holds an unread frame.
+//
+// maxQueuedFrames bounds how far the producer runs ahead: with 1 it simulates
+// frame N+1 while frame N renders and then waits, with 0 it never waits and the
+// consumer skips stale snapshots.
+
+struct FramePipelineStats
+{
+    uint64_t published = 0;
+    uint64_t consumed = 0;
+    // published snapshots the consumer never took
+    uint64_t dropped = 0;
+    // seconds spent blocked in waitForRoom and beginFrame / acquire
+    double producerWait = 0.0;
+    double consumerWait = 0.0;
+    // input applied to frame presented, seconds
+    FrameTimePercentiles latency;
+};
+
+template<typename T>
+class FramePipeline
+{
+public:
+    explicit FramePipeline(uint32_t maxQueuedFrames = 1, uint32_t latencyHistory = 1024) :
+        maxQueued(maxQueuedFrames), latencies(latencyHistory)
+    {
+    }
+
+    // producer: block until another frame fits into the queue, waiting before
+    // sampling input keeps the latency of a full queue out of the frame
+    void waitForRoom()
+    {
+        auto start = GameLoop::clockNow();
+        while (!stopping.load() && !hasRoom())
+            std::this_thread::yield();
+        addTime(producerWait, GameLoop::clockNow() - start);
+    }
+
+    // producer: slot to fill once there is room, nullptr after stop()
+    T* beginFrame()
+    {
+        auto start = GameLoop::clockNow();
+        for (;;)
+        {
+            if (stopping.load())
+                return nullptr;
+
+            // pause() either sees this flag or we see its request
+            inFrame.store(true);
+            if (!pauseRequested.load() && hasRoom())
+                break;
+            inFrame.store(false);
+            std::this_thread::yield();
+        }
+        addTime(producerWait, GameLoop::clockNow() - start);
+        return &slots[back].data;
+    }
+
+    // producer: hand the slot from beginFrame to the consumer, inputTime is when
+    // the newest input it reflects was applied (GameLoop::clockNow)
+    void publish(double inputTime)
+    {
+        auto frame = published.load(std::memory_order_relaxed) + 1;
+        slots[back].frame = frame;
+        slots[back].inputTime = inputTime;
+        back = middle.exchange(back | unread, std::memory_order_acq_rel) & indexMask;
+        published.store(frame);
+        inFrame.store(false);
+    }
+
+    // consumer: newest published snapshot, waits up to timeout seconds for one it
+    // hasn't seen yet, nullptr on timeout or after stop()
+    T const* acquire(double timeout)
+    {
+        auto start = GameLoop::clockNow();
+        while (!(middle.load(std::memory_order_acquire) & unread))
+        {
+            if (stopping.load() || GameLoop::clockNow() - start >= timeout)
+            {
+                addTime(consumerWait, GameLoop::clockNow() - start);
+                return nullptr;
+            }
+            std::this_thread::yield();
+        }
+        addTime(consumerWait, GameLoop::clockNow() - start);
+
+        front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+        auto frame = slots[front].frame;
+        dropped.fetch_add(frame - consumedFrame.load() - 1, std::memory_order_relaxed);
+        consumed.fetch_add(1, std::memory_order_relaxed);
+        consumedFrame.store(frame);
+        return &slots[front].data;
+    }
+
+    // consumer: the acquired snapshot is on screen
+    void presented()
+    {
+        latencies.add(GameLoop::clockNow() - slots[front].inputTime);
+    }
+
+    // park the producer at its next beginFrame, returns once it is outside a frame
+    void pause()
+    {
+        pauseRequested.store(true);
+        while (inFrame.load() && !stopping.load())
+            std::this_thread::yield();
+    }
+    void resume() { pauseRequested.store(false); }
+
+    // unblock both sides for good
+    void stop() { stopping.store(true); }
+    bool stopped() const { return stopping.load(); }
+
+    void setMaxQueuedFrames(uint32_t frames) { maxQueued.store(frames); }
+    uint32_t maxQueuedFrames() const { return maxQueued.load(); }
+
+    // latency is recorded on the consumer thread, call it from there
+    FramePipelineStats stats() const
+    {
+        FramePipelineStats stats;
+        stats.published = published.load();
+        stats.consumed = consumed.load();
+        stats.dropped = dropped.load();
+        stats.producerWait = producerWait.load() * 1e-9;
+        stats.consumerWait = consumerWait.load() * 1e-9;
+        stats.latency = latencies.percentiles();
+        return stats;
+    }
+
+private:
+    FramePipeline(FramePipeline const&) = delete;
+    FramePipeline& operator=(FramePipeline const&) = delete;
+
+    bool hasRoom() const
+    {
+        auto limit = maxQueued.load();
+        return limit == 0 || published.load() - consumedFrame.load() < limit;
+    }
+
+    static void addTime(std::atomic<uint64_t>& total, double seconds)
+    {
+        total.fetch_add(static_cast<uint64_t>(seconds * 1e9), std::memory_order_relaxed);
+    }
+
+    struct Slot
+    {
+        T data;
+        uint64_t frame = 0;
+        double inputTime = 0.0;
+    };
+
+    static constexpr uint32_t indexMask = 3;
+    // set in middle while it holds a frame the consumer hasn't taken
+    static constexpr uint32_t unread = 4;
+
+    Slot slots[3];
+    // owned by the producer and the consumer respectively
+    uint32_t back = 0;
+    uint32_t front = 1;
+    alignas(64) std::atomic<uint32_t> middle = 2;
+
+    std::atomic<uint64_t> published = 0;
+    std::atomic<uint64_t> consumedFrame = 0;
+    std::atomic<uint64_t> consumed = 0;
+    std::atomic<uint64_t> dropped = 0;
+    std::atomic<uint32_t> maxQueued;
+
+    std::atomic<bool> inFrame = false;
+    std::atomic<bool> pauseRequested = false;
+    std::atomic<bool> stopping = false;
+
+    std::atomic<uint64_t> producerWait = 0;
+    std::atomic<uint64_t> consumerWait = 0;
+    FrameTimeHistory latencies;
+};
@@ -0,0 +1,121 @@
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "game_loop.h"
+
+
+FrameTimeHistory::FrameTimeHistory(uint32_t capacity) :
+    times(std::max<uint32_t>(capacity, 1), 0.0)
+{
+}
+
+void FrameTimeHistory::add(double seconds)
+{
+    times[next] = seconds;
+    next = (next + 1) % times.size();
+    if (next == 0)
+        full = true;
+}
+
+void FrameTimeHistory::clear()
+{
+    next = 0;
+    full = false;
+}
+
+FrameTimePercentiles FrameTimeHistory::percentiles() const
+{
+    FrameTimePercentiles result;
+    std::vector<double> sorted(times.begin(), full ? times.end() : times.begin() + next);
+    if (sorted.empty())
+        return result;
+
+    std::sort(sorted.begin(), sorted.end());
+    auto at = [&sorted](double p) {
+        auto index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    };
+
+    double sum = 0.0;
+    for (auto t : sorted)
+        sum += t;
+
+    result.p50 = at(0.50);
+    result.p95 = at(0.95);
+    result.p99 = at(0.99);
+    result.mean = sum / sorted.size();
+    result.max = sorted.back();
+    result.count = static_cast<uint32_t>(sorted.size());
+    return result;
+}
+
+GameLoop::GameLoop(UpdateFunc update, RenderFunc render, GameLoopSettings const& settings) :
+    update(update), render(render), _settings(settings)
+{
+    now = &GameLoop::clockNow;
+    sleep = [](double seconds) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    };
+}
+
+double GameLoop::clockNow()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void GameLoop::setTimeSource(NowFunc nowFunc, SleepFunc sleepFunc)
+{
+    now = nowFunc;
+    sleep = sleepFunc;
+    lastFrame = -1.0;
+}
+
+void GameLoop::sleepUntil(double time) const
+{
+    // OS sleeps overshoot by up to a scheduler tick
+    const double spinTime = 0.002;
+    for (auto remaining = time - now(); remaining > 0.0; remaining = time - now())
+    {
+        // sleep(0) only yields
+        sleep(remaining > spinTime ? remaining - spinTime : 0.0);
+    }
+}
+
+void GameLoop::tick()
+{
+    if (wait)
+        wait();
+
+    auto frameStart = now();
+    auto frameTime = lastFrame < 0.0 ? 0.0 : frameStart - lastFrame;
+    lastFrame = frameStart;
+    if (frames > 0)
+        _history.add(frameTime);
+
+    accumulator += frameTime;
+    uint32_t steps = 0;
+    while (accumulator >= _settings.fixedStep && steps < _settings.maxStepsPerFrame)
+    {
+        update(_settings.fixedStep);
+        accumulator -= _settings.fixedStep;
+        steps++;
+        updates++;
+    }
+
+    // don't try to catch up after a stall (breakpoint, window drag)
+    if (accumulator >= _settings.fixedStep)
+    {
+        auto keep = std::fmod(accumulator, _settings.fixedStep);
+        dropped += accumulator - keep;
+        accumulator = keep;
+    }
+
+    render(accumulator / _settings.fixedStep, frameTime);
+    frames++;
+
+    if (_settings.maxFps > 0.0)
+        sleepUntil(frameStart + 1.0 / _settings.maxFps);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <functional>
+
+// Portable fixed-timestep loop: the simulation advances in fixed steps, the
+// renderer gets the fraction of a step left over for interpolation. Frames can
+// be capped and paced by an external wait (e.g. a waitable swapchain).
+
+struct FrameTimePercentiles
+{
+    // seconds
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double mean = 0.0;
+    double max = 0.0;
+    uint32_t count = 0;
+};
+
+// frame times of the last capacity frames
+class FrameTimeHistory
+{
+public:
+    explicit FrameTimeHistory(uint32_t capacity = 1024);
+
+    void add(double seconds);
+    void clear();
+    FrameTimePercentiles percentiles() const;
+
+private:
+    std::vector<double> times;
+    uint32_t next = 0;
+    bool full = false;
+};
+
+struct GameLoopSettings
+{
+    // seconds per simulation step
+    double fixedStep = 1.0 / 120.0;
+    // steps per frame at most, a larger backlog is dropped
+    uint32_t maxStepsPerFrame = 8;
+    // 0 for uncapped
+    double maxFps = 0.0;
+};
+
+class GameLoop
+{
+public:
+    using UpdateFunc = std::function<void(double step)>;
+    // interpolation in [0, 1) between the last two simulation states, frame time in seconds
+    using RenderFunc = std::function<void(double interpolation, double frameTime)>;
+    // blocks until a new frame may be started
+    using WaitFunc = std::function<void()>;
+    // monotonic seconds and sleep, replaceable to run on a simulated clock
+    using NowFunc = std::function<double()>;
+    using SleepFunc = std::function<void(double seconds)>;
+
+    GameLoop(UpdateFunc update, RenderFunc render, GameLoopSettings const& settings = GameLoopSettings());
+
+    // run one frame: wait, fixed updates, render, cap
+    void tick();
+
+    void setWaitFunc(WaitFunc func) { wait = func; }
+    void setTimeSource(NowFunc nowFunc, SleepFunc sleepFunc);
+    void setMaxFps(double fps) { _settings.maxFps = fps; }
+
+    GameLoopSettings const& settings() const { return _settings; }
+    FrameTimeHistory const& history() const { return _history; }
+    uint64_t frameCount() const { return frames; }
+    uint64_t updateCount() const { return updates; }
+    // simulation time dropped because the frame took too long
+    double droppedTime() const { return dropped; }
+
+    // steady_clock based time source
+    static double clockNow();
+    // sleep most of the interval and spin the rest
+    void sleepUntil(double time) const;
+
+private:
+    UpdateFunc update;
+    RenderFunc render;
+    WaitFunc wait;
+    NowFunc now;
+    SleepFunc sleep;
+
+    GameLoopSettings _settings;
+    FrameTimeHistory _history;
+
+    double lastFrame = -1.0;
+    double accumulator = 0.0;
+    double dropped = 0.0;
+    uint64_t frames = 0;
+    uint64_t updates = 0;
+};
@@ -0,0 +1,234 @@
+#include "gpu_profiler.h"
+
+
+GpuProfiler::GpuProfiler(ID3D11Device* device, ID3D11DeviceContext* context,
+    ID3DUserDefinedAnnotation* annotation) :
+    context(context), annotation(annotation)
+{
+    D3D11_QUERY_DESC disjointDesc = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+    D3D11_QUERY_DESC timestampDesc = { D3D11_QUERY_TIMESTAMP, 0 };
+
+    // a missing query only disables the GPU lane of that frame
+    for (auto& frame : frames)
+    {
+        if (FAILED(device->CreateQuery(&disjointDesc, &frame.disjoint)))
+            frame.disjoint = nullptr;
+
+        frame.timestamps.resize(maxScopes * 2, nullptr);
+        for (auto& query : frame.timestamps)
+            if (FAILED(device->CreateQuery(&timestampDesc, &query)))
+                query = nullptr;
+        frame.scopes.reserve(maxScopes);
+    }
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    cleanup();
+}
+
+void GpuProfiler::beginFrame()
+{
+    auto& frame = frames[current];
+
+    // the ring wrapped before the GPU finished, drop that frame's timings
+    if (frame.pending && !collect(frame))
+        frame.pending = false;
+
+    frame.scopes.clear();
+    frame.profilerFrame = Profiler::get().frameIndex();
+    frame.cpuStart = Profiler::get().now();
+    frame.active = frame.disjoint != nullptr;
+    if (frame.active)
+        context->Begin(frame.disjoint);
+}
+
+void GpuProfiler::endFrame()
+{
+    auto& frame = frames[current];
+    if (frame.active)
+    {
+        context->End(frame.disjoint);
+        frame.pending = true;
+        frame.active = false;
+    }
+    current = (current + 1) % frameLatency;
+
+    // oldest first, stop at the first frame still in flight
+    for (UINT i = 0; i < frameLatency; i++)
+    {
+        auto& older = frames[(current + i) % frameLatency];
+        if (older.pending && !collect(older))
+            break;
+    }
+}
+
+bool GpuProfiler::collect(FrameQueries& frame)
+{
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+    if (context->GetData(frame.disjoint, &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+        return false;
+    frame.pending = false;
+
+    // the clock changed frequency during the frame, timings are meaningless
+    if (disjoint.Disjoint || disjoint.Frequency == 0)
+        return true;
+
+    std::vector<ProfileEvent> events;
+    events.reserve(frame.scopes.size());
+    UINT64 origin = 0;
+    for (size_t i = 0; i < frame.scopes.size(); i++)
+    {
+        UINT64 start = 0, end = 0;
+        if (!frame.timestamps[2 * i] || !frame.timestamps[2 * i + 1] ||
+            context->GetData(frame.timestamps[2 * i], &start, sizeof(start), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            context->GetData(frame.timestamps[2 * i + 1], &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+            continue;
+
+        if (events.empty())
+            origin = start;
+
+        // GPU ticks to nanoseconds, placed after the CPU start of the frame
+        auto toProfiler = [&](UINT64 ticks) {
+            auto delta = ticks > origin ? ticks - origin : 0;
+            return frame.cpuStart + static_cast<uint64_t>(delta * 1e9 / disjoint.Frequency);
+        };
+        events.push_back({ frame.scopes[i].name, toProfiler(start), toProfiler(end), frame.scopes[i].depth, 0 });
+    }
+
+    Profiler::get().addGpuEvents(frame.profilerFrame, events);
+    return true;
+}
+
+void GpuProfiler::begin(char const* name)
+{
+    Profiler::get().begin(name);
+
+    if (annotation)
+    {
+        wchar_t wideName[128];
+        size_t i = 0;
+        for (; name[i] && i + 1 < ARRAYSIZE(wideName); i++)
+            wideName[i] = static_cast<wchar_t>(name[i]);
+        wideName[i] = 0;
+        annotation->BeginEvent(wideName);
+    }
+
+    auto& frame = frames[current];
+    if (!frame.active || frame.scopes.size() >= maxScopes)
+    {
+        stack.push_back(~0u);
+        return;
+    }
+
+    auto index = static_cast<UINT>(frame.scopes.size());
+    frame.scopes.push_back({ name, static_cast<uint16_t>(stack.size()) });
+    if (frame.timestamps[2 * index])
+        context->End(frame.timestamps[2 * index]);
+    stack.push_back(index);
+}
+
+void GpuProfiler::end()
+{
+    if (!stack.empty())
+    {
+        auto index = stack.back();
+        stack.pop_back();
+
+        auto& frame = frames[current];
+        if (index != ~0u && frame.timestamps[2 * index + 1])
+            context->End(frame.timestamps[2 * index + 1]);
+    }
+
+    if (annotation)
+        annotation->EndEvent();
+
+    Profiler::get().end();
+}
+
+void GpuProfiler::cleanup()
+{
+    for (auto& frame : frames)
+    {
+        if (frame.disjoint) frame.disjoint->Release();
+        frame.disjoint = nullptr;
+        for (auto& query : frame.timestamps)
+        {
+            if (query) query->Release();
+            query = nullptr;
+        }
+        frame.pending = false;
+        frame.active = false;
+    }
+}
+
+GpuPipelineStats::GpuPipelineStats(ID3D11Device* device, ID3D11DeviceContext* context) :
+    context(context)
+{
+    D3D11_QUERY_DESC desc = { D3D11_QUERY_PIPELINE_STATISTICS, 0 };
+    for (auto& span : spans)
+        if (FAILED(device->CreateQuery(&desc, &span.query)))
+            span.query = nullptr;
+}
+
+GpuPipelineStats::~GpuPipelineStats()
+{
+    cleanup();
+}
+
+void GpuPipelineStats::begin(uint32_t tag)
+{
+    auto& span = spans[current];
+    // the ring wrapped before the GPU finished, that span is lost
+    span.pending = false;
+    span.tag = tag;
+    active = span.query != nullptr;
+    if (active)
+        context->Begin(span.query);
+}
+
+void GpuPipelineStats::end()
+{
+    if (active)
+    {
+        context->End(spans[current].query);
+        spans[current].pending = true;
+        active = false;
+    }
+    current = (current + 1) % frameLatency;
+
+    // oldest first, stop at the first span still in flight
+    for (UINT i = 0; i < frameLatency; i++)
+    {
+        auto& span = spans[(current + i) % frameLatency];
+        if (!span.pending)
+            continue;
+        D3D11_QUERY_DATA_PIPELINE_STATISTICS stats;
+        if (context->GetData(span.query, &stats, sizeof(stats), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+            break;
+        span.pending = false;
+        result = stats;
+        resultTag = span.tag;
+        hasResult = true;
+    }
+}
+
+bool GpuPipelineStats::latest(D3D11_QUERY_DATA_PIPELINE_STATISTICS& stats, uint32_t& tag) const
+{
+    if (!hasResult)
+        return false;
+    stats = result;
+    tag = resultTag;
+    return true;
+}
+
+void GpuPipelineStats::cleanup()
+{
+    for (auto& span : spans)
+    {
+        if (span.query) span.query->Release();
+        span.query = nullptr;
+        span.pending = false;
+    }
+    active = false;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <vector>
+#include <d3d11_1.h>
+
+#include "profiler.h"
+
+
+// GPU timestamps for profiler scopes. Every frame gets a disjoint query and a set
+// of timestamp pairs from a small ring, results are read back a few frames later
+// without stalling and attached to the matching Profiler frame.
+class GpuProfiler
+{
+public:
+    GpuProfiler(ID3D11Device* device, ID3D11DeviceContext* context,
+        ID3DUserDefinedAnnotation* annotation = nullptr);
+    ~GpuProfiler();
+
+    void beginFrame();
+    // close the frame and collect the finished ones
+    void endFrame();
+
+    // CPU scope, PIX event and GPU timestamps, name must outlive the profiler history
+    void begin(char const* name);
+    void end();
+
+    void cleanup();
+
+private:
+    GpuProfiler(GpuProfiler const&) = delete;
+    GpuProfiler& operator=(GpuProfiler const&) = delete;
+
+    static constexpr UINT frameLatency = 4;
+    static constexpr UINT maxScopes = 256;
+
+    struct Scope
+    {
+        char const* name;
+        uint16_t depth;
+    };
+
+    struct FrameQueries
+    {
+        ID3D11Query* disjoint = nullptr;
+        // start and end of every scope
+        std::vector<ID3D11Query*> timestamps;
+        std::vector<Scope> scopes;
+        uint64_t profilerFrame = 0;
+        uint64_t cpuStart = 0;
+        bool pending = false;
+        bool active = false;
+    };
+
+    // false while the queries are still in flight
+    bool collect(FrameQueries& frame);
+
+    ID3D11DeviceContext* context;
+    ID3DUserDefinedAnnotation* annotation;
+
+    FrameQueries frames[frameLatency];
+    UINT current = 0;
+    // scope indices, ~0u for scopes past maxScopes
+    std::vector<UINT> stack;
+};
+
+// Pipeline statistics (PS invocations and friends) of one span per frame, read
+// back from a ring of queries a few frames later without stalling
+class GpuPipelineStats
+{
+public:
+    GpuPipelineStats(ID3D11Device* device, ID3D11DeviceContext* context);
+    ~GpuPipelineStats();
+
+    // tag is returned with the results, e.g. the settings the span was drawn with
+    void begin(uint32_t tag = 0);
+    // close the span and collect the finished ones
+    void end();
+
+    // newest finished span, false until one arrived
+    bool latest(D3D11_QUERY_DATA_PIPELINE_STATISTICS& stats, uint32_t& tag) const;
+
+    void cleanup();
+
+private:
+    GpuPipelineStats(GpuPipelineStats const&) = delete;
+    GpuPipelineStats& operator=(GpuPipelineStats const&) = delete;
+
+    static constexpr UINT frameLatency = 4;
+
+    struct Span
+    {
+        ID3D11Query* query = nullptr;
+        uint32_t tag = 0;
+        bool pending = false;
+    };
+
+    ID3D11DeviceContext* context;
+    Span spans[frameLatency];
+    UINT current = 0;
+    bool active = false;
+
+    D3D11_QUERY_DATA_PIPELINE_STATISTICS result = {};
+    uint32_t resultTag = 0;
+    bool hasResult = false;
+};
+
+// CPU and GPU scope
+class GpuProfileScope
+{
+public:
+    GpuProfileScope(GpuProfiler* profiler, char const* name) : profiler(profiler)
+    {
+        if (profiler)
+            profiler->begin(name);
+        else
+            Profiler::get().begin(name);
+    }
+    ~GpuProfileScope()
+    {
+        if (profiler)
+            profiler->end();
+        else
+            Profiler::get().end();
+    }
+
+    GpuProfileScope(GpuProfileScope const&) = delete;
+    GpuProfileScope& operator=(GpuProfileScope const&) = delete;
+
+private:
+    GpuProfiler* profiler;
+};
+
+#define PROFILE_GPU_SCOPE(profiler, name) GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(profiler, name)
@@ -1,16 +1,22 @@
 #include <vector>
 #include <string>
 #include <d3d11_1.h>
+#include <dxgi1_3.h>
 #include <directxcolors.h>
+#include <directxcollision.h>
 #include <chrono>
 #include <cmath>
 #include <tuple>
 #include <algorithm>
+#include <atomic>
+#include <optional>
 #include "DDSTextureLoader.h"
 
 #include "imgui.h"
+#include "imgui_internal.h"
 #include "imgui_impl_win32.h"
 #include "imgui_impl_dx11.h"
+#include "imgui_font_cache.h"
 
 #include "graphics.h"
 #include "camera.h"
@@ -18,6 +24,15 @@
 #include "primitive.h"
 #include "spotlight.h"
 #include "const_buffer.h"
+#include "texture_manager.h"
+#include "render_target_pool.h"
+#include "frame_graph_backend.h"
+#include "game_loop.h"
+#include "gpu_profiler.h"
+#include "benchmark.h"
+#include "input_recording.h"
+#include "job_system.h"
+#include "frame_pipeline.h"
 
 #pragma comment(lib, "DirectXTK.lib")
 
@@ -25,7 +40,7 @@
 std::shared_ptr<Graphics> Graphics::inst(new Graphics);
 
 
-std::shared_ptr<Graphics> Graphics::init(HWND hWnd) {
+std::shared_ptr<Graphics> Graphics::init(HWND hWnd, bool waitableSwapChain) {
     // alias
     auto graphics = inst;
 
@@ -124,10 +139,33 @@ std::shared_ptr<Graphics> Graphics::init(HWND hWnd) {
         sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
         sd.BufferCount = 1;
 
-        hr = dxgiFactory2->CreateSwapChainForHwnd(graphics->device, hWnd, &sd, nullptr, nullptr, &graphics->swapChain1);
+        if (waitableSwapChain) {
+            // flip model buffers can't be sRGB, the RTV does the conversion
+            DXGI_SWAP_CHAIN_DESC1 flipDesc = sd;
+            flipDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+            flipDesc.BufferCount = 2;
+            flipDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+            flipDesc.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+
+            hr = dxgiFactory2->CreateSwapChainForHwnd(graphics->device, hWnd, &flipDesc, nullptr, nullptr, &graphics->swapChain1);
+            if (SUCCEEDED(hr))
+                graphics->swapChainFlags = flipDesc.Flags;
+        }
+
+        if (!graphics->swapChain1)
+            hr = dxgiFactory2->CreateSwapChainForHwnd(graphics->device, hWnd, &sd, nullptr, nullptr, &graphics->swapChain1);
         if (SUCCEEDED(hr))
             hr = graphics->swapChain1->QueryInterface( __uuidof(IDXGISwapChain), reinterpret_cast<void**>(&graphics->swapChain));
 
+        IDXGISwapChain2* swapChain2 = nullptr;
+        if (SUCCEEDED(hr) && graphics->swapChainFlags &&
+            SUCCEEDED(graphics->swapChain1->QueryInterface(__uuidof(IDXGISwapChain2), reinterpret_cast<void**>(&swapChain2)))) {
+            // one queued frame keeps input latency low
+            swapChain2->SetMaximumFrameLatency(1);
+            graphics->frameLatencyWaitable = swapChain2->GetFrameLatencyWaitableObject();
+            swapChain2->Release();
+        }
+
         dxgiFactory2->Release();
     }
     else {
@@ -157,10 +195,10 @@ std::shared_ptr<Graphics> Graphics::init(HWND hWnd) {
         return nullptr;
 
     graphics->initShaders();
-    
-    if (!graphics->createRenderTargetTexture(
-        width, height, inst->baseTextureRTV, inst->baseSRV, inst->samplerState, DXGI_FORMAT_R32G32B32A32_FLOAT, true))
-        return nullptr; 
+
+    graphics->renderTargets = std::make_unique<RenderTargetPool>();
+    if (!graphics->createSamplerState(graphics->samplerState))
+        return nullptr;
 
     // Create a render target view
     ID3D11Texture2D* pBackBuffer = nullptr;
@@ -168,16 +206,31 @@ std::shared_ptr<Graphics> Graphics::init(HWND hWnd) {
     if (FAILED(hr))
         return nullptr;
 
-    hr = graphics->device->CreateRenderTargetView(pBackBuffer, nullptr, &graphics->swapChainRTV);
+    D3D11_RENDER_TARGET_VIEW_DESC rtvd;
+    ZeroMemory(&rtvd, sizeof(rtvd));
+    rtvd.Format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+    rtvd.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
+
+    hr = graphics->device->CreateRenderTargetView(pBackBuffer, &rtvd, &graphics->swapChainRTV);
     pBackBuffer->Release();
     if (FAILED(hr))
         return nullptr;
 
-    if (!graphics->createDepthStencil(width, height))
+    if (!graphics->createDepthStencil(width, height) || !graphics->createDepthStates())
         return nullptr;
 
+    // the window thread is the first job thread
+    graphics->jobs = std::make_unique<JobSystem>();
+
     graphics->initGUI(hWnd);
 
+    graphics->gpuProfiler = std::make_unique<GpuProfiler>(
+        graphics->device, graphics->context, graphics->annotation);
+    graphics->sceneStatsQuery = std::make_unique<GpuPipelineStats>(graphics->device, graphics->context);
+
+    graphics->textureManager = std::make_unique<TextureManager>(
+        static_cast<uint64_t>(graphics->textureBudgetMB) << 20);
+
     if (!graphics->initGeometry())
         return nullptr;
 
@@ -186,13 +239,14 @@ std::shared_ptr<Graphics> Graphics::init(HWND hWnd) {
     graphics->width = width;
     graphics->height = height;
 
+    graphics->prevCameraPosition = graphics->camera.getPosition();
+
     return graphics;
 }
 
 bool Graphics::createDepthStencil(UINT width, UINT height)
 {
     ID3D11Texture2D* pDepthStencil = nullptr;
-    ID3D11DepthStencilState* dsState = nullptr;
 
     D3D11_TEXTURE2D_DESC descDepth;
 
@@ -214,6 +268,26 @@ bool Graphics::createDepthStencil(UINT width, UINT height)
     if (FAILED(hr))
         return false;
 
+    D3D11_DEPTH_STENCIL_VIEW_DESC descDSV;
+    ZeroMemory(&descDSV, sizeof(D3D11_DEPTH_STENCIL_VIEW_DESC));
+
+    descDSV.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    descDSV.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+    descDSV.Texture2D.MipSlice = 0;
+    descDepth.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+
+    // Create the depth stencil view
+    hr = inst->device->CreateDepthStencilView(pDepthStencil, // Depth stencil texture
+        &descDSV, // Depth stencil desc
+        &dsv);  // [out] Depth stencil view
+
+    pDepthStencil->Release();
+
+    return SUCCEEDED(hr);
+}
+
+bool Graphics::createDepthStates()
+{
     D3D11_DEPTH_STENCIL_DESC dsDesc;
 
     ZeroMemory(&dsDesc, sizeof(D3D11_DEPTH_STENCIL_DESC));
@@ -240,31 +314,42 @@ bool Graphics::createDepthStencil(UINT width, UINT height)
     dsDesc.BackFace.StencilFunc = D3D11_COMPARISON_ALWAYS;
 
     // Create depth stencil state
-    hr = inst->device->CreateDepthStencilState(&dsDesc, &dsState);
-
+    auto hr = inst->device->CreateDepthStencilState(&dsDesc, &depthLessState);
     if (FAILED(hr))
         return false;
 
-    // Bind depth stencil state
-    inst->context->OMSetDepthStencilState(dsState, 1);
-
-    D3D11_DEPTH_STENCIL_VIEW_DESC descDSV;
-    ZeroMemory(&descDSV, sizeof(D3D11_DEPTH_STENCIL_VIEW_DESC));
-
-    descDSV.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-    descDSV.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
-    descDSV.Texture2D.MipSlice = 0;
-    descDepth.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    // the pre-pass already wrote the depth the shaded pixels have to match
+    dsDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+    dsDesc.DepthFunc = D3D11_COMPARISON_EQUAL;
+    dsDesc.StencilEnable = false;
+    hr = inst->device->CreateDepthStencilState(&dsDesc, &depthEqualState);
+    if (FAILED(hr))
+        return false;
 
-    // Create the depth stencil view
-    hr = inst->device->CreateDepthStencilView(pDepthStencil, // Depth stencil texture
-        &descDSV, // Depth stencil desc
-        &dsv);  // [out] Depth stencil view
+    // the skybox is projected to z = w, it passes only where the cleared depth is left
+    dsDesc.DepthFunc = D3D11_COMPARISON_LESS_EQUAL;
+    hr = inst->device->CreateDepthStencilState(&dsDesc, &depthSkyState);
+    if (FAILED(hr))
+        return false;
 
-    dsState->Release();
-    pDepthStencil->Release();
+    // Bind depth stencil state
+    inst->context->OMSetDepthStencilState(depthLessState, 1);
+    return true;
+}
 
-    return SUCCEEDED(hr);
+void Graphics::setDepthState(RenderPass pass)
+{
+    switch (pass) {
+    case RenderPass::Opaque:
+        context->OMSetDepthStencilState(depthPrepass ? depthEqualState : depthLessState, 1);
+        break;
+    case RenderPass::Sky:
+        context->OMSetDepthStencilState(depthSkyState, 1);
+        break;
+    default:
+        context->OMSetDepthStencilState(depthLessState, 1);
+        break;
+    }
 }
 
 void Graphics::initShaders()
@@ -274,7 +359,6 @@ void Graphics::initShaders()
     // Create constant buffers
     graphics->simpleCbuf = std::make_unique<ConstBuffer<SimpleConstantBuffer>>();
     graphics->pbrCbuf = std::make_unique<ConstBuffer<PBRConstantBuffer>>();
-    graphics->materialCbuf = std::make_unique<ConstBuffer<MaterialConstantBuffer>>();
     graphics->brightnessCbuf = std::make_unique<ConstBuffer<BrightnessConstantBuffer>>();
     graphics->tonemapCbuf = std::make_unique<ConstBuffer<TonemapConstantBuffer>>();
 
@@ -292,8 +376,7 @@ void Graphics::initShaders()
     graphics->pbrShader = ShaderFactory::makeShaders(L"pbr.fx", simpleLayout, 3);
     graphics->pbrShader->addConstBuffers(
         { 
-            { graphics->pbrCbuf->appliedConstBuffer(), true, true },
-            { graphics->materialCbuf->appliedConstBuffer(), false, true }
+            { graphics->pbrCbuf->appliedConstBuffer(), true, true }
         });
 
 
@@ -323,6 +406,7 @@ void Graphics::initLights()
     spotLights[0] = SpotLight(XMFLOAT3(-2, 0, 0), XMFLOAT3(0, 0, 1), XMFLOAT3(1, 0, 0), 15.0f, 1.0f);
     spotLights[1] = SpotLight(XMFLOAT3(2, 0, 0), XMFLOAT3(0, 0, 1), XMFLOAT3(1, 0, 0), 15.0f, 1.0f);
     spotLights[2] = SpotLight(XMFLOAT3(0, 3, 0), XMFLOAT3(0, 0, 1), XMFLOAT3(1, 0, 0), 15.0f, 1.0f);
+    spotLights[3] = SpotLight(XMFLOAT3(0, -3, 0), XMFLOAT3(0, 0, 1), XMFLOAT3(1, 0, 0), 15.0f, 1.0f);
 }
 
 std::shared_ptr<Graphics> Graphics::get()
@@ -344,98 +428,20 @@ void Graphics::setViewport(UINT width, UINT height)
     inst->context->RSSetViewports(1, &vp);
 }
 
-bool Graphics::createRenderTargetTexture(
-    UINT width, UINT height, ID3D11RenderTargetView*& rtv,
-    ID3D11ShaderResourceView*& srv, 
-    ID3D11SamplerState*& samplerState, 
-    DXGI_FORMAT format, bool createSamplerState,
-    ID3D11Texture2D** tex)
+bool Graphics::createSamplerState(ID3D11SamplerState*& samplerState)
 {
-    // Setup render target texture
-    D3D11_TEXTURE2D_DESC td;
-    ZeroMemory(&td, sizeof(td));
-    td.Width = width;
-    td.Height = height;
-    td.MipLevels = 1;
-    td.ArraySize = 1;
-    td.Format = format;
-    td.SampleDesc.Count = 1;
-    td.SampleDesc.Quality = 0;
-    td.Usage = D3D11_USAGE_DEFAULT;
-    td.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
-    td.CPUAccessFlags = 0;
-
-    ID3D11Texture2D* rndTargetTexWH = nullptr;
-    auto hr = inst->device->CreateTexture2D(&td, NULL, &rndTargetTexWH);
-    if (FAILED(hr))
-        return false;
-
-    if (tex)
-        *tex = rndTargetTexWH;
-
-    // Setup the description of the render target view.
-    D3D11_RENDER_TARGET_VIEW_DESC rtvd;
-
-    rtvd.Format = td.Format;
-    rtvd.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
-    rtvd.Texture2D.MipSlice = 0;
-
-    hr = inst->device->CreateRenderTargetView(rndTargetTexWH, &rtvd, &rtv);
-    if (FAILED(hr))
-        return false;
-
-    if (createSamplerState)
-    {
-        // Create the sample state
-        D3D11_SAMPLER_DESC sampDesc;
-        ZeroMemory(&sampDesc, sizeof(sampDesc));
-        sampDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-        sampDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
-        sampDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
-        sampDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
-        sampDesc.ComparisonFunc = D3D11_COMPARISON_NEVER;
-        sampDesc.MinLOD = 0;
-        sampDesc.MaxLOD = D3D11_FLOAT32_MAX;
-        hr = inst->device->CreateSamplerState(&sampDesc, &samplerState);
-        if (FAILED(hr))
-            return false;
-    }
-
-    // Setup the description of the shader resource view.
-    D3D11_SHADER_RESOURCE_VIEW_DESC srvd;
-    srvd.Format = td.Format;
-    srvd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-    srvd.Texture2D.MostDetailedMip = 0;
-    srvd.Texture2D.MipLevels = 1;
-
-    // Create the shader resource view.
-    hr = inst->device->CreateShaderResourceView(rndTargetTexWH, &srvd, &srv);
-
-    if (!tex)
-        rndTargetTexWH->Release();
-
-    if (FAILED(hr))
-        return false;
-
-    return true;
-}
-
-bool Graphics::createCPUAccessedTexture(ID3D11Texture2D*& dst, ID3D11Texture2D* src) {
-    // Setup render target texture
-    D3D11_TEXTURE2D_DESC td;
-
-    src->GetDesc(&td);
-    td.Usage = D3D11_USAGE_STAGING;
-    td.BindFlags = 0;
-    //td.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
-    td.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
-
-    auto hr = inst->device->CreateTexture2D(&td, NULL, &dst);
-    if (FAILED(hr))
-        return false;
-
-    context->CopyResource(dst, src);
-    return true;
+    // Create the sample state
+    D3D11_SAMPLER_DESC sampDesc;
+    ZeroMemory(&sampDesc, sizeof(sampDesc));
+    sampDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+    sampDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
+    sampDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
+    sampDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
+    sampDesc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+    sampDesc.MinLOD = 0;
+    sampDesc.MaxLOD = D3D11_FLOAT32_MAX;
+    auto hr = inst->device->CreateSamplerState(&sampDesc, &samplerState);
+    return SUCCEEDED(hr);
 }
 
 
@@ -445,18 +451,25 @@ bool Graphics::createSkybox()
     if (!success)
         return false;
 
-    ID3D11Texture2D* skyboxTex = nullptr;
+    HRESULT hr = S_OK;
 
-    auto hr = CreateDDSTextureFromFileEx(inst->device, L"skymap.dds",
-        0, D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0,
-        D3D11_RESOURCE_MISC_TEXTURECUBE, false, 
-        (ID3D11Resource **)&skyboxTex, &skyboxSRV);
+    // stream mips in the background, fall back to the blocking loader for unsupported files
+    skyboxTextureId = textureManager->load(L"skymap.dds");
+    if (skyboxTextureId == InvalidTextureId)
+    {
+        ID3D11Texture2D* skyboxTex = nullptr;
 
-    if (FAILED(hr))
-        return false;
+        hr = CreateDDSTextureFromFileEx(inst->device, L"skymap.dds",
+            0, D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0,
+            D3D11_RESOURCE_MISC_TEXTURECUBE, false,
+            (ID3D11Resource **)&skyboxTex, &skyboxSRV);
 
-    if (skyboxTex)
-        skyboxTex->Release();
+        if (FAILED(hr))
+            return false;
+
+        if (skyboxTex)
+            skyboxTex->Release();
+    }
 
     D3D11_SAMPLER_DESC sampDesc;
     ZeroMemory(&sampDesc, sizeof(sampDesc));
@@ -585,16 +598,39 @@ bool Graphics::initGeometry() {
 }
 
 
+// ImFontAtlas::BuildParallelFor on the job system, one glyph job per range
+static void guiParallelFor(int count, void (*job)(int index, void* jobData), void* jobData, void* userData) {
+    static_cast<JobSystem*>(userData)->parallelFor(static_cast<uint32_t>(count), 1,
+        [job, jobData](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++)
+                job(static_cast<int>(i), jobData);
+        });
+}
+
 void Graphics::initGUI(HWND hWnd) {
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO();
     ImGui::StyleColorsDark();
     ImGui_ImplWin32_Init(hWnd);
     ImGui_ImplDX11_Init(inst->device, inst->context);
+    ImGui_ImplDX11_SetUploadMode(guiRingUpload, guiSkipUnchanged);
+
+    // the atlas of the last launch when the fonts didn't change, otherwise rasterize
+    // the glyphs on the job threads now, not on whichever thread starts the first GUI frame
+    io.Fonts->BuildParallelFor = guiParallelFor;
+    io.Fonts->BuildParallelForUserData = jobs.get();
+    if (ImFontAtlasCache_Load(io.Fonts, guiFontCacheFile) != ImFontAtlasCacheResult_Loaded) {
+        io.Fonts->Build();
+        ImFontAtlasCache_Save(io.Fonts, guiFontCacheFile);
+    }
 }
 
 
-void Graphics::moveCamera() {
+void Graphics::update(float step) {
+    PROFILE_SCOPE("Update");
+
+    prevCameraPosition = camera.getPosition();
+
     // Camera movement
     XMVECTOR moveDirection = { 0.0f, 0.0f, 0.0f, 0.0f };
     if (moveRight) moveDirection += camera.getRight();
@@ -604,93 +640,256 @@ void Graphics::moveCamera() {
     if (moveUp) moveDirection += { 0.0f, 1.0f, 0.0f, 0.0f };
     if (moveDown) moveDirection += { 0.0f, -1.0f, 0.0f, 0.0f };
 
-    deltaTime = (timeGetTime() - lastFrame) / 1000.0f;
-    moveDirection *= moveSpeed * deltaTime;
+    moveDirection *= moveSpeed * step;
 
     if (XMVectorGetX(XMVector3Length(moveDirection)) > 1e-4) {
         camera.move(moveDirection);
     }
+}
+
 
-    lastFrame = timeGetTime();
+void Graphics::waitForFrame() {
+    if (frameLatencyWaitable)
+        WaitForSingleObjectEx(frameLatencyWaitable, 1000, TRUE);
 }
 
 
-void Graphics::startEvent(LPCWSTR eventName)
-{
-#ifdef _DEBUG
-    annotation->BeginEvent(eventName);
-#endif
+void Graphics::buildSnapshot(float interpolation, float frameTime, FrameSnapshot& snapshot) {
+    PROFILE_SCOPE("BuildSnapshot");
+    snapshot.frameTime = frameTime;
+    snapshot.eye = XMVectorLerp(prevCameraPosition, camera.getPosition(), interpolation);
+    snapshot.view = camera.viewFrom(snapshot.eye);
+    snapshot.projection = camera.projection();
+
+    snapshot.lightCount = lightCount;
+    for (int idx = 0; idx < lightCount; idx++) {
+        snapshot.lightPos[idx] = spotLights[idx].getPosition();
+        snapshot.lightColor[idx] = spotLights[idx].getColor();
+        snapshot.lightIntensity[idx] = spotLights[idx].getIntensity();
+    }
+
+    prepareScene(snapshot);
+}
+
+void Graphics::buildSceneGraph() {
+    scene.clear();
+    sphereNodes.clear();
+    sphereMaterials.clear();
+
+    // the grid hangs 30 units in front of the origin, spheres are offset from its center
+    auto root = scene.create();
+    scene.setPosition(root, 0.0f, 0.0f, 30.0f);
+    const float step = (1 - 0.01f) / max(gridSize - 1, 1);
+    for (int i = 0; i < gridSize * gridSize; i++) {
+        int row = i / gridSize;
+        int column = i % gridSize;
+        auto node = scene.create(root);
+        scene.setPosition(node, 3 * (column - gridSize / 2) * radius, 3 * (row - gridSize / 2) * radius, 0.0f);
+        sphereNodes.push_back(node);
+
+        // roughness grows along a row, metalness along a column
+        GpuMaterial material;
+        material.F0[0] = 0.95f;
+        material.F0[1] = 0.64f;
+        material.F0[2] = 0.54f;
+        material.roughness = 0.01f + column * step;
+        material.metalness = 0.01f + row * step;
+        sphereMaterials.push_back(materials.create(
+            "sphere " + std::to_string(gridSize) + " " + std::to_string(row) + " " + std::to_string(column), material));
+    }
 }
 
+void Graphics::prepareScene(FrameSnapshot& snapshot) {
+    PROFILE_SCOPE("PrepareScene");
 
-void Graphics::endEvent()
-{
-#ifdef _DEBUG
-    annotation->EndEvent();
-#endif
+    auto count = static_cast<uint32_t>(gridSize * gridSize);
+    if (sphereNodes.size() != count)
+        buildSceneGraph();
+    {
+        PROFILE_SCOPE("UpdateTransforms");
+        snapshot.sceneStats = scene.updateTransforms();
+    }
+    snapshot.instances.resize(count);
+
+    // view space frustum moved into world space
+    BoundingFrustum frustum;
+    BoundingFrustum::CreateFromMatrix(frustum, snapshot.projection);
+    frustum.Transform(frustum, XMMatrixInverse(nullptr, snapshot.view));
+
+    std::atomic<uint32_t> visible = 0;
+    jobs->parallelFor(count, 256, [this, &frustum, &snapshot, &visible](uint32_t begin, uint32_t end) {
+        PROFILE_SCOPE("PackSpheres");
+        uint32_t visibleInRange = 0;
+        for (auto i = begin; i < end; i++)
+        {
+            auto node = sphereNodes[i];
+            XMFLOAT3 center;
+            scene.worldPosition(node, center.x, center.y, center.z);
+
+            auto& instance = snapshot.instances[i];
+            instance.visible = frustum.Contains(BoundingSphere(center, radius)) != DISJOINT;
+            // already transposed for the constant buffer
+            instance.world = XMLoadFloat4x4A(reinterpret_cast<XMFLOAT4X4A const*>(&scene.gpuWorld(node)));
+            instance.material = sphereMaterials[i];
+            instance.viewDepth = XMVectorGetZ(XMVector3Transform(XMLoadFloat3(&center), snapshot.view));
+            visibleInRange += instance.visible;
+        }
+        visible += visibleInRange;
+    });
+    snapshot.visibleInstances = visible;
 }
 
-void Graphics::renderScene() {
+// shader field of the render queue keys
+static const uint32_t PBRShaderKey = 0;
+static const uint32_t SkyboxShaderKey = 1;
+// draw index of the skybox, the others index the snapshot's instances
+static const uint32_t SkyboxDraw = ~0u;
+
+void Graphics::renderScene(FrameSnapshot const& snapshot) {
     // Render sphere grid
     PBRConstantBuffer pbrCB;
     ZeroMemory(&pbrCB, sizeof(PBRConstantBuffer));
     pbrCB.DrawMask = DrawMask;
-    pbrCB.View = XMMatrixTranspose(camera.view());
-    pbrCB.Projection = XMMatrixTranspose(camera.projection());
+    pbrCB.LightCount = snapshot.lightCount;
+    pbrCB.View = XMMatrixTranspose(snapshot.view);
+    pbrCB.Projection = XMMatrixTranspose(snapshot.projection);
     pbrCB.World = XMMatrixIdentity();
 
     // Setup lights
-    for (size_t idx = 0; idx < spotLights.size(); idx++) {
-        pbrCB.LightPos[idx] = spotLights[idx].getPosition();
-        pbrCB.LightColor[idx] = spotLights[idx].getColor();
-        pbrCB.LightIntensity[idx] = spotLights[idx].getIntensity();
+    for (int idx = 0; idx < snapshot.lightCount; idx++) {
+        pbrCB.LightPos[idx] = snapshot.lightPos[idx];
+        pbrCB.LightColor[idx] = snapshot.lightColor[idx];
+        pbrCB.LightIntensity[idx] = snapshot.lightIntensity[idx];
     }
-    auto pos = camera.getPosition().m128_f32;
+    auto pos = snapshot.eye.m128_f32;
     pbrCB.CameraPos = XMFLOAT3(pos[0], pos[1], pos[2]);
 
-    // TODO update material in loop
-    MaterialConstantBuffer mtlCB;
-    ZeroMemory(&mtlCB, sizeof(MaterialConstantBuffer));
-    mtlCB.roughness = 0.5f;
-    mtlCB.metalness = 0.1f;
-    mtlCB.F0 = XMFLOAT3(0.95f, 0.64f, 0.54f);
-
-    startEvent(L"DrawSphereGrid");
-    //quadPrim->render(simpleShader);
+    {
+        PROFILE_SCOPE("SortDraws");
+        renderQueue.clear();
+        // a material is only an index into the table, switching it costs nothing,
+        // so it's left out of the key and the spheres go front to back
+        for (uint32_t i = 0; i < snapshot.instances.size(); i++) {
+            auto const& instance = snapshot.instances[i];
+            if (!instance.visible)
+                continue;
+            if (depthPrepass)
+                renderQueue.push(RenderKey::make(RenderPass::DepthPrepass, PBRShaderKey, 0, instance.viewDepth), i);
+            renderQueue.push(RenderKey::make(RenderPass::Opaque, PBRShaderKey, 0, instance.viewDepth), i);
+        }
+        renderQueue.push(RenderKey::make(RenderPass::Sky, SkyboxShaderKey, 0, 0.0f), SkyboxDraw);
+        renderQueue.sort();
+        renderQueueStats = renderQueue.measure();
+    }
 
-    const int GridSize = 8;
+    PROFILE_GPU_SCOPE(gpuProfiler.get(), "DrawScene");
+    sceneStatsQuery->begin(depthPrepass ? 1 : 0);
+    std::optional<GpuProfileScope> passScope;
+    auto boundPass = static_cast<RenderPass>(0xff);
+    uint32_t boundShader = ~0u;
+    for (auto const& item : renderQueue.items()) {
+        auto pass = RenderKey::pass(item.key);
+        if (pass != boundPass) {
+            static char const* const passNames[] = { "DepthPrepass", "DrawOpaque", "DrawSkybox", "DrawTransparent" };
+            passScope.reset();
+            passScope.emplace(gpuProfiler.get(), passNames[static_cast<int>(pass)]);
+            setDepthState(pass);
+            boundPass = pass;
+            boundShader = ~0u;
+        }
 
-    for (int y = -GridSize / 2; y < GridSize / 2; y++)
-    {
-        mtlCB.metalness = 0.01f + (y + GridSize / 2) * (1 - 0.01f) / (GridSize - 1);
-        for (int x = -GridSize / 2; x < GridSize / 2; x++)
-        {
-            mtlCB.roughness = 0.01f + (x + GridSize / 2) * (1 - 0.01f) / (GridSize - 1);
-            pbrCB.World = XMMatrixTranspose(XMMatrixTranslation(3 * x * radius, 3 * y * radius, 30.0f));
-            
-            pbrCbuf->update(pbrCB);
-            materialCbuf->update(mtlCB);
+        if (item.index == SkyboxDraw) {
+            SimpleConstantBuffer simpleCB;
+            simpleCB.mWorld = XMMatrixTranspose(XMMatrixTranslation(pos[0], pos[1], pos[2]));
+            simpleCB.mView = XMMatrixTranspose(snapshot.view);
+            simpleCB.mProjection = XMMatrixTranspose(snapshot.projection);
+            simpleCbuf->update(simpleCB);
+            auto skySRV = skyboxTextureId != InvalidTextureId ? textureManager->srv(skyboxTextureId) : skyboxSRV;
+            skyboxPrim->render(skyboxShader, skyboxSamplerState, skySRV);
+            boundShader = SkyboxShaderKey;
+            continue;
+        }
 
-            spherePrim->render(pbrShader);
+        // shader and sphere stay bound across a run of draws
+        if (boundShader != PBRShaderKey) {
+            pbrShader->apply();
+            if (pass == RenderPass::DepthPrepass)
+                context->PSSetShader(nullptr, nullptr, 0);
+            else
+                // materials come from the table, the draw only carries its index
+                context->PSSetShaderResources(0, 1, &materialSRV);
+            spherePrim->bind();
+            boundShader = PBRShaderKey;
         }
+
+        auto const& instance = snapshot.instances[item.index];
+        pbrCB.World = instance.world;
+        pbrCB.MaterialIndex = instance.material;
+        pbrCbuf->update(pbrCB);
+        spherePrim->draw();
     }
-    endEvent();
+    passScope.reset();
+    sceneStatsQuery->end();
+    // the later passes expect the default state
+    context->OMSetDepthStencilState(depthLessState, 1);
+
+    D3D11_QUERY_DATA_PIPELINE_STATISTICS stats;
+    uint32_t withPrepass;
+    if (sceneStatsQuery->latest(stats, withPrepass))
+        psInvocations[withPrepass] = stats.PSInvocations;
+}
+
+void Graphics::uploadMaterials() {
+    PROFILE_SCOPE("UploadMaterials");
+    // returning 0 leaves the range dirty, so a failed grow is retried next frame
+    materials.flush([this](GpuMaterial const* data, uint32_t count, uint32_t first, uint32_t end) -> uint32_t {
+        if (count > materialCapacity) {
+            // grow geometrically, the new buffer gets every material
+            auto capacity = max(count, max(materialCapacity * 2, 64u));
+            if (materialSRV) materialSRV->Release();
+            if (materialBuffer) materialBuffer->Release();
+            materialSRV = nullptr;
+            materialBuffer = nullptr;
+            materialCapacity = 0;
+
+            D3D11_BUFFER_DESC bd;
+            ZeroMemory(&bd, sizeof(bd));
+            bd.Usage = D3D11_USAGE_DEFAULT;
+            bd.ByteWidth = capacity * sizeof(GpuMaterial);
+            bd.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+            bd.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+            bd.StructureByteStride = sizeof(GpuMaterial);
+            if (FAILED(device->CreateBuffer(&bd, nullptr, &materialBuffer))) {
+                printf("Failed to create the material buffer :(");
+                return 0;
+            }
+
+            D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+            ZeroMemory(&srvDesc, sizeof(srvDesc));
+            srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+            srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+            srvDesc.Buffer.FirstElement = 0;
+            srvDesc.Buffer.NumElements = capacity;
+            if (FAILED(device->CreateShaderResourceView(materialBuffer, &srvDesc, &materialSRV))) {
+                printf("Failed to create the material buffer view :(");
+                materialBuffer->Release();
+                materialBuffer = nullptr;
+                return 0;
+            }
 
-    // render skybox
-    startEvent(L"DrawSkybox");
-    SimpleConstantBuffer simpleCB;
-    simpleCB.mWorld = XMMatrixTranspose(XMMatrixTranslation(pos[0], pos[1], pos[2]));
-    simpleCB.mView = XMMatrixTranspose(camera.view());
-    simpleCB.mProjection = XMMatrixTranspose(camera.projection());
-    simpleCbuf->update(simpleCB);
-    skyboxPrim->render(skyboxShader, skyboxSamplerState, skyboxSRV);
-    endEvent();
+            materialCapacity = capacity;
+            first = 0;
+            end = count;
+        }
+
+        D3D11_BOX box = { first * static_cast<UINT>(sizeof(GpuMaterial)), 0, 0, end * static_cast<UINT>(sizeof(GpuMaterial)), 1, 1 };
+        context->UpdateSubresource(materialBuffer, 0, &box, data + first, 0, 0);
+        return end - first;
+    });
 }
 
 void Graphics::renderGUI() {
-    // Start the Dear ImGui frame
-    ImGui_ImplDX11_NewFrame();
-    ImGui_ImplWin32_NewFrame();
+    // the backends' NewFrame already ran on the window thread
     ImGui::NewFrame();
 
     ImGui::Begin("PBR Setting");
@@ -706,90 +905,348 @@ void Graphics::renderGUI() {
     if (ImGui::RadioButton("Geometry Function", DrawMask == 3))
         DrawMask = 3;
 
+    ImGui::Checkbox("Profiler", &showProfiler);
+
+    if (gameLoop && ImGui::CollapsingHeader("Frame pacing"))
+    {
+        auto times = gameLoop->history().percentiles();
+        ImGui::Text("Frame time: p50 %.2f ms, p95 %.2f ms, p99 %.2f ms",
+            times.p50 * 1000.0, times.p95 * 1000.0, times.p99 * 1000.0);
+        ImGui::Text("Mean %.2f ms (%.0f FPS), max %.2f ms",
+            times.mean * 1000.0, times.mean > 0.0 ? 1.0 / times.mean : 0.0, times.max * 1000.0);
+        ImGui::Text("Simulation: %.0f Hz, %.2f s dropped", 1.0 / gameLoop->settings().fixedStep, gameLoop->droppedTime());
+        ImGui::Text("Waitable swapchain: %s", frameLatencyWaitable ? "yes" : "no");
+
+        int maxFps = static_cast<int>(gameLoop->settings().maxFps);
+        if (ImGui::SliderInt("FPS cap (0 = off)", &maxFps, 0, 240))
+            gameLoop->setMaxFps(maxFps);
+    }
+
+    if (framePipeline && ImGui::CollapsingHeader("Pipeline"))
+    {
+        auto stats = framePipeline->stats();
+        ImGui::Text("Frames: %llu published, %llu rendered, %llu dropped", stats.published, stats.consumed, stats.dropped);
+        ImGui::Text("Input latency: p50 %.2f ms, p95 %.2f ms, p99 %.2f ms",
+            stats.latency.p50 * 1000.0, stats.latency.p95 * 1000.0, stats.latency.p99 * 1000.0);
+        ImGui::Text("Waited: simulation %.2f s, render %.2f s", stats.producerWait, stats.consumerWait);
+
+        int queued = static_cast<int>(framePipeline->maxQueuedFrames());
+        if (ImGui::SliderInt("Queued frames (0 = newest only)", &queued, 0, 2))
+            framePipeline->setMaxQueuedFrames(static_cast<uint32_t>(queued));
+    }
+
+    if (ImGui::CollapsingHeader("Frame graph"))
+    {
+        ImGui::Text("Passes: %u (%u culled)", frameGraphStats.passCount, frameGraphStats.culledCount);
+        ImGui::Text("Transient: %u textures in %u slots", frameGraphStats.transientCount, frameGraphStats.physicalCount);
+        ImGui::Text("Memory: %.2f MB allocated, %.2f MB peak, %.2f MB unaliased",
+            frameGraphStats.allocatedBytes / 1048576.0, frameGraphStats.peakBytes / 1048576.0,
+            frameGraphStats.unaliasedBytes / 1048576.0);
+    }
+
+    if (ImGui::CollapsingHeader("Jobs"))
+    {
+        auto stats = jobs->stats();
+        ImGui::Text("Threads: %u", jobs->threadCount());
+        ImGui::Text("Jobs: %llu, stolen %llu, inlined %llu", stats.executed, stats.stolen, stats.inlined);
+        ImGui::Text("Spheres: %u of %u visible", visibleObjects, sceneObjectCount);
+    }
+
+    if (ImGui::CollapsingHeader("Materials"))
+    {
+        ImGui::Text("Materials: %u", materialStats.materialCount);
+        ImGui::Text("Last frame: %u uploaded, %llu bytes", materialStats.frameUploads, materialStats.frameBytes);
+        ImGui::Text("Total: %llu uploaded in %llu flushes, %.2f KB",
+            materialStats.uploads, materialStats.flushes, materialStats.uploadedBytes / 1024.0);
+    }
+
+    if (ImGui::CollapsingHeader("Depth"))
+    {
+        ImGui::Checkbox("Depth pre-pass", &depthPrepass);
+        // last measured frame of each mode
+        auto pixels = static_cast<double>(width) * height;
+        ImGui::Text("PS invocations without pre-pass: %llu (%.2f per pixel)", psInvocations[0], psInvocations[0] / pixels);
+        ImGui::Text("PS invocations with pre-pass: %llu (%.2f per pixel)", psInvocations[1], psInvocations[1] / pixels);
+        if (psInvocations[0] && psInvocations[1])
+            ImGui::Text("Saved: %lld (%.1f%%)", static_cast<long long>(psInvocations[0] - psInvocations[1]),
+                100.0 * (1.0 - static_cast<double>(psInvocations[1]) / psInvocations[0]));
+    }
+
+    if (ImGui::CollapsingHeader("GUI"))
+    {
+        ImGui::Checkbox("Reuse idle frames", &retainGUI);
+        ImGui::Text("Frames: %llu built, %llu reused", guiBuiltFrames, guiReusedFrames);
+        bool ring = ImGui::Checkbox("Ring buffer upload", &guiRingUpload);
+        bool skip = ImGui::Checkbox("Skip unchanged draw lists", &guiSkipUnchanged);
+        if (ring || skip)
+            ImGui_ImplDX11_SetUploadMode(guiRingUpload, guiSkipUnchanged);
+        ImGui_ImplDX11_UploadStats upload;
+        ImGui_ImplDX11_GetUploadStats(&upload);
+        ImGui::Text("Last upload: %.1f KB, %d lists, %d skipped", upload.FrameUploadedBytes / 1024.0,
+            upload.FrameUploadedLists, upload.FrameSkippedLists);
+        ImGui::Text("Total: %.1f MB, %d reallocations, %d wraps", upload.TotalUploadedBytes / (1024.0 * 1024.0),
+            upload.Reallocations, upload.Discards);
+    }
+
+    if (ImGui::CollapsingHeader("Render queue"))
+    {
+        ImGui::Text("Draws: %u", renderQueueStats.draws);
+        ImGui::Text("Shader changes: %u", renderQueueStats.shaderChanges);
+    }
+
+    if (ImGui::CollapsingHeader("Scene"))
+    {
+        ImGui::Text("Nodes: %u", sceneStats.nodeCount);
+        ImGui::Text("Last update: %u local, %u world matrices", sceneStats.localUpdates, sceneStats.worldUpdates);
+    }
+
+    if (ImGui::CollapsingHeader("Render targets"))
+    {
+        auto const& stats = renderTargets->stats();
+        ImGui::Text("Pooled: %u (%u in use), %.2f MB", stats.entryCount, stats.inUseCount,
+            renderTargets->pooledBytes() / 1048576.0);
+        ImGui::Text("Last frame: %u hits, %u misses", stats.frameHits, stats.frameMisses);
+        ImGui::Text("Total: %llu hits, %llu misses, %llu evictions", stats.hits, stats.misses, stats.evictions);
+    }
+
+    if (ImGui::CollapsingHeader("Textures"))
+    {
+        auto const& stats = textureManager->stats();
+        if (ImGui::SliderInt("Budget (MB)", &textureBudgetMB, 1, 2048))
+            textureManager->setBudget(static_cast<uint64_t>(textureBudgetMB) << 20);
+        ImGui::Text("Resident: %.2f MB of %.2f MB requested",
+            stats.residentBytes / 1048576.0, stats.requestedBytes / 1048576.0);
+        ImGui::Text("Textures: %u (%u trimmed)", stats.textureCount, stats.trimmedCount);
+        ImGui::Text("Loads: %llu, deduplicated: %llu", stats.loads, stats.dedupedLoads);
+        ImGui::Text("Evicted mips: %llu, textures: %llu, restored mips: %llu",
+            stats.mipEvictions, stats.textureEvictions, stats.mipRestores);
+    }
+
     ImGui::End();
 
+    if (showProfiler)
+        renderProfiler();
+
     ImGui::Render();
 }
 
-void Graphics::setRenderTarget(ID3D11RenderTargetView* rtv, bool useDSV)
+// one flame row per depth, events of other threads get their own rows below
+static void drawFlameGraph(char const* id, std::vector<ProfileEvent> const& events, uint64_t start, uint64_t end)
 {
-    float clearColor[] = { 0.3f, 0.5f, 0.7f, 1.0f };
-    context->ClearRenderTargetView(rtv, clearColor);
-    context->ClearDepthStencilView(dsv, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+    if (events.empty() || end <= start)
+        return;
+
+    // first row of every thread
+    uint32_t rows = 0;
+    std::vector<uint32_t> threadRow;
+    for (auto const& e : events)
+    {
+        if (e.thread >= threadRow.size())
+            threadRow.resize(e.thread + 1, 0);
+        threadRow[e.thread] = std::max<uint32_t>(threadRow[e.thread], e.depth + 1);
+    }
+    for (auto& row : threadRow)
+    {
+        auto count = row;
+        row = rows;
+        rows += count;
+    }
+
+    auto rowHeight = ImGui::GetTextLineHeightWithSpacing();
+    auto origin = ImGui::GetCursorScreenPos();
+    auto width = ImGui::GetContentRegionAvail().x;
+    ImGui::InvisibleButton(id, ImVec2(width, rowHeight * rows));
+    bool hovered = ImGui::IsItemHovered();
+    auto mouse = ImGui::GetIO().MousePos;
+
+    auto drawList = ImGui::GetWindowDrawList();
+    auto scale = width / static_cast<double>(end - start);
+    for (auto const& e : events)
+    {
+        auto x0 = origin.x + static_cast<float>((std::max<uint64_t>(e.start, start) - start) * scale);
+        auto x1 = origin.x + static_cast<float>((std::min<uint64_t>(e.end, end) - start) * scale);
+        auto y0 = origin.y + (threadRow[e.thread] + e.depth) * rowHeight;
+        auto y1 = y0 + rowHeight - 1.0f;
+        if (x1 - x0 < 1.0f)
+            x1 = x0 + 1.0f;
+
+        // stable color per name
+        uint32_t hash = 2166136261u;
+        for (auto c = e.name; *c; c++)
+            hash = (hash ^ static_cast<unsigned char>(*c)) * 16777619u;
+        auto color = ImColor::HSV((hash % 360) / 360.0f, 0.5f, 0.7f);
+        drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), color);
+        if (x1 - x0 > 20.0f)
+        {
+            drawList->PushClipRect(ImVec2(x0, y0), ImVec2(x1, y1), true);
+            drawList->AddText(ImVec2(x0 + 2.0f, y0), IM_COL32_WHITE, e.name);
+            drawList->PopClipRect();
+        }
+
+        if (hovered && mouse.x >= x0 && mouse.x < x1 && mouse.y >= y0 && mouse.y < y1)
+            ImGui::SetTooltip("%s: %.3f ms", e.name, (e.end - e.start) / 1e6);
+    }
+}
+
+void Graphics::renderProfiler() {
+    auto& profiler = Profiler::get();
+
+    ImGui::Begin("Profiler", &showProfiler);
+
+    bool paused = profiler.isPaused();
+    if (ImGui::Checkbox("Pause", &paused))
+        profiler.setPaused(paused);
+    ImGui::SameLine();
+    if (ImGui::Button("Export trace"))
+        profilerExported = profiler.exportChromeTrace("profile.json") ? 1 : -1;
+    if (profilerExported != 0)
+    {
+        ImGui::SameLine();
+        ImGui::Text(profilerExported > 0 ? "Saved profile.json" : "Failed to save profile.json");
+    }
+
+    // newest frame whose GPU timings arrived
+    auto const& history = profiler.history();
+    ProfilerFrame const* frame = nullptr;
+    for (auto it = history.rbegin(); it != history.rend() && !frame; ++it)
+        if (it->gpuReady)
+            frame = &*it;
+    if (!frame && !history.empty())
+        frame = &history.back();
+
+    if (frame)
+    {
+        ImGui::Text("Frame %llu, CPU %.3f ms", static_cast<unsigned long long>(frame->index),
+            (frame->end - frame->start) / 1e6);
+        drawFlameGraph("##cpu", frame->cpu, frame->start, frame->end);
+
+        if (!frame->gpu.empty())
+        {
+            uint64_t gpuStart = frame->gpu.front().start, gpuEnd = 0;
+            for (auto const& e : frame->gpu)
+            {
+                gpuStart = std::min<uint64_t>(gpuStart, e.start);
+                gpuEnd = std::max<uint64_t>(gpuEnd, e.end);
+            }
+            ImGui::Text("GPU %.3f ms", (gpuEnd - gpuStart) / 1e6);
+            drawFlameGraph("##gpu", frame->gpu, gpuStart, gpuEnd);
+        }
+        else
+            ImGui::Text("GPU timings pending");
+    }
+
+    if (profiler.droppedEvents())
+        ImGui::Text("%llu events dropped", static_cast<unsigned long long>(profiler.droppedEvents()));
+
+    ImGui::End();
+}
+
+void Graphics::setRenderTarget(ID3D11RenderTargetView* rtv, bool useDSV, bool clear)
+{
+    if (clear)
+    {
+        float clearColor[] = { 0.3f, 0.5f, 0.7f, 1.0f };
+        context->ClearRenderTargetView(rtv, clearColor);
+        context->ClearDepthStencilView(dsv, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+    }
     context->OMSetRenderTargets(1, &rtv, useDSV ? inst->dsv : nullptr);
 }
 
-bool Graphics::evalMeanBrightnessTex(ID3D11ShaderResourceView*&srv, ID3D11Texture2D*& tex)
+FrameGraphHandle Graphics::addHDRPasses(FrameGraph& graph, FrameGraphHandle backBuffer, FrameSnapshot const& snapshot)
 {
-    setViewport(width, height);
-    setRenderTarget(baseTextureRTV);
-    renderScene();
+    auto scene = graph.addPass("Scene");
+    auto hdr = scene.write(scene.create("HDR", { width, height, DXGI_FORMAT_R32G32B32A32_FLOAT }));
+    scene.execute([this, hdr, &snapshot](FrameGraphResources const& res) {
+        setViewport(width, height);
+        setRenderTarget(res.get<RenderTarget const>(hdr)->rtv);
+        renderScene(snapshot);
+    });
 
     // eval brightness
-    ID3D11RenderTargetView* rtv_bright = nullptr;
-    ID3D11ShaderResourceView* srv_bright = nullptr;
-    ID3D11Texture2D* tex_bright = nullptr;
-
-    startEvent(L"DrawScreenQuadEvalBrightness");
-    if (!createRenderTargetTexture(
-        width, height, rtv_bright, srv_bright, 
-        samplerState, DXGI_FORMAT_R32_FLOAT, false))
-        return false;
+    auto brightness = graph.addPass("EvalBrightness");
+    brightness.read(hdr);
+    auto level = brightness.write(brightness.create("Brightness", { width, height, DXGI_FORMAT_R32_FLOAT }));
+    brightness.execute([this, hdr, level](FrameGraphResources const& res) {
+        BrightnessConstantBuffer cb;
+        ZeroMemory(&cb, sizeof(BrightnessConstantBuffer));
+        cb.isBrightnessCalc = 1;
+        brightnessCbuf->update(cb);
 
-    BrightnessConstantBuffer cb;
-    ZeroMemory(&cb, sizeof(BrightnessConstantBuffer));
-
-    setViewport(width, height);
-    setRenderTarget(rtv_bright);
-    cb.isBrightnessCalc = 1;
-    brightnessCbuf->update(cb);
-    screenQuadPrim->render(brightShader, samplerState, baseSRV);
-    endEvent();
-    rtv_bright->Release();
+        setViewport(width, height);
+        setRenderTarget(res.get<RenderTarget const>(level)->rtv);
+        screenQuadPrim->render(brightShader, samplerState, res.get<RenderTarget const>(hdr)->srv);
+    });
 
     // 2 ^ n
     auto n = static_cast<int>(std::max<double>(std::ceil(std::log2(width)), std::ceil(std::log(height))));
-    auto two_pow_n = 1 << n;
-    ID3D11ShaderResourceView* curSRV = srv_bright, *prevSRV = baseSRV;
-    ID3D11Texture2D* resTex2D = nullptr;
-
-    cb.isBrightnessCalc = 0;
-    brightnessCbuf->update(cb);
-    for (; n >= 0; n--, two_pow_n >>= 1)
-    {
-        ID3D11RenderTargetView* rtv_2n = nullptr;
-        ID3D11ShaderResourceView* srv_2n = nullptr;
-        bool cpuAccessFlag = n == 0;
-        ID3D11Texture2D* tex_2n = nullptr;
-
-        startEvent((std::wstring(L"DrawScreenQuad2^") + std::to_wstring(n)).c_str());
-        if (!createRenderTargetTexture(
-            two_pow_n, two_pow_n, rtv_2n, srv_2n, samplerState, 
-            DXGI_FORMAT_R32_FLOAT, false, cpuAccessFlag ? &tex_2n : nullptr))
-            return false;
-
-        setViewport(two_pow_n, two_pow_n);
-        setRenderTarget(rtv_2n, false);
-        screenQuadPrim->render(brightShader, samplerState, curSRV);
-        endEvent();
+    for (UINT two_pow_n = 1 << n; n >= 0; n--, two_pow_n >>= 1)
+    {
+        auto reduce = graph.addPass("Reduce 2^" + std::to_string(n));
+        auto src = reduce.read(level);
+        level = reduce.write(reduce.create("Brightness 2^" + std::to_string(n),
+            { two_pow_n, two_pow_n, DXGI_FORMAT_R32_FLOAT }));
+        reduce.execute([this, src, dst = level, two_pow_n](FrameGraphResources const& res) {
+            BrightnessConstantBuffer cb;
+            ZeroMemory(&cb, sizeof(BrightnessConstantBuffer));
+            brightnessCbuf->update(cb);
+
+            setViewport(two_pow_n, two_pow_n);
+            setRenderTarget(res.get<RenderTarget const>(dst)->rtv, false);
+            screenQuadPrim->render(brightShader, samplerState, res.get<RenderTarget const>(src)->srv);
+        });
+    }
 
-        if (cpuAccessFlag)
+    auto tonemap = graph.addPass("Tonemap");
+    tonemap.read(hdr);
+    tonemap.read(level);
+    auto tonemapped = tonemap.write(backBuffer);
+    tonemap.execute([this, hdr, level, tonemapped](FrameGraphResources const& res) {
+        auto meanBrightness = 0.0f;
+        auto staging = renderTargets->acquireStaging(1, 1, DXGI_FORMAT_R32_FLOAT);
+        if (staging)
         {
-            if (!createCPUAccessedTexture(resTex2D, tex_2n))
-                return false;
-            tex_2n->Release();
+            context->CopyResource(staging->texture, res.get<RenderTarget const>(level)->texture);
+            meanBrightness = calcMeanBrightness(staging->texture);
+            renderTargets->release(staging);
         }
+        else
+            printf("Failed eval mean brightness :(");
 
-        prevSRV = curSRV;
-        curSRV = srv_2n;
+        const float adaptationTime = 1.5f;
+        float curMeanBrightness;
+        if (std::fabs(prevMeanBrightness + 1) > 1e-6)
+            curMeanBrightness = prevMeanBrightness + (meanBrightness - prevMeanBrightness) * (1 - exp(-deltaTime / adaptationTime));
+        else
+            curMeanBrightness = meanBrightness;
+        prevMeanBrightness = curMeanBrightness;
 
-        rtv_2n->Release();
-        if (prevSRV != baseSRV)
-            prevSRV->Release();
-    }
-    srv = curSRV;
-    tex = resTex2D;
-    return true;
+        TonemapConstantBuffer cb;
+        ZeroMemory(&cb, sizeof(TonemapConstantBuffer));
+        cb.meanBrightness = curMeanBrightness;
+        cb.isBrightnessWindow = 0;
+        tonemapCbuf->update(cb);
+
+        setViewport(width, height);
+        setRenderTarget(res.get<RenderTarget const>(tonemapped)->rtv);
+        screenQuadPrim->render(tonemapShader, samplerState, res.get<RenderTarget const>(hdr)->srv);
+    });
+
+    auto brightWindow = graph.addPass("BrightWindow");
+    brightWindow.read(level);
+    auto output = brightWindow.write(tonemapped);
+    brightWindow.execute([this, level, output](FrameGraphResources const& res) {
+        TonemapConstantBuffer cb;
+        ZeroMemory(&cb, sizeof(TonemapConstantBuffer));
+        cb.meanBrightness = prevMeanBrightness;
+        cb.isBrightnessWindow = 1;
+        tonemapCbuf->update(cb);
+
+        // drawn over the tonemapped image
+        setRenderTarget(res.get<RenderTarget const>(output)->rtv, true, false);
+        brightQuadPrim->render(tonemapShader, samplerState, res.get<RenderTarget const>(level)->srv);
+    });
+
+    return output;
 }
 
 float Graphics::calcMeanBrightness(ID3D11Texture2D* brightnessPixelTex2D) {
@@ -812,66 +1269,119 @@ float Graphics::calcMeanBrightness(ID3D11Texture2D* brightnessPixelTex2D) {
 }
 
 
-void Graphics::render() {
-    moveCamera();
-    renderGUI();
+void Graphics::render(float interpolation, float frameTime) {
+    // Win32 and D3D parts of the GUI frame stay on this thread, the widgets are
+    // built on a job while the scene is packed
+    ImGui_ImplDX11_NewFrame();
+    ImGui_ImplWin32_NewFrame();
+    JobCounter guiBuilt;
+    if (guiNeedsBuild()) {
+        jobs->run([this]() {
+            PROFILE_SCOPE("RenderGUI");
+            renderGUI();
+        }, guiBuilt);
+    }
 
-    if (DrawMask == 0)
-    {
-        ID3D11ShaderResourceView* brightnessPixelSRV = nullptr;
-        ID3D11Texture2D* brightnessPixelTex2D = nullptr;
+    buildSnapshot(interpolation, frameTime, serialSnapshot);
+    jobs->wait(guiBuilt);
+    submit(serialSnapshot);
+}
 
-        bool brightness_ok = evalMeanBrightnessTex(brightnessPixelSRV, brightnessPixelTex2D);
-        if (!brightness_ok)
-            printf("Failed eval mean brightness :(");
-        auto meanBrightness = calcMeanBrightness(brightnessPixelTex2D);
+void Graphics::render(FrameSnapshot const& snapshot) {
+    // the scene was packed on the simulation thread, which is building the next one by now
+    ImGui_ImplDX11_NewFrame();
+    ImGui_ImplWin32_NewFrame();
+    if (guiNeedsBuild()) {
+        PROFILE_SCOPE("RenderGUI");
+        renderGUI();
+    }
+    submit(snapshot);
+}
 
-        const float adaptationTime = 1.5f;
-        float curMeanBrightness;
-        if (std::fabs(prevMeanBrightness + 1) > 1e-6)
-            curMeanBrightness = prevMeanBrightness + (meanBrightness - prevMeanBrightness) * (1 - exp(-deltaTime / adaptationTime));
-        else
-            curMeanBrightness = meanBrightness;
-        prevMeanBrightness = curMeanBrightness;
+bool Graphics::guiNeedsBuild() {
+    // the stats the widgets show aren't tracked, building now and then refreshes them
+    auto now = std::chrono::steady_clock::now();
+    guiReused = retainGUI && std::chrono::duration<double>(now - lastGUIBuild).count() < guiRefreshInterval &&
+        ImGui::ReuseLastFrame();
+    if (guiReused) {
+        guiReusedFrames++;
+        return false;
+    }
+    lastGUIBuild = now;
+    guiBuiltFrames++;
+    return true;
+}
 
-        setViewport(width, height);
-        setRenderTarget(swapChainRTV);
+void Graphics::submit(FrameSnapshot const& snapshot) {
+    deltaTime = snapshot.frameTime;
+    // shown by the next frame's GUI
+    sceneObjectCount = static_cast<uint32_t>(snapshot.instances.size());
+    visibleObjects = snapshot.visibleInstances;
+    sceneStats = snapshot.sceneStats;
 
-        TonemapConstantBuffer cb;
-        ZeroMemory(&cb, sizeof(TonemapConstantBuffer));
-        cb.meanBrightness = curMeanBrightness;
+    uploadMaterials();
+    materialStats = materials.stats();
 
-        startEvent(L"DrawScreenQuad");
-        cb.isBrightnessWindow = 0;
-        tonemapCbuf->update(cb);
-        screenQuadPrim->render(tonemapShader, samplerState, baseSRV);
-        endEvent();
+    gpuProfiler->beginFrame();
 
-        startEvent(L"DrawBrightQuad");
-        cb.isBrightnessWindow = 1;
-        tonemapCbuf->update(cb);
-        brightQuadPrim->render(tonemapShader, samplerState, brightnessPixelSRV);
-        endEvent();
+    // the swapchain is the only texture that outlives the frame
+    RenderTarget backBufferTarget;
+    backBufferTarget.rtv = swapChainRTV;
+    backBufferTarget.width = width;
+    backBufferTarget.height = height;
+
+    FrameGraph graph;
+    auto backBuffer = graph.import("Backbuffer", { width, height, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB }, &backBufferTarget);
+
+    // both paths are declared, the one not reaching the output is culled
+    auto tonemapped = addHDRPasses(graph, backBuffer, snapshot);
 
-        if (brightnessPixelSRV)
-            brightnessPixelSRV->Release();
-        if (brightnessPixelTex2D)
-            brightnessPixelTex2D->Release();
+    auto debugScene = graph.addPass("DebugScene");
+    auto debugOutput = debugScene.write(backBuffer);
+    debugScene.execute([this, debugOutput, &snapshot](FrameGraphResources const& res) {
+        setViewport(width, height);
+        setRenderTarget(res.get<RenderTarget const>(debugOutput)->rtv);
+        renderScene(snapshot);
+    });
+
+    auto gui = graph.addPass("GUI");
+    auto output = gui.write(DrawMask == 0 ? tonemapped : debugOutput);
+    gui.execute([this, output](FrameGraphResources const& res) {
+        setRenderTarget(res.get<RenderTarget const>(output)->rtv, true, false);
+        ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+    });
+    graph.setOutput(output);
+
+    bool compiled;
+    {
+        PROFILE_SCOPE("CompileFrameGraph");
+        compiled = graph.compile();
     }
-    else
+
+    if (compiled)
     {
-        setViewport(width, height);
-        setRenderTarget(swapChainRTV);
-        renderScene();
+        RenderTargetBackend backend(*renderTargets, context, gpuProfiler.get());
+        if (!graph.execute(backend))
+            printf("Failed to acquire frame graph targets :(");
+        frameGraphStats = graph.stats();
     }
+    else
+        printf("Invalid frame graph :(");
 
-    ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+    {
+        PROFILE_SCOPE("Present");
+        swapChain->Present(0, 0);
+    }
 
-    swapChain->Present(0, 0);
+    // stream pending mips and apply the texture budget for the next frame
+    {
+        PROFILE_GPU_SCOPE(gpuProfiler.get(), "TextureStreaming");
+        textureManager->update(context);
+    }
+    renderTargets->endFrame();
 
-    // Unbind shader resource
-    ID3D11ShaderResourceView* views[1] = { nullptr };
-    context->PSSetShaderResources(0, 1, views);
+    gpuProfiler->endFrame();
+    Profiler::get().endFrame();
 }
 
 void Graphics::cleanup() {
@@ -880,9 +1390,15 @@ void Graphics::cleanup() {
     ImGui::DestroyContext();
 
     if (swapChainRTV) swapChainRTV->Release();
-    if (baseTextureRTV) baseTextureRTV->Release();
     if (skyboxSRV) skyboxSRV->Release();
-    if (baseSRV) baseSRV->Release();
+    if (materialSRV) materialSRV->Release();
+    if (materialBuffer) materialBuffer->Release();
+    // no jobs may run while the device objects go away
+    jobs.reset();
+    textureManager->cleanup();
+    renderTargets->cleanup();
+    gpuProfiler->cleanup();
+    sceneStatsQuery->cleanup();
 
     //simpleShader->cleanup();
     skyboxShader->cleanup();
@@ -892,7 +1408,6 @@ void Graphics::cleanup() {
 
     simpleCbuf->cleanup();
     pbrCbuf->cleanup();
-    materialCbuf->cleanup();
     brightnessCbuf->cleanup();
     tonemapCbuf->cleanup();
 
@@ -903,7 +1418,11 @@ void Graphics::cleanup() {
     brightQuadPrim->cleanup();
 
     if (dsv) dsv->Release();
+    if (depthLessState) depthLessState->Release();
+    if (depthEqualState) depthEqualState->Release();
+    if (depthSkyState) depthSkyState->Release();
 
+    if (frameLatencyWaitable) CloseHandle(frameLatencyWaitable);
     if (swapChain1) swapChain1->Release();
     if (swapChain) swapChain->Release();
     if (annotation) annotation->Release();
@@ -939,12 +1458,11 @@ HRESULT Graphics::resizeBackbuffer(UINT width, UINT height) {
     context->OMSetRenderTargets(ARRAYSIZE(nullViews), nullViews, nullptr);
 
     if (swapChainRTV) swapChainRTV->Release();
-    if (baseTextureRTV) baseTextureRTV->Release();
-    if (baseSRV) baseSRV->Release();
     if (dsv) dsv->Release();
     context->Flush();
 
-    hr = swapChain->ResizeBuffers(1, width, height, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, 0);
+    // keep buffer count and format, flags must match the ones the swapchain was created with
+    hr = swapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, swapChainFlags);
     if (FAILED(hr))
         return hr;
 
@@ -953,16 +1471,17 @@ HRESULT Graphics::resizeBackbuffer(UINT width, UINT height) {
     if (FAILED(hr))
         return hr;
 
-    hr = device->CreateRenderTargetView(backBuffer, nullptr, &swapChainRTV);
+    D3D11_RENDER_TARGET_VIEW_DESC rtvd;
+    ZeroMemory(&rtvd, sizeof(rtvd));
+    rtvd.Format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+    rtvd.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
+
+    hr = device->CreateRenderTargetView(backBuffer, &rtvd, &swapChainRTV);
     if (FAILED(hr))
         return hr;
  
     backBuffer->Release();
 
-    if (!inst->createRenderTargetTexture(
-        width, height, baseTextureRTV, baseSRV, samplerState, DXGI_FORMAT_R32G32B32A32_FLOAT, false))
-        return S_FALSE;
-
     if (!inst->createDepthStencil(width, height))
         return S_FALSE;;
 
@@ -985,6 +1504,16 @@ void Graphics::rotate(int mouseDeltaX, int mouseDeltaY) {
     camera.rotate(mouseDeltaX * sensitivity, mouseDeltaY * sensitivity);
 }
 
+void Graphics::setCameraPose(CameraPose const& pose) {
+    camera.setPose(XMVectorSet(pose.position[0], pose.position[1], pose.position[2], 0.0f), pose.yaw, pose.pitch);
+    prevCameraPosition = camera.getPosition();
+}
+
+void Graphics::setSceneParams(int gridSize, int lightCount) {
+    this->gridSize = max(gridSize, 1);
+    this->lightCount = min(max(lightCount, 0), MaxLights);
+}
+
 void Graphics::resetLightIntensity(int lightIndex) {
     spotLights[lightIndex].setIntensity(1.0f);
 }
@@ -996,3 +1525,30 @@ void Graphics::increaseLightIntensity(int lightIndex) {
 void Graphics::decreaseLightIntensity(int lightIndex) {
     spotLights[lightIndex].setIntensity(max(spotLights[lightIndex].getIntensity() - 10.0f, 0.0f));
 }
+
+void Graphics::applyInput(InputEvent const& event) {
+    bool pressed = event.value != 0;
+    switch (event.type) {
+    case InputEventType::MoveLeft: setMoveLeft(pressed); break;
+    case InputEventType::MoveRight: setMoveRight(pressed); break;
+    case InputEventType::MoveForward: setMoveForward(pressed); break;
+    case InputEventType::MoveBackward: setMoveBackward(pressed); break;
+    case InputEventType::MoveUp: setMoveUp(pressed); break;
+    case InputEventType::MoveDown: setMoveDown(pressed); break;
+    case InputEventType::Rotate: rotate(event.value, event.value2); break;
+    case InputEventType::ResetLightIntensity:
+    case InputEventType::IncreaseLightIntensity:
+    case InputEventType::DecreaseLightIntensity:
+        if (event.value < 0 || event.value >= MaxLights)
+            break;
+        if (event.type == InputEventType::ResetLightIntensity)
+            resetLightIntensity(event.value);
+        else if (event.type == InputEventType::IncreaseLightIntensity)
+            increaseLightIntensity(event.value);
+        else
+            decreaseLightIntensity(event.value);
+        break;
+    default:
+        break;
+    }
+}
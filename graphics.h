@@ -10,19 +10,66 @@
 #include "camera.h"
 #include "shader.h"
 #include "spotlight.h"
+#include "texture_residency.h"
+#include "frame_graph.h"
+#include "scene.h"
+#include "material_registry.h"
+#include "render_queue.h"
 
 
 using namespace DirectX;
 
 class Primitive;
+class GameLoop;
+class GpuProfiler;
+class GpuPipelineStats;
+class TextureManager;
+class RenderTargetPool;
+class JobSystem;
+struct RenderTarget;
+struct CameraPose;
+struct InputEvent;
 
 template<typename T>
 class ConstBuffer;
+template<typename T>
+class FramePipeline;
+
+struct SceneInstance
+{
+    XMMATRIX world;
+    MaterialId material;
+    // view space z of the center, for sorting
+    float viewDepth;
+    bool visible;
+};
+
+// everything the render side needs from the simulation for one frame, read only
+// once built so it can be handed to another thread
+struct FrameSnapshot
+{
+    XMMATRIX view;
+    XMMATRIX projection;
+    XMVECTOR eye;
+    float frameTime;
+
+    static const int MaxLights = 4;
+    int lightCount;
+    XMFLOAT4 lightPos[MaxLights];
+    XMFLOAT4 lightColor[MaxLights];
+    float lightIntensity[MaxLights];
+
+    // sphere grid, culled against the view frustum
+    std::vector<SceneInstance> instances;
+    uint32_t visibleInstances;
+    SceneUpdateStats sceneStats;
+};
 
 class Graphics {
 public:
     // factory method
-    static std::shared_ptr<Graphics> init(HWND hWnd);
+    // waitableSwapChain: flip model swapchain with a frame latency waitable object
+    static std::shared_ptr<Graphics> init(HWND hWnd, bool waitableSwapChain = false);
     static std::shared_ptr<Graphics> get();
 
     void initShaders();
@@ -33,8 +80,23 @@ public:
     ID3D11Device* getDevice() const { return device; }
     ID3D11DeviceContext* getContext() const { return context; }
 
-    // render the frame
-    void render();
+    // advance the simulation by a fixed step
+    void update(float step);
+
+    // render the frame, interpolation in [0, 1) between the last two simulation steps
+    void render(float interpolation, float frameTime);
+
+    // pipelined frames: the simulation thread builds snapshots, the window thread renders them
+    void buildSnapshot(float interpolation, float frameTime, FrameSnapshot& snapshot);
+    void render(FrameSnapshot const& snapshot);
+    // pipeline feeding render(snapshot), for the GUI
+    void setFramePipeline(FramePipeline<FrameSnapshot>* pipeline) { framePipeline = pipeline; }
+
+    // block until the swapchain can take a new frame, no-op without a waitable swapchain
+    void waitForFrame();
+
+    // loop driving the frames, for the pacing GUI
+    void setGameLoop(GameLoop* loop) { gameLoop = loop; }
 
     // cleanup all d3d objects
     void cleanup();
@@ -51,33 +113,46 @@ public:
 
     void rotate(int mouseDeltaX, int mouseDeltaY);
 
+    // place the camera directly, without interpolating from the previous position
+    void setCameraPose(CameraPose const& pose);
+    // sphere grid side and number of lit spot lights (up to MaxLights)
+    void setSceneParams(int gridSize, int lightCount);
+    // depth-only pass over opaque geometry before it's shaded with an EQUAL test
+    void setDepthPrepass(bool enabled) { depthPrepass = enabled; }
+
     void resetLightIntensity(int lightIndex);
     void increaseLightIntensity(int lightIndex);
     void decreaseLightIntensity(int lightIndex);
 
-private:
-    void startEvent(LPCWSTR eventName);
-    void endEvent();
+    // dispatch a recorded or live input event to the calls above
+    void applyInput(InputEvent const& event);
 
-    void moveCamera();
-    void renderScene();
+private:
+    // pack per-sphere constants and cull the grid against the view frustum on the job system
+    void prepareScene(FrameSnapshot& snapshot);
+    // sphere grid nodes under one root, rebuilt when the grid size changes
+    void buildSceneGraph();
+    void submit(FrameSnapshot const& snapshot);
+    void renderScene(FrameSnapshot const& snapshot);
+    // upload changed materials, growing the buffer when needed
+    void uploadMaterials();
+    // false when nothing in the GUI changed and the last frame's draw data is drawn again
+    bool guiNeedsBuild();
     void renderGUI();
+    void renderProfiler();
 
-    bool evalMeanBrightnessTex(ID3D11ShaderResourceView*& srv, ID3D11Texture2D*& tex);
+    // scene, brightness reduction and tonemapping, returns the tonemapped backbuffer
+    FrameGraphHandle addHDRPasses(FrameGraph& graph, FrameGraphHandle backBuffer, FrameSnapshot const& snapshot);
     float calcMeanBrightness(ID3D11Texture2D* brightnessPixelTex2D);
 
     bool createDepthStencil(UINT width, UINT height);
-
-    bool createRenderTargetTexture(UINT width, UINT height, 
-        ID3D11RenderTargetView*& rtv, ID3D11ShaderResourceView*& srv,
-        ID3D11SamplerState*& samplerState, 
-        DXGI_FORMAT format, bool createSamplerState = false,
-        ID3D11Texture2D **tex = nullptr);
-
-    bool createCPUAccessedTexture(ID3D11Texture2D*& dst, ID3D11Texture2D* src);
+    bool createDepthStates();
+    // depth state of a render queue pass
+    void setDepthState(RenderPass pass);
+    bool createSamplerState(ID3D11SamplerState*& samplerState);
 
     void setViewport(UINT width, UINT height);
-    void setRenderTarget(ID3D11RenderTargetView* rtv, bool useDSV = true);
+    void setRenderTarget(ID3D11RenderTargetView* rtv, bool useDSV = true, bool clear = true);
 
     bool createQuad(std::shared_ptr<Primitive>& prim);
     bool createScreenQuad(std::shared_ptr<Primitive> &prim, bool full, float val = 0.0f);
@@ -98,17 +173,56 @@ private:
     IDXGISwapChain* swapChain = nullptr;
     IDXGISwapChain1* swapChain1 = nullptr;
     ID3D11DepthStencilView* dsv = nullptr;
+    // LESS with writes, the default; EQUAL without writes for shading after the pre-pass;
+    // LESS_EQUAL without writes for the skybox at the far plane
+    ID3D11DepthStencilState* depthLessState = nullptr;
+    ID3D11DepthStencilState* depthEqualState = nullptr;
+    ID3D11DepthStencilState* depthSkyState = nullptr;
 
     ID3D11RenderTargetView* swapChainRTV = nullptr;
-    ID3D11RenderTargetView* baseTextureRTV = nullptr;
-    ID3D11ShaderResourceView* baseSRV = nullptr;
+    UINT swapChainFlags = 0;
+    HANDLE frameLatencyWaitable = nullptr;
+    // transient targets of the frame graph
+    std::unique_ptr<RenderTargetPool> renderTargets;
+    // last compiled frame graph, shown in the GUI
+    FrameGraphStats frameGraphStats;
     ID3D11SamplerState* samplerState = nullptr;
 
     ID3D11SamplerState* skyboxSamplerState = nullptr;
+    // only used when skymap.dds can't be handled by the texture manager
     ID3D11ShaderResourceView* skyboxSRV = nullptr;
+    // StructuredBuffer of every material, indexed by MaterialIndex in pbr.fx
+    ID3D11Buffer* materialBuffer = nullptr;
+    ID3D11ShaderResourceView* materialSRV = nullptr;
+    uint32_t materialCapacity = 0;
+
+    std::unique_ptr<TextureManager> textureManager;
+    TextureId skyboxTextureId = InvalidTextureId;
+    // MB, edited from the GUI
+    int textureBudgetMB = 256;
 
     //------------//
     ID3DUserDefinedAnnotation* annotation = nullptr;
+    std::unique_ptr<GpuProfiler> gpuProfiler;
+    // PS invocations of the scene, tagged with whether the pre-pass ran
+    std::unique_ptr<GpuPipelineStats> sceneStatsQuery;
+    uint64_t psInvocations[2] = {};
+    bool depthPrepass = true;
+    bool showProfiler = false;
+    // skip building idle GUI frames, the stats they show are refreshed at guiRefreshInterval
+    bool retainGUI = true;
+    static constexpr double guiRefreshInterval = 0.25;
+    std::chrono::steady_clock::time_point lastGUIBuild;
+    bool guiReused = false;
+    uint64_t guiBuiltFrames = 0;
+    uint64_t guiReusedFrames = 0;
+    // how the DX11 GUI backend uploads vertices and indices, see imgui_impl_dx11_upload.h
+    bool guiRingUpload = true;
+    bool guiSkipUnchanged = false;
+    // built font atlas of the last launch, see imgui_font_cache.h
+    static constexpr char const* guiFontCacheFile = "imgui_fonts.cache";
+    // 1 after a successful trace export, -1 after a failed one
+    int profilerExported = 0;
 
     struct SimpleVertex
     {
@@ -147,14 +261,10 @@ private:
         // camera
         XMFLOAT3 CameraPos;
         int DrawMask;
-    };
-
-    struct MaterialConstantBuffer
-    {
-        XMFLOAT3 F0;
-        float roughness;
-        float metalness;
-        float _dummy[3];
+        int LightCount;
+        // into the material table
+        uint32_t MaterialIndex;
+        float _dummy[2];
     };
 
     struct TonemapConstantBuffer
@@ -170,7 +280,30 @@ private:
         float _dummy[3];
     };
 
+    std::unique_ptr<JobSystem> jobs;
+    // owned by the thread building snapshots
+    Scene scene;
+    std::vector<SceneNode> sphereNodes;
+    std::vector<MaterialId> sphereMaterials;
+    MaterialRegistry materials;
+    // snapshot of the serial render path
+    FrameSnapshot serialSnapshot;
+    FramePipeline<FrameSnapshot>* framePipeline = nullptr;
+    // of the last submitted snapshot, shown in the GUI
+    uint32_t sceneObjectCount = 0;
+    uint32_t visibleObjects = 0;
+    SceneUpdateStats sceneStats;
+    MaterialStats materialStats;
+
+    // draws of renderScene, sorted by state and depth
+    RenderQueue renderQueue;
+    RenderQueueStats renderQueueStats;
+
     Camera camera;
+    // camera position before the last simulation step
+    XMVECTOR prevCameraPosition;
+
+    GameLoop* gameLoop = nullptr;
 
     std::unique_ptr<Shader>
         /*simpleShader, */ pbrShader, brightShader, tonemapShader, skyboxShader;
@@ -181,11 +314,13 @@ private:
 
     std::unique_ptr<ConstBuffer<SimpleConstantBuffer>> simpleCbuf;
     std::unique_ptr<ConstBuffer<PBRConstantBuffer>> pbrCbuf;
-    std::unique_ptr<ConstBuffer<MaterialConstantBuffer>> materialCbuf;
     std::unique_ptr<ConstBuffer<BrightnessConstantBuffer>> brightnessCbuf;
     std::unique_ptr<ConstBuffer<TonemapConstantBuffer>> tonemapCbuf;
 
-    std::array<SpotLight, 3> spotLights;
+    static const int MaxLights = FrameSnapshot::MaxLights;
+    std::array<SpotLight, MaxLights> spotLights;
+    int lightCount = 3;
+    int gridSize = 8;
 
     std::chrono::system_clock::time_point start;
 
@@ -210,8 +345,5 @@ private:
 
     const float radius = 2.0f;
 
-    // last frame timestamp
-    DWORD lastFrame = timeGetTime();
-
     UINT width, height;
 };
@@ -49,6 +49,15 @@
 //#define IMGUI_DISABLE_DEFAULT_ALLOCATORS                  // Don't implement default allocators calling malloc()/free() to avoid linking with them. You will need to call ImGui::SetAllocatorFunctions().
 //#define IMGUI_DISABLE_SSE                                 // Disable use of SSE intrinsics even if available
 
+//---- ID hash backend. The default is CRC32 with slicing-by-8 tables, the same IDs as the byte-at-a-time CRC32 of upstream Dear ImGui.
+// CRC32C hashes 8 bytes per SSE4.2 crc32 instruction (needs an SSE4.2 CPU, '-msse4.2' on GCC/Clang). It produces different ImGuiID values:
+// IDs saved in .ini files (e.g. [Table] settings) by a build using the default hash won't be recognized.
+//#define IMGUI_USE_CRC32C_HASH
+
+//---- Look up ImGuiStorage keys (tree node state, window state storage, ImPool maps) through an open addressing hash index instead of a binary search
+// over the sorted pairs. Insertions append instead of shifting the tail. ImGuiStorage::Data is then kept in insertion order, call BuildSortByKey() to sort it.
+//#define IMGUI_USE_HASHED_STORAGE
+
 //---- Include imgui_user.h at the end of imgui.h as a convenience
 //#define IMGUI_INCLUDE_IMGUI_USER_H
 
@@ -140,8 +140,11 @@ struct ImDrawListSplitter;          // Helper to split a draw list into differen
 struct ImDrawVert;                  // A single vertex (pos + uv + col = 20 bytes by default. Override layout with IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
 struct ImFont;                      // Runtime data for a single font within a parent ImFontAtlas
 struct ImFontAtlas;                 // Runtime data for multiple fonts, bake multiple fonts into a single texture, TTF/OTF font loader
+struct ImFontAtlasDynamicGlyphs;    // Opaque storage for glyphs rasterized on demand (ImFontConfig::DynamicGlyphs)
+struct ImFontAtlasTexUpdate;        // A region of the atlas texture changed since it was uploaded
 struct ImFontBuilderIO;             // Opaque interface to a font builder (stb_truetype or FreeType).
 struct ImFontConfig;                // Configuration data when adding a font or merging fonts
+struct ImFontDynamicGlyphs;         // Opaque per-font data for glyphs rasterized on demand (ImFontConfig::DynamicGlyphs)
 struct ImFontGlyph;                 // A single font glyph (code point + coordinates within in ImFontAtlas + offset)
 struct ImFontGlyphRangesBuilder;    // Helper to build glyph ranges from text/string data
 struct ImColor;                     // Helper functions to create a color that can be converted to either u32 or float4 (*OBSOLETE* please avoid using)
@@ -241,6 +244,7 @@ typedef ImWchar16 ImWchar;
 typedef int     (*ImGuiInputTextCallback)(ImGuiInputTextCallbackData* data);    // Callback function for ImGui::InputText()
 typedef void    (*ImGuiSizeCallback)(ImGuiSizeCallbackData* data);              // Callback function for ImGui::SetNextWindowSizeConstraints()
 typedef void*   (*ImGuiMemAllocFunc)(size_t sz, void* user_data);               // Function signature for ImGui::SetAllocatorFunctions()
+typedef void    (*ImFontAtlasParallelForFunc)(int count, void (*job)(int index, void* job_data), void* job_data, void* user_data); // Function signature for ImFontAtlas::BuildParallelFor
 typedef void    (*ImGuiMemFreeFunc)(void* ptr, void* user_data);                // Function signature for ImGui::SetAllocatorFunctions()
 
 // ImVec2: 2D vector used to store positions, sizes etc. [Compile-time configurable type]
@@ -2223,6 +2227,7 @@ struct ImGuiTextBuffer
 // Typically you don't have to worry about this since a storage is held within each Window.
 // We use it to e.g. store collapse state for a tree (Int 0/1)
 // This is optimized for efficient lookup (dichotomy into a contiguous buffer) and rare insertion (typically tied to user interactions aka max once a frame)
+// With IMGUI_USE_HASHED_STORAGE (imconfig.h) lookups and insertions go through an open addressing index instead, for storages with many thousands of keys.
 // You can use it as custom user storage for temporary values. Declare your own storage if, for example:
 // - You want to manipulate the open/close state of a particular sub-tree in your interface (tree node uses Int 0/1 to store their state).
 // - You want to store custom debug data easily without adding or editing structures in your code (probably not efficient, but convenient)
@@ -2240,11 +2245,28 @@ struct ImGuiStorage
     };
 
     ImVector<ImGuiStoragePair>      Data;
+#ifdef IMGUI_USE_HASHED_STORAGE
+    // [Internal] Open addressing index over Data (power of two slots, index == -1 is an empty slot).
+    // Data stays in insertion order until BuildSortByKey(). Index is rebuilt on demand when Data.Size no longer matches IndexedSize.
+    struct ImGuiStorageSlot
+    {
+        ImGuiID key;
+        int     index;
+    };
+    ImVector<ImGuiStorageSlot>      Index;
+    int                             IndexedSize;
+
+    ImGuiStorage() { IndexedSize = 0; }
+#endif
 
-    // - Get***() functions find pair, never add/allocate. Pairs are sorted so a query is O(log N)
+    // - Get***() functions find pair, never add/allocate. Pairs are sorted so a query is O(log N), or O(1) with IMGUI_USE_HASHED_STORAGE
     // - Set***() functions find pair, insertion on demand if missing.
     // - Sorted insertion is costly, paid once. A typical frame shouldn't need to insert any new pair.
+#ifdef IMGUI_USE_HASHED_STORAGE
+    void                Clear() { Data.clear(); Index.clear(); IndexedSize = 0; }
+#else
     void                Clear() { Data.clear(); }
+#endif
     IMGUI_API int       GetInt(ImGuiID key, int default_val = 0) const;
     IMGUI_API void      SetInt(ImGuiID key, int val);
     IMGUI_API bool      GetBool(ImGuiID key, bool default_val = false) const;
@@ -2267,6 +2289,7 @@ struct ImGuiStorage
     IMGUI_API void      SetAllInt(int val);
 
     // For quicker full rebuild of a storage (instead of an incremental one), you may add all your contents and then sort once.
+    // Also required after editing Data directly with IMGUI_USE_HASHED_STORAGE, it rebuilds the index.
     IMGUI_API void      BuildSortByKey();
 };
 
@@ -2664,6 +2687,7 @@ struct ImFontConfig
     unsigned int    FontBuilderFlags;       // 0        // Settings for custom font builder. THIS IS BUILDER IMPLEMENTATION DEPENDENT. Leave as zero if unsure.
     float           RasterizerMultiply;     // 1.0f     // Brighten (>1.0f) or darken (<1.0f) font output. Brightening small fonts may be a good workaround to make them more readable.
     ImWchar         EllipsisChar;           // -1       // Explicitly specify unicode codepoint of ellipsis character. When fonts are being merged first specified ellipsis will be used.
+    bool            DynamicGlyphs;          // false    // Rasterize glyphs on first use into the pages of ImFontAtlas::DynamicPageCount instead of baking every glyph of GlyphRanges in Build(). For large ranges (e.g. GetGlyphRangesChineseFull()). Only the stb_truetype builder supports it, the atlas must keep its CPU pixels (don't call ClearTexData()) and the renderer backend must apply ImFontAtlas::TexUpdates.
 
     // [Internal]
     char            Name[40];               // Name (strictly to ease debugging)
@@ -2713,6 +2737,12 @@ struct ImFontAtlasCustomRect
     bool IsPacked() const           { return X != 0xFFFF; }
 };
 
+// A region of the atlas pixels that changed after the texture was built, see ImFontAtlas::TexUpdates.
+struct ImFontAtlasTexUpdate
+{
+    int             X, Y, Width, Height;
+};
+
 // Flags for ImFontAtlas build
 enum ImFontAtlasFlags_
 {
@@ -2809,6 +2839,11 @@ struct ImFontAtlas
     int                         TexDesiredWidth;    // Texture width desired by user before Build(). Must be a power-of-two. If have many glyphs your graphics API have texture size restrictions you may want to increase texture width to decrease height.
     int                         TexGlyphPadding;    // Padding between glyphs within texture in pixels. Defaults to 1. If your rendering method doesn't rely on bilinear filtering you may set this to 0 (will also need to set AntiAliasedLinesUseTex = false).
     bool                        Locked;             // Marked as Locked by ImGui::NewFrame() so attempt to modify the atlas will assert.
+    ImFontAtlasParallelForFunc  BuildParallelFor;   // Optional: call job(0..count-1) on worker threads in any order and return when all are done. Build() then measures and rasterizes glyphs in parallel (packing stays serial, the texture is the same). Jobs allocate through the ImGui::SetAllocatorFunctions() functions, which must be thread-safe (malloc() is).
+    void*                       BuildParallelForUserData;
+    int                         DynamicPageSize;    // Width and height of the pages holding glyphs of ImFontConfig::DynamicGlyphs fonts. Defaults to 256. Must be larger than the largest glyph.
+    int                         DynamicPageCount;   // Pages reserved in the texture when a font uses ImFontConfig::DynamicGlyphs. Defaults to 8. When they are full, the least recently used page not drawn in the current frame is cleared for new glyphs.
+    ImVector<ImFontAtlasTexUpdate> TexUpdates;      // Regions of TexPixelsAlpha8/TexPixelsRGBA32 rasterized after the texture was built (ImFontConfig::DynamicGlyphs). The renderer backend copies them into its texture before drawing, then clears the list.
 
     // [Internal]
     // NB: Access texture data via GetTexData*() calls! Which will setup a default font for you.
@@ -2832,6 +2867,8 @@ struct ImFontAtlas
     // [Internal] Packing data
     int                         PackIdMouseCursors; // Custom texture rectangle ID for white pixel and mouse cursors
     int                         PackIdLines;        // Custom texture rectangle ID for baked anti-aliased lines
+    int                         PackIdDynamicPages; // Custom texture rectangle ID of the first of DynamicPageCount pages, -1 when no font uses ImFontConfig::DynamicGlyphs
+    ImFontAtlasDynamicGlyphs*   DynamicGlyphs;      // Pages and font sources of glyphs rasterized on demand
 
     // [Obsolete]
     //typedef ImFontAtlasCustomRect    CustomRect;         // OBSOLETED in 1.72+
@@ -2860,6 +2897,7 @@ struct ImFont
     ImWchar                     EllipsisChar;       // 2     // out // = '...'    // Character used for ellipsis rendering.
     ImWchar                     DotChar;            // 2     // out // = '.'      // Character used for ellipsis rendering (if a single '...' character isn't found)
     bool                        DirtyLookupTables;  // 1     // out //
+    ImFontDynamicGlyphs*        DynamicGlyphs;      // 4-8   // out //            // NULL unless one of its sources uses ImFontConfig::DynamicGlyphs, then IndexAdvanceX holds -1.0f until a glyph is measured
     float                       Scale;              // 4     // in  // = 1.f      // Base font scale, multiplied by the per-window font scale which you can adjust with SetWindowFontScale()
     float                       Ascent, Descent;    // 4+4   // out //            // Ascent: distance from top to bottom of e.g. 'A' [0..FontSize]
     int                         MetricsTotalSurface;// 4     // out //            // Total surface in pixels to get an idea of the font rasterization/texture cost (not exact, we approximate the cost of padding between glyphs)
@@ -2870,7 +2908,7 @@ struct ImFont
     IMGUI_API ~ImFont();
     IMGUI_API const ImFontGlyph*FindGlyph(ImWchar c) const;
     IMGUI_API const ImFontGlyph*FindGlyphNoFallback(ImWchar c) const;
-    float                       GetCharAdvance(ImWchar c) const     { return ((int)c < IndexAdvanceX.Size) ? IndexAdvanceX[(int)c] : FallbackAdvanceX; }
+    float                       GetCharAdvance(ImWchar c) const     { float advance_x = ((int)c < IndexAdvanceX.Size) ? IndexAdvanceX.Data[(int)c] : FallbackAdvanceX; return (advance_x >= 0.0f) ? advance_x : LoadCharAdvance(c); }
     bool                        IsLoaded() const                    { return ContainerAtlas != NULL; }
     const char*                 GetDebugName() const                { return ConfigData ? ConfigData->Name : "<unknown>"; }
 
@@ -2889,6 +2927,8 @@ struct ImFont
     IMGUI_API void              AddRemapChar(ImWchar dst, ImWchar src, bool overwrite_dst = true); // Makes 'dst' character/glyph points to 'src' character/glyph. Currently needs to be called AFTER fonts have been built.
     IMGUI_API void              SetGlyphVisible(ImWchar c, bool visible);
     IMGUI_API bool              IsGlyphRangeUnused(unsigned int c_begin, unsigned int c_last);
+    IMGUI_API float             LoadCharAdvance(ImWchar c) const;   // ImFontConfig::DynamicGlyphs: measure a glyph not measured yet
+    IMGUI_API const ImFontGlyph*LoadGlyph(ImWchar c) const;         // ImFontConfig::DynamicGlyphs: rasterize a glyph not in the texture
 };
 
 //-----------------------------------------------------------------------------
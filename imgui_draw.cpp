@@ -142,10 +142,14 @@ namespace IMGUI_STB_NAMESPACE
 #endif
 
 #ifdef  IMGUI_ENABLE_STB_TRUETYPE
+// Glyph jobs running on ImFontAtlas::BuildParallelFor threads pass an allocator as font userdata: IM_ALLOC() updates a non-atomic counter
+struct ImFontBuildJobAllocator { ImGuiMemAllocFunc AllocFunc; ImGuiMemFreeFunc FreeFunc; void* UserData; };
+static inline void* ImFontBuildJobAlloc(size_t sz, void* u)    { ImFontBuildJobAllocator* a = (ImFontBuildJobAllocator*)u; return a->AllocFunc(sz, a->UserData); }
+static inline void  ImFontBuildJobFree(void* ptr, void* u)     { ImFontBuildJobAllocator* a = (ImFontBuildJobAllocator*)u; a->FreeFunc(ptr, a->UserData); }
 #ifndef STB_TRUETYPE_IMPLEMENTATION                         // in case the user already have an implementation in the _same_ compilation unit (e.g. unity builds)
 #ifndef IMGUI_DISABLE_STB_TRUETYPE_IMPLEMENTATION           // in case the user already have an implementation in another compilation unit
-#define STBTT_malloc(x,u)   ((void)(u), IM_ALLOC(x))
-#define STBTT_free(x,u)     ((void)(u), IM_FREE(x))
+#define STBTT_malloc(x,u)   ((u) ? ImFontBuildJobAlloc(x,u) : IM_ALLOC(x))
+#define STBTT_free(x,u)     ((u) ? ImFontBuildJobFree(x,u) : IM_FREE(x))
 #define STBTT_assert(x)     do { IM_ASSERT(x); } while(0)
 #define STBTT_fmod(x,y)     ImFmod(x,y)
 #define STBTT_sqrt(x)       ImSqrt(x)
@@ -1977,7 +1981,9 @@ ImFontAtlas::ImFontAtlas()
 {
     memset(this, 0, sizeof(*this));
     TexGlyphPadding = 1;
-    PackIdMouseCursors = PackIdLines = -1;
+    DynamicPageSize = 256;
+    DynamicPageCount = 8;
+    PackIdMouseCursors = PackIdLines = PackIdDynamicPages = -1;
 }
 
 ImFontAtlas::~ImFontAtlas()
@@ -2003,9 +2009,11 @@ void    ImFontAtlas::ClearInputData()
             Fonts[i]->ConfigData = NULL;
             Fonts[i]->ConfigDataCount = 0;
         }
+    // Glyphs of ImFontConfig::DynamicGlyphs fonts are rasterized from the font data
+    ImFontAtlasBuildClearDynamicGlyphs(this);
     ConfigData.clear();
     CustomRects.clear();
-    PackIdMouseCursors = PackIdLines = -1;
+    PackIdMouseCursors = PackIdLines = PackIdDynamicPages = -1;
     // Important: we leave TexReady untouched
 }
 
@@ -2025,7 +2033,9 @@ void    ImFontAtlas::ClearTexData()
 void    ImFontAtlas::ClearFonts()
 {
     IM_ASSERT(!Locked && "Cannot modify a locked ImFontAtlas between NewFrame() and EndFrame/Render()!");
+    ImFontAtlasBuildClearDynamicGlyphs(this);
     Fonts.clear_delete();
+    TexUpdates.clear();
     TexReady = false;
 }
 
@@ -2319,6 +2329,8 @@ struct ImFontBuildSrcData
     int                 GlyphsCount;        // Glyph count (excluding missing glyphs and glyphs already set by an earlier source font)
     ImBitVector         GlyphsSet;          // Glyph bit map (random access, 1-bit per codepoint. This will be a maximum of 8KB)
     ImVector<int>       GlyphsList;         // Glyph codepoints list (flattened version of GlyphsMap)
+    int                 DynamicHighest;     // Highest codepoint of DynamicSet
+    ImBitVector         DynamicSet;         // Codepoints available but not baked, with ImFontConfig::DynamicGlyphs
 };
 
 // Temporary data for one destination ImFont* (multiple source fonts can be merged into one destination ImFont)
@@ -2330,6 +2342,92 @@ struct ImFontBuildDstData
     ImBitVector         GlyphsSet;          // This is used to resolve collision when multiple sources are merged into a same destination font.
 };
 
+// A run of glyphs of one source font, measured then rasterized by one job. Every glyph has its own rectangle, so jobs
+// can run on any thread in any order and the atlas is the same.
+struct ImFontBuildGlyphJob
+{
+    int                 SrcIndex;
+    int                 GlyphBegin;
+    int                 GlyphEnd;
+};
+
+struct ImFontBuildJobs
+{
+    ImFontAtlas*        Atlas;
+    ImFontBuildSrcData* SrcTmp;
+    ImVector<ImFontBuildGlyphJob> Jobs;
+    stbtt_pack_context* PackContext;        // Rasterization only
+    ImFontBuildJobAllocator Allocator;
+    void*               FontUserData;       // &Allocator when running on BuildParallelFor threads, NULL otherwise
+};
+
+static const int FONT_BUILD_GLYPHS_PER_JOB = 128;
+
+static void ImFontAtlasBuildRunJobs(ImFontBuildJobs* jobs, void (*job)(int job_i, void* job_data))
+{
+    ImFontAtlas* atlas = jobs->Atlas;
+    if (atlas->BuildParallelFor != NULL && jobs->Jobs.Size > 1)
+        atlas->BuildParallelFor(jobs->Jobs.Size, job, jobs, atlas->BuildParallelForUserData);
+    else
+        for (int job_i = 0; job_i < jobs->Jobs.Size; job_i++)
+            job(job_i, jobs);
+}
+
+// Gather the sizes of the rectangles we will need to pack (this is based on stbtt_PackFontRangesGatherRects)
+static void ImFontAtlasBuildMeasureGlyphsJob(int job_i, void* job_data)
+{
+    ImFontBuildJobs* jobs = (ImFontBuildJobs*)job_data;
+    const ImFontBuildGlyphJob& job = jobs->Jobs[job_i];
+    ImFontBuildSrcData& src_tmp = jobs->SrcTmp[job.SrcIndex];
+    const ImFontConfig& cfg = jobs->Atlas->ConfigData[job.SrcIndex];
+    stbtt_fontinfo font_info = src_tmp.FontInfo;
+    font_info.userdata = jobs->FontUserData;
+
+    const float scale = (cfg.SizePixels > 0) ? stbtt_ScaleForPixelHeight(&font_info, cfg.SizePixels) : stbtt_ScaleForMappingEmToPixels(&font_info, -cfg.SizePixels);
+    const int padding = jobs->Atlas->TexGlyphPadding;
+    for (int glyph_i = job.GlyphBegin; glyph_i < job.GlyphEnd; glyph_i++)
+    {
+        int x0, y0, x1, y1;
+        const int glyph_index_in_font = stbtt_FindGlyphIndex(&font_info, src_tmp.GlyphsList[glyph_i]);
+        IM_ASSERT(glyph_index_in_font != 0);
+        stbtt_GetGlyphBitmapBoxSubpixel(&font_info, glyph_index_in_font, scale * cfg.OversampleH, scale * cfg.OversampleV, 0, 0, &x0, &y0, &x1, &y1);
+        src_tmp.Rects[glyph_i].w = (stbrp_coord)(x1 - x0 + padding + cfg.OversampleH - 1);
+        src_tmp.Rects[glyph_i].h = (stbrp_coord)(y1 - y0 + padding + cfg.OversampleV - 1);
+    }
+}
+
+static void ImFontAtlasBuildRenderGlyphsJob(int job_i, void* job_data)
+{
+    ImFontBuildJobs* jobs = (ImFontBuildJobs*)job_data;
+    const ImFontBuildGlyphJob& job = jobs->Jobs[job_i];
+    ImFontBuildSrcData& src_tmp = jobs->SrcTmp[job.SrcIndex];
+    const ImFontConfig& cfg = jobs->Atlas->ConfigData[job.SrcIndex];
+    stbtt_fontinfo font_info = src_tmp.FontInfo;
+    font_info.userdata = jobs->FontUserData;
+
+    // stbtt_PackFontRangesRenderIntoRects() writes the oversampling into the context, every job works on its own copy
+    stbtt_pack_context spc = *jobs->PackContext;
+    stbtt_pack_range range = src_tmp.PackRange;
+    range.array_of_unicode_codepoints += job.GlyphBegin;
+    range.chardata_for_range += job.GlyphBegin;
+    range.num_chars = job.GlyphEnd - job.GlyphBegin;
+    stbtt_PackFontRangesRenderIntoRects(&spc, &font_info, &range, 1, src_tmp.Rects + job.GlyphBegin);
+
+    // Apply multiply operator
+    if (cfg.RasterizerMultiply != 1.0f)
+    {
+        unsigned char multiply_table[256];
+        ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
+        ImFontAtlas* atlas = jobs->Atlas;
+        for (int glyph_i = job.GlyphBegin; glyph_i < job.GlyphEnd; glyph_i++)
+        {
+            const stbrp_rect* r = &src_tmp.Rects[glyph_i];
+            if (r->was_packed)
+                ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, atlas->TexPixelsAlpha8, r->x, r->y, r->w, r->h, atlas->TexWidth * 1);
+        }
+    }
+}
+
 static void UnpackBitVectorToFlatIndexList(const ImBitVector* in, ImVector<int>* out)
 {
     IM_ASSERT(sizeof(in->Storage.Data[0]) == sizeof(int));
@@ -2342,11 +2440,17 @@ static void UnpackBitVectorToFlatIndexList(const ImBitVector* in, ImVector<int>*
                     out->push_back((int)(((it - it_begin) << 5) + bit_n));
 }
 
+// Glyphs rasterized on demand (ImFontConfig::DynamicGlyphs), see below
+static void ImFontAtlasBuildInitDynamicPages(ImFontAtlas* atlas);
+static bool ImFontAtlasBuildIsResidentGlyph(const ImFontConfig* cfg, unsigned int codepoint);
+static void ImFontAtlasBuildSetupDynamicGlyphs(ImFontAtlas* atlas, ImVector<ImFontBuildSrcData>& src_tmp_array);
+
 static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
 {
     IM_ASSERT(atlas->ConfigData.Size > 0);
 
     ImFontAtlasBuildInit(atlas);
+    ImFontAtlasBuildInitDynamicPages(atlas);
 
     // Clear atlas
     atlas->TexID = (ImTextureID)NULL;
@@ -2354,6 +2458,8 @@ static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     atlas->TexUvScale = ImVec2(0.0f, 0.0f);
     atlas->TexUvWhitePixel = ImVec2(0.0f, 0.0f);
     atlas->ClearTexData();
+    atlas->TexUpdates.clear();
+    ImFontAtlasBuildClearDynamicGlyphs(atlas);
 
     // Temporary storage for building
     ImVector<ImFontBuildSrcData> src_tmp_array;
@@ -2396,15 +2502,18 @@ static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     }
 
     // 2. For every requested codepoint, check for their presence in the font data, and handle redundancy or overlaps between source fonts to avoid unused glyphs.
+    // A source with DynamicGlyphs still claims its codepoints (so that later sources don't bake them), but only bakes the few glyphs BuildLookupTable() needs.
     int total_glyphs_count = 0;
     for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
     {
         ImFontBuildSrcData& src_tmp = src_tmp_array[src_i];
         ImFontBuildDstData& dst_tmp = dst_tmp_array[src_tmp.DstIndex];
+        const ImFontConfig& cfg = atlas->ConfigData[src_i];
         src_tmp.GlyphsSet.Create(src_tmp.GlyphsHighest + 1);
         if (dst_tmp.GlyphsSet.Storage.empty())
             dst_tmp.GlyphsSet.Create(dst_tmp.GlyphsHighest + 1);
 
+        int first_dynamic_codepoint = -1;
         for (const ImWchar* src_range = src_tmp.SrcRanges; src_range[0] && src_range[1]; src_range += 2)
             for (unsigned int codepoint = src_range[0]; codepoint <= src_range[1]; codepoint++)
             {
@@ -2412,14 +2521,35 @@ static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
                     continue;
                 if (!stbtt_FindGlyphIndex(&src_tmp.FontInfo, codepoint))    // It is actually in the font?
                     continue;
+                dst_tmp.GlyphsSet.SetBit(codepoint);
+                if (cfg.DynamicGlyphs && !ImFontAtlasBuildIsResidentGlyph(&cfg, codepoint))
+                {
+                    if (first_dynamic_codepoint == -1)
+                    {
+                        first_dynamic_codepoint = (int)codepoint;
+                        src_tmp.DynamicSet.Create(src_tmp.GlyphsHighest + 1);
+                    }
+                    src_tmp.DynamicSet.SetBit(codepoint);
+                    src_tmp.DynamicHighest = ImMax(src_tmp.DynamicHighest, (int)codepoint);
+                    continue;
+                }
 
                 // Add to avail set/counters
                 src_tmp.GlyphsCount++;
                 dst_tmp.GlyphsCount++;
                 src_tmp.GlyphsSet.SetBit(codepoint);
-                dst_tmp.GlyphsSet.SetBit(codepoint);
                 total_glyphs_count++;
             }
+
+        // A font needs at least one glyph for its fallback
+        if (dst_tmp.GlyphsCount == 0 && first_dynamic_codepoint != -1)
+        {
+            src_tmp.GlyphsCount++;
+            dst_tmp.GlyphsCount++;
+            src_tmp.GlyphsSet.SetBit(first_dynamic_codepoint);
+            src_tmp.DynamicSet.ClearBit(first_dynamic_codepoint);
+            total_glyphs_count++;
+        }
     }
 
     // 3. Unpack our bit map into a flat list (we now have all the Unicode points that we know are requested _and_ available _and_ not overlapping another)
@@ -2444,8 +2574,24 @@ static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     memset(buf_rects.Data, 0, (size_t)buf_rects.size_in_bytes());
     memset(buf_packedchars.Data, 0, (size_t)buf_packedchars.size_in_bytes());
 
+    // Split every source font into jobs
+    ImFontBuildJobs jobs;
+    jobs.Atlas = atlas;
+    jobs.SrcTmp = src_tmp_array.Data;
+    jobs.PackContext = NULL;
+    ImGui::GetAllocatorFunctions(&jobs.Allocator.AllocFunc, &jobs.Allocator.FreeFunc, &jobs.Allocator.UserData);
+    jobs.FontUserData = atlas->BuildParallelFor ? &jobs.Allocator : NULL;
+    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
+        for (int glyph_i = 0; glyph_i < src_tmp_array[src_i].GlyphsCount; glyph_i += FONT_BUILD_GLYPHS_PER_JOB)
+        {
+            ImFontBuildGlyphJob job;
+            job.SrcIndex = src_i;
+            job.GlyphBegin = glyph_i;
+            job.GlyphEnd = ImMin(glyph_i + FONT_BUILD_GLYPHS_PER_JOB, src_tmp_array[src_i].GlyphsCount);
+            jobs.Jobs.push_back(job);
+        }
+
     // 4. Gather glyphs sizes so we can pack them in our virtual canvas.
-    int total_surface = 0;
     int buf_rects_out_n = 0;
     int buf_packedchars_out_n = 0;
     for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
@@ -2468,21 +2614,13 @@ static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
         src_tmp.PackRange.chardata_for_range = src_tmp.PackedChars;
         src_tmp.PackRange.h_oversample = (unsigned char)cfg.OversampleH;
         src_tmp.PackRange.v_oversample = (unsigned char)cfg.OversampleV;
-
-        // Gather the sizes of all rectangles we will need to pack (this loop is based on stbtt_PackFontRangesGatherRects)
-        const float scale = (cfg.SizePixels > 0) ? stbtt_ScaleForPixelHeight(&src_tmp.FontInfo, cfg.SizePixels) : stbtt_ScaleForMappingEmToPixels(&src_tmp.FontInfo, -cfg.SizePixels);
-        const int padding = atlas->TexGlyphPadding;
-        for (int glyph_i = 0; glyph_i < src_tmp.GlyphsList.Size; glyph_i++)
-        {
-            int x0, y0, x1, y1;
-            const int glyph_index_in_font = stbtt_FindGlyphIndex(&src_tmp.FontInfo, src_tmp.GlyphsList[glyph_i]);
-            IM_ASSERT(glyph_index_in_font != 0);
-            stbtt_GetGlyphBitmapBoxSubpixel(&src_tmp.FontInfo, glyph_index_in_font, scale * cfg.OversampleH, scale * cfg.OversampleV, 0, 0, &x0, &y0, &x1, &y1);
-            src_tmp.Rects[glyph_i].w = (stbrp_coord)(x1 - x0 + padding + cfg.OversampleH - 1);
-            src_tmp.Rects[glyph_i].h = (stbrp_coord)(y1 - y0 + padding + cfg.OversampleV - 1);
-            total_surface += src_tmp.Rects[glyph_i].w * src_tmp.Rects[glyph_i].h;
-        }
     }
+    ImFontAtlasBuildRunJobs(&jobs, ImFontAtlasBuildMeasureGlyphsJob);
+    int total_surface = 0;
+    for (int rect_i = 0; rect_i < buf_rects_out_n; rect_i++)
+        total_surface += buf_rects[rect_i].w * buf_rects[rect_i].h;
+    if (atlas->PackIdDynamicPages >= 0)
+        total_surface += atlas->DynamicPageSize * atlas->DynamicPageSize * atlas->DynamicPageCount;
 
     // We need a width for the skyline algorithm, any width!
     // The exact width doesn't really matter much, but some API/GPU have texture size limitations and increasing width can decrease height.
@@ -2526,27 +2664,10 @@ static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     spc.height = atlas->TexHeight;
 
     // 8. Render/rasterize font characters into the texture
+    jobs.PackContext = &spc;
+    ImFontAtlasBuildRunJobs(&jobs, ImFontAtlasBuildRenderGlyphsJob);
     for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
-    {
-        ImFontConfig& cfg = atlas->ConfigData[src_i];
-        ImFontBuildSrcData& src_tmp = src_tmp_array[src_i];
-        if (src_tmp.GlyphsCount == 0)
-            continue;
-
-        stbtt_PackFontRangesRenderIntoRects(&spc, &src_tmp.FontInfo, &src_tmp.PackRange, 1, src_tmp.Rects);
-
-        // Apply multiply operator
-        if (cfg.RasterizerMultiply != 1.0f)
-        {
-            unsigned char multiply_table[256];
-            ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
-            stbrp_rect* r = &src_tmp.Rects[0];
-            for (int glyph_i = 0; glyph_i < src_tmp.GlyphsCount; glyph_i++, r++)
-                if (r->was_packed)
-                    ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, atlas->TexPixelsAlpha8, r->x, r->y, r->w, r->h, atlas->TexWidth * 1);
-        }
-        src_tmp.Rects = NULL;
-    }
+        src_tmp_array[src_i].Rects = NULL;
 
     // End packing
     stbtt_PackEnd(&spc);
@@ -2555,14 +2676,13 @@ static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     // 9. Setup ImFont and glyphs for runtime
     for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
     {
-        ImFontBuildSrcData& src_tmp = src_tmp_array[src_i];
-        if (src_tmp.GlyphsCount == 0)
-            continue;
-
         // When merging fonts with MergeMode=true:
         // - We can have multiple input fonts writing into a same destination font.
         // - dst_font->ConfigData is != from cfg which is our source configuration.
+        ImFontBuildSrcData& src_tmp = src_tmp_array[src_i];
         ImFontConfig& cfg = atlas->ConfigData[src_i];
+        if (src_tmp.GlyphsCount == 0 && !cfg.DynamicGlyphs)
+            continue;
         ImFont* dst_font = cfg.DstFont;
 
         const float font_scale = stbtt_ScaleForPixelHeight(&src_tmp.FontInfo, cfg.SizePixels);
@@ -2587,10 +2707,12 @@ static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
         }
     }
 
+    ImFontAtlasBuildFinish(atlas);
+    if (atlas->PackIdDynamicPages >= 0)
+        ImFontAtlasBuildSetupDynamicGlyphs(atlas, src_tmp_array);
+
     // Cleanup
     src_tmp_array.clear_destruct();
-
-    ImFontAtlasBuildFinish(atlas);
     return true;
 }
 
@@ -2601,6 +2723,425 @@ const ImFontBuilderIO* ImFontAtlasGetBuilderForStbTruetype()
     return &io;
 }
 
+// Glyphs rasterized on demand (ImFontConfig::DynamicGlyphs)
+// - Build() reserves DynamicPageCount square pages in the texture, and of a dynamic source only bakes the glyphs BuildLookupTable() needs.
+// - CalcTextSize() measures the other glyphs on first use: IndexAdvanceX holds -1.0f until then.
+// - FindGlyph() rasterizes them into a page on first use (IndexLookup holds -1 until then), the backend uploads ImFontAtlas::TexUpdates.
+// - Pages are filled with shelves, rows as high as their first glyph. When no page has room, the least recently drawn page is cleared:
+//   its glyphs go back to not loaded (their advance stays measured) and are rasterized again when drawn. A page drawn in the current
+//   frame is never cleared, when they all are the glyph is drawn blank for this frame.
+struct ImFontDynamicShelf
+{
+    int                 Y, Height;
+    int                 X;                  // Where the next glyph goes
+};
+
+struct ImFontDynamicPageGlyph
+{
+    ImFont*             Font;
+    unsigned int        Codepoint;
+};
+
+struct ImFontDynamicPage
+{
+    int                 X, Y;               // Position in the texture
+    int                 ShelvesHeight;      // Where the next shelf goes
+    int                 LastUsedFrame;
+    ImVector<ImFontDynamicShelf>      Shelves;
+    ImVector<ImFontDynamicPageGlyph>  Glyphs;   // Unloaded when the page is cleared
+};
+
+struct ImFontDynamicSource
+{
+    int                 ConfigIndex;        // Index into atlas->ConfigData[]
+    stbtt_fontinfo      FontInfo;
+    float               Scale;              // As stbtt_PackFontRangesRenderIntoRects() computes it
+    ImBitVector         Glyphs;             // Codepoints it rasterizes: in its GlyphRanges and in the font, not baked, not claimed by an earlier source
+};
+
+struct ImFontDynamicGlyphs
+{
+    ImVector<int>       Sources;            // Index into ImFontAtlasDynamicGlyphs::Sources[], in ConfigData[] order
+    ImVector<short>     GlyphPage;          // Page of every Glyphs[] entry, -1 for glyphs baked by Build()
+    ImVector<int>       FreeGlyphs;         // Glyphs[] entries unloaded when their page was cleared
+    ImFontGlyph         Blank;              // Returned when no page has room: the right advance, no pixels
+};
+
+struct ImFontAtlasDynamicGlyphs
+{
+    ImVector<ImFontDynamicSource>   Sources;
+    ImVector<ImFontDynamicPage>     Pages;
+    ImVector<ImFontDynamicGlyphs*>  Fonts;
+    ImVector<ImFontDynamicPage*>    PagesByUse;     // Temporary
+    ~ImFontAtlasDynamicGlyphs()     { Sources.clear_destruct(); Pages.clear_destruct(); Fonts.clear_delete(); }
+};
+
+static int ImFontAtlasDynamicGetFrame()
+{
+    ImGuiContext* g = GImGui;
+    return g ? g->FrameCount : 0;
+}
+
+static void ImFontAtlasBuildInitDynamicPages(ImFontAtlas* atlas)
+{
+    if (atlas->PackIdDynamicPages >= 0)
+        return;
+    for (int src_i = 0; src_i < atlas->ConfigData.Size; src_i++)
+        if (atlas->ConfigData[src_i].DynamicGlyphs)
+        {
+            IM_ASSERT(atlas->DynamicPageSize > 0 && atlas->DynamicPageSize <= 0xFFFF && atlas->DynamicPageCount > 0);
+            atlas->PackIdDynamicPages = atlas->CustomRects.Size;
+            for (int page_n = 0; page_n < atlas->DynamicPageCount; page_n++)
+                atlas->AddCustomRectRegular(atlas->DynamicPageSize, atlas->DynamicPageSize);
+            return;
+        }
+}
+
+// The glyphs BuildLookupTable() picks the tab, ellipsis, dot and fallback from are baked, and never unloaded
+static bool ImFontAtlasBuildIsResidentGlyph(const ImFontConfig* cfg, unsigned int codepoint)
+{
+    static const unsigned int resident_chars[] = { ' ', '.', '?', 0x0085, 0x2026, 0xFF0E, IM_UNICODE_CODEPOINT_INVALID };
+    for (int n = 0; n < IM_ARRAYSIZE(resident_chars); n++)
+        if (codepoint == resident_chars[n])
+            return true;
+    return codepoint == (unsigned int)cfg->EllipsisChar || codepoint == (unsigned int)cfg->DstFont->FallbackChar;
+}
+
+static void ImFontAtlasBuildSetupDynamicGlyphs(ImFontAtlas* atlas, ImVector<ImFontBuildSrcData>& src_tmp_array)
+{
+    ImFontAtlasDynamicGlyphs* atlas_dyn = IM_NEW(ImFontAtlasDynamicGlyphs)();
+    atlas->DynamicGlyphs = atlas_dyn;
+
+    // Pages, in the rectangles reserved by ImFontAtlasBuildInitDynamicPages()
+    for (int page_n = 0; page_n < atlas->DynamicPageCount && atlas->PackIdDynamicPages + page_n < atlas->CustomRects.Size; page_n++)
+    {
+        const ImFontAtlasCustomRect* r = atlas->GetCustomRectByIndex(atlas->PackIdDynamicPages + page_n);
+        if (!r->IsPacked() || r->Width != atlas->DynamicPageSize) // Larger than the texture, or DynamicPageSize changed without ClearInputData()
+            continue;
+        atlas_dyn->Pages.resize(atlas_dyn->Pages.Size + 1);
+        ImFontDynamicPage& page = atlas_dyn->Pages.back();
+        memset((void*)&page, 0, sizeof(page));
+        page.X = r->X;
+        page.Y = r->Y;
+        page.LastUsedFrame = -1;
+    }
+    IM_ASSERT(atlas_dyn->Pages.Size > 0 && "No dynamic glyph page fits in the texture?");
+
+    // Sources, and the fonts they are merged into
+    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
+    {
+        ImFontBuildSrcData& src_tmp = src_tmp_array[src_i];
+        const ImFontConfig& cfg = atlas->ConfigData[src_i];
+        if (src_tmp.DynamicSet.Storage.empty())
+            continue;
+        atlas_dyn->Sources.resize(atlas_dyn->Sources.Size + 1);
+        ImFontDynamicSource& src = atlas_dyn->Sources.back();
+        memset((void*)&src, 0, sizeof(src));
+        src.ConfigIndex = src_i;
+        src.FontInfo = src_tmp.FontInfo;
+        src.Scale = (cfg.SizePixels > 0) ? stbtt_ScaleForPixelHeight(&src.FontInfo, cfg.SizePixels) : stbtt_ScaleForMappingEmToPixels(&src.FontInfo, -cfg.SizePixels);
+        src.Glyphs.Storage.swap(src_tmp.DynamicSet.Storage);
+
+        ImFont* font = cfg.DstFont;
+        if (font->DynamicGlyphs == NULL)
+        {
+            font->DynamicGlyphs = IM_NEW(ImFontDynamicGlyphs)();
+            atlas_dyn->Fonts.push_back(font->DynamicGlyphs);
+        }
+        font->DynamicGlyphs->Sources.push_back(atlas_dyn->Sources.Size - 1);
+
+        font->DynamicGlyphs->GlyphPage.resize(font->Glyphs.Size, (short)-1);
+
+        // Measured on first use
+        font->GrowIndex(src_tmp.DynamicHighest + 1);
+        for (int codepoint = 0; codepoint <= src_tmp.DynamicHighest; codepoint++)
+            if (src.Glyphs.TestBit(codepoint))
+                font->IndexAdvanceX.Data[codepoint] = -1.0f;
+    }
+}
+
+void ImFontAtlasBuildClearDynamicGlyphs(ImFontAtlas* atlas)
+{
+    if (atlas->DynamicGlyphs == NULL)
+        return;
+    for (int font_n = 0; font_n < atlas->Fonts.Size; font_n++)
+        atlas->Fonts[font_n]->DynamicGlyphs = NULL;
+    IM_DELETE(atlas->DynamicGlyphs);
+    atlas->DynamicGlyphs = NULL;
+}
+
+// Copy a changed rectangle of TexPixelsAlpha8 to TexPixelsRGBA32, and add it to the region of its page the backend will upload
+static void ImFontAtlasDynamicUpdateTexRect(ImFontAtlas* atlas, const ImFontDynamicPage& page, int x, int y, int w, int h)
+{
+    if (atlas->TexPixelsRGBA32 != NULL)
+        for (int py = y; py < y + h; py++)
+        {
+            const unsigned char* src = atlas->TexPixelsAlpha8 + x + py * atlas->TexWidth;
+            unsigned int* dst = atlas->TexPixelsRGBA32 + x + py * atlas->TexWidth;
+            for (int px = 0; px < w; px++)
+                dst[px] = IM_COL32(255, 255, 255, (unsigned int)src[px]);
+        }
+
+    const int page_size = atlas->DynamicPageSize;
+    for (int n = 0; n < atlas->TexUpdates.Size; n++)
+    {
+        ImFontAtlasTexUpdate& update = atlas->TexUpdates[n];
+        if (update.X >= page.X && update.Y >= page.Y && update.X < page.X + page_size && update.Y < page.Y + page_size)
+        {
+            const int x1 = ImMax(update.X + update.Width, x + w);
+            const int y1 = ImMax(update.Y + update.Height, y + h);
+            update.X = ImMin(update.X, x);
+            update.Y = ImMin(update.Y, y);
+            update.Width = x1 - update.X;
+            update.Height = y1 - update.Y;
+            return;
+        }
+    }
+    ImFontAtlasTexUpdate update = { x, y, w, h };
+    atlas->TexUpdates.push_back(update);
+}
+
+static void ImFontAtlasDynamicClearPage(ImFontAtlas* atlas, int page_n)
+{
+    ImFontDynamicPage& page = atlas->DynamicGlyphs->Pages[page_n];
+    for (int n = 0; n < page.Glyphs.Size; n++)
+    {
+        ImFont* font = page.Glyphs[n].Font;
+        const unsigned int codepoint = page.Glyphs[n].Codepoint;
+        const int glyph_n = font->IndexLookup[codepoint];
+        font->IndexLookup[codepoint] = (ImWchar)-1;
+        font->DynamicGlyphs->GlyphPage[glyph_n] = -1;
+        font->DynamicGlyphs->FreeGlyphs.push_back(glyph_n);
+    }
+    page.Glyphs.resize(0);
+    page.Shelves.resize(0);
+    page.ShelvesHeight = 0;
+
+    // Glyphs rely on clear padding around them
+    const int page_size = atlas->DynamicPageSize;
+    for (int y = page.Y; y < page.Y + page_size; y++)
+        memset(atlas->TexPixelsAlpha8 + page.X + y * atlas->TexWidth, 0, (size_t)page_size);
+    ImFontAtlasDynamicUpdateTexRect(atlas, page, page.X, page.Y, page_size, page_size);
+}
+
+// The shelf wasting the least height, or a new shelf when it would waste too much
+static bool ImFontDynamicPageAllocRect(ImFontDynamicPage* page, int size, int w, int h, int* out_x, int* out_y)
+{
+    ImFontDynamicShelf* best = NULL;
+    for (int n = 0; n < page->Shelves.Size; n++)
+    {
+        ImFontDynamicShelf* shelf = &page->Shelves[n];
+        if (shelf->Height >= h && shelf->X + w <= size && (best == NULL || shelf->Height < best->Height))
+            best = shelf;
+    }
+    if ((best == NULL || best->Height > h + h / 2) && page->ShelvesHeight + h <= size)
+    {
+        ImFontDynamicShelf shelf = { page->ShelvesHeight, h, 0 };
+        page->Shelves.push_back(shelf);
+        page->ShelvesHeight += h;
+        best = &page->Shelves.back();
+    }
+    if (best == NULL)
+        return false;
+    *out_x = page->X + best->X;
+    *out_y = page->Y + best->Y;
+    best->X += w;
+    return true;
+}
+
+static int IMGUI_CDECL ImFontDynamicPageComparerByUse(const void* lhs, const void* rhs)
+{
+    const ImFontDynamicPage* a = *(const ImFontDynamicPage* const*)lhs;
+    const ImFontDynamicPage* b = *(const ImFontDynamicPage* const*)rhs;
+    return (a->LastUsedFrame != b->LastUsedFrame) ? (b->LastUsedFrame > a->LastUsedFrame ? 1 : -1) : (a < b ? -1 : 1);
+}
+
+// Returns the page, or -1 when all pages are drawn in this frame
+static int ImFontAtlasDynamicAllocRect(ImFontAtlas* atlas, int w, int h, int* out_x, int* out_y)
+{
+    ImFontAtlasDynamicGlyphs* atlas_dyn = atlas->DynamicGlyphs;
+    const int size = atlas->DynamicPageSize - atlas->TexGlyphPadding; // Keep the right and bottom border clear, as stbtt_PackBegin() does
+    if (w > size || h > size)
+        return -1;
+    // Most recently drawn pages first: glyphs drawn together stay together, and pages of glyphs no longer drawn age as a whole
+    const int frame = ImFontAtlasDynamicGetFrame();
+    ImVector<ImFontDynamicPage*>& pages_by_use = atlas_dyn->PagesByUse;
+    pages_by_use.resize(0);
+    for (int page_n = 0; page_n < atlas_dyn->Pages.Size; page_n++)
+        pages_by_use.push_back(&atlas_dyn->Pages[page_n]);
+    ImQsort(pages_by_use.Data, (size_t)pages_by_use.Size, sizeof(ImFontDynamicPage*), ImFontDynamicPageComparerByUse);
+    for (int n = 0; n < pages_by_use.Size; n++)
+        if (ImFontDynamicPageAllocRect(pages_by_use[n], size, w, h, out_x, out_y))
+        {
+            pages_by_use[n]->LastUsedFrame = frame;
+            return (int)(pages_by_use[n] - atlas_dyn->Pages.Data);
+        }
+
+    int lru_page_n = -1;
+    for (int page_n = 0; page_n < atlas_dyn->Pages.Size; page_n++)
+        if (atlas_dyn->Pages[page_n].LastUsedFrame != frame && (lru_page_n == -1 || atlas_dyn->Pages[page_n].LastUsedFrame < atlas_dyn->Pages[lru_page_n].LastUsedFrame))
+            lru_page_n = page_n;
+    if (lru_page_n == -1)
+        return -1;
+    ImFontAtlasDynamicClearPage(atlas, lru_page_n);
+    ImFontDynamicPageAllocRect(&atlas_dyn->Pages[lru_page_n], size, w, h, out_x, out_y);
+    atlas_dyn->Pages[lru_page_n].LastUsedFrame = frame;
+    return lru_page_n;
+}
+
+static void ImFontDynamicTouchGlyph(const ImFont* font, int glyph_n)
+{
+    const ImVector<short>& glyph_page = font->DynamicGlyphs->GlyphPage;
+    if (glyph_n < glyph_page.Size && glyph_page.Data[glyph_n] >= 0)
+        font->ContainerAtlas->DynamicGlyphs->Pages.Data[glyph_page.Data[glyph_n]].LastUsedFrame = ImFontAtlasDynamicGetFrame();
+}
+
+static ImFontDynamicSource* ImFontDynamicFindSource(const ImFont* font, unsigned int codepoint, int* out_glyph_index)
+{
+    ImFontDynamicGlyphs* dyn = font->DynamicGlyphs;
+    ImFontAtlasDynamicGlyphs* atlas_dyn = font->ContainerAtlas->DynamicGlyphs;
+    for (int n = 0; n < dyn->Sources.Size; n++)
+    {
+        ImFontDynamicSource* src = &atlas_dyn->Sources[dyn->Sources[n]];
+        if ((int)codepoint < (src->Glyphs.Storage.Size << 5) && src->Glyphs.TestBit((int)codepoint))
+        {
+            *out_glyph_index = stbtt_FindGlyphIndex(&src->FontInfo, (int)codepoint);
+            return src;
+        }
+    }
+    return NULL;
+}
+
+// As ImFont::AddGlyph() adjusts the advance of stb_truetype
+static float ImFontDynamicAdjustAdvanceX(const ImFontConfig* cfg, float advance_x)
+{
+    advance_x = ImClamp(advance_x, cfg->GlyphMinAdvanceX, cfg->GlyphMaxAdvanceX);
+    if (cfg->PixelSnapH)
+        advance_x = IM_ROUND(advance_x);
+    return advance_x + cfg->GlyphExtraSpacing.x;
+}
+
+float ImFont::LoadCharAdvance(ImWchar c) const
+{
+    if (DynamicGlyphs == NULL || (int)c >= IndexAdvanceX.Size)
+        return FallbackAdvanceX;
+
+    float advance_x = FallbackAdvanceX;
+    int glyph_index = 0;
+    if (ImFontDynamicSource* src = ImFontDynamicFindSource(this, c, &glyph_index))
+    {
+        int advance, lsb;
+        stbtt_GetGlyphHMetrics(&src->FontInfo, glyph_index, &advance, &lsb);
+        advance_x = ImFontDynamicAdjustAdvanceX(&ContainerAtlas->ConfigData[src->ConfigIndex], src->Scale * advance);
+    }
+    IndexAdvanceX.Data[c] = advance_x; // Kept when the glyph is unloaded
+    return advance_x;
+}
+
+const ImFontGlyph* ImFont::LoadGlyph(ImWchar c) const
+{
+    ImFontDynamicGlyphs* dyn = DynamicGlyphs;
+    int glyph_index = 0;
+    ImFontDynamicSource* src = (dyn != NULL && (int)c < IndexLookup.Size) ? ImFontDynamicFindSource(this, c, &glyph_index) : NULL;
+    if (src == NULL)
+        return FallbackGlyph;
+
+    // Measure as ImFontAtlasBuildMeasureGlyphsJob() does, and find room in a page
+    ImFont* font = const_cast<ImFont*>(this);
+    ImFontAtlas* atlas = ContainerAtlas;
+    const ImFontConfig& cfg = atlas->ConfigData[src->ConfigIndex];
+    int x0, y0, x1, y1;
+    stbtt_GetGlyphBitmapBoxSubpixel(&src->FontInfo, glyph_index, src->Scale * cfg.OversampleH, src->Scale * cfg.OversampleV, 0, 0, &x0, &y0, &x1, &y1);
+    const int w = x1 - x0 + atlas->TexGlyphPadding + cfg.OversampleH - 1;
+    const int h = y1 - y0 + atlas->TexGlyphPadding + cfg.OversampleV - 1;
+    int x = 0, y = 0;
+    int page_n = -1;
+    if (atlas->TexPixelsAlpha8 != NULL && (dyn->FreeGlyphs.Size > 0 || Glyphs.Size < 0xFFFE))
+        page_n = ImFontAtlasDynamicAllocRect(atlas, w, h, &x, &y);
+    if (page_n < 0)
+    {
+        // Keep the layout, draw nothing this frame
+        dyn->Blank = *FallbackGlyph;
+        dyn->Blank.Codepoint = c;
+        dyn->Blank.Visible = 0;
+        dyn->Blank.AdvanceX = GetCharAdvance(c);
+        return &dyn->Blank;
+    }
+
+    // Rasterize as ImFontAtlasBuildRenderGlyphsJob() does, into a clear area
+    int codepoint = (int)c;
+    stbtt_packedchar pc;
+    stbtt_pack_range range;
+    stbtt_pack_context spc;
+    stbrp_rect r;
+    memset(&pc, 0, sizeof(pc));
+    memset(&range, 0, sizeof(range));
+    memset(&spc, 0, sizeof(spc));
+    memset(&r, 0, sizeof(r));
+    range.font_size = cfg.SizePixels;
+    range.array_of_unicode_codepoints = &codepoint;
+    range.num_chars = 1;
+    range.chardata_for_range = &pc;
+    range.h_oversample = (unsigned char)cfg.OversampleH;
+    range.v_oversample = (unsigned char)cfg.OversampleV;
+    spc.width = atlas->TexWidth;
+    spc.height = atlas->TexHeight;
+    spc.stride_in_bytes = atlas->TexWidth;
+    spc.padding = atlas->TexGlyphPadding;
+    spc.pixels = atlas->TexPixelsAlpha8;
+    r.x = (stbrp_coord)x;
+    r.y = (stbrp_coord)y;
+    r.w = (stbrp_coord)w;
+    r.h = (stbrp_coord)h;
+    r.was_packed = 1;
+    stbtt_PackFontRangesRenderIntoRects(&spc, &src->FontInfo, &range, 1, &r);
+    if (cfg.RasterizerMultiply != 1.0f)
+    {
+        unsigned char multiply_table[256];
+        ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
+        ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, atlas->TexPixelsAlpha8, r.x, r.y, r.w, r.h, atlas->TexWidth * 1);
+    }
+    ImFontDynamicPage& page = atlas->DynamicGlyphs->Pages[page_n];
+    ImFontAtlasDynamicUpdateTexRect(atlas, page, x, y, w, h);
+
+    // Register as step 9 of ImFontAtlasBuildWithStbTruetype() does, in the entry of an unloaded glyph if there is one
+    stbtt_aligned_quad q;
+    float unused_x = 0.0f, unused_y = 0.0f;
+    stbtt_GetPackedQuad(&pc, atlas->TexWidth, atlas->TexHeight, 0, &unused_x, &unused_y, &q, 0);
+    const float font_off_x = cfg.GlyphOffset.x;
+    const float font_off_y = cfg.GlyphOffset.y + IM_ROUND(Ascent);
+    const int fallback_glyph_n = (int)(FallbackGlyph - Glyphs.Data);
+    const int metrics_total_surface = MetricsTotalSurface;
+    font->AddGlyph(&cfg, c, q.x0 + font_off_x, q.y0 + font_off_y, q.x1 + font_off_x, q.y1 + font_off_y, q.s0, q.t0, q.s1, q.t1, pc.xadvance);
+    font->DirtyLookupTables = false;
+    font->MetricsTotalSurface = metrics_total_surface; // Baked glyphs only
+    int glyph_n = Glyphs.Size - 1;
+    if (dyn->FreeGlyphs.Size > 0)
+    {
+        glyph_n = dyn->FreeGlyphs.back();
+        dyn->FreeGlyphs.pop_back();
+        font->Glyphs[glyph_n] = font->Glyphs.back();
+        font->Glyphs.pop_back();
+    }
+    font->FallbackGlyph = &font->Glyphs.Data[fallback_glyph_n]; // Glyphs[] may have moved
+    dyn->GlyphPage.resize(Glyphs.Size, (short)-1);
+    dyn->GlyphPage[glyph_n] = (short)page_n;
+    IndexLookup.Data[c] = (ImWchar)glyph_n;
+    IndexAdvanceX.Data[c] = Glyphs.Data[glyph_n].AdvanceX;
+    const int page_4k_n = (int)c / 4096;
+    font->Used4kPagesMap[page_4k_n >> 3] |= 1 << (page_4k_n & 7);
+    ImFontDynamicPageGlyph page_glyph = { font, (unsigned int)c };
+    page.Glyphs.push_back(page_glyph);
+    return &Glyphs.Data[glyph_n];
+}
+
+#else
+
+void ImFontAtlasBuildClearDynamicGlyphs(ImFontAtlas* atlas)     { IM_UNUSED(atlas); }
+static void ImFontDynamicTouchGlyph(const ImFont*, int)         {}
+float ImFont::LoadCharAdvance(ImWchar) const                    { return FallbackAdvanceX; }
+const ImFontGlyph* ImFont::LoadGlyph(ImWchar) const             { return FallbackGlyph; }
+
 #endif // IMGUI_ENABLE_STB_TRUETYPE
 
 void ImFontAtlasBuildSetupFont(ImFontAtlas* atlas, ImFont* font, ImFontConfig* font_config, float ascent, float descent)
@@ -3115,6 +3656,7 @@ ImFont::ImFont()
     ConfigData = NULL;
     ConfigDataCount = 0;
     DirtyLookupTables = false;
+    DynamicGlyphs = NULL;
     Scale = 1.0f;
     Ascent = Descent = 0.0f;
     MetricsTotalSurface = 0;
@@ -3136,6 +3678,7 @@ void    ImFont::ClearOutputData()
     FallbackGlyph = NULL;
     ContainerAtlas = NULL;
     DirtyLookupTables = true;
+    DynamicGlyphs = NULL;   // Owned by ContainerAtlas->DynamicGlyphs
     Ascent = Descent = 0.0f;
     MetricsTotalSurface = 0;
 }
@@ -3310,16 +3853,21 @@ void ImFont::AddRemapChar(ImWchar dst, ImWchar src, bool overwrite_dst)
     IndexAdvanceX[dst] = (src < index_size) ? IndexAdvanceX.Data[src] : 1.0f;
 }
 
+// With ImFontConfig::DynamicGlyphs this rasterizes a glyph not in the texture yet, and keeps the page of the glyph for this frame.
+// The pointer is then only valid until the next glyph is rasterized (Glyphs[] may grow).
 const ImFontGlyph* ImFont::FindGlyph(ImWchar c) const
 {
     if (c >= (size_t)IndexLookup.Size)
         return FallbackGlyph;
     const ImWchar i = IndexLookup.Data[c];
     if (i == (ImWchar)-1)
-        return FallbackGlyph;
+        return DynamicGlyphs ? LoadGlyph(c) : FallbackGlyph;
+    if (DynamicGlyphs)
+        ImFontDynamicTouchGlyph(this, i);
     return &Glyphs.Data[i];
 }
 
+// Doesn't rasterize glyphs of ImFontConfig::DynamicGlyphs
 const ImFontGlyph* ImFont::FindGlyphNoFallback(ImWchar c) const
 {
     if (c >= (size_t)IndexLookup.Size)
@@ -3327,9 +3875,84 @@ const ImFontGlyph* ImFont::FindGlyphNoFallback(ImWchar c) const
     const ImWchar i = IndexLookup.Data[c];
     if (i == (ImWchar)-1)
         return NULL;
+    if (DynamicGlyphs)
+        ImFontDynamicTouchGlyph(this, i);
     return &Glyphs.Data[i];
 }
 
+// Text layout fast path: runs of printable ASCII (0x20..0x7F) need no UTF-8 decoding, no '\n'/'\r' handling, and
+// their glyphs are looked up directly in IndexAdvanceX/IndexLookup. Widths are still summed one glyph at a time,
+// in the same order as the generic path, so results are bit for bit the same.
+// With SSE2 the end of a run is found 16 bytes at a time.
+#if defined(IMGUI_ENABLE_SSE) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define IMGUI_ENABLE_SSE2_TEXT
+static inline int ImTextCountTrailingZeroes(unsigned int mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+static inline bool ImTextIsAsciiPrintable(unsigned char c)
+{
+    return c >= 0x20 && c < 0x80;
+}
+
+// Breaks CalcWordWrapPositionA() looks for in ASCII: blanks and the punctuation it wraps after
+static inline bool ImTextIsAsciiWordChar(unsigned char c)
+{
+    return c > 0x20 && c < 0x80 && c != '.' && c != ',' && c != ';' && c != '!' && c != '?' && c != '\"';
+}
+
+// End of the run of printable ASCII starting at 's'
+static inline const char* ImTextFindAsciiRunEnd(const char* s, const char* s_end)
+{
+#ifdef IMGUI_ENABLE_SSE2_TEXT
+    // Control characters and bytes from 0x80 (negative as signed) all compare less than 0x20
+    const __m128i space = _mm_set1_epi8(0x20);
+    while (s_end - s >= 16)
+    {
+        const int mask = _mm_movemask_epi8(_mm_cmplt_epi8(_mm_loadu_si128((const __m128i*)(const void*)s), space));
+        if (mask != 0)
+            return s + ImTextCountTrailingZeroes((unsigned int)mask);
+        s += 16;
+    }
+#endif
+    while (s < s_end && ImTextIsAsciiPrintable((unsigned char)*s))
+        s++;
+    return s;
+}
+
+// End of the run of ASCII word characters (ImTextIsAsciiWordChar()) starting at 's'
+static inline const char* ImTextFindAsciiWordEnd(const char* s, const char* s_end)
+{
+#ifdef IMGUI_ENABLE_SSE2_TEXT
+    const __m128i blank = _mm_set1_epi8(0x21);
+    const __m128i dot = _mm_set1_epi8('.'), comma = _mm_set1_epi8(','), semicolon = _mm_set1_epi8(';');
+    const __m128i exclamation = _mm_set1_epi8('!'), question = _mm_set1_epi8('?'), quote = _mm_set1_epi8('\"');
+    while (s_end - s >= 16)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(const void*)s);
+        __m128i breaks = _mm_cmplt_epi8(v, blank);
+        breaks = _mm_or_si128(breaks, _mm_or_si128(_mm_cmpeq_epi8(v, dot), _mm_cmpeq_epi8(v, comma)));
+        breaks = _mm_or_si128(breaks, _mm_or_si128(_mm_cmpeq_epi8(v, semicolon), _mm_cmpeq_epi8(v, exclamation)));
+        breaks = _mm_or_si128(breaks, _mm_or_si128(_mm_cmpeq_epi8(v, question), _mm_cmpeq_epi8(v, quote)));
+        const int mask = _mm_movemask_epi8(breaks);
+        if (mask != 0)
+            return s + ImTextCountTrailingZeroes((unsigned int)mask);
+        s += 16;
+    }
+#endif
+    while (s < s_end && ImTextIsAsciiWordChar((unsigned char)*s))
+        s++;
+    return s;
+}
+
 const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const char* text_end, float wrap_width) const
 {
     // Simple word-wrapping for English, not full-featured. Please submit failing cases!
@@ -3355,10 +3978,32 @@ const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const c
     const char* word_end = text;
     const char* prev_word_end = NULL;
     bool inside_word = true;
+    const bool ascii_fast_path = (IndexAdvanceX.Size >= 0x80);
 
     const char* s = text;
     while (s < text_end)
     {
+        // Fast path: the rest of a word of ASCII characters
+        if (inside_word && ascii_fast_path && ImTextIsAsciiWordChar((unsigned char)*s))
+        {
+            const char* word_run_end = ImTextFindAsciiWordEnd(s, text_end);
+            for (; s < word_run_end; s++)
+            {
+                float char_width = IndexAdvanceX.Data[(unsigned char)*s];
+                if (char_width < 0.0f)
+                    char_width = LoadCharAdvance((ImWchar)(unsigned char)*s);
+                word_width += char_width;
+                word_end = s + 1;
+                if (line_width + word_width > wrap_width)
+                {
+                    if (word_width < wrap_width)
+                        s = prev_word_end ? prev_word_end : word_end;
+                    return s;
+                }
+            }
+            continue;
+        }
+
         unsigned int c = (unsigned int)*s;
         const char* next_s;
         if (c < 0x80)
@@ -3384,7 +4029,7 @@ const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const c
             }
         }
 
-        const float char_width = ((int)c < IndexAdvanceX.Size ? IndexAdvanceX.Data[c] : FallbackAdvanceX);
+        const float char_width = GetCharAdvance((ImWchar)c);
         if (ImCharIsBlankW(c))
         {
             if (inside_word)
@@ -3442,6 +4087,7 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
 
     const bool word_wrap_enabled = (wrap_width > 0.0f);
     const char* word_wrap_eol = NULL;
+    const bool ascii_fast_path = (IndexAdvanceX.Size >= 0x80);
 
     const char* s = text_begin;
     while (s < text_end)
@@ -3474,6 +4120,29 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
             }
         }
 
+        // Fast path: a run of printable ASCII, up to the wrap point
+        if (ascii_fast_path && ImTextIsAsciiPrintable((unsigned char)*s))
+        {
+            const char* run_end = ImTextFindAsciiRunEnd(s, word_wrap_enabled ? ImMin(text_end, word_wrap_eol) : text_end);
+            bool max_width_reached = false;
+            for (; s < run_end; s++)
+            {
+                float char_width = IndexAdvanceX.Data[(unsigned char)*s];
+                if (char_width < 0.0f)
+                    char_width = LoadCharAdvance((ImWchar)(unsigned char)*s);
+                char_width *= scale;
+                if (line_width + char_width >= max_width)
+                {
+                    max_width_reached = true;
+                    break;
+                }
+                line_width += char_width;
+            }
+            if (max_width_reached)
+                break;
+            continue;
+        }
+
         // Decode and advance source
         const char* prev_s = s;
         unsigned int c = (unsigned int)*s;
@@ -3501,7 +4170,7 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
                 continue;
         }
 
-        const float char_width = ((int)c < IndexAdvanceX.Size ? IndexAdvanceX.Data[c] : FallbackAdvanceX) * scale;
+        const float char_width = GetCharAdvance((ImWchar)c) * scale;
         if (line_width + char_width >= max_width)
         {
             s = prev_s;
@@ -3594,6 +4263,7 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, const ImVec2& pos, Im
     unsigned int vtx_current_idx = draw_list->_VtxCurrentIdx;
 
     const ImU32 col_untinted = col | ~IM_COL32_A_MASK;
+    const bool ascii_fast_path = (IndexLookup.Size >= 0x80 && !cpu_fine_clip);
 
     while (s < text_end)
     {
@@ -3623,6 +4293,42 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, const ImVec2& pos, Im
             }
         }
 
+        // Fast path: the quads of a run of printable ASCII, up to the wrap point
+        if (ascii_fast_path && ImTextIsAsciiPrintable((unsigned char)*s))
+        {
+            const char* run_end = ImTextFindAsciiRunEnd(s, word_wrap_enabled ? ImMin(text_end, word_wrap_eol) : text_end);
+            for (; s < run_end; s++)
+            {
+                const ImWchar c = (ImWchar)(unsigned char)*s;
+                const ImWchar glyph_n = IndexLookup.Data[c];
+                const ImFontGlyph* glyph = (glyph_n != (ImWchar)-1 && DynamicGlyphs == NULL) ? &Glyphs.Data[glyph_n] : FindGlyph(c);
+                if (glyph == NULL)
+                    continue;
+                if (glyph->Visible)
+                {
+                    const float x1 = x + glyph->X0 * scale;
+                    const float x2 = x + glyph->X1 * scale;
+                    if (x1 <= clip_rect.z && x2 >= clip_rect.x)
+                    {
+                        const float y1 = y + glyph->Y0 * scale;
+                        const float y2 = y + glyph->Y1 * scale;
+                        const ImU32 glyph_col = glyph->Colored ? col_untinted : col;
+                        idx_write[0] = (ImDrawIdx)(vtx_current_idx); idx_write[1] = (ImDrawIdx)(vtx_current_idx+1); idx_write[2] = (ImDrawIdx)(vtx_current_idx+2);
+                        idx_write[3] = (ImDrawIdx)(vtx_current_idx); idx_write[4] = (ImDrawIdx)(vtx_current_idx+2); idx_write[5] = (ImDrawIdx)(vtx_current_idx+3);
+                        vtx_write[0].pos.x = x1; vtx_write[0].pos.y = y1; vtx_write[0].col = glyph_col; vtx_write[0].uv.x = glyph->U0; vtx_write[0].uv.y = glyph->V0;
+                        vtx_write[1].pos.x = x2; vtx_write[1].pos.y = y1; vtx_write[1].col = glyph_col; vtx_write[1].uv.x = glyph->U1; vtx_write[1].uv.y = glyph->V0;
+                        vtx_write[2].pos.x = x2; vtx_write[2].pos.y = y2; vtx_write[2].col = glyph_col; vtx_write[2].uv.x = glyph->U1; vtx_write[2].uv.y = glyph->V1;
+                        vtx_write[3].pos.x = x1; vtx_write[3].pos.y = y2; vtx_write[3].col = glyph_col; vtx_write[3].uv.x = glyph->U0; vtx_write[3].uv.y = glyph->V1;
+                        vtx_write += 4;
+                        vtx_current_idx += 4;
+                        idx_write += 6;
+                    }
+                }
+                x += glyph->AdvanceX * scale;
+            }
+            continue;
+        }
+
         // Decode and advance source
         unsigned int c = (unsigned int)*s;
         if (c < 0x80)
@@ -0,0 +1,484 @@
+// dear imgui: On-disk cache of a built ImFontAtlas
+// (see imgui_font_cache.h for usage)
+
+// CHANGELOG
+//  2026-10-19: Initial version: memory-mapped load of pixels, glyph tables and custom rectangles, keyed by the build inputs.
+
+// File layout (native endian):
+//  ImFontAtlasCacheHeader
+//  Key:        ImWchar size, IMGUI_VERSION_NUM, atlas settings, then every ImFontConfig (font data size and hash,
+//              settings, glyph ranges) and every custom rectangle request. Compared byte for byte on load.
+//  Payload:    Texture size and UVs, custom rectangle positions, per font metrics and glyphs, then the Alpha8 and/or
+//              RGBA32 pixels. Checksummed with ImHashData().
+
+#include "imgui.h"
+#include "imgui_font_cache.h"
+#include "imgui_internal.h"
+#include <stdio.h>
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct ImFontAtlasCacheHeader
+{
+    char            Magic[8];       // "IMFATLAS"
+    ImU32           Version;        // IMGUI_FONT_ATLAS_CACHE_VERSION
+    ImU32           KeySize;
+    ImU32           PayloadSize;
+    ImU32           PayloadHash;
+};
+
+static const char   FONT_ATLAS_CACHE_MAGIC[8] = { 'I', 'M', 'F', 'A', 'T', 'L', 'A', 'S' };
+static const int    FONT_ATLAS_CACHE_GLYPH_SIZE = 4 + 9 * 4;   // Codepoint and flags, AdvanceX, X0..V1
+static const int    FONT_ATLAS_CACHE_TEX_SIZE_MAX = 1024 * 32;
+
+struct ImFontAtlasCacheWriter
+{
+    ImVector<unsigned char> Data;
+
+    void WriteBytes(const void* data, size_t size)  { const int offset = Data.Size; Data.resize(offset + (int)size); if (size > 0) memcpy(Data.Data + offset, data, size); }
+    template<typename T> void Write(const T& value) { WriteBytes(&value, sizeof(T)); }
+};
+
+// Reading past the end returns zeroes and sets Overrun
+struct ImFontAtlasCacheReader
+{
+    const unsigned char* Ptr;
+    const unsigned char* End;
+    bool            Overrun;
+
+    ImFontAtlasCacheReader(const unsigned char* data, size_t size) { Ptr = data; End = data + size; Overrun = false; }
+    const unsigned char* ReadBytes(size_t size)     { if ((size_t)(End - Ptr) < size) { Overrun = true; return NULL; } const unsigned char* p = Ptr; Ptr += size; return p; }
+    template<typename T> T Read()                   { T value; memset((void*)&value, 0, sizeof(T)); if (const unsigned char* p = ReadBytes(sizeof(T))) memcpy(&value, p, sizeof(T)); return value; }
+};
+
+//-----------------------------------------------------------------------------
+// Read-only mapping of the whole file
+//-----------------------------------------------------------------------------
+
+struct ImFontAtlasCacheMapping
+{
+    const unsigned char* Data;
+    size_t          Size;
+#ifdef _WIN32
+    HANDLE          File;
+    HANDLE          Mapping;
+#else
+    int             File;
+#endif
+
+    ImFontAtlasCacheMapping();
+    ~ImFontAtlasCacheMapping();
+    bool            Open(const char* filename);     // false when the file can't be opened, an empty file maps to Size == 0
+};
+
+#ifdef _WIN32
+ImFontAtlasCacheMapping::ImFontAtlasCacheMapping()  { Data = NULL; Size = 0; File = INVALID_HANDLE_VALUE; Mapping = NULL; }
+
+ImFontAtlasCacheMapping::~ImFontAtlasCacheMapping()
+{
+    if (Data)
+        ::UnmapViewOfFile(Data);
+    if (Mapping)
+        ::CloseHandle(Mapping);
+    if (File != INVALID_HANDLE_VALUE)
+        ::CloseHandle(File);
+}
+
+bool ImFontAtlasCacheMapping::Open(const char* filename)
+{
+    // UTF-8 filename, like ImFileOpen()
+    const int filename_wsize = ::MultiByteToWideChar(CP_UTF8, 0, filename, -1, NULL, 0);
+    ImVector<wchar_t> filename_w;
+    filename_w.resize(filename_wsize);
+    ::MultiByteToWideChar(CP_UTF8, 0, filename, -1, filename_w.Data, filename_wsize);
+    File = ::CreateFileW(filename_w.Data, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (File == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER file_size;
+    if (!::GetFileSizeEx(File, &file_size))
+        return false;
+    if (file_size.QuadPart == 0)
+        return true;
+    Mapping = ::CreateFileMappingW(File, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!Mapping)
+        return false;
+    Data = (const unsigned char*)::MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+    Size = Data ? (size_t)file_size.QuadPart : 0;
+    return Data != NULL;
+}
+#else
+ImFontAtlasCacheMapping::ImFontAtlasCacheMapping()  { Data = NULL; Size = 0; File = -1; }
+
+ImFontAtlasCacheMapping::~ImFontAtlasCacheMapping()
+{
+    if (Data)
+        munmap((void*)Data, Size);
+    if (File != -1)
+        close(File);
+}
+
+bool ImFontAtlasCacheMapping::Open(const char* filename)
+{
+    File = open(filename, O_RDONLY);
+    if (File == -1)
+        return false;
+    struct stat st;
+    if (fstat(File, &st) != 0)
+        return false;
+    if (st.st_size == 0)
+        return true;
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, File, 0);
+    if (data == MAP_FAILED)
+        return false;
+    Data = (const unsigned char*)data;
+    Size = (size_t)st.st_size;
+    return true;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+// Key and payload
+//-----------------------------------------------------------------------------
+
+// The default builder only, and no ImFontConfig::DynamicGlyphs: their glyphs are rasterized while running, not by Build()
+static bool ImFontAtlasCache_IsSupported(ImFontAtlas* atlas)
+{
+#if defined(IMGUI_ENABLE_STB_TRUETYPE) && !defined(IMGUI_ENABLE_FREETYPE)
+    if (atlas->FontBuilderIO != NULL && atlas->FontBuilderIO != ImFontAtlasGetBuilderForStbTruetype())
+        return false;
+    for (int n = 0; n < atlas->ConfigData.Size; n++)
+        if (atlas->ConfigData[n].DynamicGlyphs)
+            return false;
+    return true;
+#else
+    IM_UNUSED(atlas);
+    return false;
+#endif
+}
+
+static int ImFontAtlasCache_FindFont(ImFontAtlas* atlas, const ImFont* font)
+{
+    for (int n = 0; n < atlas->Fonts.Size; n++)
+        if (atlas->Fonts[n] == font)
+            return n;
+    return -1;
+}
+
+// Everything Build() reads
+static void ImFontAtlasCache_WriteKey(ImFontAtlas* atlas, ImFontAtlasCacheWriter* w)
+{
+    w->Write((ImU32)sizeof(ImWchar));
+    w->Write((ImU32)IMGUI_VERSION_NUM);
+    w->Write(atlas->Flags);
+    w->Write(atlas->TexDesiredWidth);
+    w->Write(atlas->TexGlyphPadding);
+    w->Write(atlas->FontBuilderFlags);
+    w->Write(atlas->Fonts.Size);
+    w->Write(atlas->ConfigData.Size);
+    w->Write(atlas->CustomRects.Size);
+    for (int cfg_n = 0; cfg_n < atlas->ConfigData.Size; cfg_n++)
+    {
+        const ImFontConfig& cfg = atlas->ConfigData[cfg_n];
+        w->Write(cfg.FontDataSize);
+        w->Write(ImHashData(cfg.FontData, (size_t)cfg.FontDataSize));
+        w->Write(cfg.FontNo);
+        w->Write(cfg.SizePixels);
+        w->Write(cfg.OversampleH);
+        w->Write(cfg.OversampleV);
+        w->Write((ImU8)cfg.PixelSnapH);
+        w->Write(cfg.GlyphExtraSpacing);
+        w->Write(cfg.GlyphOffset);
+        w->Write(cfg.GlyphMinAdvanceX);
+        w->Write(cfg.GlyphMaxAdvanceX);
+        w->Write((ImU8)cfg.MergeMode);
+        w->Write(cfg.FontBuilderFlags);
+        w->Write(cfg.RasterizerMultiply);
+        w->Write(cfg.EllipsisChar);
+        w->Write(ImFontAtlasCache_FindFont(atlas, cfg.DstFont));
+
+        const ImWchar* ranges = cfg.GlyphRanges ? cfg.GlyphRanges : atlas->GetGlyphRangesDefault();
+        int ranges_count = 0;
+        while (ranges[ranges_count * 2] && ranges[ranges_count * 2 + 1])
+            ranges_count++;
+        w->Write(ranges_count);
+        w->WriteBytes(ranges, sizeof(ImWchar) * 2 * ranges_count);
+    }
+    for (int rect_n = 0; rect_n < atlas->CustomRects.Size; rect_n++)
+    {
+        const ImFontAtlasCustomRect& r = atlas->CustomRects[rect_n];
+        w->Write(r.Width);
+        w->Write(r.Height);
+        w->Write(r.GlyphID);
+        w->Write(r.GlyphAdvanceX);
+        w->Write(r.GlyphOffset);
+        w->Write(ImFontAtlasCache_FindFont(atlas, r.Font));
+    }
+}
+
+// Everything Build() produces
+static void ImFontAtlasCache_WritePayload(ImFontAtlas* atlas, ImFontAtlasCacheWriter* w)
+{
+    const bool write_alpha8 = atlas->TexPixelsAlpha8 != NULL;
+    const bool write_rgba32 = atlas->TexPixelsRGBA32 != NULL && (atlas->TexPixelsUseColors || !write_alpha8);
+    w->Write(atlas->TexWidth);
+    w->Write(atlas->TexHeight);
+    w->Write((ImU8)atlas->TexPixelsUseColors);
+    w->Write((ImU8)write_alpha8);
+    w->Write((ImU8)write_rgba32);
+    w->Write(atlas->TexUvWhitePixel);
+    w->Write((int)IM_ARRAYSIZE(atlas->TexUvLines));
+    w->Write(atlas->TexUvLines);
+    for (int rect_n = 0; rect_n < atlas->CustomRects.Size; rect_n++)
+    {
+        w->Write(atlas->CustomRects[rect_n].X);
+        w->Write(atlas->CustomRects[rect_n].Y);
+    }
+    for (int font_n = 0; font_n < atlas->Fonts.Size; font_n++)
+    {
+        const ImFont* font = atlas->Fonts[font_n];
+        const bool config_in_atlas = font->ConfigData >= atlas->ConfigData.Data && font->ConfigData < atlas->ConfigData.Data + atlas->ConfigData.Size;
+        w->Write(font->FontSize);
+        w->Write(font->Ascent);
+        w->Write(font->Descent);
+        w->Write(config_in_atlas ? (int)(font->ConfigData - atlas->ConfigData.Data) : -1);
+        w->Write((int)font->ConfigDataCount);
+        w->Write(font->MetricsTotalSurface);
+        w->Write(font->Glyphs.Size);
+        for (int glyph_n = 0; glyph_n < font->Glyphs.Size; glyph_n++)
+        {
+            const ImFontGlyph& glyph = font->Glyphs[glyph_n];
+            w->Write((ImU32)(glyph.Codepoint | (glyph.Visible << 30) | (glyph.Colored << 31)));
+            w->Write(glyph.AdvanceX);
+            w->Write(glyph.X0); w->Write(glyph.Y0); w->Write(glyph.X1); w->Write(glyph.Y1);
+            w->Write(glyph.U0); w->Write(glyph.V0); w->Write(glyph.U1); w->Write(glyph.V1);
+        }
+    }
+    const size_t pixel_count = (size_t)atlas->TexWidth * (size_t)atlas->TexHeight;
+    if (write_alpha8)
+        w->WriteBytes(atlas->TexPixelsAlpha8, pixel_count);
+    if (write_rgba32)
+        w->WriteBytes(atlas->TexPixelsRGBA32, pixel_count * 4);
+}
+
+struct ImFontAtlasCacheFont
+{
+    float           FontSize;
+    float           Ascent;
+    float           Descent;
+    int             ConfigIndex;
+    int             ConfigDataCount;
+    int             MetricsTotalSurface;
+    int             GlyphsCount;
+    const unsigned char* Glyphs;        // GlyphsCount * FONT_ATLAS_CACHE_GLYPH_SIZE bytes in the mapping
+};
+
+//-----------------------------------------------------------------------------
+// Public API
+//-----------------------------------------------------------------------------
+
+ImFontAtlasCacheResult ImFontAtlasCache_Load(ImFontAtlas* atlas, const char* filename)
+{
+    IM_ASSERT(!atlas->Locked && "Cannot modify a locked ImFontAtlas between NewFrame() and EndFrame/Render()!");
+    if (!ImFontAtlasCache_IsSupported(atlas))
+        return ImFontAtlasCacheResult_Unsupported;
+
+    // Same inputs as Build() would see
+    if (atlas->ConfigData.Size == 0)
+        atlas->AddFontDefault();
+    ImFontAtlasBuildInit(atlas);
+
+    ImFontAtlasCacheMapping file;
+    if (!file.Open(filename))
+        return ImFontAtlasCacheResult_NoFile;
+    ImFontAtlasCacheHeader header;
+    if (file.Size < sizeof(header))
+        return ImFontAtlasCacheResult_BadHeader;
+    memcpy(&header, file.Data, sizeof(header));
+    if (memcmp(header.Magic, FONT_ATLAS_CACHE_MAGIC, sizeof(header.Magic)) != 0)
+        return ImFontAtlasCacheResult_BadHeader;
+    if (header.Version != IMGUI_FONT_ATLAS_CACHE_VERSION)
+        return ImFontAtlasCacheResult_OldVersion;
+    if ((ImU64)sizeof(header) + header.KeySize + header.PayloadSize != (ImU64)file.Size)
+        return ImFontAtlasCacheResult_BadHeader;
+
+    ImFontAtlasCacheWriter key;
+    ImFontAtlasCache_WriteKey(atlas, &key);
+    const unsigned char* file_key = file.Data + sizeof(header);
+    if (header.KeySize != (ImU32)key.Data.Size || memcmp(file_key, key.Data.Data, (size_t)key.Data.Size) != 0)
+        return ImFontAtlasCacheResult_KeyMismatch;
+
+    const unsigned char* payload = file_key + header.KeySize;
+    if (ImHashData(payload, header.PayloadSize) != header.PayloadHash)
+        return ImFontAtlasCacheResult_Corrupt;
+
+    // Read and check everything before touching the atlas
+    ImFontAtlasCacheReader r(payload, header.PayloadSize);
+    const int tex_width = r.Read<int>();
+    const int tex_height = r.Read<int>();
+    const bool tex_use_colors = r.Read<ImU8>() != 0;
+    const bool has_alpha8 = r.Read<ImU8>() != 0;
+    const bool has_rgba32 = r.Read<ImU8>() != 0;
+    const ImVec2 tex_uv_white_pixel = r.Read<ImVec2>();
+    const int tex_uv_lines_count = r.Read<int>();
+    const unsigned char* tex_uv_lines = r.ReadBytes(sizeof(atlas->TexUvLines));
+    if (tex_width <= 0 || tex_width > FONT_ATLAS_CACHE_TEX_SIZE_MAX || tex_height <= 0 || tex_height > FONT_ATLAS_CACHE_TEX_SIZE_MAX || (!has_alpha8 && !has_rgba32) || tex_uv_lines_count != IM_ARRAYSIZE(atlas->TexUvLines))
+        return ImFontAtlasCacheResult_Corrupt;
+
+    const unsigned char* rects = r.ReadBytes(sizeof(unsigned short) * 2 * atlas->CustomRects.Size);
+    for (int rect_n = 0; rect_n < atlas->CustomRects.Size && rects != NULL; rect_n++)
+    {
+        unsigned short pos[2];
+        memcpy(pos, rects + rect_n * sizeof(pos), sizeof(pos));
+        const ImFontAtlasCustomRect& rect = atlas->CustomRects[rect_n];
+        if (pos[0] != 0xFFFF && (pos[0] + rect.Width > tex_width || pos[1] + rect.Height > tex_height))
+            return ImFontAtlasCacheResult_Corrupt;
+    }
+
+    ImVector<ImFontAtlasCacheFont> fonts;
+    fonts.resize(atlas->Fonts.Size);
+    for (int font_n = 0; font_n < fonts.Size; font_n++)
+    {
+        ImFontAtlasCacheFont& font = fonts[font_n];
+        font.FontSize = r.Read<float>();
+        font.Ascent = r.Read<float>();
+        font.Descent = r.Read<float>();
+        font.ConfigIndex = r.Read<int>();
+        font.ConfigDataCount = r.Read<int>();
+        font.MetricsTotalSurface = r.Read<int>();
+        font.GlyphsCount = r.Read<int>();
+        if (font.ConfigIndex < -1 || font.ConfigIndex >= atlas->ConfigData.Size || font.ConfigDataCount < 0 || font.ConfigDataCount > atlas->ConfigData.Size || font.GlyphsCount < 0 || font.GlyphsCount >= 0xFFFF)
+            return ImFontAtlasCacheResult_Corrupt;
+        font.Glyphs = r.ReadBytes((size_t)font.GlyphsCount * FONT_ATLAS_CACHE_GLYPH_SIZE);
+        for (int glyph_n = 0; glyph_n < font.GlyphsCount && font.Glyphs != NULL; glyph_n++)
+        {
+            ImU32 codepoint;
+            memcpy(&codepoint, font.Glyphs + glyph_n * FONT_ATLAS_CACHE_GLYPH_SIZE, sizeof(codepoint));
+            if ((codepoint & 0x3FFFFFFF) > IM_UNICODE_CODEPOINT_MAX)
+                return ImFontAtlasCacheResult_Corrupt;
+        }
+    }
+
+    const size_t pixel_count = (size_t)tex_width * (size_t)tex_height;
+    const unsigned char* alpha8 = has_alpha8 ? r.ReadBytes(pixel_count) : NULL;
+    const unsigned char* rgba32 = has_rgba32 ? r.ReadBytes(pixel_count * 4) : NULL;
+    if (r.Overrun || r.Ptr != r.End)
+        return ImFontAtlasCacheResult_Corrupt;
+
+    // Fill the atlas like Build() does
+    atlas->ClearTexData();
+    atlas->TexID = (ImTextureID)NULL;
+    atlas->TexWidth = tex_width;
+    atlas->TexHeight = tex_height;
+    atlas->TexUvScale = ImVec2(1.0f / tex_width, 1.0f / tex_height);
+    atlas->TexUvWhitePixel = tex_uv_white_pixel;
+    memcpy(atlas->TexUvLines, tex_uv_lines, sizeof(atlas->TexUvLines));
+    if (alpha8)
+    {
+        atlas->TexPixelsAlpha8 = (unsigned char*)IM_ALLOC(pixel_count);
+        memcpy(atlas->TexPixelsAlpha8, alpha8, pixel_count);
+    }
+    if (rgba32)
+    {
+        atlas->TexPixelsRGBA32 = (unsigned int*)IM_ALLOC(pixel_count * 4);
+        memcpy(atlas->TexPixelsRGBA32, rgba32, pixel_count * 4);
+    }
+    atlas->TexPixelsUseColors = tex_use_colors;
+
+    for (int rect_n = 0; rect_n < atlas->CustomRects.Size; rect_n++)
+    {
+        memcpy(&atlas->CustomRects[rect_n].X, rects + rect_n * 4, sizeof(unsigned short));
+        memcpy(&atlas->CustomRects[rect_n].Y, rects + rect_n * 4 + 2, sizeof(unsigned short));
+    }
+
+    for (int font_n = 0; font_n < fonts.Size; font_n++)
+    {
+        const ImFontAtlasCacheFont& src = fonts[font_n];
+        ImFont* font = atlas->Fonts[font_n];
+        font->ClearOutputData();
+        font->FontSize = src.FontSize;
+        font->Ascent = src.Ascent;
+        font->Descent = src.Descent;
+        font->ConfigData = src.ConfigIndex >= 0 ? &atlas->ConfigData[src.ConfigIndex] : NULL;
+        font->ConfigDataCount = (short)src.ConfigDataCount;
+        font->ContainerAtlas = atlas;
+        font->MetricsTotalSurface = src.MetricsTotalSurface;
+        font->Glyphs.resize(src.GlyphsCount);
+        for (int glyph_n = 0; glyph_n < src.GlyphsCount; glyph_n++)
+        {
+            float values[9];
+            ImU32 codepoint;
+            const unsigned char* data = src.Glyphs + glyph_n * FONT_ATLAS_CACHE_GLYPH_SIZE;
+            memcpy(&codepoint, data, sizeof(codepoint));
+            memcpy(values, data + sizeof(codepoint), sizeof(values));
+            ImFontGlyph& glyph = font->Glyphs[glyph_n];
+            glyph.Codepoint = codepoint & 0x3FFFFFFF;
+            glyph.Visible = (codepoint >> 30) & 1;
+            glyph.Colored = (codepoint >> 31) & 1;
+            glyph.AdvanceX = values[0];
+            glyph.X0 = values[1]; glyph.Y0 = values[2]; glyph.X1 = values[3]; glyph.Y1 = values[4];
+            glyph.U0 = values[5]; glyph.V0 = values[6]; glyph.U1 = values[7]; glyph.V1 = values[8];
+        }
+        if (font->Glyphs.Size > 0)
+            font->BuildLookupTable();
+    }
+    atlas->TexReady = true;
+    return ImFontAtlasCacheResult_Loaded;
+}
+
+bool ImFontAtlasCache_Save(ImFontAtlas* atlas, const char* filename)
+{
+    if (!atlas->IsBuilt() || !ImFontAtlasCache_IsSupported(atlas) || (atlas->TexPixelsAlpha8 == NULL && atlas->TexPixelsRGBA32 == NULL))
+        return false;
+
+    ImFontAtlasCacheWriter key, payload;
+    ImFontAtlasCache_WriteKey(atlas, &key);
+    ImFontAtlasCache_WritePayload(atlas, &payload);
+    ImFontAtlasCacheHeader header;
+    memcpy(header.Magic, FONT_ATLAS_CACHE_MAGIC, sizeof(header.Magic));
+    header.Version = IMGUI_FONT_ATLAS_CACHE_VERSION;
+    header.KeySize = (ImU32)key.Data.Size;
+    header.PayloadSize = (ImU32)payload.Data.Size;
+    header.PayloadHash = ImHashData(payload.Data.Data, (size_t)payload.Data.Size);
+
+    ImGuiTextBuffer temp_filename;
+    temp_filename.appendf("%s.tmp", filename);
+    ImFileHandle f = ImFileOpen(temp_filename.c_str(), "wb");
+    if (!f)
+        return false;
+    bool ok = ImFileWrite(&header, sizeof(header), 1, f) == 1;
+    ok = ok && ImFileWrite(key.Data.Data, (ImU64)key.Data.Size, 1, f) == 1;
+    ok = ok && ImFileWrite(payload.Data.Data, (ImU64)payload.Data.Size, 1, f) == 1;
+    ok = ImFileClose(f) && ok;
+    if (ok)
+    {
+        remove(filename);
+        ok = rename(temp_filename.c_str(), filename) == 0;
+    }
+    if (!ok)
+        remove(temp_filename.c_str());
+    return ok;
+}
+
+const char* ImFontAtlasCache_GetResultName(ImFontAtlasCacheResult result)
+{
+    switch (result)
+    {
+    case ImFontAtlasCacheResult_Loaded:         return "Loaded";
+    case ImFontAtlasCacheResult_NoFile:         return "NoFile";
+    case ImFontAtlasCacheResult_Unsupported:    return "Unsupported";
+    case ImFontAtlasCacheResult_BadHeader:      return "BadHeader";
+    case ImFontAtlasCacheResult_OldVersion:     return "OldVersion";
+    case ImFontAtlasCacheResult_KeyMismatch:    return "KeyMismatch";
+    case ImFontAtlasCacheResult_Corrupt:        return "Corrupt";
+    }
+    return "Unknown";
+}
@@ -0,0 +1,40 @@
+// dear imgui: On-disk cache of a built ImFontAtlas
+// Build() rasterizes every glyph of every font at every launch. The cache stores what it produces (pixels, glyph
+// tables, custom rectangle positions, baked line UVs) in one binary file, loading it maps the file and fills the
+// atlas without rasterizing anything:
+//
+//   if (ImFontAtlasCache_Load(io.Fonts, "imgui_fonts.cache") != ImFontAtlasCacheResult_Loaded)
+//   {
+//       io.Fonts->Build();
+//       ImFontAtlasCache_Save(io.Fonts, "imgui_fonts.cache");
+//   }
+//
+// The file is keyed by everything Build() reads: a hash and the size of every font file, sizes, glyph ranges, all
+// ImFontConfig settings, atlas flags and custom rectangles. Any change gives ImFontAtlasCacheResult_KeyMismatch and the
+// atlas is built (and the cache written) again. The whole payload is checksummed, a truncated or damaged file is
+// rejected as well. The fonts still need to be added (their data is part of the key), only their rasterization is skipped.
+// The layout is native endian, and only for the default stb_truetype builder without ImFontConfig::DynamicGlyphs.
+
+#pragma once
+#include "imgui.h"      // IMGUI_API
+
+// Bump when the layout of the file changes, older files are then ignored
+#define IMGUI_FONT_ATLAS_CACHE_VERSION  1
+
+enum ImFontAtlasCacheResult
+{
+    ImFontAtlasCacheResult_Loaded,
+    ImFontAtlasCacheResult_NoFile,
+    ImFontAtlasCacheResult_Unsupported,     // Custom font builder, or a font with ImFontConfig::DynamicGlyphs
+    ImFontAtlasCacheResult_BadHeader,       // Not a cache file, or truncated
+    ImFontAtlasCacheResult_OldVersion,
+    ImFontAtlasCacheResult_KeyMismatch,     // Made from other fonts or settings
+    ImFontAtlasCacheResult_Corrupt          // Checksum or content doesn't add up
+};
+
+// Fill a not yet built atlas from the cache file. Adds the default font first when none was added, like Build().
+// On anything but _Loaded the atlas is left as it was.
+IMGUI_API ImFontAtlasCacheResult    ImFontAtlasCache_Load(ImFontAtlas* atlas, const char* filename);
+// Write a built atlas, through a temporary file so a crash never leaves half a cache behind.
+IMGUI_API bool                      ImFontAtlasCache_Save(ImFontAtlas* atlas, const char* filename);
+IMGUI_API const char*               ImFontAtlasCache_GetResultName(ImFontAtlasCacheResult result);
@@ -4,6 +4,7 @@
 // Implemented features:
 //  [X] Renderer: User texture binding. Use 'ID3D11ShaderResourceView*' as ImTextureID. Read the FAQ about ImTextureID!
 //  [X] Renderer: Support for large meshes (64k+ vertices) with 16-bit indices.
+//  [X] Renderer: Font atlas regions changed after the build (ImFontConfig::DynamicGlyphs), see ImFontAtlas::TexUpdates.
 
 // You can use unmodified imgui_impl_* files in your project. See examples/ folder for examples of using this.
 // Prefer including the entire imgui/ repository into your project (either as a copy or as a submodule), and only build the backends you need.
@@ -12,6 +13,9 @@
 
 // CHANGELOG
 // (minor and older changes stripped away, please see git history for details)
+//  2026-10-19: DirectX11: Upload the font atlas regions listed in io.Fonts->TexUpdates (glyphs rasterized on demand) before rendering.
+//  2026-10-19: DirectX11: Added optional ring buffer upload with WRITE_NO_OVERWRITE, skipping of unchanged draw lists and upload statistics (see ImGui_ImplDX11_SetUploadMode()). Buffers grow geometrically.
+//  2026-10-19: DirectX11: Skip the vertex/index upload when the draw data of the last upload is rendered again (see ImGui::ReuseLastFrame()).
 //  2021-06-29: Reorganized backend to pull data from a single structure to facilitate usage with multiple-contexts (all g_XXXX access changed to bd->XXXX).
 //  2021-05-19: DirectX11: Replaced direct access to ImDrawCmd::TextureId with a call to ImDrawCmd::GetTexID(). (will become a requirement)
 //  2021-02-18: DirectX11: Change blending equation to preserve alpha in output buffer.
@@ -31,6 +35,7 @@
 
 #include "imgui.h"
 #include "imgui_impl_dx11.h"
+#include "imgui_impl_dx11_upload.h"
 
 // DirectX
 #include <stdio.h>
@@ -57,10 +62,11 @@ struct ImGui_ImplDX11_Data
     ID3D11RasterizerState*      pRasterizerState;
     ID3D11BlendState*           pBlendState;
     ID3D11DepthStencilState*    pDepthStencilState;
-    int                         VertexBufferSize;
-    int                         IndexBufferSize;
+    int                         UploadedFrame;              // ImGui frame count of the draw data in pVB/pIB, -1 when they need an upload
+    const ImDrawData*           UploadedDrawData;
+    ImGui_ImplDX11_UploadPlan   Upload;
 
-    ImGui_ImplDX11_Data()       { memset((void*)this, 0, sizeof(*this)); VertexBufferSize = 5000; IndexBufferSize = 10000; }
+    ImGui_ImplDX11_Data()       { memset((void*)this, 0, sizeof(*this)); UploadedFrame = -1; }
 };
 
 struct VERTEX_CONSTANT_BUFFER
@@ -123,53 +129,83 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
     ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
     ID3D11DeviceContext* ctx = bd->pd3dDeviceContext;
 
-    // Create and grow vertex/index buffers if needed
-    if (!bd->pVB || bd->VertexBufferSize < draw_data->TotalVtxCount)
+    // Upload font atlas regions changed since the last frame (glyphs rasterized on demand)
+    ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+    if (atlas->TexUpdates.Size > 0 && bd->pFontTextureView && atlas->TexPixelsRGBA32)
     {
-        if (bd->pVB) { bd->pVB->Release(); bd->pVB = NULL; }
-        bd->VertexBufferSize = draw_data->TotalVtxCount + 5000;
-        D3D11_BUFFER_DESC desc;
-        memset(&desc, 0, sizeof(D3D11_BUFFER_DESC));
-        desc.Usage = D3D11_USAGE_DYNAMIC;
-        desc.ByteWidth = bd->VertexBufferSize * sizeof(ImDrawVert);
-        desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-        desc.MiscFlags = 0;
-        if (bd->pd3dDevice->CreateBuffer(&desc, NULL, &bd->pVB) < 0)
-            return;
-    }
-    if (!bd->pIB || bd->IndexBufferSize < draw_data->TotalIdxCount)
-    {
-        if (bd->pIB) { bd->pIB->Release(); bd->pIB = NULL; }
-        bd->IndexBufferSize = draw_data->TotalIdxCount + 10000;
-        D3D11_BUFFER_DESC desc;
-        memset(&desc, 0, sizeof(D3D11_BUFFER_DESC));
-        desc.Usage = D3D11_USAGE_DYNAMIC;
-        desc.ByteWidth = bd->IndexBufferSize * sizeof(ImDrawIdx);
-        desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-        if (bd->pd3dDevice->CreateBuffer(&desc, NULL, &bd->pIB) < 0)
-            return;
+        ID3D11Resource* pTexture = NULL;
+        bd->pFontTextureView->GetResource(&pTexture);
+        for (int n = 0; n < atlas->TexUpdates.Size; n++)
+        {
+            const ImFontAtlasTexUpdate& update = atlas->TexUpdates[n];
+            D3D11_BOX box = { (UINT)update.X, (UINT)update.Y, 0, (UINT)(update.X + update.Width), (UINT)(update.Y + update.Height), 1 };
+            ctx->UpdateSubresource(pTexture, 0, &box, atlas->TexPixelsRGBA32 + update.X + update.Y * atlas->TexWidth, atlas->TexWidth * 4, 0);
+        }
+        pTexture->Release();
     }
+    atlas->TexUpdates.resize(0);
 
-    // Upload vertex/index data into a single contiguous GPU buffer
-    D3D11_MAPPED_SUBRESOURCE vtx_resource, idx_resource;
-    if (ctx->Map(bd->pVB, 0, D3D11_MAP_WRITE_DISCARD, 0, &vtx_resource) != S_OK)
-        return;
-    if (ctx->Map(bd->pIB, 0, D3D11_MAP_WRITE_DISCARD, 0, &idx_resource) != S_OK)
-        return;
-    ImDrawVert* vtx_dst = (ImDrawVert*)vtx_resource.pData;
-    ImDrawIdx* idx_dst = (ImDrawIdx*)idx_resource.pData;
-    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    // Upload vertex/index data, see imgui_impl_dx11_upload.h for where each draw list goes
+    // A frame skipped with ImGui::ReuseLastFrame() keeps the same draw data and frame count, the buffers still hold it.
+    ImGui_ImplDX11_UploadPlan& upload = bd->Upload;
+    if (!bd->pVB || !bd->pIB || bd->UploadedFrame != ImGui::GetFrameCount() || bd->UploadedDrawData != draw_data)
     {
-        const ImDrawList* cmd_list = draw_data->CmdLists[n];
-        memcpy(vtx_dst, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
-        memcpy(idx_dst, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
-        vtx_dst += cmd_list->VtxBuffer.Size;
-        idx_dst += cmd_list->IdxBuffer.Size;
+        bd->UploadedFrame = -1;
+        if (!bd->pVB || !bd->pIB)
+            upload.Reset();
+        upload.Plan(draw_data);
+
+        // Create and grow vertex/index buffers if needed
+        if (upload.Reallocate)
+        {
+            if (bd->pVB) { bd->pVB->Release(); bd->pVB = NULL; }
+            if (bd->pIB) { bd->pIB->Release(); bd->pIB = NULL; }
+            D3D11_BUFFER_DESC desc;
+            memset(&desc, 0, sizeof(D3D11_BUFFER_DESC));
+            desc.Usage = D3D11_USAGE_DYNAMIC;
+            desc.ByteWidth = upload.VtxCapacity * sizeof(ImDrawVert);
+            desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+            desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+            desc.MiscFlags = 0;
+            if (bd->pd3dDevice->CreateBuffer(&desc, NULL, &bd->pVB) < 0)
+                return;
+            desc.ByteWidth = upload.IdxCapacity * sizeof(ImDrawIdx);
+            desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+            if (bd->pd3dDevice->CreateBuffer(&desc, NULL, &bd->pIB) < 0)
+                return;
+        }
+
+        if (upload.Stats.FrameUploadedBytes != 0)
+        {
+            // NO_OVERWRITE: the GPU may still read the regions written by earlier frames, we only write after them
+            D3D11_MAP map_type = upload.Discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+            D3D11_MAPPED_SUBRESOURCE vtx_resource, idx_resource;
+            if (ctx->Map(bd->pVB, 0, map_type, 0, &vtx_resource) != S_OK)
+            {
+                upload.Reset();
+                return;
+            }
+            if (ctx->Map(bd->pIB, 0, map_type, 0, &idx_resource) != S_OK)
+            {
+                ctx->Unmap(bd->pVB, 0);
+                upload.Reset();
+                return;
+            }
+            ImDrawVert* vtx_dst = (ImDrawVert*)vtx_resource.pData;
+            ImDrawIdx* idx_dst = (ImDrawIdx*)idx_resource.pData;
+            for (const ImGui_ImplDX11_ListPlacement& placement : upload.Lists)
+            {
+                if (!placement.Upload)
+                    continue;
+                memcpy(vtx_dst + placement.VtxOffset, placement.List->VtxBuffer.Data, placement.VtxCount * sizeof(ImDrawVert));
+                memcpy(idx_dst + placement.IdxOffset, placement.List->IdxBuffer.Data, placement.IdxCount * sizeof(ImDrawIdx));
+            }
+            ctx->Unmap(bd->pVB, 0);
+            ctx->Unmap(bd->pIB, 0);
+        }
+        bd->UploadedFrame = ImGui::GetFrameCount();
+        bd->UploadedDrawData = draw_data;
     }
-    ctx->Unmap(bd->pVB, 0);
-    ctx->Unmap(bd->pIB, 0);
 
     // Setup orthographic projection matrix into our constant buffer
     // Our visible imgui space lies from draw_data->DisplayPos (top left) to draw_data->DisplayPos+data_data->DisplaySize (bottom right). DisplayPos is (0,0) for single viewport apps.
@@ -242,13 +278,13 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
     ImGui_ImplDX11_SetupRenderState(draw_data, ctx);
 
     // Render command lists
-    // (Because we merged all buffers into a single one, we maintain our own offset into them)
-    int global_idx_offset = 0;
-    int global_vtx_offset = 0;
+    // (Because we merged all buffers into a single one, each list starts at its own offset into them)
     ImVec2 clip_off = draw_data->DisplayPos;
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
         const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        const int global_idx_offset = upload.Lists[n].IdxOffset;
+        const int global_vtx_offset = upload.Lists[n].VtxOffset;
         for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
         {
             const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
@@ -279,8 +315,6 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
                 ctx->DrawIndexed(pcmd->ElemCount, pcmd->IdxOffset + global_idx_offset, pcmd->VtxOffset + global_vtx_offset);
             }
         }
-        global_idx_offset += cmd_list->IdxBuffer.Size;
-        global_vtx_offset += cmd_list->VtxBuffer.Size;
     }
 
     // Restore modified DX state
@@ -585,6 +619,23 @@ void ImGui_ImplDX11_Shutdown()
     IM_DELETE(bd);
 }
 
+void ImGui_ImplDX11_SetUploadMode(bool ring_buffer, bool skip_unchanged_lists)
+{
+    ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
+    IM_ASSERT(bd != NULL && "Did you call ImGui_ImplDX11_Init()?");
+    bd->Upload.Ring = ring_buffer;
+    bd->Upload.SkipUnchanged = skip_unchanged_lists;
+    bd->Upload.Lists.resize(0);     // Not hashed in the same mode
+    bd->UploadedFrame = -1;
+}
+
+void ImGui_ImplDX11_GetUploadStats(ImGui_ImplDX11_UploadStats* out_stats)
+{
+    ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
+    IM_ASSERT(bd != NULL && "Did you call ImGui_ImplDX11_Init()?");
+    *out_stats = bd->Upload.Stats;
+}
+
 void ImGui_ImplDX11_NewFrame()
 {
     ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
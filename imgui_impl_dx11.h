@@ -4,6 +4,7 @@
 // Implemented features:
 //  [X] Renderer: User texture binding. Use 'ID3D11ShaderResourceView*' as ImTextureID. Read the FAQ about ImTextureID!
 //  [X] Renderer: Support for large meshes (64k+ vertices) with 16-bit indices.
+//  [X] Renderer: Font atlas regions changed after the build (ImFontConfig::DynamicGlyphs), see ImFontAtlas::TexUpdates.
 
 // You can use unmodified imgui_impl_* files in your project. See examples/ folder for examples of using this. 
 // Prefer including the entire imgui/ repository into your project (either as a copy or as a submodule), and only build the backends you need.
@@ -24,3 +25,20 @@ IMGUI_IMPL_API void     ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data);
 // Use if you want to reset your rendering device without losing Dear ImGui state.
 IMGUI_IMPL_API void     ImGui_ImplDX11_InvalidateDeviceObjects();
 IMGUI_IMPL_API bool     ImGui_ImplDX11_CreateDeviceObjects();
+
+// Vertex/index upload, see imgui_impl_dx11_upload.h.
+// ring_buffer: append each frame with WRITE_NO_OVERWRITE instead of discarding the buffers every frame.
+// skip_unchanged_lists: hash the draw lists and don't copy the ones that didn't change (needs ring_buffer).
+struct ImGui_ImplDX11_UploadStats
+{
+    ImU64   TotalUploadedBytes;
+    ImU64   FrameUploadedBytes;         // Of the last upload
+    int     FrameUploadedLists;
+    int     FrameSkippedLists;          // Unchanged lists left in place
+    int     Reallocations;              // Buffers created again to grow
+    int     Discards;                   // Ring wrapped around
+
+    ImGui_ImplDX11_UploadStats()        { memset((void*)this, 0, sizeof(*this)); }
+};
+IMGUI_IMPL_API void     ImGui_ImplDX11_SetUploadMode(bool ring_buffer, bool skip_unchanged_lists);
+IMGUI_IMPL_API void     ImGui_ImplDX11_GetUploadStats(ImGui_ImplDX11_UploadStats* out_stats);
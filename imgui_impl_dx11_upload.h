@@ -0,0 +1,176 @@
+// dear imgui: Vertex/index upload planning of the DirectX11 Renderer Backend (imgui_impl_dx11.cpp)
+// There is no D3D in here, so the placement logic can be checked on any platform (see tools/imgui_upload_bench.cpp).
+
+// Default: like upstream, the whole draw data is written from the start of the buffers every frame with WRITE_DISCARD.
+// Ring mode: each frame appends the draw lists it uploads after the previous frame's data and maps with
+// WRITE_NO_OVERWRITE, the regions the GPU may still read are never written again. When the new data doesn't fit in
+// the rest of the buffers, they are discarded (the driver renames them) and written from the start again.
+// Skip unchanged (ring mode only): every draw list is hashed, one with the same hash and sizes as in the previous frame
+// keeps its place in the ring instead of being copied again. The hash is a 64-bit multiply/rotate over four lanes,
+// several times faster than ImHashData()'s CRC32 so that hashing costs less than the copy it saves.
+// Either way the buffers grow geometrically, to hold at least two frames, four in ring mode so it wraps around less often.
+
+#pragma once
+#include "imgui.h"
+#include "imgui_impl_dx11.h"    // ImGui_ImplDX11_UploadStats
+
+struct ImGui_ImplDX11_ListPlacement
+{
+    const ImDrawList*   List;
+    ImU64               Hash;           // Of the vertices and indices, 0 when not skipping unchanged lists
+    int                 VtxCount;
+    int                 IdxCount;
+    int                 VtxOffset;      // Where the list is in the buffers, in elements
+    int                 IdxOffset;
+    bool                Upload;         // Copy it this frame
+};
+
+struct ImGui_ImplDX11_UploadPlan
+{
+    bool                Ring;
+    bool                SkipUnchanged;
+    int                 VtxCapacity;    // Buffer sizes in elements, 0 until the first frame or after Reset()
+    int                 IdxCapacity;
+    int                 VtxCursor;      // Where the next upload goes
+    int                 IdxCursor;
+    bool                Reallocate;     // Plan() result: create the buffers again with VtxCapacity/IdxCapacity
+    bool                Discard;        // Plan() result: map with WRITE_DISCARD instead of WRITE_NO_OVERWRITE
+    ImVector<ImGui_ImplDX11_ListPlacement> Lists;       // Placement of each draw_data->CmdLists[]
+    ImVector<ImGui_ImplDX11_ListPlacement> PrevLists;
+    ImGui_ImplDX11_UploadStats Stats;
+
+    ImGui_ImplDX11_UploadPlan()         { Ring = SkipUnchanged = false; Reset(); }
+    void    Reset()                     { VtxCapacity = IdxCapacity = VtxCursor = IdxCursor = 0; Reallocate = Discard = false; Lists.resize(0); PrevLists.resize(0); }
+    void    Plan(const ImDrawData* draw_data);
+};
+
+static inline int ImGui_ImplDX11_GrowCapacity(int capacity, int frame_count, int frames, int min_capacity)
+{
+    if (capacity < min_capacity)
+        capacity = min_capacity;
+    while (capacity < frame_count * frames)
+        capacity *= 2;
+    return capacity;
+}
+
+static inline ImU64 ImGui_ImplDX11_HashRound(ImU64 acc, ImU64 input)
+{
+    acc += input * 0xC2B2AE3D27D4EB4FULL;
+    acc = (acc << 31) | (acc >> 33);
+    return acc * 0x9E3779B185EBCA87ULL;
+}
+
+// Four independent lanes of 8 bytes, the multiplies of one block overlap
+static inline ImU64 ImGui_ImplDX11_HashBytes(const void* data, size_t size, ImU64 seed)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    ImU64 lanes[4] = { seed + 1, seed + 2, seed + 3, seed + 4 };
+    ImU64 words[4];
+    for (; size >= 32; p += 32, size -= 32)
+    {
+        memcpy(words, p, 32);
+        for (int n = 0; n < 4; n++)
+            lanes[n] = ImGui_ImplDX11_HashRound(lanes[n], words[n]);
+    }
+    ImU64 hash = lanes[0] ^ ((lanes[1] << 7) | (lanes[1] >> 57)) ^ ((lanes[2] << 13) | (lanes[2] >> 51)) ^ ((lanes[3] << 29) | (lanes[3] >> 35));
+    hash = ImGui_ImplDX11_HashRound(hash, (ImU64)size);
+    for (; size >= 8; p += 8, size -= 8)
+    {
+        memcpy(words, p, 8);
+        hash = ImGui_ImplDX11_HashRound(hash, words[0]);
+    }
+    if (size > 0)
+    {
+        words[0] = 0;
+        memcpy(words, p, size);
+        hash = ImGui_ImplDX11_HashRound(hash, words[0]);
+    }
+    hash ^= hash >> 29;
+    return hash;
+}
+
+inline void ImGui_ImplDX11_UploadPlan::Plan(const ImDrawData* draw_data)
+{
+    PrevLists.swap(Lists);
+    Lists.resize(draw_data->CmdListsCount);
+    int total_vtx = 0, total_idx = 0;
+    int upload_vtx = 0, upload_idx = 0;
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        ImGui_ImplDX11_ListPlacement& placement = Lists[n];
+        placement.List = cmd_list;
+        placement.Hash = 0;
+        placement.VtxCount = cmd_list->VtxBuffer.Size;
+        placement.IdxCount = cmd_list->IdxBuffer.Size;
+        placement.VtxOffset = placement.IdxOffset = 0;
+        placement.Upload = true;
+        if (Ring && SkipUnchanged)
+        {
+            // Every region of the previous frame is below the cursors and still intact
+            placement.Hash = ImGui_ImplDX11_HashBytes(cmd_list->IdxBuffer.Data, (size_t)cmd_list->IdxBuffer.size_in_bytes(), ImGui_ImplDX11_HashBytes(cmd_list->VtxBuffer.Data, (size_t)cmd_list->VtxBuffer.size_in_bytes(), 0));
+            for (const ImGui_ImplDX11_ListPlacement& prev : PrevLists)
+                if (prev.List == cmd_list && prev.Hash == placement.Hash && prev.VtxCount == placement.VtxCount && prev.IdxCount == placement.IdxCount)
+                {
+                    placement.VtxOffset = prev.VtxOffset;
+                    placement.IdxOffset = prev.IdxOffset;
+                    placement.Upload = false;
+                    break;
+                }
+        }
+        total_vtx += placement.VtxCount;
+        total_idx += placement.IdxCount;
+        if (placement.Upload)
+        {
+            upload_vtx += placement.VtxCount;
+            upload_idx += placement.IdxCount;
+        }
+    }
+
+    // Grow, wrap around, or append
+    Reallocate = Discard = false;
+    const int frames = Ring ? 4 : 2;
+    int vtx_capacity = ImGui_ImplDX11_GrowCapacity(VtxCapacity, total_vtx, frames, 5000);
+    int idx_capacity = ImGui_ImplDX11_GrowCapacity(IdxCapacity, total_idx, frames, 10000);
+    if (vtx_capacity != VtxCapacity || idx_capacity != IdxCapacity)
+    {
+        if (VtxCapacity != 0)
+            Stats.Reallocations++;
+        VtxCapacity = vtx_capacity;
+        IdxCapacity = idx_capacity;
+        Reallocate = Discard = true;
+    }
+    else if (!Ring)
+    {
+        Discard = true;
+    }
+    else if (VtxCursor + upload_vtx > VtxCapacity || IdxCursor + upload_idx > IdxCapacity)
+    {
+        Stats.Discards++;
+        Discard = true;
+    }
+    if (Discard)
+    {
+        VtxCursor = IdxCursor = 0;
+        for (ImGui_ImplDX11_ListPlacement& placement : Lists)
+            placement.Upload = true;
+    }
+
+    Stats.FrameUploadedBytes = 0;
+    Stats.FrameUploadedLists = Stats.FrameSkippedLists = 0;
+    for (ImGui_ImplDX11_ListPlacement& placement : Lists)
+    {
+        if (!placement.Upload)
+        {
+            Stats.FrameSkippedLists++;
+            continue;
+        }
+        placement.VtxOffset = VtxCursor;
+        placement.IdxOffset = IdxCursor;
+        VtxCursor += placement.VtxCount;
+        IdxCursor += placement.IdxCount;
+        Stats.FrameUploadedLists++;
+        Stats.FrameUploadedBytes += (ImU64)placement.VtxCount * sizeof(ImDrawVert) + (ImU64)placement.IdxCount * sizeof(ImDrawIdx);
+    }
+    Stats.TotalUploadedBytes += Stats.FrameUploadedBytes;
+}
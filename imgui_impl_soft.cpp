@@ -0,0 +1,632 @@
+// dear imgui: Renderer Backend rasterizing on the CPU into a memory framebuffer
+// This needs to be used along with a Platform Backend, or with io.DisplaySize/io.DeltaTime/inputs set by hand (headless).
+
+// Implemented features:
+//  [X] Renderer: User texture binding. Use 'ImGui_ImplSoft_Texture*' as ImTextureID.
+//  [X] Renderer: Support for large meshes (64k+ vertices) with 16-bit indices.
+//  [X] Renderer: Font atlas regions changed after the build (ImFontConfig::DynamicGlyphs), see ImFontAtlas::TexUpdates.
+// See imgui_impl_soft.h for how it rasterizes.
+
+// CHANGELOG
+//  2026-10-19: Copy the font atlas regions listed in io.Fonts->TexUpdates (glyphs rasterized on demand) before rendering.
+//  2026-10-19: Initial version: tiled rasterizer with SSE2 edge functions and worker threads, for headless benchmarks and image checks.
+
+#include "imgui.h"
+#include "imgui_impl_soft.h"
+#include "imgui_internal.h"     // ImMin, ImMax, ImClamp, ImSwap
+#include <math.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMGUI_IMPL_SOFT_SSE2
+#include <emmintrin.h>
+#endif
+
+static const int ImGui_ImplSoft_TileSize = 64;
+
+enum ImGui_ImplSoft_TriangleFlags_
+{
+    ImGui_ImplSoft_TriangleFlags_ConstColor     = 1 << 0,
+    ImGui_ImplSoft_TriangleFlags_ConstTexel     = 1 << 1,   // Texel holds the only sample
+    ImGui_ImplSoft_TriangleFlags_Nearest        = 1 << 2,   // One texel per pixel, sampled on texel centers
+};
+
+// Planes are c + dx * x + dy * y, at pixel centers
+struct ImGui_ImplSoft_Plane
+{
+    float       C, DX, DY;
+};
+
+struct ImGui_ImplSoft_Triangle
+{
+    // Edge i (opposite vertex i) is Sign * ((x - X) * DY - (y - Y) * DX), from its lowest endpoint so that both triangles
+    // sharing an edge compute the same value, and positive inside.
+    float       EdgeX[3], EdgeY[3], EdgeDX[3], EdgeDY[3], EdgeSign[3];
+    bool        EdgeOwner[3];               // Pixels exactly on the edge belong to this triangle, not to its neighbor
+    int         MinX, MinY, MaxX, MaxY;     // Pixels to test, clipped, max exclusive
+    int         Flags;
+    ImGui_ImplSoft_Plane Color[4];          // r, g, b, a in [0, 255], only C when ConstColor
+    ImGui_ImplSoft_Plane S, T;              // Texel coordinates minus 0.5, the bilinear footprint starts at floor()
+    float       Texel[4];                   // ConstTexel, in [0, 1]
+    const ImGui_ImplSoft_Texture* Texture;
+};
+
+// Soft renderer data
+struct ImGui_ImplSoft_Data
+{
+    ImVector<ImU32>                     FontPixels;
+    ImGui_ImplSoft_Texture              FontTexture;
+    ImVector<ImGui_ImplSoft_Triangle>   Triangles;
+    ImVector<int>                       TileStart;      // Bins of tile n are TileItems[TileStart[n]..TileStart[n + 1]), in submission order
+    ImVector<int>                       TileCursor;
+    ImVector<int>                       TileItems;
+    int                                 TilesX, TilesY;
+    ImGui_ImplSoft_Framebuffer          Target;
+    ImGui_ImplSoft_Stats                Stats;
+
+    // Workers take tiles from NextTile, every one of them runs once per Generation
+    std::vector<std::thread>            Threads;
+    std::mutex                          Mutex;
+    std::condition_variable             Wake;
+    std::condition_variable             Done;
+    int                                 Generation;
+    int                                 Working;
+    bool                                Stopping;
+    std::atomic<int>                    NextTile;
+
+    ImGui_ImplSoft_Data()               { FontTexture.Pixels = NULL; FontTexture.Width = FontTexture.Height = 0; TilesX = TilesY = 0; memset((void*)&Target, 0, sizeof(Target)); Generation = Working = 0; Stopping = false; NextTile = 0; }
+};
+
+// Backend data stored in io.BackendRendererUserData to allow support for multiple Dear ImGui contexts
+static ImGui_ImplSoft_Data* ImGui_ImplSoft_GetBackendData()
+{
+    return ImGui::GetCurrentContext() ? (ImGui_ImplSoft_Data*)ImGui::GetIO().BackendRendererUserData : NULL;
+}
+
+// Functions
+static inline int ImGui_ImplSoft_Clamp(int v, int mn, int mx)
+{
+    return v < mn ? mn : v > mx ? mx : v;
+}
+
+// Bilinear with clamping, out in [0, 1]
+static void ImGui_ImplSoft_Sample(const ImGui_ImplSoft_Texture* tex, float s, float t, float out[4])
+{
+    s = s < -1.0f ? -1.0f : s > (float)tex->Width ? (float)tex->Width : s;
+    t = t < -1.0f ? -1.0f : t > (float)tex->Height ? (float)tex->Height : t;
+    float fs = floorf(s), ft = floorf(t);
+    float ax = s - fs, ay = t - ft;
+    int x0 = ImGui_ImplSoft_Clamp((int)fs, 0, tex->Width - 1), x1 = ImGui_ImplSoft_Clamp((int)fs + 1, 0, tex->Width - 1);
+    int y0 = ImGui_ImplSoft_Clamp((int)ft, 0, tex->Height - 1), y1 = ImGui_ImplSoft_Clamp((int)ft + 1, 0, tex->Height - 1);
+    ImU32 c00 = tex->Pixels[y0 * tex->Width + x0], c10 = tex->Pixels[y0 * tex->Width + x1];
+    ImU32 c01 = tex->Pixels[y1 * tex->Width + x0], c11 = tex->Pixels[y1 * tex->Width + x1];
+    for (int c = 0; c < 4; c++)
+    {
+        int shift = c * 8;
+        float top = (float)((c00 >> shift) & 0xFF) + ((float)((c10 >> shift) & 0xFF) - (float)((c00 >> shift) & 0xFF)) * ax;
+        float bottom = (float)((c01 >> shift) & 0xFF) + ((float)((c11 >> shift) & 0xFF) - (float)((c01 >> shift) & 0xFF)) * ax;
+        out[c] = (top + (bottom - top) * ay) * (1.0f / 255.0f);
+    }
+}
+
+static ImGui_ImplSoft_Plane ImGui_ImplSoft_MakePlane(const ImVec2 pos[3], float a0, float a1, float a2, float area)
+{
+    ImGui_ImplSoft_Plane plane;
+    plane.DX = ((a1 - a0) * (pos[2].y - pos[0].y) - (a2 - a0) * (pos[1].y - pos[0].y)) / area;
+    plane.DY = ((a2 - a0) * (pos[1].x - pos[0].x) - (a1 - a0) * (pos[2].x - pos[0].x)) / area;
+    plane.C = a0 - plane.DX * pos[0].x - plane.DY * pos[0].y;
+    return plane;
+}
+
+static bool ImGui_ImplSoft_SetupTriangle(ImGui_ImplSoft_Triangle* tri, const ImVec2 pos[3], const ImVec2 uv[3], const ImU32 col[3], const ImGui_ImplSoft_Texture* tex, const int clip[4])
+{
+    float area = (pos[1].x - pos[0].x) * (pos[2].y - pos[0].y) - (pos[2].x - pos[0].x) * (pos[1].y - pos[0].y);
+    if (!(area != 0.0f) || !(fabsf(area) < 1e30f))
+        return false;
+
+    // Pixel centers within the bounds, clamped before converting so that far away vertices don't overflow
+    float min_x = ImMin(ImMin(pos[0].x, pos[1].x), pos[2].x), max_x = ImMax(ImMax(pos[0].x, pos[1].x), pos[2].x);
+    float min_y = ImMin(ImMin(pos[0].y, pos[1].y), pos[2].y), max_y = ImMax(ImMax(pos[0].y, pos[1].y), pos[2].y);
+    tri->MinX = (int)floorf(ImClamp(min_x, (float)clip[0], (float)clip[2]));
+    tri->MinY = (int)floorf(ImClamp(min_y, (float)clip[1], (float)clip[3]));
+    tri->MaxX = (int)ceilf(ImClamp(max_x, (float)clip[0], (float)clip[2]));
+    tri->MaxY = (int)ceilf(ImClamp(max_y, (float)clip[1], (float)clip[3]));
+    if (tri->MinX >= tri->MaxX || tri->MinY >= tri->MaxY)
+        return false;
+
+    for (int i = 0; i < 3; i++)
+    {
+        ImVec2 a = pos[(i + 1) % 3], b = pos[(i + 2) % 3];
+        if (b.y < a.y || (b.y == a.y && b.x < a.x))
+            ImSwap(a, b);
+        tri->EdgeX[i] = a.x;
+        tri->EdgeY[i] = a.y;
+        tri->EdgeDX[i] = b.x - a.x;
+        tri->EdgeDY[i] = b.y - a.y;
+        float opposite = (pos[i].x - a.x) * tri->EdgeDY[i] - (pos[i].y - a.y) * tri->EdgeDX[i];
+        if (opposite == 0.0f)
+            return false;
+        tri->EdgeSign[i] = opposite > 0.0f ? 1.0f : -1.0f;
+        // The neighbor's inward normal is the opposite of ours, exactly one of the two owns the edge
+        float normal_x = tri->EdgeSign[i] * tri->EdgeDY[i], normal_y = -tri->EdgeSign[i] * tri->EdgeDX[i];
+        tri->EdgeOwner[i] = normal_x > 0.0f || (normal_x == 0.0f && normal_y > 0.0f);
+    }
+
+    tri->Flags = 0;
+    tri->Texture = tex;
+    if (col[0] == col[1] && col[0] == col[2])
+    {
+        tri->Flags |= ImGui_ImplSoft_TriangleFlags_ConstColor;
+        for (int c = 0; c < 4; c++)
+        {
+            tri->Color[c].C = (float)((col[0] >> (c * 8)) & 0xFF);
+            tri->Color[c].DX = tri->Color[c].DY = 0.0f;
+        }
+    }
+    else
+    {
+        for (int c = 0; c < 4; c++)
+            tri->Color[c] = ImGui_ImplSoft_MakePlane(pos, (float)((col[0] >> (c * 8)) & 0xFF), (float)((col[1] >> (c * 8)) & 0xFF), (float)((col[2] >> (c * 8)) & 0xFF), area);
+    }
+
+    if (tex == NULL || tex->Pixels == NULL)
+    {
+        tri->Flags |= ImGui_ImplSoft_TriangleFlags_ConstTexel;
+        tri->Texel[0] = tri->Texel[1] = tri->Texel[2] = tri->Texel[3] = 1.0f;
+    }
+    else if (uv[0].x == uv[1].x && uv[0].x == uv[2].x && uv[0].y == uv[1].y && uv[0].y == uv[2].y)
+    {
+        tri->Flags |= ImGui_ImplSoft_TriangleFlags_ConstTexel;
+        ImGui_ImplSoft_Sample(tex, uv[0].x * tex->Width - 0.5f, uv[0].y * tex->Height - 0.5f, tri->Texel);
+    }
+    else
+    {
+        float w = (float)tex->Width, h = (float)tex->Height;
+        tri->S = ImGui_ImplSoft_MakePlane(pos, uv[0].x * w - 0.5f, uv[1].x * w - 0.5f, uv[2].x * w - 0.5f, area);
+        tri->T = ImGui_ImplSoft_MakePlane(pos, uv[0].y * h - 0.5f, uv[1].y * h - 0.5f, uv[2].y * h - 0.5f, area);
+        // Glyphs drawn at their size on whole pixels: every pixel center lands on a texel center
+        const float eps = 1e-4f;
+        if (fabsf(tri->S.DX - 1.0f) < eps && fabsf(tri->S.DY) < eps && fabsf(tri->T.DX) < eps && fabsf(tri->T.DY - 1.0f) < eps)
+        {
+            float s = tri->S.C + tri->S.DX * (tri->MinX + 0.5f) + tri->S.DY * (tri->MinY + 0.5f);
+            float t = tri->T.C + tri->T.DX * (tri->MinX + 0.5f) + tri->T.DY * (tri->MinY + 0.5f);
+            if (fabsf(s - floorf(s + 0.5f)) < 1e-3f && fabsf(t - floorf(t + 0.5f)) < 1e-3f)
+                tri->Flags |= ImGui_ImplSoft_TriangleFlags_Nearest;
+        }
+    }
+    return true;
+}
+
+#ifdef IMGUI_IMPL_SOFT_SSE2
+
+static inline __m128 ImGui_ImplSoft_PlaneRow(const ImGui_ImplSoft_Plane& plane, float py)
+{
+    return _mm_set1_ps(plane.C + plane.DY * py);
+}
+
+static void ImGui_ImplSoft_RasterizeTriangle(const ImGui_ImplSoft_Data* bd, const ImGui_ImplSoft_Triangle& tri, int x0, int y0, int x1, int y1)
+{
+    const ImGui_ImplSoft_Framebuffer& fb = bd->Target;
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 lane_offset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128i lane_index = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i byte_mask = _mm_set1_epi32(0xFF);
+    const __m128 max_value = _mm_set1_ps(255.0f);
+    const __m128i first = _mm_set1_epi32(x0 - 1), last = _mm_set1_epi32(x1);
+
+    __m128 edge_x[3], edge_dy[3], edge_sign[3];
+    for (int i = 0; i < 3; i++)
+    {
+        edge_x[i] = _mm_set1_ps(tri.EdgeX[i]);
+        edge_dy[i] = _mm_set1_ps(tri.EdgeDY[i]);
+        edge_sign[i] = _mm_set1_ps(tri.EdgeSign[i]);
+    }
+    const bool const_color = (tri.Flags & ImGui_ImplSoft_TriangleFlags_ConstColor) != 0;
+    const bool const_texel = (tri.Flags & ImGui_ImplSoft_TriangleFlags_ConstTexel) != 0;
+    const bool nearest = (tri.Flags & ImGui_ImplSoft_TriangleFlags_Nearest) != 0;
+    __m128 texel[4];
+    for (int c = 0; c < 4; c++)
+        texel[c] = _mm_set1_ps(const_texel ? tri.Texel[c] : 1.0f);
+
+    for (int y = y0; y < y1; y++)
+    {
+        const float py = (float)y + 0.5f;
+        __m128 row_term[3];
+        for (int i = 0; i < 3; i++)
+            row_term[i] = _mm_set1_ps((py - tri.EdgeY[i]) * tri.EdgeDX[i]);
+        __m128 color_row[4], color_dx[4];
+        for (int c = 0; c < 4; c++)
+        {
+            color_row[c] = ImGui_ImplSoft_PlaneRow(tri.Color[c], py);
+            color_dx[c] = _mm_set1_ps(tri.Color[c].DX);
+        }
+        ImU32* row = fb.Pixels + (size_t)y * fb.Stride;
+
+        for (int x = x0 & ~3; x < x1; x += 4)
+        {
+            const __m128 px = _mm_add_ps(_mm_set1_ps((float)x), lane_offset);
+            const __m128i lanes = _mm_add_epi32(_mm_set1_epi32(x), lane_index);
+            __m128i mask = _mm_and_si128(_mm_cmpgt_epi32(lanes, first), _mm_cmplt_epi32(lanes, last));
+            for (int i = 0; i < 3; i++)
+            {
+                __m128 w = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_sub_ps(px, edge_x[i]), edge_dy[i]), row_term[i]), edge_sign[i]);
+                __m128 inside = _mm_cmpgt_ps(w, zero);
+                if (tri.EdgeOwner[i])
+                    inside = _mm_or_ps(inside, _mm_cmpeq_ps(w, zero));
+                mask = _mm_and_si128(mask, _mm_castps_si128(inside));
+            }
+            if (_mm_movemask_epi8(mask) == 0)
+                continue;
+
+            // Source color
+            __m128 color[4];
+            for (int c = 0; c < 4; c++)
+                color[c] = const_color ? color_row[c] : _mm_add_ps(color_row[c], _mm_mul_ps(color_dx[c], px));
+            if (!const_texel)
+            {
+                float s[4], t[4];
+                _mm_storeu_ps(s, _mm_add_ps(ImGui_ImplSoft_PlaneRow(tri.S, py), _mm_mul_ps(_mm_set1_ps(tri.S.DX), px)));
+                _mm_storeu_ps(t, _mm_add_ps(ImGui_ImplSoft_PlaneRow(tri.T, py), _mm_mul_ps(_mm_set1_ps(tri.T.DX), px)));
+                const ImGui_ImplSoft_Texture* tex = tri.Texture;
+                if (nearest)
+                {
+                    ImU32 texels[4];
+                    for (int l = 0; l < 4; l++)
+                    {
+                        int tx = ImGui_ImplSoft_Clamp((int)floorf(s[l] + 0.5f), 0, tex->Width - 1);
+                        int ty = ImGui_ImplSoft_Clamp((int)floorf(t[l] + 0.5f), 0, tex->Height - 1);
+                        texels[l] = tex->Pixels[ty * tex->Width + tx];
+                    }
+                    const __m128i packed = _mm_loadu_si128((const __m128i*)texels);
+                    const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+                    for (int c = 0; c < 4; c++)
+                        texel[c] = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, c * 8), byte_mask)), scale);
+                }
+                else
+                {
+                    float sampled[4][4];
+                    for (int l = 0; l < 4; l++)
+                    {
+                        float out[4];
+                        ImGui_ImplSoft_Sample(tex, s[l], t[l], out);
+                        for (int c = 0; c < 4; c++)
+                            sampled[c][l] = out[c];
+                    }
+                    for (int c = 0; c < 4; c++)
+                        texel[c] = _mm_loadu_ps(sampled[c]);
+                }
+            }
+            for (int c = 0; c < 4; c++)
+                color[c] = _mm_mul_ps(color[c], texel[c]);
+
+            // Blend like the DX11 backend: rgb over with source alpha, alpha = src + dst * (1 - src)
+            const __m128i dst = _mm_loadu_si128((const __m128i*)(row + x));
+            const __m128 alpha = _mm_mul_ps(color[3], _mm_set1_ps(1.0f / 255.0f));
+            const __m128 inv_alpha = _mm_sub_ps(_mm_set1_ps(1.0f), alpha);
+            __m128i out = _mm_setzero_si128();
+            for (int c = 0; c < 4; c++)
+            {
+                __m128 d = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(dst, c * 8), byte_mask));
+                __m128 v = c < 3 ? _mm_add_ps(_mm_mul_ps(color[c], alpha), _mm_mul_ps(d, inv_alpha)) : _mm_add_ps(color[c], _mm_mul_ps(d, inv_alpha));
+                v = _mm_min_ps(_mm_max_ps(v, zero), max_value);
+                out = _mm_or_si128(out, _mm_slli_epi32(_mm_cvtps_epi32(v), c * 8));
+            }
+            out = _mm_or_si128(_mm_and_si128(mask, out), _mm_andnot_si128(mask, dst));
+            _mm_storeu_si128((__m128i*)(row + x), out);
+        }
+    }
+}
+
+#else
+
+static void ImGui_ImplSoft_RasterizeTriangle(const ImGui_ImplSoft_Data* bd, const ImGui_ImplSoft_Triangle& tri, int x0, int y0, int x1, int y1)
+{
+    const ImGui_ImplSoft_Framebuffer& fb = bd->Target;
+    const bool const_texel = (tri.Flags & ImGui_ImplSoft_TriangleFlags_ConstTexel) != 0;
+    const bool nearest = (tri.Flags & ImGui_ImplSoft_TriangleFlags_Nearest) != 0;
+    for (int y = y0; y < y1; y++)
+    {
+        const float py = (float)y + 0.5f;
+        float row_term[3];
+        for (int i = 0; i < 3; i++)
+            row_term[i] = (py - tri.EdgeY[i]) * tri.EdgeDX[i];
+        ImU32* row = fb.Pixels + (size_t)y * fb.Stride;
+        for (int x = x0; x < x1; x++)
+        {
+            const float px = (float)x + 0.5f;
+            bool inside = true;
+            for (int i = 0; i < 3 && inside; i++)
+            {
+                float w = ((px - tri.EdgeX[i]) * tri.EdgeDY[i] - row_term[i]) * tri.EdgeSign[i];
+                inside = w > 0.0f || (w == 0.0f && tri.EdgeOwner[i]);
+            }
+            if (!inside)
+                continue;
+
+            float texel[4] = { tri.Texel[0], tri.Texel[1], tri.Texel[2], tri.Texel[3] };
+            if (!const_texel)
+            {
+                const ImGui_ImplSoft_Texture* tex = tri.Texture;
+                float s = tri.S.C + tri.S.DY * py + tri.S.DX * px;
+                float t = tri.T.C + tri.T.DY * py + tri.T.DX * px;
+                if (nearest)
+                {
+                    ImU32 c = tex->Pixels[ImGui_ImplSoft_Clamp((int)floorf(t + 0.5f), 0, tex->Height - 1) * tex->Width + ImGui_ImplSoft_Clamp((int)floorf(s + 0.5f), 0, tex->Width - 1)];
+                    for (int n = 0; n < 4; n++)
+                        texel[n] = (float)((c >> (n * 8)) & 0xFF) * (1.0f / 255.0f);
+                }
+                else
+                {
+                    ImGui_ImplSoft_Sample(tex, s, t, texel);
+                }
+            }
+            float color[4];
+            for (int c = 0; c < 4; c++)
+                color[c] = (tri.Color[c].C + tri.Color[c].DY * py + tri.Color[c].DX * px) * texel[c];
+
+            const ImU32 dst = row[x];
+            const float alpha = color[3] * (1.0f / 255.0f);
+            ImU32 out = 0;
+            for (int c = 0; c < 4; c++)
+            {
+                float d = (float)((dst >> (c * 8)) & 0xFF);
+                float v = c < 3 ? color[c] * alpha + d * (1.0f - alpha) : color[c] + d * (1.0f - alpha);
+                v = v < 0.0f ? 0.0f : v > 255.0f ? 255.0f : v;
+                out |= (ImU32)(int)nearbyintf(v) << (c * 8);
+            }
+            row[x] = out;
+        }
+    }
+}
+
+#endif
+
+static void ImGui_ImplSoft_RasterizeTile(const ImGui_ImplSoft_Data* bd, int tile)
+{
+    const int tile_x0 = (tile % bd->TilesX) * ImGui_ImplSoft_TileSize;
+    const int tile_y0 = (tile / bd->TilesX) * ImGui_ImplSoft_TileSize;
+    const int tile_x1 = ImMin(tile_x0 + ImGui_ImplSoft_TileSize, bd->Target.Width);
+    const int tile_y1 = ImMin(tile_y0 + ImGui_ImplSoft_TileSize, bd->Target.Height);
+    for (int n = bd->TileStart[tile]; n < bd->TileStart[tile + 1]; n++)
+    {
+        const ImGui_ImplSoft_Triangle& tri = bd->Triangles[bd->TileItems[n]];
+        ImGui_ImplSoft_RasterizeTriangle(bd, tri, ImMax(tri.MinX, tile_x0), ImMax(tri.MinY, tile_y0), ImMin(tri.MaxX, tile_x1), ImMin(tri.MaxY, tile_y1));
+    }
+}
+
+static void ImGui_ImplSoft_RunTiles(ImGui_ImplSoft_Data* bd)
+{
+    const int tile_count = bd->TilesX * bd->TilesY;
+    for (int tile = bd->NextTile.fetch_add(1); tile < tile_count; tile = bd->NextTile.fetch_add(1))
+        ImGui_ImplSoft_RasterizeTile(bd, tile);
+}
+
+static void ImGui_ImplSoft_WorkerMain(ImGui_ImplSoft_Data* bd)
+{
+    int generation = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(bd->Mutex);
+            bd->Wake.wait(lock, [&]() { return bd->Stopping || bd->Generation != generation; });
+            if (bd->Stopping)
+                return;
+            generation = bd->Generation;
+        }
+        ImGui_ImplSoft_RunTiles(bd);
+        {
+            std::lock_guard<std::mutex> lock(bd->Mutex);
+            if (--bd->Working == 0)
+                bd->Done.notify_one();
+        }
+    }
+}
+
+// Render function
+void ImGui_ImplSoft_RenderDrawData(ImDrawData* draw_data, const ImGui_ImplSoft_Framebuffer* framebuffer)
+{
+    ImGui_ImplSoft_Data* bd = ImGui_ImplSoft_GetBackendData();
+    IM_ASSERT(bd != NULL && "Did you call ImGui_ImplSoft_Init()?");
+    IM_ASSERT(framebuffer->Stride % 4 == 0 && framebuffer->Stride >= framebuffer->Width);
+    bd->Stats = ImGui_ImplSoft_Stats();
+    bd->Stats.Threads = (int)bd->Threads.size() + 1;
+
+    // Avoid rendering when minimized
+    if (draw_data->DisplaySize.x <= 0.0f || draw_data->DisplaySize.y <= 0.0f || framebuffer->Width <= 0 || framebuffer->Height <= 0)
+        return;
+    bd->Target = *framebuffer;
+
+    // Copy font atlas regions changed since the last frame (glyphs rasterized on demand)
+    ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+    if (atlas->TexPixelsRGBA32 && atlas->TexWidth == bd->FontTexture.Width && atlas->TexHeight == bd->FontTexture.Height)
+        for (int n = 0; n < atlas->TexUpdates.Size; n++)
+        {
+            const ImFontAtlasTexUpdate& update = atlas->TexUpdates[n];
+            for (int y = update.Y; y < update.Y + update.Height; y++)
+                memcpy(&bd->FontPixels.Data[update.X + y * atlas->TexWidth], &atlas->TexPixelsRGBA32[update.X + y * atlas->TexWidth], (size_t)update.Width * 4);
+        }
+    atlas->TexUpdates.resize(0);
+
+    // Set up every triangle
+    // (Our visible imgui space lies from draw_data->DisplayPos (top left) to draw_data->DisplayPos+data_data->DisplaySize (bottom right), scaled to framebuffer pixels)
+    ImVec2 clip_off = draw_data->DisplayPos;
+    ImVec2 clip_scale = draw_data->FramebufferScale;
+    bd->Triangles.resize(0);
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+        {
+            const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+            if (pcmd->UserCallback != NULL)
+            {
+                // User callback, registered via ImDrawList::AddCallback()
+                // (ImDrawCallback_ResetRenderState is a special callback value used by the user to request the renderer to reset render state, there is none here.)
+                if (pcmd->UserCallback != ImDrawCallback_ResetRenderState)
+                    pcmd->UserCallback(cmd_list, pcmd);
+                continue;
+            }
+
+            // Project scissor/clipping rectangles into framebuffer space, truncated like the DX11 backend's scissor
+            int clip[4];
+            clip[0] = (int)ImClamp((pcmd->ClipRect.x - clip_off.x) * clip_scale.x, 0.0f, (float)framebuffer->Width);
+            clip[1] = (int)ImClamp((pcmd->ClipRect.y - clip_off.y) * clip_scale.y, 0.0f, (float)framebuffer->Height);
+            clip[2] = (int)ImClamp((pcmd->ClipRect.z - clip_off.x) * clip_scale.x, 0.0f, (float)framebuffer->Width);
+            clip[3] = (int)ImClamp((pcmd->ClipRect.w - clip_off.y) * clip_scale.y, 0.0f, (float)framebuffer->Height);
+            if (clip[2] <= clip[0] || clip[3] <= clip[1])
+                continue;
+
+            const ImGui_ImplSoft_Texture* tex = (const ImGui_ImplSoft_Texture*)pcmd->GetTexID();
+            const ImDrawVert* vtx_buffer = cmd_list->VtxBuffer.Data + pcmd->VtxOffset;
+            const ImDrawIdx* idx_buffer = cmd_list->IdxBuffer.Data + pcmd->IdxOffset;
+            for (unsigned int i = 0; i + 2 < pcmd->ElemCount; i += 3)
+            {
+                ImVec2 pos[3], uv[3];
+                ImU32 col[3];
+                for (int k = 0; k < 3; k++)
+                {
+                    const ImDrawVert& v = vtx_buffer[idx_buffer[i + k]];
+                    pos[k] = ImVec2((v.pos.x - clip_off.x) * clip_scale.x, (v.pos.y - clip_off.y) * clip_scale.y);
+                    uv[k] = v.uv;
+                    col[k] = v.col;
+                }
+                bd->Triangles.resize(bd->Triangles.Size + 1);
+                if (!ImGui_ImplSoft_SetupTriangle(&bd->Triangles.back(), pos, uv, col, tex, clip))
+                    bd->Triangles.pop_back();
+            }
+        }
+    }
+
+    // Bin triangles into tiles, counting first
+    bd->TilesX = (framebuffer->Width + ImGui_ImplSoft_TileSize - 1) / ImGui_ImplSoft_TileSize;
+    bd->TilesY = (framebuffer->Height + ImGui_ImplSoft_TileSize - 1) / ImGui_ImplSoft_TileSize;
+    const int tile_count = bd->TilesX * bd->TilesY;
+    bd->TileStart.resize(tile_count + 1);
+    memset(bd->TileStart.Data, 0, (size_t)bd->TileStart.size_in_bytes());
+    for (const ImGui_ImplSoft_Triangle& tri : bd->Triangles)
+        for (int ty = tri.MinY / ImGui_ImplSoft_TileSize; ty <= (tri.MaxY - 1) / ImGui_ImplSoft_TileSize; ty++)
+            for (int tx = tri.MinX / ImGui_ImplSoft_TileSize; tx <= (tri.MaxX - 1) / ImGui_ImplSoft_TileSize; tx++)
+                bd->TileStart[ty * bd->TilesX + tx + 1]++;
+    for (int tile = 0; tile < tile_count; tile++)
+        bd->TileStart[tile + 1] += bd->TileStart[tile];
+    bd->TileItems.resize(bd->TileStart[tile_count]);
+    bd->TileCursor.resize(tile_count);
+    memcpy(bd->TileCursor.Data, bd->TileStart.Data, (size_t)bd->TileCursor.size_in_bytes());
+    for (int n = 0; n < bd->Triangles.Size; n++)
+    {
+        const ImGui_ImplSoft_Triangle& tri = bd->Triangles[n];
+        for (int ty = tri.MinY / ImGui_ImplSoft_TileSize; ty <= (tri.MaxY - 1) / ImGui_ImplSoft_TileSize; ty++)
+            for (int tx = tri.MinX / ImGui_ImplSoft_TileSize; tx <= (tri.MaxX - 1) / ImGui_ImplSoft_TileSize; tx++)
+                bd->TileItems[bd->TileCursor[ty * bd->TilesX + tx]++] = n;
+        if (tri.Flags & ImGui_ImplSoft_TriangleFlags_ConstTexel)
+            bd->Stats.ConstTexelTriangles++;
+        if (tri.Flags & ImGui_ImplSoft_TriangleFlags_Nearest)
+            bd->Stats.NearestTriangles++;
+    }
+    bd->Stats.Triangles = bd->Triangles.Size;
+    bd->Stats.TileBins = bd->TileItems.Size;
+
+    // Rasterize, the calling thread takes tiles too
+    bd->NextTile = 0;
+    if (!bd->Threads.empty())
+    {
+        std::lock_guard<std::mutex> lock(bd->Mutex);
+        bd->Working = (int)bd->Threads.size();
+        bd->Generation++;
+        bd->Wake.notify_all();
+    }
+    ImGui_ImplSoft_RunTiles(bd);
+    if (!bd->Threads.empty())
+    {
+        std::unique_lock<std::mutex> lock(bd->Mutex);
+        bd->Done.wait(lock, [&]() { return bd->Working == 0; });
+    }
+}
+
+void ImGui_ImplSoft_GetStats(ImGui_ImplSoft_Stats* out_stats)
+{
+    ImGui_ImplSoft_Data* bd = ImGui_ImplSoft_GetBackendData();
+    IM_ASSERT(bd != NULL && "Did you call ImGui_ImplSoft_Init()?");
+    *out_stats = bd->Stats;
+}
+
+bool    ImGui_ImplSoft_CreateDeviceObjects()
+{
+    // Build texture atlas, and keep a copy: applications may clear the atlas pixels after uploading them
+    ImGuiIO& io = ImGui::GetIO();
+    ImGui_ImplSoft_Data* bd = ImGui_ImplSoft_GetBackendData();
+    if (bd->FontTexture.Pixels)
+        ImGui_ImplSoft_InvalidateDeviceObjects();
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    bd->FontPixels.resize(width * height);
+    memcpy(bd->FontPixels.Data, pixels, (size_t)bd->FontPixels.size_in_bytes());
+    bd->FontTexture.Pixels = bd->FontPixels.Data;
+    bd->FontTexture.Width = width;
+    bd->FontTexture.Height = height;
+
+    // Store our identifier
+    io.Fonts->SetTexID((ImTextureID)&bd->FontTexture);
+    return true;
+}
+
+void    ImGui_ImplSoft_InvalidateDeviceObjects()
+{
+    ImGui_ImplSoft_Data* bd = ImGui_ImplSoft_GetBackendData();
+    if (!bd->FontTexture.Pixels)
+        return;
+    bd->FontPixels.clear();
+    bd->FontTexture.Pixels = NULL;
+    ImGui::GetIO().Fonts->SetTexID(NULL);
+}
+
+bool    ImGui_ImplSoft_Init(int thread_count)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    IM_ASSERT(io.BackendRendererUserData == NULL && "Already initialized a renderer backend!");
+
+    // Setup backend capabilities flags
+    ImGui_ImplSoft_Data* bd = IM_NEW(ImGui_ImplSoft_Data)();
+    io.BackendRendererUserData = (void*)bd;
+    io.BackendRendererName = "imgui_impl_soft";
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;  // We can honor the ImDrawCmd::VtxOffset field, allowing for large meshes.
+
+    if (thread_count <= 0)
+        thread_count = ImMax((int)std::thread::hardware_concurrency(), 1);
+    for (int n = 1; n < thread_count; n++)
+        bd->Threads.push_back(std::thread(ImGui_ImplSoft_WorkerMain, bd));
+    return true;
+}
+
+void ImGui_ImplSoft_Shutdown()
+{
+    ImGui_ImplSoft_Data* bd = ImGui_ImplSoft_GetBackendData();
+    IM_ASSERT(bd != NULL && "No renderer backend to shutdown, or already shutdown?");
+    ImGuiIO& io = ImGui::GetIO();
+
+    {
+        std::lock_guard<std::mutex> lock(bd->Mutex);
+        bd->Stopping = true;
+        bd->Wake.notify_all();
+    }
+    for (std::thread& thread : bd->Threads)
+        thread.join();
+    ImGui_ImplSoft_InvalidateDeviceObjects();
+    io.BackendRendererName = NULL;
+    io.BackendRendererUserData = NULL;
+    IM_DELETE(bd);
+}
+
+void ImGui_ImplSoft_NewFrame()
+{
+    ImGui_ImplSoft_Data* bd = ImGui_ImplSoft_GetBackendData();
+    IM_ASSERT(bd != NULL && "Did you call ImGui_ImplSoft_Init()?");
+
+    if (!bd->FontTexture.Pixels)
+        ImGui_ImplSoft_CreateDeviceObjects();
+}
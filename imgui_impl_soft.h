@@ -0,0 +1,55 @@
+// dear imgui: Renderer Backend rasterizing on the CPU into a memory framebuffer
+// This needs to be used along with a Platform Backend, or with io.DisplaySize/io.DeltaTime/inputs set by hand (headless).
+
+// Implemented features:
+//  [X] Renderer: User texture binding. Use 'ImGui_ImplSoft_Texture*' as ImTextureID.
+//  [X] Renderer: Support for large meshes (64k+ vertices) with 16-bit indices.
+//  [X] Renderer: Font atlas regions changed after the build (ImFontConfig::DynamicGlyphs), see ImFontAtlas::TexUpdates.
+// Triangles are binned into 64x64 pixel tiles, worker threads take whole tiles so every pixel is blended in submission order.
+// Coverage uses edge functions evaluated for 4 pixels at a time with SSE2 (scalar fallback), pixel centers and a tie
+// rule so that triangles sharing an edge never blend the same pixel twice.
+// Textures are sampled bilinearly like the DX11 backend, but clamped instead of wrapped. Triangles with a single UV
+// (solid fills, they all use the atlas white pixel) sample once, and glyph quads mapping one texel to one pixel read
+// the texel directly.
+// User callbacks are called while binning, before any triangle is rasterized.
+
+#pragma once
+#include "imgui.h"      // IMGUI_IMPL_API
+
+// RGBA8 pixels with the IM_COL32() packing
+struct ImGui_ImplSoft_Texture
+{
+    const ImU32*    Pixels;
+    int             Width;
+    int             Height;
+};
+
+struct ImGui_ImplSoft_Framebuffer
+{
+    ImU32*          Pixels;         // RGBA8 with the IM_COL32() packing
+    int             Width;
+    int             Height;
+    int             Stride;         // In pixels, a multiple of 4 at least Width (4 pixels are read and written at once)
+};
+
+// Of the last ImGui_ImplSoft_RenderDrawData() call
+struct ImGui_ImplSoft_Stats
+{
+    int             Triangles;          // Rasterized, after dropping clipped and degenerate ones
+    int             TileBins;           // Triangle/tile pairs
+    int             ConstTexelTriangles;
+    int             NearestTriangles;   // Texel-aligned glyph quads
+    int             Threads;
+
+    ImGui_ImplSoft_Stats()              { memset((void*)this, 0, sizeof(*this)); }
+};
+
+IMGUI_IMPL_API bool     ImGui_ImplSoft_Init(int thread_count = 0);     // 0: one thread per hardware thread, 1: only the calling thread
+IMGUI_IMPL_API void     ImGui_ImplSoft_Shutdown();
+IMGUI_IMPL_API void     ImGui_ImplSoft_NewFrame();
+IMGUI_IMPL_API void     ImGui_ImplSoft_RenderDrawData(ImDrawData* draw_data, const ImGui_ImplSoft_Framebuffer* framebuffer);
+IMGUI_IMPL_API void     ImGui_ImplSoft_GetStats(ImGui_ImplSoft_Stats* out_stats);
+
+// Use if you want to rebuild the font texture without losing Dear ImGui state.
+IMGUI_IMPL_API void     ImGui_ImplSoft_InvalidateDeviceObjects();
+IMGUI_IMPL_API bool     ImGui_ImplSoft_CreateDeviceObjects();
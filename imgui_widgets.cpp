@@ -3647,6 +3647,111 @@ static ImVec2 InputTextCalcTextSizeW(const ImWchar* text_begin, const ImWchar* t
     return text_size;
 }
 
+// Line index of the edited text (ImGuiInputTextState::LineStartsW/LineStartsA), so that locating the cursor, laying out rows for
+// stb_textedit and rendering only touch the lines involved instead of rescanning the whole buffer. Lines are rows: we don't word-wrap.
+// Return the line containing character 'pos_w' (the last line starting at or before it).
+static int InputTextFindLine(const ImGuiInputTextState* state, int pos_w)
+{
+    const int* starts = state->LineStartsW.Data;
+    int lo = 0, hi = state->LineStartsW.Size;
+    while (hi - lo > 1)
+    {
+        const int mid = (lo + hi) >> 1;
+        if (starts[mid] <= pos_w)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// UTF-8 offset of character 'pos_w', only counting from the start of its line
+static int InputTextGetOffsetA(const ImGuiInputTextState* state, int pos_w)
+{
+    const int line = InputTextFindLine(state, pos_w);
+    const ImWchar* text = state->TextW.Data;
+    return state->LineStartsA[line] + ImTextCountUtf8BytesFromStr(text + state->LineStartsW[line], text + pos_w);
+}
+
+// Rebuild the whole line index from TextW
+static void InputTextReindexLines(ImGuiInputTextState* state)
+{
+    state->LineStartsW.resize(0);
+    state->LineStartsA.resize(0);
+    state->LineStartsW.push_back(0);
+    state->LineStartsA.push_back(0);
+    const ImWchar* text = state->TextW.Data;
+    const ImWchar* line_start = text;
+    int offset_a = 0;
+    for (const ImWchar* s = text, *s_end = text + state->CurLenW; s < s_end; s++)
+        if (*s == '\n')
+        {
+            offset_a += ImTextCountUtf8BytesFromStr(line_start, s + 1);
+            line_start = s + 1;
+            state->LineStartsW.push_back((int)(line_start - text));
+            state->LineStartsA.push_back(offset_a);
+        }
+}
+
+// Update the line index after the 'removed_w' characters at 'pos_w' were replaced by 'inserted_w' characters (already in TextW).
+// Lines starting inside the removed range go away, the new text adds one line per '\n' and the following lines are moved.
+static void InputTextReindexLinesRange(ImGuiInputTextState* state, int pos_w, int pos_a, int removed_w, int removed_a, int inserted_w, int inserted_a)
+{
+    ImVector<int>& starts_w = state->LineStartsW;
+    ImVector<int>& starts_a = state->LineStartsA;
+    const int first = InputTextFindLine(state, pos_w) + 1;
+    int last = first;
+    while (last < starts_w.Size && starts_w[last] <= pos_w + removed_w)
+        last++;
+
+    const ImWchar* inserted = state->TextW.Data + pos_w;
+    int new_lines = 0;
+    for (int n = 0; n < inserted_w; n++)
+        if (inserted[n] == '\n')
+            new_lines++;
+
+    // Make room for the new lines (or close the gap of the removed ones) and move the following lines
+    const int old_size = starts_w.Size;
+    const int new_size = old_size - (last - first) + new_lines;
+    if (new_size > old_size)
+    {
+        starts_w.resize(new_size);
+        starts_a.resize(new_size);
+    }
+    if (last != first + new_lines)
+    {
+        memmove(starts_w.Data + first + new_lines, starts_w.Data + last, (size_t)(old_size - last) * sizeof(int));
+        memmove(starts_a.Data + first + new_lines, starts_a.Data + last, (size_t)(old_size - last) * sizeof(int));
+    }
+    if (new_size < old_size)
+    {
+        starts_w.resize(new_size);
+        starts_a.resize(new_size);
+    }
+    const int delta_w = inserted_w - removed_w;
+    const int delta_a = inserted_a - removed_a;
+    if (delta_w != 0 || delta_a != 0)
+        for (int line = first + new_lines; line < new_size; line++)
+        {
+            starts_w[line] += delta_w;
+            starts_a[line] += delta_a;
+        }
+
+    // Lines started by the new text
+    int line = first;
+    const ImWchar* segment_start = inserted;
+    int offset_a = pos_a;
+    for (int n = 0; n < inserted_w; n++)
+        if (inserted[n] == '\n')
+        {
+            offset_a += ImTextCountUtf8BytesFromStr(segment_start, inserted + n + 1);
+            segment_start = inserted + n + 1;
+            starts_w[line] = pos_w + n + 1;
+            starts_a[line] = offset_a;
+            line++;
+        }
+}
+
 // Wrapper for stb_textedit.h to edit text (our wrapper is for: statically sized buffer, single-line, wchar characters. InputText converts between UTF-8 and wchar)
 namespace ImStb
 {
@@ -3669,6 +3774,26 @@ static void    STB_TEXTEDIT_LAYOUTROW(StbTexteditRow* r, ImGuiInputTextState* ob
     r->num_chars = (int)(text_remaining - (text + line_start_idx));
 }
 
+// Rows are the lines of the line index, all g.FontSize high, so stb_textedit can start its row searches next to the one it is looking for.
+// Start a row early when searching by y, so float rounding can't make us step over the target row.
+static int     STB_TEXTEDIT_SEEKROW_BY_Y_IMPL(ImGuiInputTextState* obj, float y, float* out_row_y)
+{
+    ImGuiContext& g = *GImGui;
+    const int line = (int)ImClamp(y / g.FontSize - 1.0f, 0.0f, (float)(obj->LineStartsW.Size - 1));
+    *out_row_y = line * g.FontSize;
+    return obj->LineStartsW[line];
+}
+static int     STB_TEXTEDIT_SEEKROW_BY_CHAR_IMPL(ImGuiInputTextState* obj, int idx, int* out_prev_row_start, float* out_row_y)
+{
+    ImGuiContext& g = *GImGui;
+    const int line = InputTextFindLine(obj, idx);
+    *out_prev_row_start = obj->LineStartsW[ImMax(line - 1, 0)];
+    *out_row_y = line * g.FontSize;
+    return obj->LineStartsW[line];
+}
+#define STB_TEXTEDIT_SEEKROW_BY_Y       STB_TEXTEDIT_SEEKROW_BY_Y_IMPL      // They need to be #define for stb_textedit.h
+#define STB_TEXTEDIT_SEEKROW_BY_CHAR    STB_TEXTEDIT_SEEKROW_BY_CHAR_IMPL
+
 // When ImGuiInputTextFlags_Password is set, we don't want actions such as CTRL+Arrow to leak the fact that underlying data are blanks or separators.
 static bool is_separator(unsigned int c)                                        { return ImCharIsBlankW(c) || c==',' || c==';' || c=='(' || c==')' || c=='{' || c=='}' || c=='[' || c==']' || c=='|' || c=='\n' || c=='\r'; }
 static int  is_word_boundary_from_right(ImGuiInputTextState* obj, int idx)      { if (obj->Flags & ImGuiInputTextFlags_Password) return 0; return idx > 0 ? (is_separator(obj->TextW[idx - 1]) && !is_separator(obj->TextW[idx]) ) : 1; }
@@ -3688,15 +3813,17 @@ static void STB_TEXTEDIT_DELETECHARS(ImGuiInputTextState* obj, int pos, int n)
     ImWchar* dst = obj->TextW.Data + pos;
 
     // We maintain our buffer length in both UTF-8 and wchar formats
+    const int pos_a = InputTextGetOffsetA(obj, pos);
+    const int n_a = ImTextCountUtf8BytesFromStr(dst, dst + n);
+    if (obj->TextAIsValid)
+        memmove(obj->TextA.Data + pos_a, obj->TextA.Data + pos_a + n_a, (size_t)(obj->CurLenA - pos_a - n_a + 1));
     obj->Edited = true;
-    obj->CurLenA -= ImTextCountUtf8BytesFromStr(dst, dst + n);
+    obj->CurLenA -= n_a;
     obj->CurLenW -= n;
 
-    // Offset remaining text (FIXME-OPT: Use memmove)
-    const ImWchar* src = obj->TextW.Data + pos + n;
-    while (ImWchar c = *src++)
-        *dst++ = c;
-    *dst = '\0';
+    // Offset remaining text
+    memmove(dst, dst + n, (size_t)(obj->CurLenW - pos + 1) * sizeof(ImWchar));
+    InputTextReindexLinesRange(obj, pos, pos_a, n, n_a, 0, 0);
 }
 
 static bool STB_TEXTEDIT_INSERTCHARS(ImGuiInputTextState* obj, int pos, const ImWchar* new_text, int new_text_len)
@@ -3719,14 +3846,28 @@ static bool STB_TEXTEDIT_INSERTCHARS(ImGuiInputTextState* obj, int pos, const Im
     }
 
     ImWchar* text = obj->TextW.Data;
+    const int pos_a = InputTextGetOffsetA(obj, pos);
     if (pos != text_len)
         memmove(text + pos + new_text_len, text + pos, (size_t)(text_len - pos) * sizeof(ImWchar));
     memcpy(text + pos, new_text, (size_t)new_text_len * sizeof(ImWchar));
 
+    // Same edit in the UTF-8 buffer (ImTextStrToUtf8() writes a zero-terminator after the new text, over the first moved byte)
+    if (obj->TextAIsValid)
+    {
+        if (obj->CurLenA + new_text_len_utf8 + 1 > obj->TextA.Size)
+            obj->TextA.resize(obj->CurLenA + new_text_len_utf8 + 1);
+        char* text_a = obj->TextA.Data;
+        memmove(text_a + pos_a + new_text_len_utf8, text_a + pos_a, (size_t)(obj->CurLenA - pos_a + 1));
+        const char overwritten = text_a[pos_a + new_text_len_utf8];
+        ImTextStrToUtf8(text_a + pos_a, new_text_len_utf8 + 1, new_text, new_text + new_text_len);
+        text_a[pos_a + new_text_len_utf8] = overwritten;
+    }
+
     obj->Edited = true;
     obj->CurLenW += new_text_len;
     obj->CurLenA += new_text_len_utf8;
     obj->TextW[obj->CurLenW] = '\0';
+    InputTextReindexLinesRange(obj, pos, pos_a, 0, 0, new_text_len, new_text_len_utf8);
 
     return true;
 }
@@ -4053,6 +4194,7 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         state->TextAIsValid = false;                // TextA is not valid yet (we will display buf until then)
         state->CurLenW = ImTextStrFromUtf8(state->TextW.Data, buf_size, buf, NULL, &buf_end);
         state->CurLenA = (int)(buf_end - buf);      // We can't get the result from ImStrncpy() above because it is not UTF-8 aware. Here we'll cut off malformed UTF-8.
+        InputTextReindexLines(state);
 
         // Preserve cursor position and undo/redo stack if we come back to same widget
         // FIXME: For non-readonly widgets we might be able to require that TextAIsValid && TextA == buf ? (untested) and discard undo stack if user buffer has changed.
@@ -4132,6 +4274,7 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         state->TextW.resize(buf_size + 1);
         state->CurLenW = ImTextStrFromUtf8(state->TextW.Data, state->TextW.Size, buf, NULL, &buf_end);
         state->CurLenA = (int)(buf_end - buf);
+        InputTextReindexLines(state);
         state->CursorClamp();
         render_selection &= state->HasSelection();
     }
@@ -4432,12 +4575,13 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
             // Apply new value immediately - copy modified buffer back
             // Note that as soon as the input box is active, the in-widget value gets priority over any underlying modification of the input buffer
             // FIXME: We actually always render 'buf' when calling DrawList->AddText, making the comment above incorrect.
-            // FIXME-OPT: CPU waste to do this every time the widget is active, should mark dirty state from the stb_textedit callbacks.
+            // Once converted, TextA is kept up to date by STB_TEXTEDIT_INSERTCHARS()/STB_TEXTEDIT_DELETECHARS(), so we only convert it the first time.
             if (!is_readonly)
             {
+                state->TextA.resize(ImMax(state->TextA.Size, state->TextW.Size * 4 + 1));
+                if (!state->TextAIsValid)
+                    ImTextStrToUtf8(state->TextA.Data, state->TextA.Size, state->TextW.Data, NULL);
                 state->TextAIsValid = true;
-                state->TextA.resize(state->TextW.Size * 4 + 1);
-                ImTextStrToUtf8(state->TextA.Data, state->TextA.Size, state->TextW.Data, NULL);
             }
 
             // User callback
@@ -4487,11 +4631,10 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
                     callback_data.BufSize = state->BufCapacityA;
                     callback_data.BufDirty = false;
 
-                    // We have to convert from wchar-positions to UTF-8-positions, which can be pretty slow (an incentive to ditch the ImWchar buffer, see https://github.com/nothings/stb/issues/188)
-                    ImWchar* text = state->TextW.Data;
-                    const int utf8_cursor_pos = callback_data.CursorPos = ImTextCountUtf8BytesFromStr(text, text + state->Stb.cursor);
-                    const int utf8_selection_start = callback_data.SelectionStart = ImTextCountUtf8BytesFromStr(text, text + state->Stb.select_start);
-                    const int utf8_selection_end = callback_data.SelectionEnd = ImTextCountUtf8BytesFromStr(text, text + state->Stb.select_end);
+                    // We have to convert from wchar-positions to UTF-8-positions (only counting from the start of their line, see https://github.com/nothings/stb/issues/188 for ditching the ImWchar buffer)
+                    const int utf8_cursor_pos = callback_data.CursorPos = InputTextGetOffsetA(state, state->Stb.cursor);
+                    const int utf8_selection_start = callback_data.SelectionStart = InputTextGetOffsetA(state, state->Stb.select_start);
+                    const int utf8_selection_end = callback_data.SelectionEnd = InputTextGetOffsetA(state, state->Stb.select_end);
 
                     // Call user code
                     callback(&callback_data);
@@ -4512,6 +4655,9 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
                             state->TextW.resize(state->TextW.Size + (callback_data.BufTextLen - backup_current_text_length));
                         state->CurLenW = ImTextStrFromUtf8(state->TextW.Data, state->TextW.Size, callback_data.Buf, NULL);
                         state->CurLenA = callback_data.BufTextLen;  // Assume correct length and valid UTF-8 from user, saves us an extra strlen()
+                        if (!is_readonly)
+                            state->TextA.resize(ImMax(state->TextA.Size, state->CurLenA + 1)); // A resize callback may have only reserved it
+                        InputTextReindexLines(state);
                         state->CursorAnimReset();
                     }
                 }
@@ -4603,54 +4749,23 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         const ImWchar* text_begin = state->TextW.Data;
         ImVec2 cursor_offset, select_start_offset;
 
+        int select_start_line = 0;
         {
-            // Find lines numbers straddling 'cursor' (slot 0) and 'select_start' (slot 1) positions.
-            const ImWchar* searches_input_ptr[2] = { NULL, NULL };
-            int searches_result_line_no[2] = { -1000, -1000 };
-            int searches_remaining = 0;
-            if (render_cursor)
-            {
-                searches_input_ptr[0] = text_begin + state->Stb.cursor;
-                searches_result_line_no[0] = -1;
-                searches_remaining++;
-            }
+            // Find lines numbers of 'cursor' and 'select_start' positions in the line index, and calculate 2d position by measuring distance from the beginning of the line
+            const int cursor_line = InputTextFindLine(state, state->Stb.cursor);
+            cursor_offset.x = InputTextCalcTextSizeW(text_begin + state->LineStartsW[cursor_line], text_begin + state->Stb.cursor).x;
+            cursor_offset.y = (cursor_line + 1) * g.FontSize;
             if (render_selection)
             {
-                searches_input_ptr[1] = text_begin + ImMin(state->Stb.select_start, state->Stb.select_end);
-                searches_result_line_no[1] = -1;
-                searches_remaining++;
-            }
-
-            // Iterate all lines to find our line numbers
-            // In multi-line mode, we never exit the loop until all lines are counted, so add one extra to the searches_remaining counter.
-            searches_remaining += is_multiline ? 1 : 0;
-            int line_count = 0;
-            //for (const ImWchar* s = text_begin; (s = (const ImWchar*)wcschr((const wchar_t*)s, (wchar_t)'\n')) != NULL; s++)  // FIXME-OPT: Could use this when wchar_t are 16-bit
-            for (const ImWchar* s = text_begin; *s != 0; s++)
-                if (*s == '\n')
-                {
-                    line_count++;
-                    if (searches_result_line_no[0] == -1 && s >= searches_input_ptr[0]) { searches_result_line_no[0] = line_count; if (--searches_remaining <= 0) break; }
-                    if (searches_result_line_no[1] == -1 && s >= searches_input_ptr[1]) { searches_result_line_no[1] = line_count; if (--searches_remaining <= 0) break; }
-                }
-            line_count++;
-            if (searches_result_line_no[0] == -1)
-                searches_result_line_no[0] = line_count;
-            if (searches_result_line_no[1] == -1)
-                searches_result_line_no[1] = line_count;
-
-            // Calculate 2d position by finding the beginning of the line and measuring distance
-            cursor_offset.x = InputTextCalcTextSizeW(ImStrbolW(searches_input_ptr[0], text_begin), searches_input_ptr[0]).x;
-            cursor_offset.y = searches_result_line_no[0] * g.FontSize;
-            if (searches_result_line_no[1] >= 0)
-            {
-                select_start_offset.x = InputTextCalcTextSizeW(ImStrbolW(searches_input_ptr[1], text_begin), searches_input_ptr[1]).x;
-                select_start_offset.y = searches_result_line_no[1] * g.FontSize;
+                const int select_start = ImMin(state->Stb.select_start, state->Stb.select_end);
+                select_start_line = InputTextFindLine(state, select_start);
+                select_start_offset.x = InputTextCalcTextSizeW(text_begin + state->LineStartsW[select_start_line], text_begin + select_start).x;
+                select_start_offset.y = (select_start_line + 1) * g.FontSize;
             }
 
             // Store text height (note that we haven't calculated text width at all, see GitHub issues #383, #1224)
             if (is_multiline)
-                text_size = ImVec2(inner_size.x, line_count * g.FontSize);
+                text_size = ImVec2(inner_size.x, state->LineStartsW.Size * g.FontSize);
         }
 
         // Scroll
@@ -4699,7 +4814,16 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
             float bg_offy_up = is_multiline ? 0.0f : -1.0f;    // FIXME: those offsets should be part of the style? they don't play so well with multi-line selection.
             float bg_offy_dn = is_multiline ? 0.0f : 2.0f;
             ImVec2 rect_pos = draw_pos + select_start_offset - draw_scroll;
-            for (const ImWchar* p = text_selected_begin; p < text_selected_end; )
+            const ImWchar* p = text_selected_begin;
+
+            // Jump over the selected lines above the clipping rectangle with the line index
+            const int first_visible_line = (int)ImClamp((clip_rect.y - draw_pos.y) / g.FontSize - 1.0f, 0.0f, (float)state->LineStartsW.Size);
+            if (first_visible_line > select_start_line)
+            {
+                p = (first_visible_line < state->LineStartsW.Size) ? ImMin(text_begin + state->LineStartsW[first_visible_line], text_selected_end) : text_selected_end;
+                rect_pos = ImVec2(draw_pos.x - draw_scroll.x, draw_pos.y + (first_visible_line + 1) * g.FontSize);
+            }
+            while (p < text_selected_end)
             {
                 if (rect_pos.y > clip_rect.w + g.FontSize)
                     break;
@@ -4728,8 +4852,26 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         // We test for 'buf_display_max_length' as a way to avoid some pathological cases (e.g. single-line 1 MB string) which would make ImDrawList crash.
         if (is_multiline || (buf_display_end - buf_display) < buf_display_max_length)
         {
+            // Multi-line: only submit the lines overlapping the clipping rectangle, found with the line index. This is what ImGuiListClipper
+            // would do, but it works from the window cursor which doesn't know about the scrolling we may have applied above during this frame.
+            // (The line index is in TextA offsets, which are those of 'buf' only once we display from TextA)
+            ImVec2 text_pos = draw_pos - draw_scroll;
+            const char* text_display_begin = buf_display;
+            const char* text_display_end = buf_display_end;
+            if (is_multiline && buf_display_from_state && !is_displaying_hint)
+            {
+                const ImVec2 draw_clip_min = draw_window->DrawList->GetClipRectMin();
+                const ImVec2 draw_clip_max = draw_window->DrawList->GetClipRectMax();
+                const int line_count = state->LineStartsA.Size;
+                const int line_begin = (int)ImClamp((draw_clip_min.y - text_pos.y) / g.FontSize - 1.0f, 0.0f, (float)(line_count - 1));
+                const int line_end = (int)ImClamp((draw_clip_max.y - text_pos.y) / g.FontSize + 2.0f, (float)line_begin, (float)line_count);
+                text_display_begin = buf_display + state->LineStartsA[line_begin];
+                if (line_end < line_count)
+                    text_display_end = buf_display + state->LineStartsA[line_end];
+                text_pos.y += line_begin * g.FontSize;
+            }
             ImU32 col = GetColorU32(is_displaying_hint ? ImGuiCol_TextDisabled : ImGuiCol_Text);
-            draw_window->DrawList->AddText(g.Font, g.FontSize, draw_pos - draw_scroll, col, buf_display, buf_display_end, 0.0f, is_multiline ? NULL : &clip_rect);
+            draw_window->DrawList->AddText(g.Font, g.FontSize, text_pos, col, text_display_begin, text_display_end, 0.0f, is_multiline ? NULL : &clip_rect);
         }
 
         // Draw blinking cursor
@@ -2,6 +2,7 @@
 // This is a slightly modified version of stb_textedit.h 1.14.
 // Those changes would need to be pushed into nothings/stb:
 // - Fix in stb_textedit_discard_redo (see https://github.com/nothings/stb/issues/321)
+// - Optional STB_TEXTEDIT_SEEKROW_BY_Y/STB_TEXTEDIT_SEEKROW_BY_CHAR, so row searches don't always start from the first row
 // Grep for [DEAR IMGUI] to find the changes.
 
 // stb_textedit.h - v1.14  - public domain - Sean Barrett
@@ -173,6 +174,9 @@
 //    STB_TEXTEDIT_K_LINEEND2            secondary keyboard input to move cursor to end of line
 //    STB_TEXTEDIT_K_TEXTSTART2          secondary keyboard input to move cursor to start of text
 //    STB_TEXTEDIT_K_TEXTEND2            secondary keyboard input to move cursor to end of text
+//    STB_TEXTEDIT_SEEKROW_BY_Y(obj,y,&row_y)                   returns the start of a row at or above 'y' and its y, to search rows from there
+//    STB_TEXTEDIT_SEEKROW_BY_CHAR(obj,i,&prev_start,&row_y)    returns the start of the row containing character #i, the start of the row
+//                                                                before it (or the same start for the first row) and its y
 //
 // Keyboard input must be encoded as a single integer value; e.g. a character code
 // and some bitflags that represent shift states. to simplify the interface, SHIFT must
@@ -408,6 +412,12 @@ static int stb_text_locate_coord(STB_TEXTEDIT_STRING *str, float x, float y)
    r.ymin = r.ymax = 0;
    r.num_chars = 0;
 
+   // [DEAR IMGUI]
+   // start from a row next to 'y' when the client can find it, instead of laying out every row above it
+   #ifdef STB_TEXTEDIT_SEEKROW_BY_Y
+   i = STB_TEXTEDIT_SEEKROW_BY_Y(str, y, &base_y);
+   #endif
+
    // search rows to find one that straddles 'y'
    while (i < n) {
       STB_TEXTEDIT_LAYOUTROW(&r, str, i);
@@ -538,6 +548,10 @@ static void stb_textedit_find_charpos(StbFindState *find, STB_TEXTEDIT_STRING *s
          find->y = 0;
          find->x = 0;
          find->height = 1;
+         // [DEAR IMGUI]
+         #ifdef STB_TEXTEDIT_SEEKROW_BY_CHAR
+         i = STB_TEXTEDIT_SEEKROW_BY_CHAR(str, z, &prev_start, &find->y);
+         #endif
          while (i < z) {
             STB_TEXTEDIT_LAYOUTROW(&r, str, i);
             prev_start = i;
@@ -552,6 +566,10 @@ static void stb_textedit_find_charpos(StbFindState *find, STB_TEXTEDIT_STRING *s
 
    // search rows to find the one that straddles character n
    find->y = 0;
+   // [DEAR IMGUI]
+   #ifdef STB_TEXTEDIT_SEEKROW_BY_CHAR
+   i = STB_TEXTEDIT_SEEKROW_BY_CHAR(str, n, &prev_start, &find->y);
+   #endif
 
    for(;;) {
       STB_TEXTEDIT_LAYOUTROW(&r, str, i);
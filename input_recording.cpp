@@ -0,0 +1,187 @@
+#include <cstring>
+
+#include "input_recording.h"
+
+
+static const char inputMagic[4] = { 'G', 'L', 'I', 'R' };
+static const uint16_t inputVersion = 1;
+
+static size_t putVarint(uint8_t* out, uint64_t value)
+{
+    size_t size = 0;
+    while (value >= 0x80)
+    {
+        out[size++] = static_cast<uint8_t>(value) | 0x80;
+        value >>= 7;
+    }
+    out[size++] = static_cast<uint8_t>(value);
+    return size;
+}
+
+static uint64_t zigzag(int32_t value)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(value)) << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63);
+}
+
+static int32_t unzigzag(uint64_t value)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(value >> 1) ^ static_cast<uint32_t>(0 - (value & 1)));
+}
+
+static bool hasSecondValue(InputEventType type)
+{
+    return type == InputEventType::Rotate;
+}
+
+InputRecorder::~InputRecorder()
+{
+    close();
+}
+
+bool InputRecorder::open(std::string const& path, double fixedStep)
+{
+    close();
+    file = fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    uint8_t header[14];
+    memcpy(header, inputMagic, 4);
+    header[4] = static_cast<uint8_t>(inputVersion);
+    header[5] = static_cast<uint8_t>(inputVersion >> 8);
+    uint64_t bits;
+    memcpy(&bits, &fixedStep, sizeof(bits));
+    for (int i = 0; i < 8; i++)
+        header[6 + i] = static_cast<uint8_t>(bits >> (8 * i));
+
+    lastStep = 0;
+    count = 0;
+    failed = fwrite(header, sizeof(header), 1, file) != 1;
+    return !failed;
+}
+
+void InputRecorder::record(InputEvent const& event)
+{
+    if (!file || event.step < lastStep)
+        return;
+
+    uint8_t buffer[32];
+    size_t size = putVarint(buffer, event.step - lastStep);
+    buffer[size++] = static_cast<uint8_t>(event.type);
+    size += putVarint(buffer + size, zigzag(event.value));
+    if (hasSecondValue(event.type))
+        size += putVarint(buffer + size, zigzag(event.value2));
+
+    if (fwrite(buffer, size, 1, file) != 1)
+        failed = true;
+    lastStep = event.step;
+    count++;
+}
+
+bool InputRecorder::close()
+{
+    if (!file)
+        return true;
+    bool ok = fclose(file) == 0 && !failed;
+    file = nullptr;
+    return ok;
+}
+
+bool InputPlayer::load(std::string const& path, std::string& error)
+{
+    FILE* in = fopen(path.c_str(), "rb");
+    if (!in)
+    {
+        error = "can't open " + path;
+        return false;
+    }
+
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), in)) > 0)
+        data.insert(data.end(), chunk, chunk + read);
+    fclose(in);
+
+    if (!parse(data, error))
+    {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+bool InputPlayer::parse(std::vector<uint8_t> const& data, std::string& error)
+{
+    events.clear();
+    position = 0;
+
+    if (data.size() < 14 || memcmp(data.data(), inputMagic, 4))
+    {
+        error = "not an input recording";
+        return false;
+    }
+    auto version = static_cast<uint16_t>(data[4] | data[5] << 8);
+    if (version != inputVersion)
+    {
+        error = "unsupported version " + std::to_string(version);
+        return false;
+    }
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; i++)
+        bits |= static_cast<uint64_t>(data[6 + i]) << (8 * i);
+    memcpy(&step, &bits, sizeof(step));
+
+    size_t offset = 14;
+    auto getVarint = [&data, &offset](uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && offset < data.size(); shift += 7)
+        {
+            auto byte = data[offset++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    };
+
+    uint64_t current = 0;
+    while (offset < data.size())
+    {
+        InputEvent event;
+        uint64_t delta, value, value2 = 0;
+        if (!getVarint(delta) || offset >= data.size())
+        {
+            error = "truncated event " + std::to_string(events.size());
+            return false;
+        }
+        auto type = data[offset++];
+        if (type >= static_cast<uint8_t>(InputEventType::Count))
+        {
+            error = "unknown event type " + std::to_string(type);
+            return false;
+        }
+        event.type = static_cast<InputEventType>(type);
+        if (!getVarint(value) || (hasSecondValue(event.type) && !getVarint(value2)))
+        {
+            error = "truncated event " + std::to_string(events.size());
+            return false;
+        }
+
+        current += delta;
+        event.step = current;
+        event.value = unzigzag(value);
+        event.value2 = unzigzag(value2);
+        events.push_back(event);
+    }
+    return true;
+}
+
+bool InputPlayer::next(uint64_t step, InputEvent& event)
+{
+    if (position == events.size() || events[position].step > step)
+        return false;
+    // events of skipped steps are applied late rather than lost
+    event = events[position++];
+    return true;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Portable input stream. Window turns key and mouse messages into InputEvents,
+// they are applied at the start of the next fixed simulation step and can be
+// recorded to a file and replayed step for step.
+
+enum class InputEventType : uint8_t
+{
+    // value: 1 pressed, 0 released
+    MoveLeft,
+    MoveRight,
+    MoveForward,
+    MoveBackward,
+    MoveUp,
+    MoveDown,
+    // value, value2: mouse delta in pixels
+    Rotate,
+    // value: light index
+    ResetLightIntensity,
+    IncreaseLightIntensity,
+    DecreaseLightIntensity,
+
+    Count
+};
+
+struct InputEvent
+{
+    // simulation step the event is applied before
+    uint64_t step = 0;
+    InputEventType type = InputEventType::MoveLeft;
+    int32_t value = 0;
+    int32_t value2 = 0;
+};
+
+// File layout, little endian:
+//   "GLIR", uint16 version, float64 fixed step
+//   per event: varint step delta, uint8 type, zigzag varint value, zigzag varint value2 (Rotate only)
+class InputRecorder
+{
+public:
+    InputRecorder() = default;
+    ~InputRecorder();
+
+    bool open(std::string const& path, double fixedStep);
+    // events must come in step order
+    void record(InputEvent const& event);
+    bool close();
+
+    bool isOpen() const { return file != nullptr; }
+    uint64_t eventCount() const { return count; }
+
+private:
+    InputRecorder(InputRecorder const&) = delete;
+    InputRecorder& operator=(InputRecorder const&) = delete;
+
+    FILE* file = nullptr;
+    uint64_t lastStep = 0;
+    uint64_t count = 0;
+    bool failed = false;
+};
+
+class InputPlayer
+{
+public:
+    bool load(std::string const& path, std::string& error);
+    // decode from memory, used by load
+    bool parse(std::vector<uint8_t> const& data, std::string& error);
+
+    // next event for this step, false when the step has no more events
+    bool next(uint64_t step, InputEvent& event);
+    // no events left
+    bool done() const { return position == events.size(); }
+
+    double fixedStep() const { return step; }
+    // step of the last event, the replay is complete after it ran
+    uint64_t lastStep() const { return events.empty() ? 0 : events.back().step; }
+    std::vector<InputEvent> const& allEvents() const { return events; }
+    void rewind() { position = 0; }
+
+private:
+    std::vector<InputEvent> events;
+    size_t position = 0;
+    double step = 0.0;
+};
@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <string>
+
+#include "job_system.h"
+#include "profiler.h"
+
+
+struct Job
+{
+    std::function<void()> func;
+    JobCounter* counter = nullptr;
+    // set while queued or running, the slot is reused once it's cleared
+    std::atomic<bool> pending = false;
+};
+
+struct JobSystem::Worker
+{
+    // a worker never has more jobs in flight than slots, so its deque can't overflow
+    static constexpr uint32_t jobCapacity = 4096;
+
+    WorkStealingDeque queue = WorkStealingDeque(jobCapacity);
+    std::unique_ptr<Job[]> jobs = std::unique_ptr<Job[]>(new Job[jobCapacity]);
+    uint32_t nextJob = 0;
+    uint32_t index = 0;
+    // xorshift state for picking victims
+    uint32_t random = 0;
+};
+
+// the job system and worker of the calling thread, if it is one
+static thread_local JobSystem const* threadSystem = nullptr;
+static thread_local void* threadWorker = nullptr;
+
+WorkStealingDeque::WorkStealingDeque(uint32_t capacity) :
+    buffer(new std::atomic<Job*>[capacity]), mask(static_cast<int64_t>(capacity) - 1)
+{
+    for (uint32_t i = 0; i < capacity; i++)
+        buffer[i].store(nullptr, std::memory_order_relaxed);
+}
+
+bool WorkStealingDeque::push(Job* job)
+{
+    auto b = bottom.load(std::memory_order_relaxed);
+    auto t = top.load(std::memory_order_acquire);
+    if (b - t > mask)
+        return false;
+
+    buffer[b & mask].store(job, std::memory_order_relaxed);
+    // publishes the job to stealers
+    bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+Job* WorkStealingDeque::pop()
+{
+    auto b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto t = top.load(std::memory_order_relaxed);
+
+    if (t > b)
+    {
+        // empty
+        bottom.store(b + 1, std::memory_order_release);
+        return nullptr;
+    }
+
+    auto job = buffer[b & mask].load(std::memory_order_relaxed);
+    if (t == b)
+    {
+        // last job, race the stealers for it
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            job = nullptr;
+        bottom.store(b + 1, std::memory_order_release);
+    }
+    return job;
+}
+
+Job* WorkStealingDeque::steal()
+{
+    auto t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto b = bottom.load(std::memory_order_acquire);
+    if (t >= b)
+        return nullptr;
+
+    auto job = buffer[t & mask].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr;
+    return job;
+}
+
+bool WorkStealingDeque::empty() const
+{
+    return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+}
+
+JobSystem::JobSystem(uint32_t workerCount)
+{
+    if (workerCount == DefaultWorkerCount)
+        workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+    // slot 0 belongs to the creating thread
+    for (uint32_t i = 0; i <= workerCount; i++)
+    {
+        workers.push_back(std::make_unique<Worker>());
+        workers.back()->index = i;
+        workers.back()->random = 0x9e3779b9u * (i + 1);
+    }
+    threadSystem = this;
+    threadWorker = workers[0].get();
+
+    for (uint32_t i = 1; i <= workerCount; i++)
+        threads.emplace_back(&JobSystem::workerMain, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads)
+        thread.join();
+
+    if (threadSystem == this)
+    {
+        threadSystem = nullptr;
+        threadWorker = nullptr;
+    }
+}
+
+JobSystem::Worker* JobSystem::currentWorker() const
+{
+    return threadSystem == this ? static_cast<Worker*>(threadWorker) : nullptr;
+}
+
+Job* JobSystem::allocate(Worker& worker)
+{
+    // a busy slot may belong to a job further up this thread's stack, so it
+    // can't be waited for; skip it and give up after a few
+    for (uint32_t probe = 0; probe < 64; probe++)
+    {
+        auto job = &worker.jobs[worker.nextJob++ & (Worker::jobCapacity - 1)];
+        if (!job->pending.load(std::memory_order_acquire))
+            return job;
+    }
+    return nullptr;
+}
+
+Job* JobSystem::findJob(Worker& worker)
+{
+    if (auto job = worker.queue.pop())
+    {
+        queued.fetch_sub(1);
+        return job;
+    }
+
+    auto count = static_cast<uint32_t>(workers.size());
+    worker.random ^= worker.random << 13;
+    worker.random ^= worker.random >> 17;
+    worker.random ^= worker.random << 5;
+    auto start = worker.random % count;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto& victim = *workers[(start + i) % count];
+        if (&victim == &worker)
+            continue;
+        if (auto job = victim.queue.steal())
+        {
+            queued.fetch_sub(1);
+            stolen.fetch_add(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(Job* job)
+{
+    job->func();
+    job->func = nullptr;
+
+    auto counter = job->counter;
+    job->pending.store(false, std::memory_order_release);
+    executed.fetch_add(1, std::memory_order_relaxed);
+    counter->value.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void JobSystem::run(std::function<void()> func, JobCounter& counter)
+{
+    counter.value.fetch_add(1, std::memory_order_relaxed);
+
+    auto worker = currentWorker();
+    auto job = worker ? allocate(*worker) : nullptr;
+    if (!job)
+    {
+        // only job threads own a deque, and only while they have free slots
+        func();
+        inlined.fetch_add(1, std::memory_order_relaxed);
+        executed.fetch_add(1, std::memory_order_relaxed);
+        counter.value.fetch_sub(1, std::memory_order_acq_rel);
+        return;
+    }
+
+    job->func = std::move(func);
+    job->counter = &counter;
+    job->pending.store(true, std::memory_order_relaxed);
+
+    if (!worker->queue.push(job))
+    {
+        inlined.fetch_add(1, std::memory_order_relaxed);
+        execute(job);
+        return;
+    }
+
+    queued.fetch_add(1);
+    if (sleepers.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wake.notify_one();
+    }
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+    auto worker = currentWorker();
+    while (!counter.done())
+    {
+        Job* job = worker ? findJob(*worker) : nullptr;
+        if (job)
+            execute(job);
+        else
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::parallelFor(uint32_t count, uint32_t grain, std::function<void(uint32_t, uint32_t)> const& body)
+{
+    grain = std::max(grain, 1u);
+    if (count <= grain)
+    {
+        if (count)
+            body(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    // the caller takes the first range itself
+    for (uint32_t begin = grain; begin < count; begin += grain)
+    {
+        auto end = std::min(begin + grain, count);
+        run([&body, begin, end]() { body(begin, end); }, counter);
+    }
+    body(0, grain);
+    wait(counter);
+}
+
+JobSystemStats JobSystem::stats() const
+{
+    JobSystemStats stats;
+    stats.executed = executed.load(std::memory_order_relaxed);
+    stats.stolen = stolen.load(std::memory_order_relaxed);
+    stats.inlined = inlined.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void JobSystem::workerMain(uint32_t index)
+{
+    auto& worker = *workers[index];
+    threadSystem = this;
+    threadWorker = &worker;
+    Profiler::get().setThreadName("Job worker " + std::to_string(index));
+
+    while (!stopping.load())
+    {
+        if (auto job = findJob(worker))
+        {
+            execute(job);
+            continue;
+        }
+
+        // jobs come in bursts, spin briefly before sleeping
+        bool busy = false;
+        for (int spin = 0; spin < 64 && !busy; spin++)
+        {
+            std::this_thread::yield();
+            busy = queued.load() > 0;
+        }
+        if (busy)
+            continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepers.fetch_add(1);
+        wake.wait(lock, [this]() { return queued.load() > 0 || stopping.load(); });
+        sleepers.fetch_sub(1);
+    }
+
+    threadSystem = nullptr;
+    threadWorker = nullptr;
+}
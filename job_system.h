@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Portable work-stealing job system. Every worker, and the thread that created
+// the system, owns a Chase-Lev deque: it pushes and pops at the bottom, idle
+// threads steal from the top. Dependencies are expressed with JobCounters,
+// waiting on one executes other jobs instead of blocking.
+
+struct Job;
+
+// number of unfinished jobs started with it, must outlive them
+class JobCounter
+{
+public:
+    JobCounter() = default;
+    JobCounter(JobCounter const&) = delete;
+    JobCounter& operator=(JobCounter const&) = delete;
+
+    bool done() const { return value.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<uint32_t> value = 0;
+};
+
+// Chase-Lev deque of a fixed capacity ("Correct and Efficient Work-Stealing for
+// Weak Memory Models", Le et al. 2013)
+class WorkStealingDeque
+{
+public:
+    explicit WorkStealingDeque(uint32_t capacity);
+
+    // owner only, false when full
+    bool push(Job* job);
+    // owner only, newest job first
+    Job* pop();
+    // any thread, oldest job first
+    Job* steal();
+
+    bool empty() const;
+
+private:
+    std::unique_ptr<std::atomic<Job*>[]> buffer;
+    int64_t mask;
+    alignas(64) std::atomic<int64_t> top = 0;
+    alignas(64) std::atomic<int64_t> bottom = 0;
+};
+
+struct JobSystemStats
+{
+    uint64_t executed = 0;
+    uint64_t stolen = 0;
+    // jobs run inline because the caller isn't a job thread or had no free job slot
+    uint64_t inlined = 0;
+};
+
+class JobSystem
+{
+public:
+    // one worker per hardware thread besides the caller
+    static const uint32_t DefaultWorkerCount = ~0u;
+
+    // threads besides the caller, 0 runs every job on the threads that wait
+    explicit JobSystem(uint32_t workerCount = DefaultWorkerCount);
+    ~JobSystem();
+
+    // start a job, counter is incremented now and decremented when it finished
+    void run(std::function<void()> job, JobCounter& counter);
+    // execute jobs until the counter reaches zero
+    void wait(JobCounter& counter);
+
+    // split [0, count) into ranges of at most grain items and wait for all of them
+    void parallelFor(uint32_t count, uint32_t grain, std::function<void(uint32_t begin, uint32_t end)> const& body);
+
+    // workers plus the creating thread
+    uint32_t threadCount() const { return static_cast<uint32_t>(workers.size()); }
+    JobSystemStats stats() const;
+
+private:
+    JobSystem(JobSystem const&) = delete;
+    JobSystem& operator=(JobSystem const&) = delete;
+
+    struct Worker;
+
+    Worker* currentWorker() const;
+    Job* allocate(Worker& worker);
+    Job* findJob(Worker& worker);
+    void execute(Job* job);
+    void workerMain(uint32_t index);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    // jobs pushed but not yet taken, wakes sleeping workers
+    std::atomic<int32_t> queued = 0;
+    std::atomic<int32_t> sleepers = 0;
+    std::atomic<bool> stopping = false;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    std::atomic<uint64_t> executed = 0;
+    std::atomic<uint64_t> stolen = 0;
+    std::atomic<uint64_t> inlined = 0;
+};
@@ -0,0 +1,103 @@
+#include <cstring>
+#include <algorithm>
+
+#include "material_registry.h"
+
+
+static_assert(sizeof(GpuMaterial) == 32, "GpuMaterial must match the stride of Material in pbr.fx");
+
+MaterialId MaterialRegistry::create(std::string const& name, GpuMaterial const& material)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    auto found = names.find(name);
+    if (found != names.end())
+    {
+        lock.unlock();
+        set(found->second, material);
+        return found->second;
+    }
+
+    auto id = static_cast<MaterialId>(materials.size());
+    materials.push_back(material);
+    names.emplace(name, id);
+    markDirty(id);
+    return id;
+}
+
+MaterialId MaterialRegistry::find(std::string const& name) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = names.find(name);
+    return found != names.end() ? found->second : InvalidMaterialId;
+}
+
+void MaterialRegistry::set(MaterialId id, GpuMaterial const& material)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (id >= materials.size() || !memcmp(&materials[id], &material, sizeof(GpuMaterial)))
+        return;
+    materials[id] = material;
+    markDirty(id);
+}
+
+GpuMaterial MaterialRegistry::get(MaterialId id) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return id < materials.size() ? materials[id] : GpuMaterial();
+}
+
+uint32_t MaterialRegistry::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<uint32_t>(materials.size());
+}
+
+void MaterialRegistry::markDirty(MaterialId id)
+{
+    if (dirtyBegin == dirtyEnd)
+    {
+        dirtyBegin = id;
+        dirtyEnd = id + 1;
+        return;
+    }
+    dirtyBegin = std::min(dirtyBegin, id);
+    dirtyEnd = std::max(dirtyEnd, id + 1);
+}
+
+uint32_t MaterialRegistry::flush(MaterialUploadFunc const& upload)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    _stats.frameUploads = 0;
+    _stats.frameBytes = 0;
+    if (dirtyBegin == dirtyEnd)
+        return 0;
+
+    // a failed upload keeps the range dirty so the next flush retries it, the callback
+    // can't call invalidate() itself while the lock is held
+    auto uploaded = upload(materials.data(), static_cast<uint32_t>(materials.size()), dirtyBegin, dirtyEnd);
+    if (uploaded == 0)
+        return 0;
+    dirtyBegin = dirtyEnd = 0;
+
+    _stats.frameUploads = uploaded;
+    _stats.frameBytes = uploaded * sizeof(GpuMaterial);
+    _stats.uploads += uploaded;
+    _stats.uploadedBytes += _stats.frameBytes;
+    _stats.flushes++;
+    return uploaded;
+}
+
+void MaterialRegistry::invalidate()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    dirtyBegin = 0;
+    dirtyEnd = static_cast<uint32_t>(materials.size());
+}
+
+MaterialStats MaterialRegistry::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto stats = _stats;
+    stats.materialCount = static_cast<uint32_t>(materials.size());
+    return stats;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
+
+// Portable material table. Materials get stable ids in creation order and live
+// in one array laid out like the shader's StructuredBuffer, so the GPU copy is
+// refreshed with a single upload of the changed range instead of a constant
+// buffer update per draw.
+
+using MaterialId = uint32_t;
+constexpr MaterialId InvalidMaterialId = ~0u;
+
+// Material in pbr.fx, 32 byte stride
+struct GpuMaterial
+{
+    float F0[3] = { 0.04f, 0.04f, 0.04f };
+    float roughness = 0.5f;
+    float metalness = 0.0f;
+    float _pad[3] = {};
+};
+
+struct MaterialStats
+{
+    uint32_t materialCount = 0;
+    // materials uploaded by the last flush
+    uint32_t frameUploads = 0;
+    uint64_t frameBytes = 0;
+    // totals since creation
+    uint64_t uploads = 0;
+    uint64_t uploadedBytes = 0;
+    // flushes that had something to upload
+    uint64_t flushes = 0;
+};
+
+// gets every material and the changed range [first, end), returns how many it uploaded;
+// 0 means the upload failed and the range is offered again by the next flush
+using MaterialUploadFunc = std::function<uint32_t(GpuMaterial const* materials, uint32_t count, uint32_t first, uint32_t end)>;
+
+// thread safe, materials may be created while another thread flushes
+class MaterialRegistry
+{
+public:
+    // the id of an existing material with that name, updated to the given values
+    MaterialId create(std::string const& name, GpuMaterial const& material);
+    MaterialId find(std::string const& name) const;
+
+    // no-op when the values didn't change
+    void set(MaterialId id, GpuMaterial const& material);
+    GpuMaterial get(MaterialId id) const;
+    uint32_t size() const;
+
+    // hand the changed range to upload, once per frame
+    uint32_t flush(MaterialUploadFunc const& upload);
+    // everything is uploaded again by the next flush, e.g. after the GPU buffer was lost
+    void invalidate();
+
+    MaterialStats stats() const;
+
+private:
+    void markDirty(MaterialId id);
+
+    mutable std::mutex mutex;
+    std::vector<GpuMaterial> materials;
+    std::unordered_map<std::string, MaterialId> names;
+    uint32_t dirtyBegin = 0;
+    uint32_t dirtyEnd = 0;
+    MaterialStats _stats;
+};
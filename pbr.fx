@@ -14,6 +14,10 @@ cbuffer PBRConstantBuffer : register(b0)
     float3 CameraPos;
     // draw mask
     int DrawMask;
+    int LightCount;
+    // into Materials
+    uint MaterialIndex;
+    float2 _pad;
 }
 
 /*
@@ -24,12 +28,21 @@ cbuffer PBRConstantBuffer : register(b0)
  * 3 -- G
  */
 
-cbuffer MaterialConstantBuffer : register(b1)
+struct Material
 {
     float3 F0;
     float roughness;
     float metalness;
-}
+    float3 _pad;
+};
+
+// every material of the scene, uploaded when one changes
+StructuredBuffer<Material> Materials : register(t0);
+
+// material of the current pixel, loaded at the top of PS
+static float3 F0;
+static float roughness;
+static float metalness;
 
 
 static const float PI = 3.14159f;
@@ -141,13 +154,18 @@ float3 fr(float3 albedo, float3 n, float3 v, float3 l)
 
 float4 PS(VS_OUTPUT input) : SV_Target
 {
+    Material material = Materials[MaterialIndex];
+    F0 = material.F0;
+    roughness = material.roughness;
+    metalness = material.metalness;
+
     float3 resultColor = float3(0.0f, 0.0f, 0.0f);
     // direction from point to camera
     float3 v = normalize(CameraPos - input.WorldPos);
     // normal
     float3 n = normalize(input.Norm);
 
-    for (uint i = 0; i < 3; i++) {
+    for (uint i = 0; i < (uint)LightCount; i++) {
         // direction from point to light
         float3 l = normalize(LightPos[i].xyz - input.WorldPos);
         // light color
@@ -15,6 +15,10 @@ public:
     void render(std::unique_ptr<Shader> const& shader,
         ID3D11SamplerState* samplerState = nullptr, ID3D11ShaderResourceView* tex = nullptr);
 
+    // render split up, so consecutive draws of one primitive bind it once
+    void bind() const;
+    void draw() const;
+
 private:
     template<typename VertexType>
     bool create(
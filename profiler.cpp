@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <chrono>
+
+#include "profiler.h"
+
+
+// single producer (the owning thread), single consumer (endFrame)
+struct Profiler::ThreadBuffer
+{
+    static constexpr uint64_t capacity = 1 << 14;
+
+    std::vector<ProfileEvent> ring = std::vector<ProfileEvent>(capacity);
+    std::atomic<uint64_t> head = 0;
+    std::atomic<uint64_t> tail = 0;
+    std::atomic<uint64_t> dropped = 0;
+
+    uint16_t id = 0;
+    std::string name;
+
+    // open scopes, only touched by the owning thread
+    struct Open
+    {
+        char const* name;
+        uint64_t start;
+    };
+    std::vector<Open> stack;
+
+    void push(ProfileEvent const& e)
+    {
+        auto h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= capacity)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        ring[h & (capacity - 1)] = e;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    void drain(std::vector<ProfileEvent>& out)
+    {
+        auto h = head.load(std::memory_order_acquire);
+        auto t = tail.load(std::memory_order_relaxed);
+        for (; t != h; t++)
+            out.push_back(ring[t & (capacity - 1)]);
+        tail.store(h, std::memory_order_release);
+    }
+};
+
+static std::chrono::steady_clock::time_point const clockOrigin = std::chrono::steady_clock::now();
+
+Profiler& Profiler::get()
+{
+    static Profiler inst;
+    return inst;
+}
+
+Profiler::Profiler()
+{
+    frameStart = now();
+}
+
+Profiler::~Profiler() = default;
+
+uint64_t Profiler::now() const
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now() - clockOrigin).count();
+}
+
+Profiler::ThreadBuffer& Profiler::threadBuffer()
+{
+    // buffers are never freed, so events of finished threads can still be collected
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer)
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        threads.push_back(std::make_unique<ThreadBuffer>());
+        buffer = threads.back().get();
+        buffer->id = static_cast<uint16_t>(threads.size() - 1);
+        buffer->name = buffer->id == 0 ? "Main" : "Thread " + std::to_string(buffer->id);
+    }
+    return *buffer;
+}
+
+void Profiler::begin(char const* name)
+{
+    threadBuffer().stack.push_back({ name, now() });
+}
+
+void Profiler::end()
+{
+    auto& buffer = threadBuffer();
+    if (buffer.stack.empty())
+        return;
+
+    auto open = buffer.stack.back();
+    buffer.stack.pop_back();
+    if (enabled)
+        buffer.push({ open.name, open.start, now(), static_cast<uint16_t>(buffer.stack.size()), buffer.id });
+}
+
+void Profiler::endFrame()
+{
+    ProfilerFrame frame;
+    frame.index = currentFrame++;
+    frame.start = frameStart;
+    frame.end = now();
+    frameStart = frame.end;
+
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        for (auto& thread : threads)
+            thread->drain(frame.cpu);
+    }
+
+    if (paused || !enabled)
+        return;
+
+    // parents before children, as a flame graph is drawn
+    std::sort(frame.cpu.begin(), frame.cpu.end(), [](ProfileEvent const& a, ProfileEvent const& b) {
+        return a.thread != b.thread ? a.thread < b.thread :
+            a.start != b.start ? a.start < b.start : a.depth < b.depth;
+    });
+
+    frames.push_back(std::move(frame));
+    while (frames.size() > historySize)
+        frames.pop_front();
+}
+
+void Profiler::addGpuEvents(uint64_t frame, std::vector<ProfileEvent> const& events)
+{
+    for (auto& f : frames)
+    {
+        if (f.index == frame)
+        {
+            f.gpu = events;
+            f.gpuReady = true;
+            return;
+        }
+    }
+}
+
+char const* Profiler::intern(std::string const& name)
+{
+    std::lock_guard<std::mutex> lock(internMutex);
+    return names.insert(name).first->c_str();
+}
+
+void Profiler::setThreadName(std::string const& name)
+{
+    auto& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    buffer.name = name;
+}
+
+uint64_t Profiler::droppedEvents() const
+{
+    uint64_t dropped = 0;
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    for (auto const& thread : threads)
+        dropped += thread->dropped.load(std::memory_order_relaxed);
+    return dropped;
+}
+
+static void writeJsonString(FILE* out, char const* s)
+{
+    fputc('"', out);
+    for (; *s; s++)
+    {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', out);
+        if (static_cast<unsigned char>(*s) >= 0x20)
+            fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+bool Profiler::exportChromeTrace(char const* path) const
+{
+    FILE* out = fopen(path, "w");
+    if (!out)
+        return false;
+
+    // pid 1 is the CPU with one tid per thread, pid 2 the GPU
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"CPU\"}},\n");
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"tid\":0,\"args\":{\"name\":\"GPU\"}}");
+    std::unique_lock<std::mutex> lock(threadsMutex);
+    for (auto const& thread : threads)
+    {
+        fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", thread->id);
+        writeJsonString(out, thread->name.c_str());
+        fprintf(out, "}}");
+    }
+    lock.unlock();
+
+    auto writeEvent = [out](ProfileEvent const& e, int pid) {
+        fprintf(out, ",\n{\"name\":");
+        writeJsonString(out, e.name);
+        fprintf(out, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%u}",
+            e.start / 1000.0, (e.end - e.start) / 1000.0, pid, pid == 1 ? e.thread : 0u);
+    };
+
+    for (auto const& frame : frames)
+    {
+        fprintf(out, ",\n{\"name\":\"Frame %llu\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":0}",
+            static_cast<unsigned long long>(frame.index), frame.start / 1000.0, (frame.end - frame.start) / 1000.0);
+        for (auto const& e : frame.cpu)
+            writeEvent(e, 1);
+        for (auto const& e : frame.gpu)
+            writeEvent(e, 2);
+    }
+
+    fprintf(out, "\n]}\n");
+    return fclose(out) == 0;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_set>
+
+// Portable hierarchical CPU profiler. Every thread records scopes into its own
+// lock-free ring, endFrame() on the main thread collects them into a frame
+// history. GPU timings are attached to the frames later by the GPU profiler.
+
+struct ProfileEvent
+{
+    // must outlive the history: a literal or Profiler::intern
+    char const* name;
+    // nanoseconds on the profiler clock
+    uint64_t start;
+    uint64_t end;
+    uint16_t depth;
+    uint16_t thread;
+};
+
+struct ProfilerFrame
+{
+    uint64_t index = 0;
+    uint64_t start = 0;
+    uint64_t end = 0;
+    std::vector<ProfileEvent> cpu;
+    // filled a few frames later, once the queries are ready
+    std::vector<ProfileEvent> gpu;
+    bool gpuReady = false;
+};
+
+class Profiler
+{
+public:
+    static Profiler& get();
+
+    // nanoseconds since the profiler was created
+    uint64_t now() const;
+
+    void begin(char const* name);
+    void end();
+
+    // close the current frame and collect all threads' events
+    void endFrame();
+    uint64_t frameIndex() const { return currentFrame; }
+
+    // attach GPU events to a frame still in the history, times on the profiler clock
+    void addGpuEvents(uint64_t frame, std::vector<ProfileEvent> const& events);
+
+    // stable copy of a dynamic name
+    char const* intern(std::string const& name);
+    void setThreadName(std::string const& name);
+
+    void setEnabled(bool enable) { enabled = enable; }
+    bool isEnabled() const { return enabled; }
+    // keep the history unchanged, e.g. to inspect a spike
+    void setPaused(bool pause) { paused = pause; }
+    bool isPaused() const { return paused; }
+    void setHistorySize(uint32_t frames) { historySize = frames; }
+
+    std::deque<ProfilerFrame> const& history() const { return frames; }
+    // events lost because a thread's ring was full
+    uint64_t droppedEvents() const;
+
+    // chrome://tracing / Perfetto JSON of the whole history
+    bool exportChromeTrace(char const* path) const;
+
+private:
+    Profiler();
+    ~Profiler();
+    Profiler(Profiler const&) = delete;
+    Profiler& operator=(Profiler const&) = delete;
+
+    struct ThreadBuffer;
+    ThreadBuffer& threadBuffer();
+
+    mutable std::mutex threadsMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> threads;
+
+    std::mutex internMutex;
+    std::unordered_set<std::string> names;
+
+    std::deque<ProfilerFrame> frames;
+    uint64_t currentFrame = 0;
+    uint64_t frameStart = 0;
+    uint32_t historySize = 240;
+    std::atomic<bool> enabled = true;
+    bool paused = false;
+};
+
+// CPU scope on the calling thread
+class ProfileScope
+{
+public:
+    explicit ProfileScope(char const* name) { Profiler::get().begin(name); }
+    ~ProfileScope() { Profiler::get().end(); }
+
+    ProfileScope(ProfileScope const&) = delete;
+    ProfileScope& operator=(ProfileScope const&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
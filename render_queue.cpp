@@ -0,0 +1,85 @@
+#include <cstring>
+#include <algorithm>
+
+#include "render_queue.h"
+
+
+// float bits that compare like the floats, negative values included
+static uint32_t orderedBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+}
+
+uint64_t RenderKey::make(RenderPass pass, uint32_t shader, uint32_t material, float depth)
+{
+    auto depthKey = orderedBits(depth);
+    if (pass == RenderPass::Transparent)
+        depthKey = ~depthKey;
+
+    return static_cast<uint64_t>(pass) << 60 |
+        static_cast<uint64_t>(std::min(shader, MaxShader)) << 52 |
+        static_cast<uint64_t>(std::min(material, MaxMaterial)) << 32 |
+        depthKey;
+}
+
+void radixSort(RenderItem* items, RenderItem* scratch, size_t count)
+{
+    if (count < 2)
+        return;
+
+    // all eight histograms in one read of the keys
+    uint32_t counts[8][256] = {};
+    for (size_t i = 0; i < count; i++)
+    {
+        auto key = items[i].key;
+        for (int byte = 0; byte < 8; byte++)
+            counts[byte][(key >> (byte * 8)) & 0xff]++;
+    }
+
+    auto source = items;
+    auto target = scratch;
+    for (int byte = 0; byte < 8; byte++)
+    {
+        auto& histogram = counts[byte];
+        // every key has the same byte here, the order doesn't change
+        if (histogram[(source[0].key >> (byte * 8)) & 0xff] == count)
+            continue;
+
+        uint32_t offsets[256];
+        uint32_t sum = 0;
+        for (int digit = 0; digit < 256; digit++)
+        {
+            offsets[digit] = sum;
+            sum += histogram[digit];
+        }
+        for (size_t i = 0; i < count; i++)
+            target[offsets[(source[i].key >> (byte * 8)) & 0xff]++] = source[i];
+        std::swap(source, target);
+    }
+
+    if (source != items)
+        memcpy(items, source, count * sizeof(RenderItem));
+}
+
+void RenderQueue::sort()
+{
+    scratch.resize(queue.size());
+    radixSort(queue.data(), scratch.data(), queue.size());
+}
+
+RenderQueueStats RenderQueue::measure() const
+{
+    RenderQueueStats stats;
+    stats.draws = size();
+    for (size_t i = 0; i < queue.size(); i++)
+    {
+        auto key = queue[i].key;
+        if (i == 0 || RenderKey::shader(key) != RenderKey::shader(queue[i - 1].key))
+            stats.shaderChanges++;
+        if (i == 0 || RenderKey::material(key) != RenderKey::material(queue[i - 1].key))
+            stats.materialChanges++;
+    }
+    return stats;
+}
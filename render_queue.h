@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Portable draw queue. Every draw is submitted with a 64 bit key and an index
+// into the caller's draw data; sorting the keys orders the draws by pass, then
+// shader, then material, then depth, so state changes are grouped and opaque
+// draws within a group go front to back.
+//
+// key bits: 63..60 pass, 59..52 shader, 51..32 material, 31..0 depth
+
+enum class RenderPass : uint8_t
+{
+    // opaque geometry into the depth buffer only
+    DepthPrepass = 0,
+    Opaque = 1,
+    // drawn after everything opaque so only uncovered pixels are shaded
+    Sky = 2,
+    // back to front
+    Transparent = 3,
+};
+
+namespace RenderKey
+{
+    const uint32_t ShaderBits = 8;
+    const uint32_t MaterialBits = 20;
+    const uint32_t MaxShader = (1u << ShaderBits) - 1;
+    const uint32_t MaxMaterial = (1u << MaterialBits) - 1;
+
+    // depth in view space, ids are clamped to their field
+    uint64_t make(RenderPass pass, uint32_t shader, uint32_t material, float depth);
+
+    inline RenderPass pass(uint64_t key) { return static_cast<RenderPass>(key >> 60); }
+    inline uint32_t shader(uint64_t key) { return static_cast<uint32_t>(key >> 52) & MaxShader; }
+    inline uint32_t material(uint64_t key) { return static_cast<uint32_t>(key >> 32) & MaxMaterial; }
+    // orders like depth for opaque draws and reversed for transparent ones
+    inline uint32_t depthBits(uint64_t key) { return static_cast<uint32_t>(key); }
+}
+
+struct RenderItem
+{
+    uint64_t key;
+    // into the submitter's draw data
+    uint32_t index;
+};
+
+// stable LSD radix sort on the key, 8 bits per pass, passes where every key has
+// the same byte are skipped; scratch has to hold count items
+void radixSort(RenderItem* items, RenderItem* scratch, size_t count);
+
+struct RenderQueueStats
+{
+    uint32_t draws = 0;
+    // of the last submitted frame
+    uint32_t shaderChanges = 0;
+    uint32_t materialChanges = 0;
+};
+
+class RenderQueue
+{
+public:
+    void clear() { queue.clear(); }
+    void push(uint64_t key, uint32_t index) { queue.push_back({ key, index }); }
+    void sort();
+
+    std::vector<RenderItem> const& items() const { return queue; }
+    uint32_t size() const { return static_cast<uint32_t>(queue.size()); }
+
+    // counts shader and material switches in the current order
+    RenderQueueStats measure() const;
+
+private:
+    std::vector<RenderItem> queue;
+    std::vector<RenderItem> scratch;
+};
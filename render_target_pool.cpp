@@ -0,0 +1,111 @@
+#include "render_target_pool.h"
+#include "graphics.h"
+#include "dds.h"
+
+
+RenderTargetPool::RenderTargetPool(UINT maxIdleFrames) :
+    pool(&RenderTargetPool::createTarget, &RenderTargetPool::destroyTarget, maxIdleFrames)
+{
+}
+
+RenderTarget const* RenderTargetPool::acquire(UINT width, UINT height, DXGI_FORMAT format, UINT bindFlags)
+{
+    return pool.acquire({ width, height, static_cast<uint32_t>(format), bindFlags });
+}
+
+RenderTarget const* RenderTargetPool::acquireStaging(UINT width, UINT height, DXGI_FORMAT format)
+{
+    return pool.acquire({ width, height, static_cast<uint32_t>(format), 0 });
+}
+
+void RenderTargetPool::release(RenderTarget const* target)
+{
+    if (target)
+        pool.release(target);
+}
+
+UINT64 RenderTargetPool::pooledBytes() const
+{
+    UINT64 bytes = 0;
+    pool.forEach([&bytes](RenderTargetKey const& key, RenderTarget const&, bool) {
+        bytes += static_cast<UINT64>(key.width) * key.height * bitsPerPixel(key.format) / 8;
+    });
+    return bytes;
+}
+
+bool RenderTargetPool::createTarget(RenderTargetKey const& key, RenderTarget& target)
+{
+    auto device = Graphics::get()->getDevice();
+
+    D3D11_TEXTURE2D_DESC td;
+    ZeroMemory(&td, sizeof(td));
+    td.Width = key.width;
+    td.Height = key.height;
+    td.MipLevels = 1;
+    td.ArraySize = 1;
+    td.Format = static_cast<DXGI_FORMAT>(key.format);
+    td.SampleDesc.Count = 1;
+    td.SampleDesc.Quality = 0;
+    if (key.bindFlags)
+    {
+        td.Usage = D3D11_USAGE_DEFAULT;
+        td.BindFlags = key.bindFlags;
+        td.CPUAccessFlags = 0;
+    }
+    else
+    {
+        td.Usage = D3D11_USAGE_STAGING;
+        td.BindFlags = 0;
+        td.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    }
+
+    target.width = key.width;
+    target.height = key.height;
+
+    auto hr = device->CreateTexture2D(&td, nullptr, &target.texture);
+    if (FAILED(hr))
+        return false;
+
+    if (key.bindFlags & D3D11_BIND_RENDER_TARGET)
+    {
+        // Setup the description of the render target view.
+        D3D11_RENDER_TARGET_VIEW_DESC rtvd;
+        rtvd.Format = td.Format;
+        rtvd.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
+        rtvd.Texture2D.MipSlice = 0;
+
+        hr = device->CreateRenderTargetView(target.texture, &rtvd, &target.rtv);
+        if (FAILED(hr))
+        {
+            destroyTarget(target);
+            return false;
+        }
+    }
+
+    if (key.bindFlags & D3D11_BIND_SHADER_RESOURCE)
+    {
+        // Setup the description of the shader resource view.
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvd;
+        srvd.Format = td.Format;
+        srvd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        srvd.Texture2D.MostDetailedMip = 0;
+        srvd.Texture2D.MipLevels = 1;
+
+        hr = device->CreateShaderResourceView(target.texture, &srvd, &target.srv);
+        if (FAILED(hr))
+        {
+            destroyTarget(target);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void RenderTargetPool::destroyTarget(RenderTarget& target)
+{
+    if (target.srv) target.srv->Release();
+    if (target.rtv) target.rtv->Release();
+    if (target.texture) target.texture->Release();
+    target = RenderTarget();
+}
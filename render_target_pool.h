@@ -0,0 +1,43 @@
+#pragma once
+
+#include <d3d11_1.h>
+
+#include "transient_pool.h"
+
+
+struct RenderTarget
+{
+    ID3D11Texture2D* texture = nullptr;
+    // not created for staging textures (bindFlags == 0)
+    ID3D11RenderTargetView* rtv = nullptr;
+    ID3D11ShaderResourceView* srv = nullptr;
+    UINT width = 0;
+    UINT height = 0;
+};
+
+// Recycles render target textures and their views across passes and frames
+class RenderTargetPool
+{
+public:
+    explicit RenderTargetPool(UINT maxIdleFrames = 60);
+
+    RenderTarget const* acquire(UINT width, UINT height, DXGI_FORMAT format,
+        UINT bindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE);
+    // CPU readable copy target
+    RenderTarget const* acquireStaging(UINT width, UINT height, DXGI_FORMAT format);
+    void release(RenderTarget const* target);
+
+    // age out idle targets, call once per frame
+    void endFrame() { pool.endFrame(); }
+    void cleanup() { pool.clear(); }
+
+    TransientPoolStats const& stats() const { return pool.stats(); }
+    // estimated memory of all pooled textures
+    UINT64 pooledBytes() const;
+
+private:
+    static bool createTarget(RenderTargetKey const& key, RenderTarget& target);
+    static void destroyTarget(RenderTarget& target);
+
+    TransientPool<RenderTargetKey, RenderTarget, RenderTargetKeyHash> pool;
+};
@@ -0,0 +1,234 @@
+#include <cstring>
+#include <algorithm>
+#include <xmmintrin.h>
+
+#include "scene.h"
+
+
+SceneMatrix SceneMatrix::identity()
+{
+    SceneMatrix m = {};
+    m.m[0][0] = m.m[1][1] = m.m[2][2] = m.m[3][3] = 1.0f;
+    return m;
+}
+
+static inline void multiplyRows(SceneMatrix const& a, SceneMatrix const& b, __m128 rows[4])
+{
+    auto b0 = _mm_load_ps(b.m[0]);
+    auto b1 = _mm_load_ps(b.m[1]);
+    auto b2 = _mm_load_ps(b.m[2]);
+    auto b3 = _mm_load_ps(b.m[3]);
+    for (int r = 0; r < 4; r++)
+    {
+        auto row = _mm_mul_ps(_mm_set1_ps(a.m[r][0]), b0);
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.m[r][1]), b1));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.m[r][2]), b2));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.m[r][3]), b3));
+        rows[r] = row;
+    }
+}
+
+static inline void storeRows(__m128 const rows[4], SceneMatrix& out)
+{
+    for (int r = 0; r < 4; r++)
+        _mm_store_ps(out.m[r], rows[r]);
+}
+
+static inline void storeTransposed(__m128 const rows[4], SceneMatrix& out)
+{
+    auto r0 = rows[0], r1 = rows[1], r2 = rows[2], r3 = rows[3];
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_store_ps(out.m[0], r0);
+    _mm_store_ps(out.m[1], r1);
+    _mm_store_ps(out.m[2], r2);
+    _mm_store_ps(out.m[3], r3);
+}
+
+void multiplyMatrices(SceneMatrix const* a, SceneMatrix const* b, SceneMatrix* out, uint32_t count)
+{
+    // out may alias a, every row is computed before any is stored
+    __m128 rows[4];
+    for (uint32_t i = 0; i < count; i++)
+    {
+        multiplyRows(a[i], b[i], rows);
+        storeRows(rows, out[i]);
+    }
+}
+
+void transposeMatrices(SceneMatrix const* in, SceneMatrix* out, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        __m128 rows[4] = { _mm_load_ps(in[i].m[0]), _mm_load_ps(in[i].m[1]), _mm_load_ps(in[i].m[2]), _mm_load_ps(in[i].m[3]) };
+        storeTransposed(rows, out[i]);
+    }
+}
+
+SceneNode Scene::create(SceneNode parent)
+{
+    if (parent != InvalidSceneNode && parent >= count)
+        return InvalidSceneNode;
+
+    if (count % 4 == 0)
+    {
+        // grow by a whole SIMD group of identity transforms
+        auto padded = count + 4;
+        for (auto array : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ })
+            array->resize(padded, 0.0f);
+        for (auto array : { &rotationW, &scaleX, &scaleY, &scaleZ })
+            array->resize(padded, 1.0f);
+        parents.resize(padded, InvalidSceneNode);
+        localDirty.resize(padded, 0);
+        worldDirty.resize(padded, 0);
+        locals.resize(padded, SceneMatrix::identity());
+        worlds.resize(padded, SceneMatrix::identity());
+        gpuWorlds.resize(padded, SceneMatrix::identity());
+    }
+
+    auto node = count++;
+    parents[node] = parent;
+    markDirty(node);
+    return node;
+}
+
+void Scene::clear()
+{
+    count = 0;
+    for (auto array : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &rotationW,
+        &scaleX, &scaleY, &scaleZ })
+        array->clear();
+    parents.clear();
+    localDirty.clear();
+    worldDirty.clear();
+    locals.clear();
+    worlds.clear();
+    gpuWorlds.clear();
+    _stats = {};
+}
+
+void Scene::setPosition(SceneNode node, float x, float y, float z)
+{
+    positionX[node] = x;
+    positionY[node] = y;
+    positionZ[node] = z;
+    markDirty(node);
+}
+
+void Scene::setRotation(SceneNode node, float x, float y, float z, float w)
+{
+    rotationX[node] = x;
+    rotationY[node] = y;
+    rotationZ[node] = z;
+    rotationW[node] = w;
+    markDirty(node);
+}
+
+void Scene::setScale(SceneNode node, float x, float y, float z)
+{
+    scaleX[node] = x;
+    scaleY[node] = y;
+    scaleZ[node] = z;
+    markDirty(node);
+}
+
+void Scene::worldPosition(SceneNode node, float& x, float& y, float& z) const
+{
+    x = worlds[node].m[3][0];
+    y = worlds[node].m[3][1];
+    z = worlds[node].m[3][2];
+}
+
+void Scene::buildLocals(uint32_t first)
+{
+    // lane i holds node first + i, the rows are transposed into place at the end
+    auto x = _mm_loadu_ps(&rotationX[first]);
+    auto y = _mm_loadu_ps(&rotationY[first]);
+    auto z = _mm_loadu_ps(&rotationZ[first]);
+    auto w = _mm_loadu_ps(&rotationW[first]);
+
+    auto one = _mm_set1_ps(1.0f);
+    auto two = _mm_set1_ps(2.0f);
+    auto xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+    auto xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+    auto xw = _mm_mul_ps(x, w), yw = _mm_mul_ps(y, w), zw = _mm_mul_ps(z, w);
+
+    // XMMatrixRotationQuaternion, rows scaled by S for S * R * T
+    auto sx = _mm_loadu_ps(&scaleX[first]);
+    auto sy = _mm_loadu_ps(&scaleY[first]);
+    auto sz = _mm_loadu_ps(&scaleZ[first]);
+    auto r00 = _mm_mul_ps(sx, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))));
+    auto r01 = _mm_mul_ps(sx, _mm_mul_ps(two, _mm_add_ps(xy, zw)));
+    auto r02 = _mm_mul_ps(sx, _mm_mul_ps(two, _mm_sub_ps(xz, yw)));
+    auto r10 = _mm_mul_ps(sy, _mm_mul_ps(two, _mm_sub_ps(xy, zw)));
+    auto r11 = _mm_mul_ps(sy, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))));
+    auto r12 = _mm_mul_ps(sy, _mm_mul_ps(two, _mm_add_ps(yz, xw)));
+    auto r20 = _mm_mul_ps(sz, _mm_mul_ps(two, _mm_add_ps(xz, yw)));
+    auto r21 = _mm_mul_ps(sz, _mm_mul_ps(two, _mm_sub_ps(yz, xw)));
+    auto r22 = _mm_mul_ps(sz, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))));
+    auto r03 = _mm_setzero_ps(), r13 = _mm_setzero_ps(), r23 = _mm_setzero_ps();
+
+    auto tx = _mm_loadu_ps(&positionX[first]);
+    auto ty = _mm_loadu_ps(&positionY[first]);
+    auto tz = _mm_loadu_ps(&positionZ[first]);
+    auto tw = one;
+
+    _MM_TRANSPOSE4_PS(r00, r01, r02, r03);
+    _MM_TRANSPOSE4_PS(r10, r11, r12, r13);
+    _MM_TRANSPOSE4_PS(r20, r21, r22, r23);
+    _MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+
+    __m128 const rows[4][4] = {
+        { r00, r10, r20, tx },
+        { r01, r11, r21, ty },
+        { r02, r12, r22, tz },
+        { r03, r13, r23, tw },
+    };
+    for (int i = 0; i < 4; i++)
+        for (int r = 0; r < 4; r++)
+            _mm_store_ps(locals[first + i].m[r], rows[i][r]);
+}
+
+SceneUpdateStats Scene::updateTransforms()
+{
+    _stats = {};
+    _stats.nodeCount = count;
+
+    // locals, whole SIMD groups holding a changed node
+    for (uint32_t first = 0; first < count; first += 4)
+    {
+        uint32_t dirty;
+        memcpy(&dirty, &localDirty[first], sizeof(dirty));
+        if (!dirty)
+            continue;
+        buildLocals(first);
+        _stats.localUpdates += localDirty[first] + localDirty[first + 1] + localDirty[first + 2] + localDirty[first + 3];
+    }
+    if (!_stats.localUpdates)
+        return _stats;
+
+    // parents come first, so their world matrices are final when a child is reached;
+    // the transposed copy is stored while the rows are still in registers
+    __m128 rows[4];
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto parent = parents[i];
+        bool dirty = localDirty[i] || (parent != InvalidSceneNode && worldDirty[parent]);
+        worldDirty[i] = dirty;
+        if (!dirty)
+            continue;
+
+        if (parent == InvalidSceneNode)
+        {
+            for (int r = 0; r < 4; r++)
+                rows[r] = _mm_load_ps(locals[i].m[r]);
+        }
+        else
+            multiplyRows(locals[i], worlds[parent], rows);
+        storeRows(rows, worlds[i]);
+        storeTransposed(rows, gpuWorlds[i]);
+        _stats.worldUpdates++;
+    }
+
+    std::fill(localDirty.begin(), localDirty.end(), 0);
+    return _stats;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Portable scene container. Node transforms are kept as structure of arrays so
+// local matrices can be built four nodes at a time with SSE. Nodes form a
+// hierarchy through parent indices, and only nodes whose own transform or an
+// ancestor's changed since the last update recompute their world matrix.
+//
+// Matrices are row-major with row vectors, the layout of DirectXMath's
+// XMMATRIX, so world = local * parent world.
+
+using SceneNode = uint32_t;
+constexpr SceneNode InvalidSceneNode = ~0u;
+
+struct alignas(16) SceneMatrix
+{
+    float m[4][4];
+
+    static SceneMatrix identity();
+};
+
+// out[i] = a[i] * b[i]
+void multiplyMatrices(SceneMatrix const* a, SceneMatrix const* b, SceneMatrix* out, uint32_t count);
+// out[i] = transpose(in[i]), in and out may be the same
+void transposeMatrices(SceneMatrix const* in, SceneMatrix* out, uint32_t count);
+
+struct SceneUpdateStats
+{
+    uint32_t nodeCount = 0;
+    // nodes whose local or world matrix was rebuilt by the last update
+    uint32_t localUpdates = 0;
+    uint32_t worldUpdates = 0;
+};
+
+class Scene
+{
+public:
+    // parents have to exist already, so a node's index is always greater than
+    // its parent's and one pass in index order resolves the hierarchy
+    SceneNode create(SceneNode parent = InvalidSceneNode);
+    void clear();
+
+    uint32_t size() const { return count; }
+    SceneNode parent(SceneNode node) const { return parents[node]; }
+
+    void setPosition(SceneNode node, float x, float y, float z);
+    // unit quaternion
+    void setRotation(SceneNode node, float x, float y, float z, float w);
+    void setScale(SceneNode node, float x, float y, float z);
+
+    // rebuild the matrices of changed nodes and their descendants
+    SceneUpdateStats updateTransforms();
+    SceneUpdateStats const& stats() const { return _stats; }
+
+    // valid after updateTransforms
+    SceneMatrix const& world(SceneNode node) const { return worlds[node]; }
+    // transposed for HLSL constant buffers
+    SceneMatrix const& gpuWorld(SceneNode node) const { return gpuWorlds[node]; }
+    // world space translation
+    void worldPosition(SceneNode node, float& x, float& y, float& z) const;
+
+private:
+    void markDirty(SceneNode node) { localDirty[node] = 1; }
+    // four nodes starting at a multiple of 4
+    void buildLocals(uint32_t first);
+
+    uint32_t count = 0;
+
+    // padded to a multiple of 4 nodes for the SIMD passes
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+    std::vector<float> scaleX, scaleY, scaleZ;
+
+    std::vector<SceneNode> parents;
+    std::vector<uint8_t> localDirty;
+    std::vector<uint8_t> worldDirty;
+
+    std::vector<SceneMatrix> locals;
+    std::vector<SceneMatrix> worlds;
+    std::vector<SceneMatrix> gpuWorlds;
+
+    SceneUpdateStats _stats;
+};
@@ -30,7 +30,7 @@ VS_OUTPUT VS(VS_INPUT input)
     //Set Pos to xyww instead of xyzw, so that z will always be 1 (furthest from camera)
     output.Pos = mul(float4(input.Pos, 1.0f), World);
     output.Pos = mul(output.Pos, View);
-    output.Pos = mul(output.Pos, Projection).xyzw;
+    output.Pos = mul(output.Pos, Projection).xyww;
 
     output.texCoord = input.Pos;
 
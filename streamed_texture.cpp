@@ -0,0 +1,257 @@
+#include <algorithm>
+
+#include "streamed_texture.h"
+#include "graphics.h"
+
+
+std::unique_ptr<StreamedTexture> StreamedTextureFactory::createFromDDS(
+    LPCWSTR fileName, UINT miscFlags, UINT mipTailSize, UINT firstMip)
+{
+    auto tex = std::unique_ptr<StreamedTexture>(new StreamedTexture);
+    if (!tex->create(fileName, miscFlags, mipTailSize, firstMip))
+        return nullptr;
+    return tex;
+}
+
+StreamedTexture::~StreamedTexture()
+{
+    stopStreaming();
+}
+
+bool StreamedTexture::mapFile(LPCWSTR fileName)
+{
+    file = CreateFileW(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        return false;
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+
+    mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+        return false;
+
+    mappedData = static_cast<uint8_t const*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    return mappedData != nullptr;
+}
+
+void StreamedTexture::unmapFile()
+{
+    if (mappedData) UnmapViewOfFile(mappedData);
+    if (mapping) CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+
+    mappedData = nullptr;
+    mapping = nullptr;
+    file = INVALID_HANDLE_VALUE;
+    mappedSize = 0;
+}
+
+bool StreamedTexture::create(LPCWSTR fileName, UINT miscFlags, UINT mipTailSize, UINT firstMip)
+{
+    if (!mapFile(fileName) || !parseDDS(mappedData, mappedSize, _info))
+    {
+        unmapFile();
+        return false;
+    }
+
+    // volume and 1D textures go through the regular loader
+    if (_info.dimension != DDS_DIMENSION_TEXTURE2D)
+    {
+        unmapFile();
+        return false;
+    }
+
+    // BC textures need a block aligned top level
+    _firstMip = std::min<UINT>(firstMip, _info.mipCount - 1);
+    while (_firstMip > 0 && isBlockCompressed(_info.format) &&
+        (surface(0, 0).width % 4 || surface(0, 0).height % 4))
+        _firstMip--;
+
+    D3D11_TEXTURE2D_DESC td;
+    ZeroMemory(&td, sizeof(td));
+    td.Width = surface(0, 0).width;
+    td.Height = surface(0, 0).height;
+    td.MipLevels = mipCount();
+    td.ArraySize = _info.arraySize;
+    td.Format = static_cast<DXGI_FORMAT>(_info.format);
+    td.SampleDesc.Count = 1;
+    td.Usage = D3D11_USAGE_DEFAULT;
+    td.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    td.MiscFlags = miscFlags;
+    if (_info.isCubemap)
+        td.MiscFlags |= D3D11_RESOURCE_MISC_TEXTURECUBE;
+
+    auto graphics = Graphics::get();
+    auto hr = graphics->getDevice()->CreateTexture2D(&td, nullptr, &_texture);
+    if (FAILED(hr) || !createSRV())
+    {
+        cleanup();
+        return false;
+    }
+
+    // first mip small enough to be part of the synchronously uploaded tail
+    UINT tailStart = 0;
+    while (tailStart + 1 < mipCount() &&
+        std::max<UINT>(surface(tailStart, 0).width, surface(tailStart, 0).height) > mipTailSize)
+        tailStart++;
+
+    auto ctx = graphics->getContext();
+    for (UINT mip = tailStart; mip < mipCount(); mip++)
+        uploadMip(ctx, mip);
+
+    _residentMip = tailStart;
+    ctx->SetResourceMinLOD(_texture, static_cast<FLOAT>(_residentMip));
+
+    if (_residentMip == 0)
+        unmapFile();
+    else
+        worker = std::thread(&StreamedTexture::streamMips, this);
+
+    return true;
+}
+
+bool StreamedTexture::createSRV()
+{
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvd;
+    ZeroMemory(&srvd, sizeof(srvd));
+    srvd.Format = static_cast<DXGI_FORMAT>(_info.format);
+
+    if (_info.isCubemap && _info.arraySize > 6)
+    {
+        srvd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBEARRAY;
+        srvd.TextureCubeArray.MipLevels = mipCount();
+        srvd.TextureCubeArray.NumCubes = _info.arraySize / 6;
+    }
+    else if (_info.isCubemap)
+    {
+        srvd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
+        srvd.TextureCube.MipLevels = mipCount();
+    }
+    else if (_info.arraySize > 1)
+    {
+        srvd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+        srvd.Texture2DArray.MipLevels = mipCount();
+        srvd.Texture2DArray.ArraySize = _info.arraySize;
+    }
+    else
+    {
+        srvd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        srvd.Texture2D.MipLevels = mipCount();
+    }
+
+    auto hr = Graphics::get()->getDevice()->CreateShaderResourceView(_texture, &srvd, &_srv);
+    return SUCCEEDED(hr);
+}
+
+void StreamedTexture::uploadMip(ID3D11DeviceContext* ctx, UINT mip)
+{
+    for (UINT slice = 0; slice < _info.arraySize; slice++)
+    {
+        auto const& surf = surface(mip, slice);
+        ctx->UpdateSubresource(_texture, D3D11CalcSubresource(mip, slice, mipCount()),
+            nullptr, mappedData + surf.offset, surf.rowPitch, surf.slicePitch);
+    }
+}
+
+void StreamedTexture::streamMips()
+{
+    auto device = Graphics::get()->getDevice();
+
+    // smallest missing mip first, so every submitted level is immediately usable
+    for (int mip = static_cast<int>(_residentMip) - 1; mip >= 0 && !stopWorker; mip--)
+    {
+        auto const& base = surface(mip, 0);
+
+        D3D11_TEXTURE2D_DESC td;
+        ZeroMemory(&td, sizeof(td));
+        td.Width = base.width;
+        td.Height = base.height;
+        td.MipLevels = 1;
+        td.ArraySize = _info.arraySize;
+        td.Format = static_cast<DXGI_FORMAT>(_info.format);
+        td.SampleDesc.Count = 1;
+        td.Usage = D3D11_USAGE_STAGING;
+        td.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+        // creating the staging copy reads the mapping, so page faults happen here
+        std::vector<D3D11_SUBRESOURCE_DATA> initData(_info.arraySize);
+        for (UINT slice = 0; slice < _info.arraySize; slice++)
+        {
+            auto const& surf = surface(mip, slice);
+            initData[slice].pSysMem = mappedData + surf.offset;
+            initData[slice].SysMemPitch = surf.rowPitch;
+            initData[slice].SysMemSlicePitch = surf.slicePitch;
+        }
+
+        ID3D11Texture2D* staging = nullptr;
+        if (FAILED(device->CreateTexture2D(&td, initData.data(), &staging)))
+            staging = nullptr;
+
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        pending.push_back({ static_cast<UINT>(mip), staging });
+    }
+}
+
+bool StreamedTexture::update(ID3D11DeviceContext* ctx)
+{
+    if (_residentMip == 0)
+        return true;
+
+    PendingMip next = { 0, nullptr };
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        if (pending.empty())
+            return false;
+        next = pending.front();
+        pending.erase(pending.begin());
+    }
+
+    if (next.staging)
+    {
+        for (UINT slice = 0; slice < _info.arraySize; slice++)
+            ctx->CopySubresourceRegion(_texture, D3D11CalcSubresource(next.mip, slice, mipCount()),
+                0, 0, 0, next.staging, D3D11CalcSubresource(0, slice, 1), nullptr);
+        next.staging->Release();
+    }
+    else
+    {
+        uploadMip(ctx, next.mip);
+    }
+
+    _residentMip = next.mip;
+    ctx->SetResourceMinLOD(_texture, static_cast<FLOAT>(_residentMip));
+
+    if (_residentMip == 0)
+    {
+        stopStreaming();
+        return true;
+    }
+    return false;
+}
+
+void StreamedTexture::stopStreaming()
+{
+    stopWorker = true;
+    if (worker.joinable())
+        worker.join();
+
+    for (auto& p : pending)
+        if (p.staging) p.staging->Release();
+    pending.clear();
+
+    unmapFile();
+}
+
+void StreamedTexture::cleanup()
+{
+    stopStreaming();
+
+    if (_srv) _srv->Release();
+    if (_texture) _texture->Release();
+    _srv = nullptr;
+    _texture = nullptr;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <windows.h>
+#include <d3d11_1.h>
+
+#include "dds.h"
+
+
+// Texture created from a memory-mapped DDS file. The mip tail is uploaded
+// synchronously so the texture is usable right away, higher mips are read
+// by a worker thread and copied to the GPU one level per frame.
+class StreamedTexture
+{
+public:
+    ~StreamedTexture();
+
+    // submit the next streamed mip (if ready), returns true when fully resident
+    bool update(ID3D11DeviceContext* ctx);
+
+    ID3D11ShaderResourceView* srv() const { return _srv; }
+    ID3D11Texture2D* texture() const { return _texture; }
+
+    // most detailed mip the GPU may sample right now
+    UINT residentMip() const { return _residentMip; }
+    // file mip stored as mip 0 of the texture
+    UINT firstMip() const { return _firstMip; }
+    UINT mipCount() const { return _info.mipCount - _firstMip; }
+    DDSInfo const& info() const { return _info; }
+
+    void cleanup();
+
+private:
+    StreamedTexture() = default;
+    StreamedTexture(StreamedTexture const&) = delete;
+    StreamedTexture& operator=(StreamedTexture const&) = delete;
+
+    bool create(LPCWSTR fileName, UINT miscFlags, UINT mipTailSize, UINT firstMip);
+    bool mapFile(LPCWSTR fileName);
+    void unmapFile();
+    bool createSRV();
+    // mip is relative to the texture, not the file
+    DDSSurface const& surface(UINT mip, UINT slice) const { return _info.surface(mip + _firstMip, slice); }
+    void uploadMip(ID3D11DeviceContext* ctx, UINT mip);
+    void streamMips();
+    void stopStreaming();
+
+    // staged mip prepared by the worker thread
+    struct PendingMip
+    {
+        UINT mip;
+        // nullptr when the level could not be staged, it is then uploaded from the mapping
+        ID3D11Texture2D* staging;
+    };
+
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+    uint8_t const* mappedData = nullptr;
+    size_t mappedSize = 0;
+
+    DDSInfo _info;
+
+    ID3D11Texture2D* _texture = nullptr;
+    ID3D11ShaderResourceView* _srv = nullptr;
+
+    UINT _firstMip = 0;
+    UINT _residentMip = 0;
+
+    std::thread worker;
+    std::mutex pendingMutex;
+    std::vector<PendingMip> pending;
+    std::atomic<bool> stopWorker = false;
+
+    friend class StreamedTextureFactory;
+};
+
+class StreamedTextureFactory
+{
+public:
+    // returns nullptr if the file can't be mapped or its format is not supported,
+    // file mips finer than firstMip are skipped
+    static std::unique_ptr<StreamedTexture> createFromDDS(
+        LPCWSTR fileName, UINT miscFlags = 0, UINT mipTailSize = 64, UINT firstMip = 0);
+};
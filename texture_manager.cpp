@@ -0,0 +1,93 @@
+#include "texture_manager.h"
+#include "streamed_texture.h"
+
+
+TextureManager::TextureManager(uint64_t budgetBytes) : residency(*this, budgetBytes)
+{
+}
+
+TextureManager::~TextureManager()
+{
+    cleanup();
+}
+
+TextureId TextureManager::load(std::wstring const& path)
+{
+    return residency.acquire(path);
+}
+
+void TextureManager::release(TextureId id)
+{
+    residency.release(id);
+}
+
+ID3D11ShaderResourceView* TextureManager::srv(TextureId id)
+{
+    auto found = textures.find(id);
+    if (found == textures.end())
+        return nullptr;
+
+    residency.touch(id);
+    return found->second->srv();
+}
+
+void TextureManager::update(ID3D11DeviceContext* ctx)
+{
+    for (auto& tex : textures)
+        tex.second->update(ctx);
+    residency.update();
+}
+
+void TextureManager::cleanup()
+{
+    for (auto& tex : textures)
+        tex.second->cleanup();
+    textures.clear();
+    paths.clear();
+}
+
+bool TextureManager::create(TextureId id, std::wstring const& path, TextureDesc& desc)
+{
+    auto tex = StreamedTextureFactory::createFromDDS(path.c_str());
+    if (!tex)
+        return false;
+
+    auto const& info = tex->info();
+    desc.width = info.width;
+    desc.height = info.height;
+    desc.mipCount = info.mipCount;
+    desc.arraySize = info.arraySize;
+    desc.format = info.format;
+
+    textures[id] = std::move(tex);
+    paths[id] = path;
+    return true;
+}
+
+bool TextureManager::setFirstMip(TextureId id, uint32_t firstMip)
+{
+    // views can't be narrowed in place, recreate from the file instead; the residency
+    // only asks for block aligned mips, so StreamedTexture keeps firstMip as given
+    auto tex = StreamedTextureFactory::createFromDDS(paths[id].c_str(), 0, 64, firstMip);
+    if (!tex || tex->firstMip() != firstMip)
+    {
+        if (tex)
+            tex->cleanup();
+        return false;
+    }
+
+    textures[id]->cleanup();
+    textures[id] = std::move(tex);
+    return true;
+}
+
+void TextureManager::destroy(TextureId id)
+{
+    auto found = textures.find(id);
+    if (found != textures.end())
+    {
+        found->second->cleanup();
+        textures.erase(found);
+    }
+    paths.erase(id);
+}
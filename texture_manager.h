@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <d3d11_1.h>
+
+#include "texture_residency.h"
+
+class StreamedTexture;
+
+// Loads DDS textures by path, shares repeated loads and keeps the estimated
+// GPU footprint within a budget. Views can change when mips are evicted or
+// restored, so query srv() every frame instead of caching it.
+class TextureManager : public TextureAllocator
+{
+public:
+    explicit TextureManager(uint64_t budgetBytes);
+    ~TextureManager();
+
+    TextureId load(std::wstring const& path);
+    void release(TextureId id);
+
+    // marks the texture as used this frame, nullptr if it is not resident
+    ID3D11ShaderResourceView* srv(TextureId id);
+
+    // stream pending mips and apply the budget, call once per frame
+    void update(ID3D11DeviceContext* ctx);
+
+    void setBudget(uint64_t budgetBytes) { residency.setBudget(budgetBytes); }
+    TextureResidencyStats const& stats() const { return residency.stats(); }
+
+    void cleanup();
+
+    bool create(TextureId id, std::wstring const& path, TextureDesc& desc) override;
+    bool setFirstMip(TextureId id, uint32_t firstMip) override;
+    void destroy(TextureId id) override;
+
+private:
+    TextureManager(TextureManager const&) = delete;
+    TextureManager& operator=(TextureManager const&) = delete;
+
+    std::unordered_map<TextureId, std::unique_ptr<StreamedTexture>> textures;
+    std::unordered_map<TextureId, std::wstring> paths;
+    TextureResidency residency;
+};
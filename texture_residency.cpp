@@ -0,0 +1,240 @@
+#include <algorithm>
+#include "texture_residency.h"
+#include "dds.h"
+
+
+uint64_t estimateTextureBytes(TextureDesc const& desc, uint32_t firstMip)
+{
+    uint64_t bytes = 0;
+    for (uint32_t mip = firstMip; mip < desc.mipCount; mip++)
+    {
+        uint32_t rowPitch, rowCount;
+        uint32_t w = std::max<uint32_t>(1, desc.width >> mip);
+        uint32_t h = std::max<uint32_t>(1, desc.height >> mip);
+        if (!surfaceInfo(w, h, desc.format, rowPitch, rowCount))
+            continue;
+        bytes += static_cast<uint64_t>(rowPitch) * rowCount;
+    }
+    return bytes * desc.arraySize;
+}
+
+bool isValidFirstMip(TextureDesc const& desc, uint32_t firstMip)
+{
+    if (firstMip == 0 || !isBlockCompressed(desc.format))
+        return true;
+    uint32_t w = std::max<uint32_t>(1, desc.width >> firstMip);
+    uint32_t h = std::max<uint32_t>(1, desc.height >> firstMip);
+    return w % 4 == 0 && h % 4 == 0;
+}
+
+TextureResidency::TextureResidency(TextureAllocator& allocator, uint64_t budgetBytes) :
+    allocator(allocator)
+{
+    _stats.budgetBytes = budgetBytes;
+}
+
+TextureId TextureResidency::acquire(std::wstring const& path)
+{
+    auto found = byPath.find(path);
+    if (found != byPath.end())
+    {
+        auto& entry = entries[found->second];
+        entry.refCount++;
+        entry.lastUsedFrame = frame;
+        _stats.dedupedLoads++;
+        return found->second;
+    }
+
+    TextureId id = nextId++;
+    Entry entry;
+    entry.path = path;
+    if (!allocator.create(id, path, entry.desc))
+        return InvalidTextureId;
+
+    entry.refCount = 1;
+    entry.lastUsedFrame = frame;
+    entry.bytes = estimateTextureBytes(entry.desc);
+
+    entries.emplace(id, entry);
+    byPath.emplace(path, id);
+    _stats.loads++;
+    updateStats();
+    return id;
+}
+
+void TextureResidency::release(TextureId id)
+{
+    auto found = entries.find(id);
+    if (found != entries.end() && found->second.refCount > 0)
+        found->second.refCount--;
+}
+
+void TextureResidency::touch(TextureId id)
+{
+    auto found = entries.find(id);
+    if (found != entries.end())
+        found->second.lastUsedFrame = frame;
+}
+
+void TextureResidency::update()
+{
+    enforceBudget();
+    restoreMips();
+    updateStats();
+    frame++;
+}
+
+void TextureResidency::setBudget(uint64_t budgetBytes)
+{
+    _stats.budgetBytes = budgetBytes;
+}
+
+bool TextureResidency::isResident(TextureId id) const
+{
+    return entries.count(id) != 0;
+}
+
+uint32_t TextureResidency::firstMip(TextureId id) const
+{
+    auto found = entries.find(id);
+    return found != entries.end() ? found->second.firstMip : 0;
+}
+
+uint32_t TextureResidency::minFirstMip(Entry const& entry) const
+{
+    uint32_t mip = 0;
+    while (mip + 1 < entry.desc.mipCount &&
+        std::max(entry.desc.width >> mip, entry.desc.height >> mip) > minResidentSize)
+        mip++;
+    return mip;
+}
+
+bool TextureResidency::setFirstMip(TextureId id, Entry& entry, uint32_t firstMip)
+{
+    if (!allocator.setFirstMip(id, firstMip))
+        return false;
+    entry.firstMip = firstMip;
+    entry.bytes = estimateTextureBytes(entry.desc, firstMip);
+    return true;
+}
+
+void TextureResidency::evict(TextureId id)
+{
+    auto found = entries.find(id);
+    allocator.destroy(id);
+    byPath.erase(found->second.path);
+    entries.erase(found);
+    _stats.textureEvictions++;
+}
+
+void TextureResidency::enforceBudget()
+{
+    uint64_t resident = 0;
+    for (auto const& e : entries)
+        resident += e.second.bytes;
+    if (resident <= _stats.budgetBytes)
+        return;
+
+    // textures used this frame are never touched
+    std::vector<TextureId> lru;
+    for (auto const& e : entries)
+        if (e.second.lastUsedFrame < frame)
+            lru.push_back(e.first);
+    std::sort(lru.begin(), lru.end(), [this](TextureId a, TextureId b) {
+        return entries[a].lastUsedFrame < entries[b].lastUsedFrame;
+    });
+
+    // drop detailed mips first, oldest textures first
+    for (auto id : lru)
+    {
+        if (resident <= _stats.budgetBytes)
+            return;
+
+        auto& entry = entries[id];
+        uint32_t target = entry.firstMip, minMip = minFirstMip(entry);
+        uint64_t bytes = entry.bytes;
+        for (uint32_t mip = target + 1; mip <= minMip && resident - entry.bytes + bytes > _stats.budgetBytes; mip++)
+        {
+            if (!isValidFirstMip(entry.desc, mip))
+                continue;
+            target = mip;
+            bytes = estimateTextureBytes(entry.desc, mip);
+        }
+
+        if (target == entry.firstMip)
+            continue;
+
+        uint32_t dropped = target - entry.firstMip;
+        uint64_t oldBytes = entry.bytes;
+        if (setFirstMip(id, entry, target))
+        {
+            resident = resident - oldBytes + entry.bytes;
+            _stats.mipEvictions += dropped;
+        }
+    }
+
+    // then whole textures nobody references anymore
+    for (auto id : lru)
+    {
+        if (resident <= _stats.budgetBytes)
+            return;
+
+        auto& entry = entries[id];
+        if (entry.refCount == 0)
+        {
+            resident -= entry.bytes;
+            evict(id);
+        }
+    }
+}
+
+void TextureResidency::restoreMips()
+{
+    uint64_t resident = 0;
+    std::vector<TextureId> trimmed;
+    for (auto const& e : entries)
+    {
+        resident += e.second.bytes;
+        if (e.second.firstMip > 0 && e.second.lastUsedFrame == frame)
+            trimmed.push_back(e.first);
+    }
+
+    for (auto id : trimmed)
+    {
+        auto& entry = entries[id];
+        uint32_t target = entry.firstMip;
+        for (uint32_t mip = target; mip > 0; mip--)
+        {
+            if (resident - entry.bytes + estimateTextureBytes(entry.desc, mip - 1) > _stats.budgetBytes)
+                break;
+            if (isValidFirstMip(entry.desc, mip - 1))
+                target = mip - 1;
+        }
+
+        if (target == entry.firstMip)
+            continue;
+
+        uint32_t restored = entry.firstMip - target;
+        uint64_t oldBytes = entry.bytes;
+        if (setFirstMip(id, entry, target))
+        {
+            resident = resident - oldBytes + entry.bytes;
+            _stats.mipRestores += restored;
+        }
+    }
+}
+
+void TextureResidency::updateStats()
+{
+    _stats.residentBytes = 0;
+    _stats.requestedBytes = 0;
+    _stats.trimmedCount = 0;
+    _stats.textureCount = static_cast<uint32_t>(entries.size());
+    for (auto const& e : entries)
+    {
+        _stats.residentBytes += e.second.bytes;
+        _stats.requestedBytes += estimateTextureBytes(e.second.desc);
+        if (e.second.firstMip > 0)
+            _stats.trimmedCount++;
+    }
+}
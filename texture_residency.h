@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// Portable texture accounting and eviction policy. The GPU side is hidden
+// behind TextureAllocator, so the policy can be driven by a fake allocator.
+
+using TextureId = uint32_t;
+constexpr TextureId InvalidTextureId = 0;
+
+struct TextureDesc
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipCount = 1;
+    // 2D slices, 6 per cube
+    uint32_t arraySize = 1;
+    // DXGI_FORMAT value
+    uint32_t format = 0;
+};
+
+// bytes taken by mips [firstMip, mipCount) of all slices
+uint64_t estimateTextureBytes(TextureDesc const& desc, uint32_t firstMip = 0);
+// whether the texture can start at firstMip: BC top levels must be whole blocks
+bool isValidFirstMip(TextureDesc const& desc, uint32_t firstMip);
+
+class TextureAllocator
+{
+public:
+    virtual ~TextureAllocator() = default;
+
+    // create the resource with its full mip chain, fills desc
+    virtual bool create(TextureId id, std::wstring const& path, TextureDesc& desc) = 0;
+    // recreate the resource with mips finer than firstMip dropped (or restored),
+    // only called with mips that pass isValidFirstMip
+    virtual bool setFirstMip(TextureId id, uint32_t firstMip) = 0;
+    virtual void destroy(TextureId id) = 0;
+};
+
+struct TextureResidencyStats
+{
+    uint64_t budgetBytes = 0;
+    uint64_t residentBytes = 0;
+    // bytes the resident textures would take with all their mips
+    uint64_t requestedBytes = 0;
+    uint32_t textureCount = 0;
+    uint32_t trimmedCount = 0;
+
+    // totals since creation
+    uint64_t loads = 0;
+    uint64_t dedupedLoads = 0;
+    uint64_t mipEvictions = 0;
+    uint64_t textureEvictions = 0;
+    uint64_t mipRestores = 0;
+};
+
+class TextureResidency
+{
+public:
+    TextureResidency(TextureAllocator& allocator, uint64_t budgetBytes);
+
+    // load the texture (or reuse the resident one) and take a reference
+    TextureId acquire(std::wstring const& path);
+    // drop a reference, unreferenced textures stay cached until evicted
+    void release(TextureId id);
+    // mark the texture as used in the current frame
+    void touch(TextureId id);
+
+    // advance the frame counter and bring residency back within budget
+    void update();
+
+    void setBudget(uint64_t budgetBytes);
+    // mips at or below this size are never evicted from a referenced texture
+    void setMinResidentSize(uint32_t size) { minResidentSize = size; }
+
+    bool isResident(TextureId id) const;
+    uint32_t firstMip(TextureId id) const;
+    TextureResidencyStats const& stats() const { return _stats; }
+
+private:
+    struct Entry
+    {
+        std::wstring path;
+        TextureDesc desc;
+        uint32_t firstMip = 0;
+        uint32_t refCount = 0;
+        uint64_t lastUsedFrame = 0;
+        uint64_t bytes = 0;
+    };
+
+    uint32_t minFirstMip(Entry const& entry) const;
+    bool setFirstMip(TextureId id, Entry& entry, uint32_t firstMip);
+    void evict(TextureId id);
+    void enforceBudget();
+    void restoreMips();
+    void updateStats();
+
+    TextureAllocator& allocator;
+    std::unordered_map<TextureId, Entry> entries;
+    std::unordered_map<std::wstring, TextureId> byPath;
+
+    TextureId nextId = 1;
+    uint64_t frame = 1;
+    uint32_t minResidentSize = 64;
+    TextureResidencyStats _stats;
+};
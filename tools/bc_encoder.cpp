@@ -0,0 +1,630 @@
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "bc_encoder.h"
+
+
+namespace {
+
+// BC6H/BC7 4-bit interpolation weights (out of 64)
+const int weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+class BitWriter
+{
+public:
+    explicit BitWriter(uint8_t* out, int size) : out(out) { memset(out, 0, size); }
+
+    void put(uint32_t value, int count)
+    {
+        for (int i = 0; i < count; i++, pos++)
+            if (value & (1u << i))
+                out[pos >> 3] |= static_cast<uint8_t>(1u << (pos & 7));
+    }
+
+private:
+    uint8_t* out;
+    int pos = 0;
+};
+
+class BitReader
+{
+public:
+    explicit BitReader(uint8_t const* in) : in(in) {}
+
+    uint32_t get(int count)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < count; i++, pos++)
+            value |= ((in[pos >> 3] >> (pos & 7)) & 1u) << i;
+        return value;
+    }
+
+private:
+    uint8_t const* in;
+    int pos = 0;
+};
+
+// Principal axis fit of N-channel points, returns the two extreme projections
+template<int N>
+void fitPrincipalAxis(float const (*pts)[N], int count, float e0[N], float e1[N])
+{
+    float mean[N] = {};
+    for (int i = 0; i < count; i++)
+        for (int c = 0; c < N; c++)
+            mean[c] += pts[i][c];
+    for (int c = 0; c < N; c++)
+        mean[c] /= count;
+
+    float cov[N][N] = {};
+    for (int i = 0; i < count; i++)
+        for (int a = 0; a < N; a++)
+            for (int b = 0; b < N; b++)
+                cov[a][b] += (pts[i][a] - mean[a]) * (pts[i][b] - mean[b]);
+
+    // power iteration seeded with the bounding box diagonal
+    float axis[N];
+    for (int c = 0; c < N; c++) {
+        float lo = pts[0][c], hi = pts[0][c];
+        for (int i = 1; i < count; i++) {
+            lo = std::min(lo, pts[i][c]);
+            hi = std::max(hi, pts[i][c]);
+        }
+        axis[c] = hi - lo;
+    }
+    for (int iter = 0; iter < 8; iter++) {
+        float next[N] = {};
+        for (int a = 0; a < N; a++)
+            for (int b = 0; b < N; b++)
+                next[a] += cov[a][b] * axis[b];
+        float len = 0;
+        for (int c = 0; c < N; c++)
+            len += next[c] * next[c];
+        if (len < 1e-12f)
+            break;
+        len = std::sqrt(len);
+        for (int c = 0; c < N; c++)
+            axis[c] = next[c] / len;
+    }
+
+    float tMin = 0, tMax = 0;
+    for (int i = 0; i < count; i++) {
+        float t = 0;
+        for (int c = 0; c < N; c++)
+            t += (pts[i][c] - mean[c]) * axis[c];
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+
+    for (int c = 0; c < N; c++) {
+        e0[c] = mean[c] + axis[c] * tMin;
+        e1[c] = mean[c] + axis[c] * tMax;
+    }
+}
+
+// Least squares endpoints for fixed interpolation factors, false if degenerate
+template<int N>
+bool refitEndpoints(float const (*pts)[N], float const* factors, int count, float e0[N], float e1[N])
+{
+    float A = 0, B = 0, C = 0;
+    float X0[N] = {}, X1[N] = {};
+    for (int i = 0; i < count; i++) {
+        float a = factors[i], b = 1.0f - a;
+        A += b * b;
+        B += a * b;
+        C += a * a;
+        for (int c = 0; c < N; c++) {
+            X0[c] += b * pts[i][c];
+            X1[c] += a * pts[i][c];
+        }
+    }
+    float det = A * C - B * B;
+    if (std::fabs(det) < 1e-8f)
+        return false;
+
+    for (int c = 0; c < N; c++) {
+        e0[c] = (C * X0[c] - B * X1[c]) / det;
+        e1[c] = (A * X1[c] - B * X0[c]) / det;
+    }
+    return true;
+}
+
+int roundClamp(float v, int lo, int hi)
+{
+    return std::min(hi, std::max(lo, static_cast<int>(std::lround(v))));
+}
+
+//--------------------------------------------------------------------------------------
+// BC1
+//--------------------------------------------------------------------------------------
+
+struct BC1Endpoints
+{
+    uint16_t c[2];
+    int rgb[2][3];
+};
+
+void expand565(uint16_t c, int rgb[3])
+{
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+uint16_t quantize565(float const rgb[3])
+{
+    int r = roundClamp(rgb[0] * 31.0f / 255.0f, 0, 31);
+    int g = roundClamp(rgb[1] * 63.0f / 255.0f, 0, 63);
+    int b = roundClamp(rgb[2] * 31.0f / 255.0f, 0, 31);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void bc1Palette(uint16_t c0, uint16_t c1, int palette[4][3])
+{
+    expand565(c0, palette[0]);
+    expand565(c1, palette[1]);
+    for (int c = 0; c < 3; c++) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+    }
+}
+
+float bc1Assign(float const pts[16][3], uint16_t c0, uint16_t c1, int idx[16])
+{
+    int palette[4][3];
+    bc1Palette(c0, c1, palette);
+    int count = c0 == c1 ? 1 : 4;
+
+    float total = 0;
+    for (int i = 0; i < 16; i++) {
+        float best = 1e30f;
+        for (int p = 0; p < count; p++) {
+            float err = 0;
+            for (int c = 0; c < 3; c++) {
+                float d = pts[i][c] - palette[p][c];
+                err += d * d;
+            }
+            if (err < best) {
+                best = err;
+                idx[i] = p;
+            }
+        }
+        total += best;
+    }
+    return total;
+}
+
+//--------------------------------------------------------------------------------------
+// BC7 mode 6
+//--------------------------------------------------------------------------------------
+
+struct BC7Endpoint
+{
+    int c7[4];
+    int p;
+    int value(int ch) const { return (c7[ch] << 1) | p; }
+};
+
+BC7Endpoint quantizeBC7(float const rgba[4])
+{
+    BC7Endpoint best = {};
+    float bestErr = 1e30f;
+    for (int p = 0; p < 2; p++) {
+        BC7Endpoint e;
+        e.p = p;
+        float err = 0;
+        for (int c = 0; c < 4; c++) {
+            e.c7[c] = roundClamp((rgba[c] - p) * 0.5f, 0, 127);
+            float d = static_cast<float>(e.value(c)) - rgba[c];
+            err += d * d;
+        }
+        if (err < bestErr) {
+            bestErr = err;
+            best = e;
+        }
+    }
+    return best;
+}
+
+float bc7Assign(float const pts[16][4], BC7Endpoint const& e0, BC7Endpoint const& e1, int idx[16])
+{
+    int palette[16][4];
+    for (int w = 0; w < 16; w++)
+        for (int c = 0; c < 4; c++)
+            palette[w][c] = ((64 - weights4[w]) * e0.value(c) + weights4[w] * e1.value(c) + 32) >> 6;
+
+    float total = 0;
+    for (int i = 0; i < 16; i++) {
+        float best = 1e30f;
+        for (int w = 0; w < 16; w++) {
+            float err = 0;
+            for (int c = 0; c < 4; c++) {
+                float d = pts[i][c] - palette[w][c];
+                err += d * d;
+            }
+            if (err < best) {
+                best = err;
+                idx[i] = w;
+            }
+        }
+        total += best;
+    }
+    return total;
+}
+
+//--------------------------------------------------------------------------------------
+// BC6H mode 11
+//--------------------------------------------------------------------------------------
+
+// 10-bit endpoint to the 16-bit interpolation domain (unsigned)
+int unquantizeBC6H(int q)
+{
+    if (q == 0)
+        return 0;
+    if (q == 1023)
+        return 0xFFFF;
+    return ((q << 16) + 0x8000) >> 10;
+}
+
+// interpolated value back to half-float bits
+int finishBC6H(int v)
+{
+    return (v * 31) >> 6;
+}
+
+int quantizeBC6H(float half)
+{
+    int q = roundClamp((half - 15.0f) / 31.0f, 0, 1023);
+    // finish() is not exactly linear at the range ends, check the neighbours
+    int best = q;
+    float bestErr = 1e30f;
+    for (int cand = std::max(0, q - 1); cand <= std::min(1023, q + 1); cand++) {
+        float err = std::fabs(finishBC6H(unquantizeBC6H(cand)) - half);
+        if (err < bestErr) {
+            bestErr = err;
+            best = cand;
+        }
+    }
+    return best;
+}
+
+float bc6hAssign(float const pts[16][3], int const q0[3], int const q1[3], int idx[16])
+{
+    int palette[16][3];
+    for (int w = 0; w < 16; w++)
+        for (int c = 0; c < 3; c++) {
+            int u0 = unquantizeBC6H(q0[c]), u1 = unquantizeBC6H(q1[c]);
+            palette[w][c] = finishBC6H((u0 * (64 - weights4[w]) + u1 * weights4[w] + 32) >> 6);
+        }
+
+    float total = 0;
+    for (int i = 0; i < 16; i++) {
+        float best = 1e30f;
+        for (int w = 0; w < 16; w++) {
+            float err = 0;
+            for (int c = 0; c < 3; c++) {
+                float d = pts[i][c] - palette[w][c];
+                err += d * d;
+            }
+            if (err < best) {
+                best = err;
+                idx[i] = w;
+            }
+        }
+        total += best;
+    }
+    return total;
+}
+
+} // namespace
+
+
+uint16_t floatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (((bits >> 23) & 0xFF) == 0xFF)
+        return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+    if (exponent >= 31)
+        return static_cast<uint16_t>(sign | 0x7BFF);
+    if (exponent <= 0) {
+        if (exponent < -10)
+            return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000;
+        uint32_t shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        // round to nearest even
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1)))
+            half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+        half++;
+    if (half > 0x7BFF)
+        half = 0x7BFF;
+    return static_cast<uint16_t>(sign | half);
+}
+
+float halfToFloat(uint16_t half)
+{
+    uint32_t sign = (half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+    uint32_t bits;
+
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        }
+        else {
+            // renormalize the denormal
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400)) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+        }
+    }
+    else if (exponent == 31) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    }
+    else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void encodeBC1Block(uint8_t const rgba[16][4], uint8_t out[BC1_BLOCK_BYTES])
+{
+    float pts[16][3];
+    for (int i = 0; i < 16; i++)
+        for (int c = 0; c < 3; c++)
+            pts[i][c] = rgba[i][c];
+
+    float e0[3], e1[3];
+    fitPrincipalAxis<3>(pts, 16, e0, e1);
+
+    uint16_t c0 = quantize565(e0), c1 = quantize565(e1);
+    int idx[16];
+    float err = bc1Assign(pts, c0, c1, idx);
+
+    // palette entries 0..3 sit at these positions between c0 and c1
+    const float bc1Factors[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+    for (int iter = 0; iter < 2 && c0 != c1; iter++) {
+        float factors[16];
+        for (int i = 0; i < 16; i++)
+            factors[i] = bc1Factors[idx[i]];
+        if (!refitEndpoints<3>(pts, factors, 16, e0, e1))
+            break;
+
+        uint16_t n0 = quantize565(e0), n1 = quantize565(e1);
+        int nidx[16];
+        float nerr = bc1Assign(pts, n0, n1, nidx);
+        if (nerr >= err)
+            break;
+        c0 = n0;
+        c1 = n1;
+        err = nerr;
+        memcpy(idx, nidx, sizeof(idx));
+    }
+
+    // 4-color mode requires c0 > c1
+    if (c0 < c1) {
+        std::swap(c0, c1);
+        const int remap[4] = { 1, 0, 3, 2 };
+        for (int i = 0; i < 16; i++)
+            idx[i] = remap[idx[i]];
+    }
+    else if (c0 == c1) {
+        for (int i = 0; i < 16; i++)
+            idx[i] = 0;
+    }
+
+    uint32_t indices = 0;
+    for (int i = 0; i < 16; i++)
+        indices |= static_cast<uint32_t>(idx[i]) << (2 * i);
+
+    out[0] = static_cast<uint8_t>(c0 & 0xFF);
+    out[1] = static_cast<uint8_t>(c0 >> 8);
+    out[2] = static_cast<uint8_t>(c1 & 0xFF);
+    out[3] = static_cast<uint8_t>(c1 >> 8);
+    for (int i = 0; i < 4; i++)
+        out[4 + i] = static_cast<uint8_t>(indices >> (8 * i));
+}
+
+void decodeBC1Block(uint8_t const in[BC1_BLOCK_BYTES], uint8_t rgba[16][4])
+{
+    uint16_t c0 = static_cast<uint16_t>(in[0] | (in[1] << 8));
+    uint16_t c1 = static_cast<uint16_t>(in[2] | (in[3] << 8));
+    uint32_t indices = in[4] | (in[5] << 8) | (in[6] << 16) | (static_cast<uint32_t>(in[7]) << 24);
+
+    int palette[4][4];
+    int rgb[4][3];
+    bc1Palette(c0, c1, rgb);
+    for (int p = 0; p < 4; p++) {
+        for (int c = 0; c < 3; c++)
+            palette[p][c] = rgb[p][c];
+        palette[p][3] = 255;
+    }
+    if (c0 <= c1) {
+        // 3-color mode with transparent black
+        for (int c = 0; c < 3; c++)
+            palette[2][c] = (rgb[0][c] + rgb[1][c]) / 2;
+        palette[3][0] = palette[3][1] = palette[3][2] = palette[3][3] = 0;
+    }
+
+    for (int i = 0; i < 16; i++) {
+        int p = (indices >> (2 * i)) & 3;
+        for (int c = 0; c < 4; c++)
+            rgba[i][c] = static_cast<uint8_t>(palette[p][c]);
+    }
+}
+
+void encodeBC7Block(uint8_t const rgba[16][4], uint8_t out[BC7_BLOCK_BYTES])
+{
+    float pts[16][4];
+    for (int i = 0; i < 16; i++)
+        for (int c = 0; c < 4; c++)
+            pts[i][c] = rgba[i][c];
+
+    float f0[4], f1[4];
+    fitPrincipalAxis<4>(pts, 16, f0, f1);
+
+    BC7Endpoint e0 = quantizeBC7(f0), e1 = quantizeBC7(f1);
+    int idx[16];
+    float err = bc7Assign(pts, e0, e1, idx);
+
+    for (int iter = 0; iter < 2; iter++) {
+        float factors[16];
+        for (int i = 0; i < 16; i++)
+            factors[i] = weights4[idx[i]] / 64.0f;
+        if (!refitEndpoints<4>(pts, factors, 16, f0, f1))
+            break;
+
+        BC7Endpoint n0 = quantizeBC7(f0), n1 = quantizeBC7(f1);
+        int nidx[16];
+        float nerr = bc7Assign(pts, n0, n1, nidx);
+        if (nerr >= err)
+            break;
+        e0 = n0;
+        e1 = n1;
+        err = nerr;
+        memcpy(idx, nidx, sizeof(idx));
+    }
+
+    // the anchor index is stored without its high bit
+    if (idx[0] & 8) {
+        std::swap(e0, e1);
+        for (int i = 0; i < 16; i++)
+            idx[i] = 15 - idx[i];
+    }
+
+    BitWriter bits(out, BC7_BLOCK_BYTES);
+    bits.put(1 << 6, 7); // mode 6
+    for (int c = 0; c < 4; c++) {
+        bits.put(e0.c7[c], 7);
+        bits.put(e1.c7[c], 7);
+    }
+    bits.put(e0.p, 1);
+    bits.put(e1.p, 1);
+    bits.put(idx[0], 3);
+    for (int i = 1; i < 16; i++)
+        bits.put(idx[i], 4);
+}
+
+bool decodeBC7Block(uint8_t const in[BC7_BLOCK_BYTES], uint8_t rgba[16][4])
+{
+    BitReader bits(in);
+    if (bits.get(7) != (1 << 6))
+        return false;
+
+    BC7Endpoint e0, e1;
+    for (int c = 0; c < 4; c++) {
+        e0.c7[c] = bits.get(7);
+        e1.c7[c] = bits.get(7);
+    }
+    e0.p = bits.get(1);
+    e1.p = bits.get(1);
+
+    for (int i = 0; i < 16; i++) {
+        int w = weights4[bits.get(i == 0 ? 3 : 4)];
+        for (int c = 0; c < 4; c++)
+            rgba[i][c] = static_cast<uint8_t>(((64 - w) * e0.value(c) + w * e1.value(c) + 32) >> 6);
+    }
+    return true;
+}
+
+void encodeBC6HBlock(float const rgb[16][3], uint8_t out[BC6H_BLOCK_BYTES])
+{
+    // fit in half-float bit space, which is what the hardware interpolates
+    float pts[16][3];
+    for (int i = 0; i < 16; i++)
+        for (int c = 0; c < 3; c++)
+            pts[i][c] = floatToHalf(std::min(std::max(rgb[i][c], 0.0f), 65504.0f));
+
+    float f0[3], f1[3];
+    fitPrincipalAxis<3>(pts, 16, f0, f1);
+
+    int q0[3], q1[3];
+    for (int c = 0; c < 3; c++) {
+        q0[c] = quantizeBC6H(f0[c]);
+        q1[c] = quantizeBC6H(f1[c]);
+    }
+    int idx[16];
+    float err = bc6hAssign(pts, q0, q1, idx);
+
+    for (int iter = 0; iter < 2; iter++) {
+        float factors[16];
+        for (int i = 0; i < 16; i++)
+            factors[i] = weights4[idx[i]] / 64.0f;
+        if (!refitEndpoints<3>(pts, factors, 16, f0, f1))
+            break;
+
+        int n0[3], n1[3];
+        for (int c = 0; c < 3; c++) {
+            n0[c] = quantizeBC6H(f0[c]);
+            n1[c] = quantizeBC6H(f1[c]);
+        }
+        int nidx[16];
+        float nerr = bc6hAssign(pts, n0, n1, nidx);
+        if (nerr >= err)
+            break;
+        memcpy(q0, n0, sizeof(q0));
+        memcpy(q1, n1, sizeof(q1));
+        memcpy(idx, nidx, sizeof(idx));
+        err = nerr;
+    }
+
+    if (idx[0] & 8) {
+        for (int c = 0; c < 3; c++)
+            std::swap(q0[c], q1[c]);
+        for (int i = 0; i < 16; i++)
+            idx[i] = 15 - idx[i];
+    }
+
+    BitWriter bits(out, BC6H_BLOCK_BYTES);
+    bits.put(0x03, 5); // mode 11
+    for (int c = 0; c < 3; c++)
+        bits.put(q0[c], 10);
+    for (int c = 0; c < 3; c++)
+        bits.put(q1[c], 10);
+    bits.put(idx[0], 3);
+    for (int i = 1; i < 16; i++)
+        bits.put(idx[i], 4);
+}
+
+bool decodeBC6HBlock(uint8_t const in[BC6H_BLOCK_BYTES], float rgb[16][3])
+{
+    BitReader bits(in);
+    if (bits.get(5) != 0x03)
+        return false;
+
+    int u0[3], u1[3];
+    for (int c = 0; c < 3; c++)
+        u0[c] = unquantizeBC6H(bits.get(10));
+    for (int c = 0; c < 3; c++)
+        u1[c] = unquantizeBC6H(bits.get(10));
+
+    for (int i = 0; i < 16; i++) {
+        int w = weights4[bits.get(i == 0 ? 3 : 4)];
+        for (int c = 0; c < 3; c++) {
+            int h = finishBC6H((u0[c] * (64 - w) + u1[c] * w + 32) >> 6);
+            rgb[i][c] = halfToFloat(static_cast<uint16_t>(h));
+        }
+    }
+    return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+// Block compression for the offline texture cooker. Every function works on
+// a single 4x4 block given in row-major order.
+//
+// The encoders use one fixed mode per format:
+//   BC1  -- 4-color mode, RGB only
+//   BC7  -- mode 6 (single subset, RGBA 7.7.7.7 + p-bit, 4-bit indices)
+//   BC6H -- mode 11 (single region, 10.10.10 endpoints, 4-bit indices), unsigned
+// Endpoints are fitted along the principal axis and refined with least squares.
+
+constexpr int BC1_BLOCK_BYTES = 8;
+constexpr int BC7_BLOCK_BYTES = 16;
+constexpr int BC6H_BLOCK_BYTES = 16;
+
+void encodeBC1Block(uint8_t const rgba[16][4], uint8_t out[BC1_BLOCK_BYTES]);
+void encodeBC7Block(uint8_t const rgba[16][4], uint8_t out[BC7_BLOCK_BYTES]);
+// negative values are clamped to zero, values above 65504 are clamped
+void encodeBC6HBlock(float const rgb[16][3], uint8_t out[BC6H_BLOCK_BYTES]);
+
+void decodeBC1Block(uint8_t const in[BC1_BLOCK_BYTES], uint8_t rgba[16][4]);
+// only the modes written by the encoders are supported, false otherwise
+bool decodeBC7Block(uint8_t const in[BC7_BLOCK_BYTES], uint8_t rgba[16][4]);
+bool decodeBC6HBlock(uint8_t const in[BC6H_BLOCK_BYTES], float rgb[16][3]);
+
+uint16_t floatToHalf(float value);
+float halfToFloat(uint16_t half);
@@ -0,0 +1,175 @@
+//--------------------------------------------------------------------------------------
+// Headless benchmark: runs the CPU side of a benchmark frame -- camera path, per-object
+// constants for the sphere grid and lights, frame graph build/compile/execute -- with the
+// same warmup/measured frame schedule and CSV/JSON reports as "graphics-labs --benchmark".
+// There are no GPU columns, the passes don't issue draw calls.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -pthread -I.. benchmark_headless.cpp ../benchmark.cpp ../profiler.cpp
+//       ../frame_graph.cpp ../dds.cpp -o benchmark_headless
+//
+// Usage:
+//   benchmark_headless [--resolution WxH] [--grid n] [--lights n] [--warmup n] [--frames n]
+//                      [--camera-path file] [--csv file] [--json file]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "profiler.h"
+#include "frame_graph.h"
+#include "renderer_graph.h"
+
+// no textures, every pass becomes a profiler scope
+class ProfilingBackend : public FrameGraphBackend
+{
+public:
+    void* acquire(FrameGraphTextureDesc const&) override { return &texture; }
+    void release(void*) override {}
+    void unbindInputs(uint32_t) override {}
+
+    void beginPass(std::string const& name) override { Profiler::get().begin(Profiler::get().intern(name)); }
+    void endPass() override { Profiler::get().end(); }
+
+private:
+    int texture = 0;
+};
+
+struct Matrix
+{
+    float m[16];
+};
+
+// look-at view from a pose, as Camera builds it
+static Matrix viewMatrix(CameraPose const& pose)
+{
+    const float toRad = 3.14159265f / 180.0f;
+    float d[3] = {
+        std::cos(pose.yaw * toRad) * std::cos(pose.pitch * toRad),
+        std::sin(pose.pitch * toRad),
+        std::sin(pose.yaw * toRad) * std::cos(pose.pitch * toRad)
+    };
+    // right = up x d, up' = d x right
+    float r[3] = { d[2], 0.0f, -d[0] };
+    float rl = std::sqrt(r[0] * r[0] + r[2] * r[2]);
+    if (rl > 0.0f)
+    {
+        r[0] /= rl;
+        r[2] /= rl;
+    }
+    float u[3] = { d[1] * r[2] - d[2] * r[1], d[2] * r[0] - d[0] * r[2], d[0] * r[1] - d[1] * r[0] };
+
+    auto const* p = pose.position;
+    auto dot = [p](float const* a) { return a[0] * p[0] + a[1] * p[1] + a[2] * p[2]; };
+    return { {
+        r[0], u[0], d[0], 0.0f,
+        r[1], u[1], d[1], 0.0f,
+        r[2], u[2], d[2], 0.0f,
+        -dot(r), -dot(u), -dot(d), 1.0f
+    } };
+}
+
+static Matrix multiply(Matrix const& a, Matrix const& b)
+{
+    Matrix c = {};
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            for (int k = 0; k < 4; k++)
+                c.m[i * 4 + j] += a.m[i * 4 + k] * b.m[k * 4 + j];
+    return c;
+}
+
+// mirrors the constant buffer updates of Graphics::renderScene
+static float setupScene(CameraPose const& pose, uint32_t gridSize, uint32_t lightCount)
+{
+    PROFILE_SCOPE("SceneSetup");
+
+    auto view = viewMatrix(pose);
+    const float radius = 2.0f;
+    const float step = (1 - 0.01f) / std::max<int>(gridSize - 1, 1);
+
+    // keep the results alive so the work isn't optimized away
+    float checksum = 0.0f;
+    for (uint32_t row = 0; row < gridSize; row++)
+    {
+        for (uint32_t column = 0; column < gridSize; column++)
+        {
+            float x = 3.0f * (static_cast<int>(column) - static_cast<int>(gridSize / 2)) * radius;
+            float y = 3.0f * (static_cast<int>(row) - static_cast<int>(gridSize / 2)) * radius;
+            Matrix world = { {
+                1, 0, 0, 0,
+                0, 1, 0, 0,
+                0, 0, 1, 0,
+                x, y, 30.0f, 1
+            } };
+            auto worldView = multiply(world, view);
+            float roughness = 0.01f + column * step;
+            float metalness = 0.01f + row * step;
+
+            for (uint32_t l = 0; l < lightCount; l++)
+                checksum += worldView.m[12 + l % 3] * roughness + metalness;
+        }
+    }
+    return checksum;
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkSettings settings;
+    settings.enabled = true;
+    // the Profiler history is the only clock, nothing to wait for
+    settings.waitForGpu = false;
+
+    std::string error;
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (!parseBenchmarkArgs(args, settings, error))
+    {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    CameraPath path;
+    if (!settings.cameraPath.empty() && !path.load(settings.cameraPath, error))
+    {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    Benchmark run(settings, path);
+    ProfilingBackend backend;
+    CameraPose pose;
+    float checksum = 0.0f;
+    while (run.nextFrame(pose))
+    {
+        checksum += setupScene(pose, settings.gridSize, settings.lightCount);
+
+        {
+            PROFILE_SCOPE("FrameGraph");
+            FrameGraph graph;
+            buildRendererGraph(graph, settings.width, settings.height, 0);
+            if (!graph.compile() || !graph.execute(backend))
+            {
+                fprintf(stderr, "frame graph failed to compile\n");
+                return 1;
+            }
+        }
+
+        Profiler::get().endFrame();
+        run.frameDone();
+    }
+
+    run.collect();
+    run.print(stdout);
+    printf("checksum %g\n", checksum);
+
+    if (!run.writeCSV(settings.csvPath) || !run.writeJSON(settings.jsonPath))
+    {
+        fprintf(stderr, "could not write %s / %s\n", settings.csvPath.c_str(), settings.jsonPath.c_str());
+        return 1;
+    }
+    printf("report written to %s and %s\n", settings.csvPath.c_str(), settings.jsonPath.c_str());
+    return 0;
+}
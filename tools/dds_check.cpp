@@ -0,0 +1,305 @@
+//--------------------------------------------------------------------------------------
+// Checks of the DDS header parser: surface offsets, pitches and sizes for legacy and
+// DX10 headers, cubemaps and arrays, block compressed formats, and rejection of
+// truncated, oversized or hostile headers. Files are built in memory.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -I.. dds_check.cpp ../dds.cpp -o dds_check
+//
+// Usage:
+//   dds_check
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+
+#include "dds.h"
+
+static bool ok = true;
+
+static void check(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+}
+
+// DXGI_FORMAT values used below
+enum : uint32_t {
+    FMT_R8G8B8A8_UNORM = 28,
+    FMT_R32G32B32A32_FLOAT = 2,
+    FMT_BC1_UNORM = 71,
+    FMT_BC3_UNORM = 77,
+    FMT_BC7_UNORM = 98,
+};
+
+constexpr size_t legacyHeaderSize = sizeof(uint32_t) + sizeof(DDSFileHeader);
+constexpr size_t dx10HeaderSize = legacyHeaderSize + sizeof(DDSFileHeaderDXT10);
+
+static DDSFileHeader makeHeader(uint32_t width, uint32_t height, uint32_t mipCount)
+{
+    DDSFileHeader header = {};
+    header.size = sizeof(DDSFileHeader);
+    header.width = width;
+    header.height = height;
+    header.depth = 1;
+    header.mipMapCount = mipCount;
+    header.ddspf.size = sizeof(DDSPixelFormat);
+    return header;
+}
+
+// RGBA8 through the legacy bit mask path
+static void setRGBA8(DDSFileHeader& header)
+{
+    header.ddspf.flags = DDS_RGB | DDS_ALPHAPIXELS;
+    header.ddspf.RGBBitCount = 32;
+    header.ddspf.RBitMask = 0x000000ff;
+    header.ddspf.GBitMask = 0x0000ff00;
+    header.ddspf.BBitMask = 0x00ff0000;
+    header.ddspf.ABitMask = 0xff000000;
+}
+
+static void setDX10(DDSFileHeader& header)
+{
+    header.ddspf.flags = DDS_FOURCC;
+    header.ddspf.fourCC = makeFourCC('D', 'X', '1', '0');
+}
+
+// magic + header (+ DX10 header) followed by payloadSize bytes of zeroes
+static std::vector<uint8_t> makeFile(DDSFileHeader const& header, DDSFileHeaderDXT10 const* dx10, size_t payloadSize)
+{
+    std::vector<uint8_t> file(sizeof(uint32_t) + sizeof(header) + (dx10 ? sizeof(*dx10) : 0) + payloadSize);
+    uint32_t magic = DDS_MAGIC;
+    memcpy(file.data(), &magic, sizeof(magic));
+    memcpy(file.data() + sizeof(magic), &header, sizeof(header));
+    if (dx10)
+        memcpy(file.data() + sizeof(magic) + sizeof(header), dx10, sizeof(*dx10));
+    return file;
+}
+
+static bool parse(std::vector<uint8_t> const& file, DDSInfo& info)
+{
+    return parseDDS(file.data(), file.size(), info);
+}
+
+// every surface follows the previous one, slice-major, and the chain ends at the payload end
+static bool surfacesContiguous(DDSInfo const& info, size_t headerSize, size_t fileSize)
+{
+    size_t offset = headerSize;
+    for (uint32_t slice = 0; slice < info.arraySize; slice++)
+    {
+        for (uint32_t mip = 0; mip < info.mipCount; mip++)
+        {
+            DDSSurface const& surf = info.surface(mip, slice);
+            if (surf.offset != offset || surf.size != size_t(surf.slicePitch) * surf.depth)
+                return false;
+            offset += surf.size;
+        }
+    }
+    return offset == fileSize;
+}
+
+static void checkLegacyCubemap()
+{
+    // 8x8 RGBA8, full chain: 256 + 64 + 16 + 4 bytes per face
+    DDSFileHeader header = makeHeader(8, 8, 4);
+    setRGBA8(header);
+    header.caps2 = DDS_CUBEMAP | DDS_CUBEMAP_ALLFACES;
+    std::vector<uint8_t> file = makeFile(header, nullptr, 6 * 340);
+
+    DDSInfo info;
+    check(parse(file, info), "legacy cubemap parses");
+    check(info.format == FMT_R8G8B8A8_UNORM, "legacy cubemap format");
+    check(info.isCubemap && info.arraySize == 6 && !info.hasDX10Header, "legacy cubemap has 6 faces");
+    check(info.surfaces.size() == 24, "legacy cubemap surface count");
+    check(surfacesContiguous(info, legacyHeaderSize, file.size()), "legacy cubemap surfaces are contiguous");
+
+    DDSSurface const& face3mip1 = info.surface(1, 3);
+    check(face3mip1.offset == legacyHeaderSize + 3 * 340 + 256, "legacy cubemap face 3 mip 1 offset");
+    check(face3mip1.width == 4 && face3mip1.height == 4, "legacy cubemap mip 1 size");
+    check(face3mip1.rowPitch == 16 && face3mip1.rowCount == 4 && face3mip1.slicePitch == 64, "legacy cubemap mip 1 pitch");
+    DDSSurface const& last = info.surface(3, 5);
+    check(last.width == 1 && last.height == 1 && last.rowPitch == 4 && last.size == 4, "legacy cubemap last mip");
+
+    // one face missing from caps2
+    header.caps2 = DDS_CUBEMAP | (DDS_CUBEMAP_ALLFACES & ~0x00000400u);
+    check(!parse(makeFile(header, nullptr, 6 * 340), info), "partial cubemap is rejected");
+}
+
+static void checkDX10Arrays()
+{
+    // two BC7 16x16 cubes: 256 + 64 + 16 bytes per face
+    DDSFileHeader header = makeHeader(16, 16, 3);
+    setDX10(header);
+    DDSFileHeaderDXT10 dx10 = {};
+    dx10.dxgiFormat = FMT_BC7_UNORM;
+    dx10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+    dx10.miscFlag = DDS_RESOURCE_MISC_TEXTURECUBE;
+    dx10.arraySize = 2;
+    std::vector<uint8_t> file = makeFile(header, &dx10, 12 * 336);
+
+    DDSInfo info;
+    check(parse(file, info), "DX10 cube array parses");
+    check(info.hasDX10Header && info.isCubemap, "DX10 cube array flags");
+    check(info.arraySize == 12 && info.surfaces.size() == 36, "DX10 cube array counts 6 faces per cube");
+    check(surfacesContiguous(info, dx10HeaderSize, file.size()), "DX10 cube array surfaces are contiguous");
+    DDSSurface const& surf = info.surface(2, 7);
+    check(surf.offset == dx10HeaderSize + 7 * 336 + 320, "DX10 cube array face 7 mip 2 offset");
+    check(surf.width == 4 && surf.rowPitch == 16 && surf.rowCount == 1 && surf.size == 16, "DX10 cube array mip 2 pitch");
+
+    // plain 2D array of three RGBA8 slices, single mip
+    header = makeHeader(4, 2, 0);
+    setDX10(header);
+    dx10 = {};
+    dx10.dxgiFormat = FMT_R8G8B8A8_UNORM;
+    dx10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+    dx10.arraySize = 3;
+    file = makeFile(header, &dx10, 3 * 32);
+    check(parse(file, info), "DX10 2D array parses");
+    check(!info.isCubemap && info.arraySize == 3 && info.mipCount == 1, "DX10 2D array counts");
+    check(surfacesContiguous(info, dx10HeaderSize, file.size()), "DX10 2D array surfaces are contiguous");
+
+    dx10.arraySize = 0;
+    check(!parse(makeFile(header, &dx10, 3 * 32), info), "DX10 array size 0 is rejected");
+    dx10.arraySize = 3;
+    dx10.resourceDimension = DDS_DIMENSION_TEXTURE3D;
+    check(!parse(makeFile(header, &dx10, 3 * 32), info), "DX10 volume array is rejected");
+}
+
+static void checkBlockSizes()
+{
+    uint32_t rowPitch, rowCount;
+
+    check(bytesPerBlock(FMT_BC1_UNORM) == 8, "BC1 block size");
+    check(bytesPerBlock(FMT_BC3_UNORM) == 16, "BC3 block size");
+    check(bytesPerBlock(FMT_BC7_UNORM) == 16, "BC7 block size");
+    check(bytesPerBlock(FMT_R8G8B8A8_UNORM) == 0, "uncompressed has no block size");
+
+    // partial blocks round up
+    check(surfaceInfo(10, 6, FMT_BC1_UNORM, rowPitch, rowCount) && rowPitch == 24 && rowCount == 2, "BC1 10x6 pitch");
+    check(surfaceInfo(10, 6, FMT_BC3_UNORM, rowPitch, rowCount) && rowPitch == 48 && rowCount == 2, "BC3 10x6 pitch");
+    check(surfaceInfo(10, 6, FMT_BC7_UNORM, rowPitch, rowCount) && rowPitch == 48 && rowCount == 2, "BC7 10x6 pitch");
+    // mips below 4x4 still take a whole block
+    check(surfaceInfo(1, 2, FMT_BC1_UNORM, rowPitch, rowCount) && rowPitch == 8 && rowCount == 1, "BC1 1x2 is one block");
+    check(surfaceInfo(2, 1, FMT_BC7_UNORM, rowPitch, rowCount) && rowPitch == 16 && rowCount == 1, "BC7 2x1 is one block");
+
+    // legacy DXT1/DXT5 map to BC1/BC3: 8x8 with 4 mips is 4+1+1+1 blocks
+    DDSFileHeader header = makeHeader(8, 8, 4);
+    header.ddspf.flags = DDS_FOURCC;
+    header.ddspf.fourCC = makeFourCC('D', 'X', 'T', '1');
+    std::vector<uint8_t> file = makeFile(header, nullptr, 7 * 8);
+    DDSInfo info;
+    check(parse(file, info) && info.format == FMT_BC1_UNORM, "DXT1 parses as BC1");
+    check(surfacesContiguous(info, legacyHeaderSize, file.size()), "DXT1 chain covers the file");
+
+    header.ddspf.fourCC = makeFourCC('D', 'X', 'T', '5');
+    file = makeFile(header, nullptr, 7 * 16);
+    check(parse(file, info) && info.format == FMT_BC3_UNORM, "DXT5 parses as BC3");
+    check(surfacesContiguous(info, legacyHeaderSize, file.size()), "DXT5 chain covers the file");
+}
+
+static void checkMipChains()
+{
+    // 8x8 RGBA8 supports at most 4 mips
+    DDSFileHeader header = makeHeader(8, 8, 4);
+    setRGBA8(header);
+    DDSInfo info;
+
+    std::vector<uint8_t> file = makeFile(header, nullptr, 340);
+    check(parse(file, info), "full chain parses");
+    file.pop_back();
+    check(!parse(file, info), "chain one byte short is rejected");
+    check(!parseDDS(file.data(), legacyHeaderSize - 1, info), "truncated header is rejected");
+
+    // trailing bytes after the chain are ignored
+    file = makeFile(header, nullptr, 400);
+    check(parse(file, info) && info.surfaces.back().offset + info.surfaces.back().size == legacyHeaderSize + 340,
+        "trailing bytes are ignored");
+
+    header.mipMapCount = 5;
+    check(!parse(makeFile(header, nullptr, 1024), info), "chain longer than log2 + 1 is rejected");
+
+    // non-square: 8x2 still allows 4 mips, the short side clamps at 1
+    header = makeHeader(8, 2, 4);
+    setRGBA8(header);
+    file = makeFile(header, nullptr, 64 + 16 + 8 + 4);
+    check(parse(file, info), "non-square chain parses");
+    check(info.surface(3, 0).width == 1 && info.surface(3, 0).height == 1, "non-square chain clamps at 1");
+    check(surfacesContiguous(info, legacyHeaderSize, file.size()), "non-square chain covers the file");
+
+    // mipMapCount 0 means a single level
+    header.mipMapCount = 0;
+    check(parse(makeFile(header, nullptr, 64), info) && info.mipCount == 1, "mip count 0 is one level");
+}
+
+static void checkHostileHeaders()
+{
+    uint32_t rowPitch, rowCount;
+    DDSInfo info;
+
+    // would wrap 32 bits: 0xffffffff * 128 bits
+    check(!surfaceInfo(0xffffffffu, 1, FMT_R32G32B32A32_FLOAT, rowPitch, rowCount), "row pitch overflow is rejected");
+
+    DDSFileHeader header = makeHeader(DDS_MAX_DIMENSION + 1, 1, 1);
+    setRGBA8(header);
+    check(!parse(makeFile(header, nullptr, 4 * (DDS_MAX_DIMENSION + 1)), info), "width above limit is rejected");
+    header = makeHeader(1, DDS_MAX_DIMENSION + 1, 1);
+    setRGBA8(header);
+    check(!parse(makeFile(header, nullptr, 4 * (DDS_MAX_DIMENSION + 1)), info), "height above limit is rejected");
+
+    // 0x40000000 x 4 RGBA8 wraps slicePitch to 0 in 32 bits
+    header = makeHeader(0x40000000, 4, 1);
+    setRGBA8(header);
+    check(!parse(makeFile(header, nullptr, 64), info), "wrapping slice pitch is rejected");
+
+    header = makeHeader(DDS_MAX_DIMENSION, DDS_MAX_DIMENSION, 1);
+    header.ddspf.flags = DDS_FOURCC;
+    header.ddspf.fourCC = makeFourCC('D', 'X', 'T', '1');
+    check(!parse(makeFile(header, nullptr, 64), info), "largest size without its payload is rejected");
+
+    // an unchecked arraySize used to reach the surface reserve
+    header = makeHeader(4, 4, 1);
+    setDX10(header);
+    DDSFileHeaderDXT10 dx10 = {};
+    dx10.dxgiFormat = FMT_BC1_UNORM;
+    dx10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+    dx10.arraySize = 0xffffffffu;
+    check(!parse(makeFile(header, &dx10, 64), info), "huge array size is rejected");
+    dx10.arraySize = DDS_MAX_ARRAY_SIZE + 1;
+    check(!parse(makeFile(header, &dx10, 8 * (DDS_MAX_ARRAY_SIZE + 1)), info), "array size above limit is rejected");
+    dx10.arraySize = DDS_MAX_ARRAY_SIZE;
+    check(parse(makeFile(header, &dx10, 8 * DDS_MAX_ARRAY_SIZE), info), "array size at limit parses");
+    dx10.miscFlag = DDS_RESOURCE_MISC_TEXTURECUBE;
+    dx10.arraySize = 0x80000000u;
+    check(!parse(makeFile(header, &dx10, 64), info), "cube count wrapping on x6 is rejected");
+
+    dx10 = {};
+    dx10.dxgiFormat = 0xffff;
+    dx10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+    dx10.arraySize = 1;
+    check(!parse(makeFile(header, &dx10, 64), info), "unknown format is rejected");
+    dx10.dxgiFormat = FMT_BC1_UNORM;
+    dx10.resourceDimension = 7;
+    check(!parse(makeFile(header, &dx10, 64), info), "unknown dimension is rejected");
+
+    std::vector<uint8_t> file = makeFile(makeHeader(4, 4, 1), nullptr, 64);
+    file[0] = 'X';
+    check(!parse(file, info), "bad magic is rejected");
+    check(!parseDDS(nullptr, 0, info), "null data is rejected");
+}
+
+int main()
+{
+    checkLegacyCubemap();
+    checkDX10Arrays();
+    checkBlockSizes();
+    checkMipChains();
+    checkHostileHeaders();
+
+    printf(ok ? "ok\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
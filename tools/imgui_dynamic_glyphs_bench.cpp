@@ -0,0 +1,313 @@
+//--------------------------------------------------------------------------------------
+// Benchmark and check of ImFontConfig::DynamicGlyphs (glyphs rasterized on first use
+// into LRU atlas pages) against the same fonts fully baked by Build(). Both atlases
+// render windows of text headless with the CPU rasterizer backend, each frame shows a
+// window of codepoints that slides through the font so new glyphs keep being loaded.
+// Every frame must give the same vertex positions and the same image. Reports the
+// texture size (Alpha8 + RGBA32 copies), glyph table size, build time, and the GUI
+// time of the first frame and of the following ones. A last run with few pages checks
+// that evicted glyphs come back identical.
+// Without --cjk-font the large range is 0x0020..0xFFFF of the Latin font, which only
+// has a few hundred glyphs: the build time gap then mostly shows the codepoint scan.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -pthread -I.. imgui_dynamic_glyphs_bench.cpp ../imgui_impl_soft.cpp ../imgui.cpp ../imgui_draw.cpp ../imgui_widgets.cpp ../imgui_tables.cpp -o imgui_dynamic_glyphs_bench
+//
+// Usage:
+//   imgui_dynamic_glyphs_bench [--font file.ttf] [--cjk-font file.ttf] [--frames n]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include "imgui.h"
+#include "imgui_impl_soft.h"
+#include "imgui_internal.h"   // ImTextCharToUtf8
+
+static bool ok = true;
+
+static void check(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+}
+
+static std::vector<unsigned char> readFile(char const* path)
+{
+    std::vector<unsigned char> data;
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return data;
+    fseek(file, 0, SEEK_END);
+    data.resize(static_cast<size_t>(ftell(file)));
+    fseek(file, 0, SEEK_SET);
+    if (fread(data.data(), 1, data.size(), file) != data.size())
+        data.clear();
+    fclose(file);
+    return data;
+}
+
+static int const Width = 1280;
+static int const Height = 720;
+
+struct Spec
+{
+    char const* name;
+    std::vector<unsigned char> const* font;     // nullptr: the embedded ProggyClean
+    ImWchar const* ranges;
+    std::vector<float> sizes;
+    int pageCount, pageSize;                    // 0: the defaults
+    int distinctPerFrame;                       // codepoints shown per font and frame, a third of them new
+};
+
+struct Result
+{
+    int width = 0, height = 0;
+    size_t glyphTableBytes = 0;
+    int glyphs = 0;
+    double buildMs = 0.0, firstFrameMs = 0.0, frameMs = 0.0, steadyFrameMs = 0.0;
+    int clearedPages = 0;
+    std::vector<std::vector<ImU32>> images;
+    std::vector<std::vector<ImVec2>> positions;
+};
+
+static size_t glyphTableBytes(ImFontAtlas const& atlas)
+{
+    size_t bytes = 0;
+    for (ImFont* font : atlas.Fonts)
+        bytes += font->Glyphs.size_in_bytes() + font->IndexAdvanceX.size_in_bytes() + font->IndexLookup.size_in_bytes();
+    return bytes;
+}
+
+static void appendUtf8(std::vector<char>& text, unsigned int c)
+{
+    char buf[5];
+    ImTextCharToUtf8(buf, c);
+    text.insert(text.end(), buf, buf + strlen(buf));
+}
+
+// codepoints[font] are the glyphs the font has (from the baked atlas), minus blanks
+static void buildGUI(int frame, int distinctPerFrame, std::vector<std::vector<unsigned int>> const& codepoints)
+{
+    auto& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2((float)Width, (float)Height);
+    io.DeltaTime = 1.0f / 60.0f;
+    ImGui_ImplSoft_NewFrame();
+    ImGui::NewFrame();
+
+    int const columns = (int)codepoints.size();
+    float const columnWidth = (float)Width / columns;
+    for (int fontIndex = 0; fontIndex < columns; fontIndex++)
+    {
+        auto const& font = codepoints[fontIndex];
+        ImGui::SetNextWindowPos(ImVec2(columnWidth * fontIndex, 0.0f), ImGuiCond_Always);
+        ImGui::SetNextWindowSize(ImVec2(columnWidth, (float)Height), ImGuiCond_Always);
+        char name[32];
+        snprintf(name, sizeof(name), "Font %d", fontIndex);
+        ImGui::Begin(name, nullptr, ImGuiWindowFlags_NoDecoration);
+        ImGui::PushFont(ImGui::GetIO().Fonts->Fonts[fontIndex]);
+        int const distinct = std::min(distinctPerFrame, (int)font.size());
+        std::vector<char> line;
+        for (int row = 0, k = 0; row < 24; row++)
+        {
+            line.clear();
+            for (int column = 0; column < 16; column++, k += 7)
+                appendUtf8(line, font[(frame * (distinctPerFrame / 3) + k % distinct) % font.size()]);
+            line.push_back(0);
+            ImGui::TextUnformatted(line.data());
+        }
+        ImGui::PopFont();
+        ImGui::End();
+    }
+    ImGui::Render();
+}
+
+static Result run(Spec const& spec, bool dynamic, int frames, std::vector<std::vector<unsigned int>>& codepoints)
+{
+    ImFontAtlas atlas;
+    for (float size : spec.sizes)
+    {
+        ImFontConfig config;
+        config.SizePixels = size;
+        config.FontDataOwnedByAtlas = false;
+        config.DynamicGlyphs = dynamic;
+        if (spec.font)
+            atlas.AddFontFromMemoryTTF((void*)spec.font->data(), static_cast<int>(spec.font->size()), size, &config, spec.ranges);
+        else
+            atlas.AddFontDefault(&config);
+    }
+    if (spec.pageCount > 0)
+        atlas.DynamicPageCount = spec.pageCount;
+    if (spec.pageSize > 0)
+        atlas.DynamicPageSize = spec.pageSize;
+
+    Result result;
+    auto start = std::chrono::steady_clock::now();
+    atlas.Build();
+    result.buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    result.width = atlas.TexWidth;
+    result.height = atlas.TexHeight;
+    result.glyphTableBytes = glyphTableBytes(atlas);
+    for (ImFont* font : atlas.Fonts)
+        result.glyphs += font->Glyphs.Size;
+
+    // the baked atlas tells which codepoints the fonts have
+    if (codepoints.empty())
+        for (ImFont* font : atlas.Fonts)
+        {
+            codepoints.emplace_back();
+            for (ImFontGlyph const& glyph : font->Glyphs)
+                if (glyph.Visible)
+                    codepoints.back().push_back(glyph.Codepoint);
+        }
+
+    ImGui::CreateContext(&atlas);
+    ImGui::GetIO().IniFilename = nullptr;
+    ImGui_ImplSoft_Init(1);
+    for (int frame = 0; frame < frames; frame++)
+    {
+        start = std::chrono::steady_clock::now();
+        buildGUI(frame, spec.distinctPerFrame, codepoints);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (frame == 0)
+            result.firstFrameMs = ms;
+        else
+            result.frameMs += ms / (frames - 1);
+
+        // a page cleared for new glyphs is uploaded whole
+        for (ImFontAtlasTexUpdate const& update : atlas.TexUpdates)
+            result.clearedPages += (update.Width == atlas.DynamicPageSize && update.Height == atlas.DynamicPageSize) ? 1 : 0;
+
+        std::vector<ImU32> image(Width * Height, IM_COL32(0, 0, 0, 255));
+        ImGui_ImplSoft_Framebuffer framebuffer = { image.data(), Width, Height, Width };
+        ImDrawData* drawData = ImGui::GetDrawData();
+        ImGui_ImplSoft_RenderDrawData(drawData, &framebuffer);
+        result.images.push_back(std::move(image));
+        result.positions.emplace_back();
+        for (int n = 0; n < drawData->CmdListsCount; n++)
+            for (ImDrawVert const& v : drawData->CmdLists[n]->VtxBuffer)
+                result.positions.back().push_back(v.pos);
+    }
+    check(atlas.TexUpdates.Size == 0, "the backend consumes the texture updates");
+
+    // the last text again: every glyph is loaded
+    int const steadyFrames = 10;
+    for (int frame = 0; frame < steadyFrames; frame++)
+    {
+        start = std::chrono::steady_clock::now();
+        buildGUI(frames - 1, spec.distinctPerFrame, codepoints);
+        result.steadyFrameMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / steadyFrames;
+    }
+    check(atlas.TexUpdates.Size == 0, "no glyph is loaded again while the text doesn't change");
+    ImGui_ImplSoft_Shutdown();
+    ImGui::DestroyContext();
+    return result;
+}
+
+static void compare(Result const& baked, Result const& dynamic, int frames)
+{
+    int differentImages = 0, differentLayouts = 0, maxDiff = 0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        auto const& a = baked.positions[frame];
+        auto const& b = dynamic.positions[frame];
+        if (a.size() != b.size() || memcmp(a.data(), b.data(), a.size() * sizeof(ImVec2)) != 0)
+            differentLayouts++;
+        bool same = true;
+        for (size_t i = 0; i < baked.images[frame].size(); i++)
+            for (int c = 0; c < 32; c += 8)
+            {
+                int diff = abs((int)((baked.images[frame][i] >> c) & 0xFF) - (int)((dynamic.images[frame][i] >> c) & 0xFF));
+                maxDiff = std::max(maxDiff, diff);
+                same &= diff == 0;
+            }
+        differentImages += same ? 0 : 1;
+    }
+    // the texture sizes differ, so do the UVs: bilinear sampling may round the other way
+    printf("  frames with other vertex positions: %d, other images: %d (max channel diff %d)\n", differentLayouts, differentImages, maxDiff);
+    check(differentLayouts == 0, "dynamic glyphs give the same layout");
+    check(maxDiff <= 1, "dynamic glyphs give the same image");
+}
+
+static void report(char const* mode, Result const& r)
+{
+    printf("  %-8s %5d glyphs, texture %4dx%-5d %8.1f KB, glyph tables %7.1f KB, build %8.2f ms\n",
+        mode, r.glyphs, r.width, r.height, r.width * r.height * 5 / 1024.0, r.glyphTableBytes / 1024.0, r.buildMs);
+    printf("           GUI: first frame %7.2f ms, sliding text %6.3f ms/frame, same text %6.3f ms/frame, cleared pages %d\n",
+        r.firstFrameMs, r.frameMs, r.steadyFrameMs, r.clearedPages);
+}
+
+static void bench(Spec const& spec, int frames)
+{
+    ImFontAtlas defaults;
+    printf("%s (%d pages of %d):\n", spec.name, spec.pageCount > 0 ? spec.pageCount : defaults.DynamicPageCount, spec.pageSize > 0 ? spec.pageSize : defaults.DynamicPageSize);
+    std::vector<std::vector<unsigned int>> codepoints;
+    Result baked = run(spec, false, frames, codepoints);
+    Result dynamic = run(spec, true, frames, codepoints);
+    report("baked", baked);
+    report("dynamic", dynamic);
+    compare(baked, dynamic, frames);
+    if (spec.pageCount > 0)
+        check(dynamic.clearedPages > 0, "pages are cleared for new glyphs");
+}
+
+int main(int argc, char** argv)
+{
+    char const* fontPath = nullptr;
+    char const* cjkFontPath = nullptr;
+    int frames = 30;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--font") && i + 1 < argc)
+            fontPath = argv[++i];
+        else if (!strcmp(argv[i], "--cjk-font") && i + 1 < argc)
+            cjkFontPath = argv[++i];
+        else if (!strcmp(argv[i], "--frames") && i + 1 < argc)
+            frames = std::max(2, atoi(argv[++i]));
+    }
+
+    std::vector<unsigned char> font, cjkFont;
+    if (fontPath && (font = readFile(fontPath)).empty())
+    {
+        printf("can't read %s\n", fontPath);
+        return 1;
+    }
+    if (cjkFontPath && (cjkFont = readFile(cjkFontPath)).empty())
+    {
+        printf("can't read %s\n", cjkFontPath);
+        return 1;
+    }
+
+    ImFontAtlas defaultRanges;
+    static ImWchar const bmpRanges[] = { 0x0020, 0xFFFF, 0 };
+    ImFontGlyphRangesBuilder builder;
+    builder.AddRanges(defaultRanges.GetGlyphRangesChineseFull());
+    builder.AddRanges(defaultRanges.GetGlyphRangesJapanese());
+    builder.AddRanges(defaultRanges.GetGlyphRangesKorean());
+    ImVector<ImWchar> cjkRanges;
+    builder.BuildRanges(&cjkRanges);
+
+    Spec latin = { "Latin", fontPath ? &font : nullptr, defaultRanges.GetGlyphRangesDefault(), { 13.0f, 16.0f, 20.0f, 24.0f }, 0, 0, 120 };
+    bench(latin, frames);
+
+    if (!cjkFontPath)
+        printf("no --cjk-font, the large range is the whole BMP of the Latin font\n");
+    Spec large = { "Large range", cjkFontPath ? &cjkFont : latin.font, cjkFontPath ? cjkRanges.Data : bmpRanges, { 16.0f, 20.0f }, 0, 0, 120 };
+    bench(large, frames);
+
+    // few small pages: glyphs get evicted and rasterized again. A page drawn in the frame can't be cleared,
+    // when the text of a frame needs more pages than there are, some of its glyphs are drawn blank.
+    Spec eviction = { "Eviction", large.font, large.ranges, { 16.0f }, 8, 64, 30 };
+    bench(eviction, frames);
+
+    printf(ok ? "ok\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
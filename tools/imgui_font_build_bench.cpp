@@ -0,0 +1,197 @@
+//--------------------------------------------------------------------------------------
+// Startup benchmark of the Dear ImGui font atlas build with stb_truetype, on the
+// calling thread and with ImFontAtlas::BuildParallelFor on the job system (1..N
+// threads). Every parallel build must give the same texture and glyph table as the
+// serial one. Two atlases: Latin only (default ranges at four sizes) and full CJK
+// (Chinese full + Japanese + Korean ranges at two sizes), which needs a font that has
+// them (e.g. NotoSansCJK, msyh.ttc); without one the CJK run only shows the cost of
+// the codepoint scan.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -pthread -I.. imgui_font_build_bench.cpp ../job_system.cpp ../profiler.cpp ../imgui.cpp ../imgui_draw.cpp ../imgui_widgets.cpp ../imgui_tables.cpp -o imgui_font_build_bench
+//
+// Usage:
+//   imgui_font_build_bench [--font file.ttf] [--cjk-font file.ttf] [--max-threads n] [--runs n]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "imgui.h"
+#include "job_system.h"
+
+static bool ok = true;
+
+static void check(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+}
+
+static std::vector<unsigned char> readFile(char const* path)
+{
+    std::vector<unsigned char> data;
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return data;
+    fseek(file, 0, SEEK_END);
+    data.resize(static_cast<size_t>(ftell(file)));
+    fseek(file, 0, SEEK_SET);
+    if (fread(data.data(), 1, data.size(), file) != data.size())
+        data.clear();
+    fclose(file);
+    return data;
+}
+
+// the same callback as Graphics::initGUI
+static void parallelFor(int count, void (*job)(int index, void* jobData), void* jobData, void* userData)
+{
+    static_cast<JobSystem*>(userData)->parallelFor(static_cast<uint32_t>(count), 1,
+        [job, jobData](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++)
+                job(static_cast<int>(i), jobData);
+        });
+}
+
+struct AtlasSpec
+{
+    char const* name;
+    std::vector<unsigned char> const* font;     // nullptr: the embedded ProggyClean
+    ImWchar const* ranges;
+    std::vector<float> sizes;
+};
+
+struct AtlasResult
+{
+    std::vector<unsigned char> pixels;
+    std::vector<ImFontGlyph> glyphs;
+    int width = 0, height = 0;
+    double ms = 0.0;
+};
+
+static void addFonts(ImFontAtlas& atlas, AtlasSpec const& spec)
+{
+    for (float size : spec.sizes)
+    {
+        ImFontConfig config;
+        config.SizePixels = size;
+        config.FontDataOwnedByAtlas = false;
+        if (spec.font)
+            atlas.AddFontFromMemoryTTF((void*)spec.font->data(), static_cast<int>(spec.font->size()), size, &config, spec.ranges);
+        else
+            atlas.AddFontDefault(&config);
+    }
+}
+
+static AtlasResult build(AtlasSpec const& spec, JobSystem* jobs)
+{
+    ImFontAtlas atlas;
+    addFonts(atlas, spec);
+    if (jobs)
+    {
+        atlas.BuildParallelFor = parallelFor;
+        atlas.BuildParallelForUserData = jobs;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    atlas.Build();
+    auto end = std::chrono::steady_clock::now();
+
+    AtlasResult result;
+    result.ms = std::chrono::duration<double, std::milli>(end - start).count();
+    result.width = atlas.TexWidth;
+    result.height = atlas.TexHeight;
+    result.pixels.assign(atlas.TexPixelsAlpha8, atlas.TexPixelsAlpha8 + atlas.TexWidth * atlas.TexHeight);
+    for (ImFont* font : atlas.Fonts)
+        result.glyphs.insert(result.glyphs.end(), font->Glyphs.begin(), font->Glyphs.end());
+    return result;
+}
+
+static bool sameAtlas(AtlasResult const& a, AtlasResult const& b)
+{
+    return a.width == b.width && a.height == b.height && a.pixels == b.pixels &&
+        a.glyphs.size() == b.glyphs.size() &&
+        memcmp(a.glyphs.data(), b.glyphs.data(), a.glyphs.size() * sizeof(ImFontGlyph)) == 0;
+}
+
+static void run(AtlasSpec const& spec, uint32_t maxThreads, int runs)
+{
+    // best of n, the first build also pages the font in
+    AtlasResult serial = build(spec, nullptr);
+    for (int i = 1; i < runs; i++)
+        serial.ms = std::min(serial.ms, build(spec, nullptr).ms);
+    printf("%s: %zu glyphs, %dx%d\n", spec.name, serial.glyphs.size(), serial.width, serial.height);
+    printf("  calling thread: %8.2f ms\n", serial.ms);
+
+    for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        JobSystem jobs(threads - 1);
+        AtlasResult parallel = build(spec, &jobs);
+        check(sameAtlas(serial, parallel), "parallel builds give the same atlas");
+        for (int i = 1; i < runs; i++)
+            parallel.ms = std::min(parallel.ms, build(spec, &jobs).ms);
+        printf("  %2u threads:     %8.2f ms\n", threads, parallel.ms);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    char const* fontPath = nullptr;
+    char const* cjkFontPath = nullptr;
+    uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    int runs = 3;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--font") && i + 1 < argc)
+            fontPath = argv[++i];
+        else if (!strcmp(argv[i], "--cjk-font") && i + 1 < argc)
+            cjkFontPath = argv[++i];
+        else if (!strcmp(argv[i], "--max-threads") && i + 1 < argc)
+            maxThreads = static_cast<uint32_t>(std::max(1, atoi(argv[++i])));
+        else if (!strcmp(argv[i], "--runs") && i + 1 < argc)
+            runs = std::max(1, atoi(argv[++i]));
+    }
+
+    std::vector<unsigned char> font, cjkFont;
+    if (fontPath && (font = readFile(fontPath)).empty())
+    {
+        printf("can't read %s\n", fontPath);
+        return 1;
+    }
+    if (cjkFontPath && (cjkFont = readFile(cjkFontPath)).empty())
+    {
+        printf("can't read %s\n", cjkFontPath);
+        return 1;
+    }
+
+    // ImFontAtlas allocates through the context allocator
+    ImGui::CreateContext();
+    ImFontAtlas defaultRanges;
+    ImFontGlyphRangesBuilder builder;
+    builder.AddRanges(defaultRanges.GetGlyphRangesChineseFull());
+    builder.AddRanges(defaultRanges.GetGlyphRangesJapanese());
+    builder.AddRanges(defaultRanges.GetGlyphRangesKorean());
+    ImVector<ImWchar> cjkRanges;
+    builder.BuildRanges(&cjkRanges);
+
+    AtlasSpec latin = { "Latin", fontPath ? &font : nullptr, defaultRanges.GetGlyphRangesDefault(), { 13.0f, 16.0f, 20.0f, 24.0f } };
+    run(latin, maxThreads, runs);
+
+    if (!cjkFontPath)
+        printf("no --cjk-font, the CJK ranges are looked up in the Latin font\n");
+    AtlasSpec cjk = { "CJK", cjkFontPath ? &cjkFont : latin.font, cjkRanges.Data, { 16.0f, 20.0f } };
+    run(cjk, maxThreads, runs);
+
+    ImGui::DestroyContext();
+    printf(ok ? "ok\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
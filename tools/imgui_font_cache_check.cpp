@@ -0,0 +1,466 @@
+//--------------------------------------------------------------------------------------
+// Checks and benchmark of the font atlas cache (imgui_font_cache). A loaded atlas must
+// match the built one field for field: pixels, UVs, custom rectangles, glyphs and
+// lookup tables. Any change of the build inputs must miss the cache, and every
+// damaged file (wrong magic or version, truncated, flipped bytes, a valid checksum
+// over inconsistent content) must be rejected without touching the atlas. Then times
+// Build() against a load.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -I.. imgui_font_cache_check.cpp ../imgui_font_cache.cpp ../imgui.cpp ../imgui_draw.cpp ../imgui_widgets.cpp ../imgui_tables.cpp -o imgui_font_cache_check
+//
+// Usage:
+//   imgui_font_cache_check [--font file.ttf] [--runs n]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+#include "imgui_font_cache.h"
+
+static bool ok = true;
+
+static void check(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+}
+
+static char const* const CacheFile = "imgui_font_cache_check.cache";
+
+static std::vector<unsigned char> readFile(char const* path)
+{
+    std::vector<unsigned char> data;
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return data;
+    fseek(file, 0, SEEK_END);
+    data.resize(static_cast<size_t>(ftell(file)));
+    fseek(file, 0, SEEK_SET);
+    if (fread(data.data(), 1, data.size(), file) != data.size())
+        data.clear();
+    fclose(file);
+    return data;
+}
+
+static void writeFile(char const* path, std::vector<unsigned char> const& data)
+{
+    FILE* file = fopen(path, "wb");
+    if (!data.empty())
+        fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+}
+
+// the inputs of one atlas, the fields the tests change
+struct AtlasInputs
+{
+    std::vector<unsigned char> const* font = nullptr;  // nullptr: the embedded ProggyClean
+    std::vector<float> sizes = { 13.0f, 20.0f };
+    int oversampleH = 3;
+    ImWchar const* ranges = nullptr;
+    bool merge = true;
+    ImFontAtlasFlags flags = 0;
+    int padding = 1;
+    float multiply = 1.0f;
+    int customGlyphs = 1;
+    bool colors = false;
+};
+
+static ImWchar const MergeRanges[] = { 0x20, 0x7F, 0 };
+static ImWchar const LatinRanges[] = { 0x20, 0x7F, 0xA0, 0xFF, 0 };
+
+static void addFont(ImFontAtlas& atlas, AtlasInputs const& in, ImFontConfig& config, ImWchar const* ranges)
+{
+    config.FontDataOwnedByAtlas = false;
+    if (in.font)
+    {
+        atlas.AddFontFromMemoryTTF((void*)in.font->data(), static_cast<int>(in.font->size()), config.SizePixels, &config, ranges);
+    }
+    else
+    {
+        config.GlyphRanges = ranges;
+        atlas.AddFontDefault(&config);
+    }
+}
+
+static void addFonts(ImFontAtlas& atlas, AtlasInputs const& in)
+{
+    atlas.Flags = in.flags;
+    atlas.TexGlyphPadding = in.padding;
+    for (float size : in.sizes)
+    {
+        ImFontConfig config;
+        config.SizePixels = size;
+        config.OversampleH = in.oversampleH;
+        config.RasterizerMultiply = in.multiply;
+        addFont(atlas, in, config, in.ranges);
+    }
+    if (in.merge)
+    {
+        // into the last font, a pixel lower
+        ImFontConfig config;
+        config.SizePixels = 16.0f;
+        config.MergeMode = true;
+        config.GlyphOffset = ImVec2(0.0f, 1.0f);
+        config.OversampleH = 1;
+        addFont(atlas, in, config, MergeRanges);
+    }
+    for (int i = 0; i < in.customGlyphs; i++)
+        atlas.AddCustomRectFontGlyph(atlas.Fonts[0], static_cast<ImWchar>(0xE000 + i), 13, 13, 14.0f, ImVec2(0.0f, 1.0f));
+}
+
+// what an application does after Build(): draw its custom glyphs
+static void drawCustomGlyphs(ImFontAtlas& atlas, AtlasInputs const& in)
+{
+    for (int rect = 0; rect < atlas.CustomRects.Size; rect++)
+    {
+        ImFontAtlasCustomRect const* r = atlas.GetCustomRectByIndex(rect);
+        if (r->GlyphID == 0)
+            continue;
+        for (int y = 0; y < r->Height; y++)
+            for (int x = 0; x < r->Width; x++)
+            {
+                int pixel = (r->Y + y) * atlas.TexWidth + r->X + x;
+                if (in.colors)
+                    atlas.TexPixelsRGBA32[pixel] = IM_COL32(x * 19, y * 19, 200, 255);
+                else
+                    atlas.TexPixelsAlpha8[pixel] = static_cast<unsigned char>((x ^ y) * 17);
+            }
+    }
+    if (in.colors)
+        atlas.TexPixelsUseColors = true;
+}
+
+static void buildAtlas(ImFontAtlas& atlas, AtlasInputs const& in)
+{
+    addFonts(atlas, in);
+    atlas.Build();
+    if (in.colors)
+    {
+        unsigned char* pixels;
+        int width, height;
+        atlas.GetTexDataAsRGBA32(&pixels, &width, &height);
+    }
+    drawCustomGlyphs(atlas, in);
+}
+
+static bool sameGlyph(ImFontGlyph const& a, ImFontGlyph const& b)
+{
+    return a.Codepoint == b.Codepoint && a.Visible == b.Visible && a.Colored == b.Colored && a.AdvanceX == b.AdvanceX &&
+        a.X0 == b.X0 && a.Y0 == b.Y0 && a.X1 == b.X1 && a.Y1 == b.Y1 &&
+        a.U0 == b.U0 && a.V0 == b.V0 && a.U1 == b.U1 && a.V1 == b.V1;
+}
+
+template<typename T>
+static bool sameVector(ImVector<T> const& a, ImVector<T> const& b)
+{
+    return a.Size == b.Size && (a.Size == 0 || memcmp(a.Data, b.Data, a.size_in_bytes()) == 0);
+}
+
+static bool sameAtlas(ImFontAtlas& built, ImFontAtlas& loaded)
+{
+    size_t pixels = static_cast<size_t>(built.TexWidth) * built.TexHeight;
+    if (built.TexWidth != loaded.TexWidth || built.TexHeight != loaded.TexHeight || !loaded.IsBuilt() ||
+        built.TexUvScale.x != loaded.TexUvScale.x || built.TexUvScale.y != loaded.TexUvScale.y ||
+        built.TexUvWhitePixel.x != loaded.TexUvWhitePixel.x || built.TexUvWhitePixel.y != loaded.TexUvWhitePixel.y ||
+        memcmp(built.TexUvLines, loaded.TexUvLines, sizeof(built.TexUvLines)) != 0 ||
+        built.TexPixelsUseColors != loaded.TexPixelsUseColors)
+        return false;
+    if (!built.TexPixelsUseColors && (!loaded.TexPixelsAlpha8 || memcmp(built.TexPixelsAlpha8, loaded.TexPixelsAlpha8, pixels) != 0))
+        return false;
+    if (built.TexPixelsUseColors && (!loaded.TexPixelsRGBA32 || memcmp(built.TexPixelsRGBA32, loaded.TexPixelsRGBA32, pixels * 4) != 0))
+        return false;
+    if (built.CustomRects.Size != loaded.CustomRects.Size || built.Fonts.Size != loaded.Fonts.Size)
+        return false;
+    for (int i = 0; i < built.CustomRects.Size; i++)
+        if (built.CustomRects[i].X != loaded.CustomRects[i].X || built.CustomRects[i].Y != loaded.CustomRects[i].Y)
+            return false;
+    for (int i = 0; i < built.Fonts.Size; i++)
+    {
+        ImFont const* a = built.Fonts[i];
+        ImFont const* b = loaded.Fonts[i];
+        if (a->FontSize != b->FontSize || a->Ascent != b->Ascent || a->Descent != b->Descent ||
+            a->ConfigData - built.ConfigData.Data != b->ConfigData - loaded.ConfigData.Data || a->ConfigDataCount != b->ConfigDataCount ||
+            a->MetricsTotalSurface != b->MetricsTotalSurface || a->ContainerAtlas != &built || b->ContainerAtlas != &loaded ||
+            a->FallbackChar != b->FallbackChar || a->EllipsisChar != b->EllipsisChar || a->DotChar != b->DotChar ||
+            a->FallbackAdvanceX != b->FallbackAdvanceX || a->FallbackGlyph - a->Glyphs.Data != b->FallbackGlyph - b->Glyphs.Data ||
+            a->DirtyLookupTables != b->DirtyLookupTables || memcmp(a->Used4kPagesMap, b->Used4kPagesMap, sizeof(a->Used4kPagesMap)) != 0 ||
+            !sameVector(a->IndexAdvanceX, b->IndexAdvanceX) || !sameVector(a->IndexLookup, b->IndexLookup) || a->Glyphs.Size != b->Glyphs.Size)
+            return false;
+        for (int g = 0; g < a->Glyphs.Size; g++)
+            if (!sameGlyph(a->Glyphs[g], b->Glyphs[g]))
+                return false;
+    }
+    return true;
+}
+
+static ImFontAtlasCacheResult load(AtlasInputs const& in, ImFontAtlas& atlas)
+{
+    addFonts(atlas, in);
+    return ImFontAtlasCache_Load(&atlas, CacheFile);
+}
+
+static void checkResult(ImFontAtlasCacheResult result, ImFontAtlasCacheResult expected, char const* what)
+{
+    if (result != expected)
+        printf("  %s: %s, expected %s\n", what, ImFontAtlasCache_GetResultName(result), ImFontAtlasCache_GetResultName(expected));
+    check(result == expected, what);
+}
+
+static void checkRoundTrip(AtlasInputs const& in, char const* what)
+{
+    ImFontAtlas built;
+    buildAtlas(built, in);
+    check(ImFontAtlasCache_Save(&built, CacheFile), "the cache is written");
+
+    ImFontAtlas loaded;
+    checkResult(load(in, loaded), ImFontAtlasCacheResult_Loaded, what);
+    check(sameAtlas(built, loaded), what);
+
+    // a second save of the loaded atlas gives the same file
+    std::vector<unsigned char> first = readFile(CacheFile);
+    check(ImFontAtlasCache_Save(&loaded, CacheFile), "the loaded atlas is written");
+    check(readFile(CacheFile) == first, "a loaded atlas saves the same file");
+}
+
+// every input Build() reads is part of the key
+static void checkKey(AtlasInputs const& base, std::vector<unsigned char> const& fontCopy)
+{
+    ImFontAtlas built;
+    buildAtlas(built, base);
+    ImFontAtlasCache_Save(&built, CacheFile);
+
+    struct Change { char const* name; std::function<void(AtlasInputs&)> apply; };
+    std::vector<Change> changes = {
+        { "size", [](AtlasInputs& in) { in.sizes[1] = 21.0f; } },
+        { "font count", [](AtlasInputs& in) { in.sizes.push_back(24.0f); } },
+        { "oversampling", [](AtlasInputs& in) { in.oversampleH = 2; } },
+        { "glyph ranges", [](AtlasInputs& in) { in.ranges = LatinRanges; } },
+        { "merged font", [](AtlasInputs& in) { in.merge = false; } },
+        { "atlas flags", [](AtlasInputs& in) { in.flags = ImFontAtlasFlags_NoBakedLines; } },
+        { "glyph padding", [](AtlasInputs& in) { in.padding = 2; } },
+        { "rasterizer multiply", [](AtlasInputs& in) { in.multiply = 1.2f; } },
+        { "custom rectangles", [](AtlasInputs& in) { in.customGlyphs = 2; } },
+        { "font data", [&fontCopy](AtlasInputs& in) { in.font = &fontCopy; } },
+    };
+    for (Change const& change : changes)
+    {
+        AtlasInputs in = base;
+        change.apply(in);
+        ImFontAtlas atlas;
+        ImFontAtlasCacheResult result = load(in, atlas);
+        checkResult(result, ImFontAtlasCacheResult_KeyMismatch, change.name);
+        check(!atlas.IsBuilt() && atlas.TexPixelsAlpha8 == nullptr, "a missed cache leaves the atlas alone");
+    }
+}
+
+static uint32_t headerField(std::vector<unsigned char> const& file, size_t offset)
+{
+    uint32_t value;
+    memcpy(&value, file.data() + offset, 4);
+    return value;
+}
+
+static void setHeaderField(std::vector<unsigned char>& file, size_t offset, uint32_t value)
+{
+    memcpy(file.data() + offset, &value, 4);
+}
+
+// header: magic[8], version, key size, payload size, payload hash
+static const size_t VersionOffset = 8, KeySizeOffset = 12, PayloadSizeOffset = 16, PayloadHashOffset = 20, HeaderSize = 24;
+
+static void rehash(std::vector<unsigned char>& file)
+{
+    size_t payload = HeaderSize + headerField(file, KeySizeOffset);
+    setHeaderField(file, PayloadSizeOffset, static_cast<uint32_t>(file.size() - payload));
+    setHeaderField(file, PayloadHashOffset, ImHashData(file.data() + payload, file.size() - payload));
+}
+
+static ImFontAtlasCacheResult loadFile(AtlasInputs const& in, std::vector<unsigned char> const& file)
+{
+    writeFile(CacheFile, file);
+    ImFontAtlas atlas;
+    ImFontAtlasCacheResult result = load(in, atlas);
+    check(result == ImFontAtlasCacheResult_Loaded || (!atlas.IsBuilt() && atlas.TexPixelsAlpha8 == nullptr), "a rejected file leaves the atlas alone");
+    return result;
+}
+
+static void checkDamage(AtlasInputs const& in)
+{
+    ImFontAtlas built;
+    buildAtlas(built, in);
+    ImFontAtlasCache_Save(&built, CacheFile);
+    std::vector<unsigned char> const good = readFile(CacheFile);
+    size_t const payload = HeaderSize + headerField(good, KeySizeOffset);
+    checkResult(loadFile(in, good), ImFontAtlasCacheResult_Loaded, "the file as written");
+
+    remove(CacheFile);
+    ImFontAtlas missing;
+    checkResult(load(in, missing), ImFontAtlasCacheResult_NoFile, "no file");
+
+    std::vector<unsigned char> file = good;
+    file[0] = 'X';
+    checkResult(loadFile(in, file), ImFontAtlasCacheResult_BadHeader, "magic");
+
+    file = good;
+    setHeaderField(file, VersionOffset, IMGUI_FONT_ATLAS_CACHE_VERSION + 1);
+    checkResult(loadFile(in, file), ImFontAtlasCacheResult_OldVersion, "version");
+
+    // every truncation
+    int accepted = 0;
+    for (size_t size = 0; size < good.size(); size += std::max<size_t>(1, size < 64 ? 1 : good.size() / 997))
+        if (loadFile(in, std::vector<unsigned char>(good.begin(), good.begin() + size)) == ImFontAtlasCacheResult_Loaded)
+            accepted++;
+    check(accepted == 0, "truncated files are rejected");
+
+    // flipped bytes: in the key they miss, in the payload the checksum catches them
+    std::mt19937 random(7);
+    accepted = 0;
+    for (int i = 0; i < 300; i++)
+    {
+        file = good;
+        size_t at = HeaderSize + random() % (good.size() - HeaderSize);
+        file[at] ^= static_cast<unsigned char>(1 + random() % 255);
+        ImFontAtlasCacheResult result = loadFile(in, file);
+        if (result == ImFontAtlasCacheResult_Loaded || result != (at < payload ? ImFontAtlasCacheResult_KeyMismatch : ImFontAtlasCacheResult_Corrupt))
+            accepted++;
+    }
+    check(accepted == 0, "flipped bytes are rejected");
+
+    // a valid checksum over content that doesn't add up
+    struct Edit { char const* name; std::function<void(std::vector<unsigned char>&)> apply; };
+    std::vector<Edit> edits = {
+        { "zero texture width", [payload](std::vector<unsigned char>& f) { memset(&f[payload], 0, 4); } },
+        { "huge texture height", [payload](std::vector<unsigned char>& f) { setHeaderField(f, payload + 4, 1u << 20); } },
+        { "texture twice as wide", [payload](std::vector<unsigned char>& f) { setHeaderField(f, payload, headerField(f, payload) * 2); } },
+        { "no pixel format", [payload](std::vector<unsigned char>& f) { f[payload + 9] = 0; f[payload + 10] = 0; } },
+        { "trailing byte", [](std::vector<unsigned char>& f) { f.push_back(0); } },
+        { "missing pixels", [](std::vector<unsigned char>& f) { f.resize(f.size() - 16); } },
+    };
+    for (Edit const& edit : edits)
+    {
+        file = good;
+        edit.apply(file);
+        rehash(file);
+        checkResult(loadFile(in, file), ImFontAtlasCacheResult_Corrupt, edit.name);
+    }
+
+    // the first glyph of the first font: its codepoint out of range, then an absurd glyph count before it
+    size_t rects = payload + 4 + 4 + 3 + sizeof(ImVec2) + 4 + sizeof(built.TexUvLines);
+    size_t font = rects + 4 * built.CustomRects.Size;
+    size_t glyphCount = font + 6 * 4;
+    file = good;
+    setHeaderField(file, glyphCount + 4, 0x3FFFFFFF);
+    rehash(file);
+    checkResult(loadFile(in, file), ImFontAtlasCacheResult_Corrupt, "codepoint out of range");
+    file = good;
+    check(static_cast<int>(headerField(file, glyphCount)) == built.Fonts[0]->Glyphs.Size, "glyph count where expected");
+    setHeaderField(file, glyphCount, 0x7FFFFFFF);
+    rehash(file);
+    checkResult(loadFile(in, file), ImFontAtlasCacheResult_Corrupt, "glyph count");
+}
+
+static double msSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void benchmark(AtlasInputs const& in, int runs)
+{
+    double buildMs = 1e9, loadMs = 1e9;
+    size_t glyphs = 0;
+    int width = 0, height = 0;
+    for (int i = 0; i < runs; i++)
+    {
+        ImFontAtlas atlas;
+        addFonts(atlas, in);
+        auto start = std::chrono::steady_clock::now();
+        atlas.Build();
+        buildMs = std::min(buildMs, msSince(start));
+        ImFontAtlasCache_Save(&atlas, CacheFile);
+        glyphs = 0;
+        for (ImFont* font : atlas.Fonts)
+            glyphs += font->Glyphs.Size;
+        width = atlas.TexWidth;
+        height = atlas.TexHeight;
+    }
+    for (int i = 0; i < runs; i++)
+    {
+        ImFontAtlas atlas;
+        addFonts(atlas, in);
+        auto start = std::chrono::steady_clock::now();
+        bool loaded = ImFontAtlasCache_Load(&atlas, CacheFile) == ImFontAtlasCacheResult_Loaded;
+        loadMs = std::min(loadMs, msSince(start));
+        check(loaded, "the benchmark atlas loads");
+    }
+    printf("%zu glyphs, %dx%d, %zu KB cache: Build() %.2f ms, load %.2f ms\n",
+        glyphs, width, height, readFile(CacheFile).size() >> 10, buildMs, loadMs);
+}
+
+int main(int argc, char** argv)
+{
+    char const* fontPath = nullptr;
+    int runs = 5;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--font") && i + 1 < argc)
+            fontPath = argv[++i];
+        else if (!strcmp(argv[i], "--runs") && i + 1 < argc)
+            runs = std::max(1, atoi(argv[++i]));
+    }
+    std::vector<unsigned char> font;
+    if (fontPath && (font = readFile(fontPath)).empty())
+    {
+        printf("can't read %s\n", fontPath);
+        return 1;
+    }
+
+    ImGui::CreateContext();
+
+    AtlasInputs base;
+    base.font = fontPath ? &font : nullptr;
+    checkRoundTrip(base, "round trip");
+    AtlasInputs colors = base;
+    colors.colors = true;
+    checkRoundTrip(colors, "round trip with colored custom glyphs");
+    AtlasInputs plain = base;
+    plain.merge = false;
+    plain.customGlyphs = 0;
+    plain.flags = ImFontAtlasFlags_NoMouseCursors | ImFontAtlasFlags_NoBakedLines;
+    checkRoundTrip(plain, "round trip without cursors, lines or custom glyphs");
+
+    // the same font in another buffer with one byte changed
+    std::vector<unsigned char> fontCopy;
+    if (base.font)
+        fontCopy = font;
+    else
+    {
+        ImFontAtlas atlas;
+        atlas.AddFontDefault();
+        fontCopy.assign((unsigned char*)atlas.ConfigData[0].FontData, (unsigned char*)atlas.ConfigData[0].FontData + atlas.ConfigData[0].FontDataSize);
+    }
+    fontCopy[fontCopy.size() / 2] ^= 1;
+    checkKey(base, fontCopy);
+    checkDamage(base);
+
+    AtlasInputs big = base;
+    big.sizes = { 13.0f, 16.0f, 20.0f, 24.0f, 32.0f, 48.0f };
+    benchmark(big, runs);
+
+    remove(CacheFile);
+    ImGui::DestroyContext();
+    printf(ok ? "ok\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
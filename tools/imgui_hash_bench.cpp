@@ -0,0 +1,287 @@
+//--------------------------------------------------------------------------------------
+// Checks and benchmark of the Dear ImGui ID hash. ImHashStr/ImHashData are compared
+// bit for bit against the original byte-at-a-time CRC32 on random data with every
+// length, alignment and seed, '#' and '###' included. The benchmark hashes the IDs
+// a widget-heavy window submits every frame with both versions, and times whole
+// frames of that window for context.
+//
+// Build (Linux), default slicing-by-8 backend:
+//   g++ -std=c++17 -O2 -I.. imgui_hash_bench.cpp ../imgui.cpp ../imgui_draw.cpp ../imgui_widgets.cpp ../imgui_tables.cpp -o imgui_hash_bench
+// SSE4.2 CRC32C backend, checked against a software CRC32C instead:
+//   g++ -std=c++17 -O2 -msse4.2 -DIMGUI_USE_CRC32C_HASH -I.. imgui_hash_bench.cpp ../imgui.cpp ../imgui_draw.cpp ../imgui_widgets.cpp ../imgui_tables.cpp -o imgui_hash_bench_crc32c
+//
+// Usage:
+//   imgui_hash_bench [--widgets n] [--frames n]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+
+static bool ok = true;
+
+static void check(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+}
+
+// the hash as it was before the backends, on the polynomial of the selected backend
+#ifdef IMGUI_USE_CRC32C_HASH
+static const uint32_t Polynomial = 0x82F63B78;
+static const uint32_t CheckValue = 0xE3069283;
+#else
+static const uint32_t Polynomial = 0xEDB88320;
+static const uint32_t CheckValue = 0xCBF43926;
+#endif
+
+static uint32_t referenceTable[256];
+
+static void initReference()
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (crc & 1 ? Polynomial : 0);
+        referenceTable[i] = crc;
+    }
+}
+
+static ImGuiID referenceHashData(const void* data_p, size_t data_size, ImU32 seed)
+{
+    ImU32 crc = ~seed;
+    const unsigned char* data = (const unsigned char*)data_p;
+    while (data_size-- != 0)
+        crc = (crc >> 8) ^ referenceTable[(crc & 0xFF) ^ *data++];
+    return ~crc;
+}
+
+static ImGuiID referenceHashStr(const char* data_p, size_t data_size, ImU32 seed)
+{
+    seed = ~seed;
+    ImU32 crc = seed;
+    const unsigned char* data = (const unsigned char*)data_p;
+    if (data_size != 0)
+    {
+        while (data_size-- != 0)
+        {
+            unsigned char c = *data++;
+            if (c == '#' && data_size >= 2 && data[0] == '#' && data[1] == '#')
+                crc = seed;
+            crc = (crc >> 8) ^ referenceTable[(crc & 0xFF) ^ c];
+        }
+    }
+    else
+    {
+        while (unsigned char c = *data++)
+        {
+            if (c == '#' && data[0] == '#' && data[1] == '#')
+                crc = seed;
+            crc = (crc >> 8) ^ referenceTable[(crc & 0xFF) ^ c];
+        }
+    }
+    return ~crc;
+}
+
+static void checkHashes()
+{
+    check(ImHashData("123456789", 9, 0) == CheckValue, "check value of the polynomial");
+    check(ImHashStr("123456789") == CheckValue, "string check value");
+    check(ImHashStr("Label###id") == ImHashStr("###id"), "### resets to the seed");
+    check(ImHashStr("A long label past a block###id", 0, 77) == ImHashStr("###id", 0, 77), "### past the first block");
+    check(ImHashStr("Label##id") != ImHashStr("##id"), "## doesn't reset");
+    check(ImHashStr("a###b###c") == ImHashStr("###c"), "the last ### wins");
+
+    std::mt19937 rng(41);
+    // '#' often enough to land runs of two and three on block boundaries
+    static const char alphabet[] = "##########abcdefghijklmnopqrstuvwxyz0123456789 _/";
+    std::uniform_int_distribution<size_t> letter(0, sizeof(alphabet) - 2);
+    std::uniform_int_distribution<uint32_t> seed;
+    std::uniform_int_distribution<int> byte(1, 255);
+
+    // aligned and misaligned starts
+    std::vector<char> buffer(256 + 8);
+    bool sameData = true, sameSized = true, sameTerminated = true;
+    for (int round = 0; round < 20000; round++)
+    {
+        size_t length = round % 130;
+        size_t offset = round % 8;
+        char* text = buffer.data() + offset;
+        bool binary = round % 5 == 0;
+        for (size_t i = 0; i < length; i++)
+            text[i] = binary ? (char)byte(rng) : alphabet[letter(rng)];
+        text[length] = 0;
+        ImU32 s = round % 3 == 0 ? 0 : seed(rng);
+
+        sameData &= ImHashData(text, length, s) == referenceHashData(text, length, s);
+        if (length != 0)
+            sameSized &= ImHashStr(text, length, s) == referenceHashStr(text, length, s);
+        sameTerminated &= ImHashStr(text, 0, s) == referenceHashStr(text, 0, s);
+    }
+    check(sameData, "ImHashData matches the reference");
+    check(sameSized, "ImHashStr with a size matches the reference");
+    check(sameTerminated, "zero-terminated ImHashStr matches the reference");
+}
+
+// the IDs one frame of the bench window hashes: labels, and an int per PushID block of 16 widgets
+struct FrameIds
+{
+    std::vector<std::string> labels;
+    std::vector<int> ints;
+};
+
+static const char* const kinds[] = { "Button", "Checkbox", "Slider", "Drag", "Input" };
+
+static FrameIds frameIds(int widgets)
+{
+    FrameIds ids;
+    for (int i = 0; i < widgets; i++)
+    {
+        if (i % 16 == 0)
+            ids.ints.push_back(i / 16);
+        char label[64];
+        if (i % 7 == 0)
+            snprintf(label, sizeof(label), "%s %d###%s%d", kinds[i % 5], i, kinds[i % 5], i);
+        else
+            snprintf(label, sizeof(label), "%s %d##widget", kinds[i % 5], i);
+        ids.labels.push_back(label);
+    }
+    return ids;
+}
+
+static void widgetWindow(FrameIds const& ids, bool* flags, float* values)
+{
+    ImGui::SetNextWindowPos(ImVec2(0, 0));
+    ImGui::SetNextWindowSize(ImVec2(1280, 720));
+    ImGui::Begin("Widgets");
+    for (size_t i = 0; i < ids.labels.size(); i++)
+    {
+        if (i % 16 == 0)
+            ImGui::PushID(ids.ints[i / 16]);
+        auto label = ids.labels[i].c_str();
+        switch (i % 5)
+        {
+        case 0: ImGui::Button(label); break;
+        case 1: ImGui::Checkbox(label, &flags[i]); break;
+        case 2: ImGui::SliderFloat(label, &values[i], 0.0f, 1.0f); break;
+        case 3: ImGui::DragFloat(label, &values[i]); break;
+        case 4: ImGui::InputFloat(label, &values[i]); break;
+        }
+        if (i % 16 == 15 || i + 1 == ids.labels.size())
+            ImGui::PopID();
+    }
+    ImGui::End();
+}
+
+using Clock = std::chrono::steady_clock;
+
+// keeps the hashes from being optimized out
+static volatile ImU32 hashSink;
+
+static double elapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// best of runs, in ms for one frame's worth of IDs
+template<typename StrHash, typename DataHash>
+static double hashFrame(FrameIds const& ids, int runs, StrHash str, DataHash data, ImU32& sink)
+{
+    double best = 1e30;
+    for (int r = 0; r < runs; r++)
+    {
+        auto start = Clock::now();
+        for (int repeat = 0; repeat < 100; repeat++)
+        {
+            ImU32 seed = 0x1234;
+            for (size_t i = 0; i < ids.labels.size(); i++)
+            {
+                if (i % 16 == 0)
+                    seed = data(&ids.ints[i / 16], sizeof(int), 0x1234);
+                sink ^= str(ids.labels[i].c_str(), 0, seed);
+            }
+        }
+        best = std::min(best, elapsedMs(start) / 100);
+    }
+    return best;
+}
+
+int main(int argc, char* argv[])
+{
+    int widgets = 2000;
+    int frames = 200;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--widgets") && i + 1 < argc)
+            widgets = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--frames") && i + 1 < argc)
+            frames = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [--widgets n] [--frames n]\n", argv[0]);
+            return 1;
+        }
+    }
+    widgets = std::max(widgets, 1);
+    frames = std::max(frames, 1);
+
+    initReference();
+    checkHashes();
+
+#ifdef IMGUI_USE_CRC32C_HASH
+    printf("backend: CRC32C (SSE4.2)\n");
+#else
+    printf("backend: CRC32 slicing-by-8\n");
+#endif
+
+    auto ids = frameIds(widgets);
+    size_t idCount = ids.labels.size() + ids.ints.size();
+    ImU32 sink = 0;
+    auto before = hashFrame(ids, 20, referenceHashStr, referenceHashData, sink);
+    auto after = hashFrame(ids, 20, ImHashStr, ImHashData, sink);
+    printf("%zu IDs per frame: byte-at-a-time %.1f us, now %.1f us (%.2fx), %.1f -> %.1f ns per ID\n",
+        idCount, before * 1000, after * 1000, before / after, before * 1e6 / idCount, after * 1e6 / idCount);
+
+    // the same IDs through the real widgets
+    ImGui::CreateContext();
+    auto& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.DisplaySize = ImVec2(1280, 720);
+    io.DeltaTime = 1.0f / 60.0f;
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    std::vector<char> flagStorage(ids.labels.size());
+    std::vector<float> values(ids.labels.size());
+    auto flags = reinterpret_cast<bool*>(flagStorage.data());
+    double best = 1e30;
+    for (int f = 0; f < frames; f++)
+    {
+        auto start = Clock::now();
+        ImGui::NewFrame();
+        widgetWindow(ids, flags, values.data());
+        ImGui::Render();
+        best = std::min(best, elapsedMs(start));
+    }
+    ImGui::DestroyContext();
+    printf("%d widgets: best frame %.3f ms, ID hashing was %.1f%% of it and is %.1f%% now\n",
+        widgets, best, 100 * before / best, 100 * after / best);
+
+    printf(ok ? "ok\n" : "failed\n");
+    hashSink = sink;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,395 @@
+//--------------------------------------------------------------------------------------
+// Headless benchmark and checks of ImGui::InputTextMultiline() on large buffers. A
+// generated shader/log like text (default 10 MB, ~1.5% multi-byte UTF-8) is edited
+// through io events the way a user would: click to focus, type at the end, middle and
+// start, Enter, Backspace, arrows, page down, clicks, typing over a selection + undo. Reports the CPU
+// time of the frame that handles each keystroke, and of an idle frame while focused.
+// After every step the buffer is compared with a std::string model of the same edits
+// and the cursor reported by a CallbackAlways with where the model puts it. Also checks
+// that a focused widget only submits the visible lines (vertex count), and that the
+// text it draws is the same as when it is not focused.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -I.. imgui_input_text_bench.cpp ../imgui.cpp ../imgui_draw.cpp ../imgui_widgets.cpp ../imgui_tables.cpp -o imgui_input_text_bench
+//
+// Usage:
+//   imgui_input_text_bench [--size mb] [--keys n]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#define IMGUI_DEFINE_MATH_OPERATORS
+#include "imgui.h"
+#include "imgui_internal.h"
+
+static bool ok = true;
+
+static void check(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+}
+
+// Lines of HLSL-ish code and log output, some of them with accents or box drawing characters
+static std::string makeText(size_t size)
+{
+    static char const* const words[] = { "float4", "output", "=", "mul(", "worldViewProj,", "input.position);", "return", "saturate(", "dot(n,", "l));",
+        "[info]", "frame", "1234", "took", "16.6ms", "texture", "streamed", "mip", "#include", "\"common.hlsli\"", "{", "}", "//", "TODO" };
+    static char const* const extra[] = { "\xC3\xA9t\xC3\xA9", "\xE2\x94\x80\xE2\x94\x80", "gr\xC3\xBC\xC3\x9F" };
+    std::mt19937 rng(1234);
+    std::string text;
+    text.reserve(size + 128);
+    while (text.size() < size)
+    {
+        int const indent = static_cast<int>(rng() % 4);
+        text.append(static_cast<size_t>(indent) * 4, ' ');
+        int const count = static_cast<int>(rng() % 12);
+        for (int i = 0; i < count; i++)
+        {
+            text += (rng() % 64 == 0) ? extra[rng() % 3] : words[rng() % (sizeof(words) / sizeof(words[0]))];
+            if (i + 1 < count)
+                text += ' ';
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+//--------------------------------------------------------------------------------------
+// The widget, driven through io events
+//--------------------------------------------------------------------------------------
+
+struct Editor
+{
+    std::string text;
+    int cursor = -1;                // UTF-8 cursor and selection from the CallbackAlways
+    int selectionStart = -1;
+    int selectionEnd = -1;
+    ImRect rect;                    // frame of the widget
+    bool active = false;
+};
+
+static int inputTextCallback(ImGuiInputTextCallbackData* data)
+{
+    Editor* editor = static_cast<Editor*>(data->UserData);
+    if (data->EventFlag == ImGuiInputTextFlags_CallbackResize)
+    {
+        editor->text.resize(static_cast<size_t>(data->BufTextLen));
+        data->Buf = &editor->text[0];
+    }
+    else
+    {
+        editor->cursor = data->CursorPos;
+        editor->selectionStart = data->SelectionStart;
+        editor->selectionEnd = data->SelectionEnd;
+    }
+    return 0;
+}
+
+// Builds and renders one frame, returns its CPU time in ms
+static double frame(Editor& editor)
+{
+    auto const start = std::chrono::steady_clock::now();
+    ImGui::NewFrame();
+    ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiCond_Always);
+    ImGui::SetNextWindowSize(ImVec2(1280, 720), ImGuiCond_Always);
+    ImGui::Begin("Editor", nullptr, ImGuiWindowFlags_NoDecoration);
+    // std::string keeps a terminator after size(), so the capacity we hand out is size() + 1
+    ImGui::InputTextMultiline("##text", &editor.text[0], editor.text.size() + 1, ImVec2(-FLT_MIN, -FLT_MIN),
+        ImGuiInputTextFlags_CallbackResize | ImGuiInputTextFlags_CallbackAlways | ImGuiInputTextFlags_AllowTabInput, inputTextCallback, &editor);
+    editor.rect = ImRect(ImGui::GetItemRectMin(), ImGui::GetItemRectMax());
+    editor.active = ImGui::IsItemActive();
+    ImGui::End();
+    ImGui::Render();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+enum Mods { None = 0, Ctrl = 1, Shift = 2 };
+
+static void setMods(int mods, bool down)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    if (mods & Ctrl)
+        io.AddKeyEvent(ImGuiKey_ModCtrl, down);
+    if (mods & Shift)
+        io.AddKeyEvent(ImGuiKey_ModShift, down);
+}
+
+// Press and release a key, returns the time of the frame handling the press
+static double key(Editor& editor, ImGuiKey k, int mods = None)
+{
+    setMods(mods, true);
+    ImGui::GetIO().AddKeyEvent(k, true);
+    double const ms = frame(editor);
+    setMods(mods, false);
+    ImGui::GetIO().AddKeyEvent(k, false);
+    frame(editor);
+    return ms;
+}
+
+static double type(Editor& editor, unsigned int c)
+{
+    ImGui::GetIO().AddInputCharacter(c);
+    return frame(editor);
+}
+
+static double click(Editor& editor, ImVec2 pos)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.AddMousePosEvent(pos.x, pos.y);
+    io.AddMouseButtonEvent(0, true);
+    double const ms = frame(editor);
+    io.AddMouseButtonEvent(0, false);
+    frame(editor);
+    // Far enough in time that the next click isn't a double click
+    io.AddMousePosEvent(-FLT_MAX, -FLT_MAX);
+    for (int i = 0; i < 30; i++)
+        frame(editor);
+    return ms;
+}
+
+static size_t lineStart(std::string const& text, size_t pos)
+{
+    while (pos > 0 && text[pos - 1] != '\n')
+        pos--;
+    return pos;
+}
+
+static size_t lineOf(std::string const& text, size_t pos)
+{
+    return static_cast<size_t>(std::count(text.begin(), text.begin() + static_cast<std::ptrdiff_t>(pos), '\n'));
+}
+
+// The draw list of the child window InputTextMultiline() draws its text into
+static ImDrawList const* textDrawList()
+{
+    ImDrawData const* data = ImGui::GetDrawData();
+    for (int i = 0; i < data->CmdListsCount; i++)
+        if (strstr(data->CmdLists[i]->_OwnerName, "##text"))
+            return data->CmdLists[i];
+    return nullptr;
+}
+
+//--------------------------------------------------------------------------------------
+
+struct Timing
+{
+    char const* what;
+    double total = 0.0, worst = 0.0;
+    int count = 0;
+    void add(double ms) { total += ms; worst = std::max(worst, ms); count++; }
+    void print() const { printf("  %-28s %8.2f ms avg %8.2f ms worst (%d)\n", what, count ? total / count : 0.0, worst, count); }
+};
+
+int main(int argc, char** argv)
+{
+    double sizeMB = 10.0;
+    int keys = 20;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--size") && i + 1 < argc)
+            sizeMB = std::max(0.001, atof(argv[++i]));
+        else if (!strcmp(argv[i], "--keys") && i + 1 < argc)
+            keys = std::max(1, atoi(argv[++i]));
+    }
+
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.DisplaySize = ImVec2(1280, 720);
+    io.DeltaTime = 1.0f / 60.0f;
+    io.ConfigInputTrickleEventQueue = false;
+    io.Fonts->AddFontDefault();
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    io.AddMousePosEvent(-FLT_MAX, -FLT_MAX);
+
+    Editor editor;
+    editor.text = makeText(static_cast<size_t>(sizeMB * 1024 * 1024));
+    std::string model = editor.text;
+    size_t modelCursor = 0;
+    size_t const lines = lineOf(model, model.size());
+    printf("%.1f MB, %zu lines\n", model.size() / (1024.0 * 1024.0), lines);
+
+    Timing tFocus = { "focus (click)" }, tIdle = { "idle, focused" }, tEnd = { "type at end" }, tMiddle = { "type in the middle" };
+    Timing tStart = { "type at start" }, tEnter = { "Enter" }, tBackspace = { "Backspace" }, tDown = { "down arrow" }, tPage = { "page down" };
+    Timing tClick = { "click in text" }, tSelect = { "type over selection" }, tUndo = { "undo" };
+    auto expect = [&](char const* what) {
+        check(editor.text == model, what);
+        check(editor.cursor == static_cast<int>(modelCursor), what);
+    };
+
+    frame(editor);
+    frame(editor);
+    float const lineHeight = ImGui::GetFontSize();
+    ImVec2 const textOrigin = editor.rect.Min + ImGui::GetStyle().FramePadding;
+
+    // Focus with a click before the first character
+    tFocus.add(click(editor, textOrigin + ImVec2(-2.0f, lineHeight * 0.5f)));
+    check(editor.active, "focused by click");
+    expect("click on the first line");
+    for (int i = 0; i < keys; i++)
+        tIdle.add(frame(editor));
+
+    // Nothing but the visible lines is submitted: a window of text is ~60 lines of ~50 characters
+    ImDrawList const* list = textDrawList();
+    check(list && list->VtxBuffer.Size < 60 * 120 * 4, "focused widget only draws the visible lines");
+
+    // Type at the end
+    key(editor, ImGuiKey_End, Ctrl);
+    modelCursor = model.size();
+    expect("ctrl+end");
+    for (int i = 0; i < keys; i++)
+    {
+        char const c = static_cast<char>('a' + i % 26);
+        tEnd.add(type(editor, static_cast<unsigned char>(c)));
+        model.insert(modelCursor++, 1, c);
+    }
+    expect("typing at the end");
+    list = textDrawList();
+    check(list && list->VtxBuffer.Size < 60 * 120 * 4, "focused widget only draws the visible lines at the end");
+
+    // Clicks in the text shown at the bottom: start of the 10th visible line from the top of the frame
+    for (int i = 0; i < keys; i++)
+    {
+        ImVec2 const pos = textOrigin + ImVec2(-2.0f, lineHeight * (10.5f + (i % 5)));
+        tClick.add(click(editor, pos));
+        check(editor.cursor >= 0 && lineStart(model, static_cast<size_t>(editor.cursor)) == static_cast<size_t>(editor.cursor), "click left of a line puts the cursor at its start");
+        size_t const line = lineOf(model, static_cast<size_t>(editor.cursor));
+        check(line + 60 > lines && line < lines, "click lands in the lines shown at the end");
+        modelCursor = static_cast<size_t>(editor.cursor);
+    }
+
+    // Down arrow and page down from the top
+    key(editor, ImGuiKey_Home, Ctrl);
+    modelCursor = 0;
+    expect("ctrl+home");
+    for (int i = 0; i < keys; i++)
+    {
+        tDown.add(key(editor, ImGuiKey_DownArrow));
+        modelCursor = model.find('\n', modelCursor) + 1;
+    }
+    expect("down arrows keep column 0");
+    for (int i = 0; i < keys; i++)
+    {
+        size_t const before = lineOf(model, static_cast<size_t>(editor.cursor));
+        tPage.add(key(editor, ImGuiKey_PageDown));
+        size_t const after = lineOf(model, static_cast<size_t>(editor.cursor));
+        check(after > before + 10 && lineStart(model, static_cast<size_t>(editor.cursor)) == static_cast<size_t>(editor.cursor), "page down moves whole lines");
+    }
+    modelCursor = static_cast<size_t>(editor.cursor);
+
+    // Type in the middle: Enter, characters, Backspace
+    // Getting half way down 10 MB with page down would take a while, put the cursor there directly
+    modelCursor = 0;
+    for (size_t line = 0; line < lines / 2; line++)
+        modelCursor = model.find('\n', modelCursor) + 1;
+    if (ImGuiInputTextState* state = ImGui::GetInputTextState(ImGui::GetActiveID()))
+    {
+        state->Stb.cursor = state->Stb.select_start = state->Stb.select_end = ImTextCountCharsFromUtf8(model.data(), model.data() + modelCursor);
+        state->CursorFollow = true;
+    }
+    frame(editor);
+    expect("cursor in the middle");
+    for (int i = 0; i < keys; i++)
+    {
+        // Some of them two bytes long in UTF-8
+        if (i % 5 == 2)
+        {
+            tMiddle.add(type(editor, 0xE9));
+            model.insert(modelCursor, "\xC3\xA9");
+            modelCursor += 2;
+        }
+        else
+        {
+            char const c = static_cast<char>('A' + i % 26);
+            tMiddle.add(type(editor, static_cast<unsigned char>(c)));
+            model.insert(modelCursor++, 1, c);
+        }
+        if (i % 4 == 3)
+        {
+            tEnter.add(key(editor, ImGuiKey_Enter));
+            model.insert(modelCursor++, 1, '\n');
+        }
+    }
+    expect("typing in the middle");
+    for (int i = 0; i < keys; i++)
+    {
+        tBackspace.add(key(editor, ImGuiKey_Backspace));
+        size_t const previous = modelCursor;
+        while ((static_cast<unsigned char>(model[--modelCursor]) & 0xC0) == 0x80)
+            ;
+        model.erase(modelCursor, previous - modelCursor);
+    }
+    expect("backspace in the middle");
+
+    // Focused and unfocused draw the same text: compare the child window vertices, minus the cursor
+    {
+        frame(editor);
+        ImDrawList const* focused = textDrawList();
+        std::vector<ImDrawVert> focusedVerts(focused->VtxBuffer.begin(), focused->VtxBuffer.end());
+        ImGuiInputTextState* state = ImGui::GetInputTextState(ImGui::GetActiveID());
+        bool const cursorDrawn = state && (state->CursorAnim <= 0.0f || ImFmod(state->CursorAnim, 1.20f) <= 0.80f);
+        ImGui::ClearActiveID();
+        frame(editor);
+        ImDrawList const* unfocused = textDrawList();
+        size_t const expectedSize = static_cast<size_t>(unfocused->VtxBuffer.Size) + (cursorDrawn ? 4 : 0);
+        check(focusedVerts.size() == expectedSize, "focused and unfocused vertex counts");
+        check(focusedVerts.size() >= expectedSize && memcmp(focusedVerts.data(), unfocused->VtxBuffer.Data, unfocused->VtxBuffer.size_in_bytes()) == 0, "focused and unfocused text vertices");
+        click(editor, textOrigin + ImVec2(-2.0f, lineHeight * 0.5f));
+        modelCursor = static_cast<size_t>(editor.cursor);
+    }
+
+    // Type at the start
+    key(editor, ImGuiKey_Home, Ctrl);
+    modelCursor = 0;
+    for (int i = 0; i < keys; i++)
+    {
+        char const c = static_cast<char>('0' + i % 10);
+        tStart.add(type(editor, static_cast<unsigned char>(c)));
+        model.insert(modelCursor++, 1, c);
+    }
+    expect("typing at the start");
+
+    // Replace a few selected lines then undo (the undo buffer only holds a thousand characters, not the whole text)
+    std::string const before = model;
+    for (int i = 0; i < 3; i++)
+    {
+        key(editor, ImGuiKey_Home);
+        modelCursor = lineStart(model, modelCursor);
+        for (int k = 0; k < 5; k++)
+            key(editor, ImGuiKey_DownArrow, Shift);
+        size_t selectionEnd = modelCursor;
+        for (int k = 0; k < 5; k++)
+            selectionEnd = model.find('\n', selectionEnd) + 1;
+        tSelect.add(type(editor, 'z'));
+        model.replace(modelCursor, selectionEnd - modelCursor, 1, 'z');
+        modelCursor++;
+        expect("typing over a selection");
+        // stb_textedit records the deletion of the selection and the typed character separately
+        tUndo.add(key(editor, ImGuiKey_Z, Ctrl));
+        tUndo.add(key(editor, ImGuiKey_Z, Ctrl));
+        model = before;
+        check(editor.text == model, "undo restores the text");
+        modelCursor = static_cast<size_t>(editor.cursor);
+    }
+    printf("frame time handling the event:\n");
+    for (Timing const* t : { &tFocus, &tIdle, &tEnd, &tMiddle, &tStart, &tEnter, &tBackspace, &tDown, &tPage, &tClick, &tSelect, &tUndo })
+        t->print();
+
+    ImGui::DestroyContext();
+    printf(ok ? "ok\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,300 @@
+//--------------------------------------------------------------------------------------
+// Headless benchmark and checks of retained GUI frames (ImGui::ReuseLastFrame). Runs a
+// window shaped like "PBR Setting" with every header open, plus a plot window like the
+// profiler, through the same schedule as Graphics: a frame is reused while ReuseLastFrame
+// says nothing changed and the shown stats are younger than the refresh interval.
+// Reports CPU time per frame and the vertex/index bytes the DX11 backend would upload,
+// for always building and for reusing, with the mouse outside the GUI, resting on a
+// widget and moving. Checks that a reused frame matches what building would produce and
+// that input after idle frames still reaches the widgets.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -I.. imgui_retained_bench.cpp ../imgui.cpp ../imgui_draw.cpp ../imgui_widgets.cpp ../imgui_tables.cpp -o imgui_retained_bench
+//
+// Usage:
+//   imgui_retained_bench [--frames n] [--refresh frames]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+
+static bool ok = true;
+
+static void check(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+}
+
+// what the widgets edit and show
+struct AppState
+{
+    int drawMask = 0;
+    bool showProfiler = true;
+    bool depthPrepass = true;
+    int budget = 256;
+    float stats[16] = {};
+    float history[120] = {};
+    char name[32] = "spheres";
+};
+
+// center of the "Normal Distributional Function" radio button, for the input checks
+static ImVec2 radioCenter;
+
+static void buildGUI(AppState& app)
+{
+    ImGui::NewFrame();
+
+    ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_Always);
+    ImGui::SetNextWindowSize(ImVec2(420, 640), ImGuiCond_Always);
+    ImGui::Begin("PBR Setting");
+    ImGui::Text("Render mode");
+    ImGui::RadioButton("Complete scene", &app.drawMask, 0);
+    ImGui::RadioButton("Normal Distributional Function", &app.drawMask, 1);
+    radioCenter = ImVec2((ImGui::GetItemRectMin().x + ImGui::GetItemRectMax().x) * 0.5f,
+        (ImGui::GetItemRectMin().y + ImGui::GetItemRectMax().y) * 0.5f);
+    ImGui::RadioButton("Fresnel Function", &app.drawMask, 2);
+    ImGui::RadioButton("Geometry Function", &app.drawMask, 3);
+    ImGui::Checkbox("Profiler", &app.showProfiler);
+    static const char* const headers[] = { "Frame pacing", "Pipeline", "Frame graph", "Jobs", "Materials", "Depth", "GUI", "Render queue" };
+    for (int h = 0; h < 8; h++)
+    {
+        ImGui::SetNextItemOpen(true, ImGuiCond_Once);
+        if (ImGui::CollapsingHeader(headers[h]))
+        {
+            ImGui::Text("Value: %.2f ms, p95 %.2f ms", app.stats[h * 2], app.stats[h * 2 + 1]);
+            ImGui::Text("Count: %d of %d", (int)app.stats[h * 2] * 10, 1000);
+        }
+    }
+    ImGui::Checkbox("Depth pre-pass", &app.depthPrepass);
+    ImGui::SliderInt("Budget (MB)", &app.budget, 1, 2048);
+    ImGui::InputText("Name", app.name, sizeof(app.name));
+    ImGui::End();
+
+    if (app.showProfiler)
+    {
+        ImGui::SetNextWindowPos(ImVec2(450, 10), ImGuiCond_Always);
+        ImGui::SetNextWindowSize(ImVec2(700, 300), ImGuiCond_Always);
+        ImGui::Begin("Profiler", &app.showProfiler);
+        ImGui::PlotLines("Frame", app.history, 120, 0, NULL, 0.0f, 20.0f, ImVec2(0, 120));
+        for (int i = 0; i < 30; i++)
+            ImGui::Text("Scope %2d: %.3f ms", i, app.history[i] * 0.1f);
+        ImGui::End();
+    }
+
+    ImGui::Render();
+}
+
+// the stats change every frame, like the real ones
+static void tick(AppState& app, int frame)
+{
+    for (int i = 0; i < 16; i++)
+        app.stats[i] = 5.0f + (float)((frame * 7 + i * 13) % 100) * 0.01f;
+    app.history[frame % 120] = 5.0f + (float)(frame % 17);
+}
+
+static uint64_t uploadBytes(ImDrawData const* drawData)
+{
+    return (uint64_t)drawData->TotalVtxCount * sizeof(ImDrawVert) + (uint64_t)drawData->TotalIdxCount * sizeof(ImDrawIdx);
+}
+
+// the backend's view of the draw data
+static std::vector<unsigned char> snapshot(ImDrawData const* drawData)
+{
+    std::vector<unsigned char> bytes;
+    for (int n = 0; n < drawData->CmdListsCount; n++)
+    {
+        auto list = drawData->CmdLists[n];
+        auto append = [&bytes](void const* data, size_t size) {
+            bytes.insert(bytes.end(), (unsigned char const*)data, (unsigned char const*)data + size);
+        };
+        append(list->VtxBuffer.Data, list->VtxBuffer.size_in_bytes());
+        append(list->IdxBuffer.Data, list->IdxBuffer.size_in_bytes());
+        for (auto const& cmd : list->CmdBuffer)
+        {
+            append(&cmd.ClipRect, sizeof(cmd.ClipRect));
+            append(&cmd.ElemCount, sizeof(cmd.ElemCount));
+            append(&cmd.IdxOffset, sizeof(cmd.IdxOffset));
+            append(&cmd.VtxOffset, sizeof(cmd.VtxOffset));
+        }
+    }
+    return bytes;
+}
+
+enum class Mouse { Outside, Resting, Moving };
+
+struct RunResult
+{
+    int built = 0;
+    int reused = 0;
+    double ms = 0.0;
+    uint64_t bytes = 0;
+};
+
+using Clock = std::chrono::steady_clock;
+
+// reuse 0: build every frame, 1: like Graphics::guiNeedsBuild
+static RunResult run(AppState& app, int frames, int refreshFrames, bool reuse, Mouse mouse)
+{
+    auto& io = ImGui::GetIO();
+    RunResult result;
+    int lastBuild = -refreshFrames;
+    auto start = Clock::now();
+    for (int f = 0; f < frames; f++)
+    {
+        tick(app, f);
+        // the Win32 backend repeats the cursor position every frame while focused
+        if (mouse == Mouse::Outside)
+            io.AddMousePosEvent(1200.0f, 700.0f);
+        else if (mouse == Mouse::Resting)
+            io.AddMousePosEvent(60.0f, 85.0f);
+        else
+            io.AddMousePosEvent(1200.0f - (float)(f % 50), 700.0f);
+        io.DeltaTime = 1.0f / 60.0f;
+
+        bool reused = reuse && f - lastBuild < refreshFrames && ImGui::ReuseLastFrame();
+        if (reused)
+        {
+            result.reused++;
+        }
+        else
+        {
+            buildGUI(app);
+            lastBuild = f;
+            result.built++;
+            result.bytes += uploadBytes(ImGui::GetDrawData());
+        }
+    }
+    result.ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+static void report(char const* name, RunResult const& always, RunResult const& retained, int frames)
+{
+    printf("  %-8s always %7.4f ms %7.1f KB/frame   reused %5.1f%%: %7.4f ms %7.1f KB/frame\n", name,
+        always.ms / frames, always.bytes / 1024.0 / frames, 100.0 * retained.reused / frames,
+        retained.ms / frames, retained.bytes / 1024.0 / frames);
+}
+
+static void checks(AppState& app)
+{
+    auto& io = ImGui::GetIO();
+    auto settle = [&]() {
+        for (int f = 0; f < 10; f++)
+        {
+            io.AddMousePosEvent(1200.0f, 700.0f);
+            if (!ImGui::ReuseLastFrame())
+                buildGUI(app);
+        }
+    };
+    settle();
+    io.AddMousePosEvent(1200.0f, 700.0f);
+    check(ImGui::ReuseLastFrame(), "idle frame is reused");
+
+    // nothing changed: building again gives the reused draw data
+    auto reused = snapshot(ImGui::GetDrawData());
+    buildGUI(app);
+    check(snapshot(ImGui::GetDrawData()) == reused, "reused draw data matches a rebuild");
+
+    // a click after idle frames reaches the radio button
+    settle();
+    auto frame = [&](bool down) {
+        io.AddMousePosEvent(radioCenter.x, radioCenter.y);
+        io.AddMouseButtonEvent(0, down);
+        check(!ImGui::ReuseLastFrame(), "input builds");
+        buildGUI(app);
+    };
+    frame(false);
+    frame(true);
+    frame(false);
+    check(app.drawMask == 1, "click after idle frames is handled");
+
+    // a hovered widget keeps building
+    for (int f = 0; f < 5; f++)
+    {
+        io.AddMousePosEvent(radioCenter.x, radioCenter.y);
+        check(!ImGui::ReuseLastFrame(), "hovered widget builds");
+        buildGUI(app);
+    }
+
+    // leaving it settles for a couple of frames, then reuses
+    io.AddMousePosEvent(1200.0f, 700.0f);
+    check(!ImGui::ReuseLastFrame(), "moving away builds");
+    buildGUI(app);
+    int builds = 0;
+    for (int f = 0; f < 5; f++)
+    {
+        io.AddMousePosEvent(1200.0f, 700.0f);
+        if (!ImGui::ReuseLastFrame())
+        {
+            buildGUI(app);
+            builds++;
+        }
+    }
+    check(builds >= 2 && builds < 5, "settles after activity");
+
+    // typing keeps building until the text field is left
+    settle();
+    check(ImGui::ReuseLastFrame(), "idle again");
+    io.AddInputCharacter('x');
+    check(!ImGui::ReuseLastFrame(), "text input builds");
+    buildGUI(app);
+    settle();
+}
+
+int main(int argc, char* argv[])
+{
+    int frames = 2000;
+    int refresh = 15;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--frames") && i + 1 < argc)
+            frames = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--refresh") && i + 1 < argc)
+            refresh = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [--frames n] [--refresh frames]\n", argv[0]);
+            return 1;
+        }
+    }
+    frames = std::max(frames, 1);
+    refresh = std::max(refresh, 1);
+
+    ImGui::CreateContext();
+    auto& io = ImGui::GetIO();
+    io.IniFilename = NULL;
+    io.DisplaySize = ImVec2(1280, 720);
+    io.DeltaTime = 1.0f / 60.0f;
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    AppState app;
+    checks(app);
+
+    printf("%d frames at 60 Hz, stats refreshed every %d frames:\n", frames, refresh);
+    Mouse const mice[] = { Mouse::Outside, Mouse::Resting, Mouse::Moving };
+    char const* const names[] = { "idle", "hovering", "moving" };
+    for (int m = 0; m < 3; m++)
+    {
+        auto always = run(app, frames, refresh, false, mice[m]);
+        auto retained = run(app, frames, refresh, true, mice[m]);
+        report(names[m], always, retained, frames);
+    }
+
+    ImGui::DestroyContext();
+    printf(ok ? "ok\n" : "failed\n");
+    return ok ? 0 : 1;
+}
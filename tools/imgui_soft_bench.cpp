@@ -0,0 +1,407 @@
+//--------------------------------------------------------------------------------------
+// Checks and benchmark of the CPU rasterizer backend (imgui_impl_soft). Renders frames
+// of the ImGui demo, style editor and a window shaped like "PBR Setting" headless, and
+// compares them against a plain per-pixel reference rasterizer in double precision.
+// Also checks that every thread count gives the same image, that triangles sharing an
+// edge never blend a pixel twice, and optionally against a golden image (PPM).
+// Reports ms per frame for the reference and for 1 to n threads, and how many
+// triangles took the single sample and texel-aligned glyph paths.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -pthread -I.. imgui_soft_bench.cpp ../imgui_impl_soft.cpp ../imgui.cpp ../imgui_draw.cpp ../imgui_widgets.cpp ../imgui_tables.cpp ../imgui_demo.cpp -o imgui_soft_bench
+//
+// Usage:
+//   imgui_soft_bench [--frames n] [--threads n] [--write-golden file.ppm] [--golden file.ppm]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "imgui.h"
+#include "imgui_impl_soft.h"
+
+static bool ok = true;
+
+static void check(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+}
+
+static int const Width = 1280;
+static int const Height = 720;
+static ImU32 const Background = IM_COL32(40, 44, 52, 255);
+
+struct Image
+{
+    int width = Width;
+    int height = Height;
+    std::vector<ImU32> pixels = std::vector<ImU32>(Width * Height, Background);
+
+    ImGui_ImplSoft_Framebuffer framebuffer()
+    {
+        return { pixels.data(), width, height, width };
+    }
+};
+
+static void buildGUI(int frame)
+{
+    auto& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2((float)Width, (float)Height);
+    io.DeltaTime = 1.0f / 60.0f;
+    ImGui_ImplSoft_NewFrame();
+    ImGui::NewFrame();
+
+    ImGui::ShowDemoWindow();
+
+    ImGui::SetNextWindowPos(ImVec2(20, 300), ImGuiCond_Always);
+    ImGui::SetNextWindowSize(ImVec2(560, 400), ImGuiCond_Always);
+    ImGui::Begin("Style");
+    ImGui::ShowStyleEditor();
+    ImGui::End();
+
+    ImGui::SetNextWindowPos(ImVec2(20, 20), ImGuiCond_Always);
+    ImGui::SetNextWindowSize(ImVec2(420, 270), ImGuiCond_Always);
+    ImGui::Begin("PBR Setting");
+    static int drawMask = 0;
+    ImGui::RadioButton("Complete scene", &drawMask, 0);
+    ImGui::RadioButton("Normal Distributional Function", &drawMask, 1);
+    static float roughness = 0.5f;
+    ImGui::SliderFloat("Roughness", &roughness, 0.0f, 1.0f);
+    float history[90];
+    for (int i = 0; i < 90; i++)
+        history[i] = 6.0f + sinf((i + frame) * 0.2f) * 2.0f;
+    ImGui::PlotLines("Frame", history, 90, 0, NULL, 0.0f, 10.0f, ImVec2(0, 100));
+    ImGui::ProgressBar(0.3f + 0.001f * frame);
+    ImGui::GetWindowDrawList()->AddCircleFilled(ImVec2(230, 230), 40.0f, IM_COL32(200, 80, 40, 160));
+    ImGui::GetWindowDrawList()->AddBezierCubic(ImVec2(40, 260), ImVec2(100, 150), ImVec2(300, 350), ImVec2(400, 230), IM_COL32(80, 200, 255, 255), 3.0f);
+    ImGui::End();
+
+    ImGui::Render();
+}
+
+//--------------------------------------------------------------------------------------
+// Reference: every pixel of the bounds against every triangle, double precision, the same
+// coverage rule (pixel centers, ties to the edge whose inward normal points right, or down)
+//--------------------------------------------------------------------------------------
+
+static void referenceSample(ImGui_ImplSoft_Texture const* tex, double s, double t, double out[4])
+{
+    s = std::min(std::max(s, -1.0), (double)tex->Width);
+    t = std::min(std::max(t, -1.0), (double)tex->Height);
+    double fs = std::floor(s), ft = std::floor(t);
+    int x0 = std::clamp((int)fs, 0, tex->Width - 1), x1 = std::clamp((int)fs + 1, 0, tex->Width - 1);
+    int y0 = std::clamp((int)ft, 0, tex->Height - 1), y1 = std::clamp((int)ft + 1, 0, tex->Height - 1);
+    auto texel = [tex](int x, int y, int c) { return (double)((tex->Pixels[y * tex->Width + x] >> (c * 8)) & 0xFF); };
+    for (int c = 0; c < 4; c++)
+    {
+        double top = texel(x0, y0, c) + (texel(x1, y0, c) - texel(x0, y0, c)) * (s - fs);
+        double bottom = texel(x0, y1, c) + (texel(x1, y1, c) - texel(x0, y1, c)) * (s - fs);
+        out[c] = (top + (bottom - top) * (t - ft)) / 255.0;
+    }
+}
+
+static void referenceTriangle(Image& image, ImDrawVert const* v[3], ImGui_ImplSoft_Texture const* tex, int const clip[4])
+{
+    double x[3], y[3];
+    for (int k = 0; k < 3; k++)
+    {
+        x[k] = v[k]->pos.x;
+        y[k] = v[k]->pos.y;
+    }
+    double area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (area == 0.0)
+        return;
+    int minX = std::max(clip[0], (int)std::floor(std::min({ x[0], x[1], x[2] })));
+    int maxX = std::min(clip[2], (int)std::ceil(std::max({ x[0], x[1], x[2] })));
+    int minY = std::max(clip[1], (int)std::floor(std::min({ y[0], y[1], y[2] })));
+    int maxY = std::min(clip[3], (int)std::ceil(std::max({ y[0], y[1], y[2] })));
+    for (int py = minY; py < maxY; py++)
+        for (int px = minX; px < maxX; px++)
+        {
+            double cx = px + 0.5, cy = py + 0.5;
+            double bary[3];
+            bool inside = true;
+            for (int i = 0; i < 3 && inside; i++)
+            {
+                int a = (i + 1) % 3, b = (i + 2) % 3;
+                // signed so that the opposite vertex is positive
+                double w = ((x[b] - x[a]) * (cy - y[a]) - (y[b] - y[a]) * (cx - x[a])) / area;
+                double nx = -(y[b] - y[a]) / area, ny = (x[b] - x[a]) / area;
+                bary[i] = w;
+                inside = w > 0.0 || (w == 0.0 && (nx > 0.0 || (nx == 0.0 && ny > 0.0)));
+            }
+            if (!inside)
+                continue;
+
+            double texel[4] = { 1.0, 1.0, 1.0, 1.0 };
+            if (tex)
+            {
+                double u = 0.0, t = 0.0;
+                for (int k = 0; k < 3; k++)
+                {
+                    u += bary[k] * v[k]->uv.x;
+                    t += bary[k] * v[k]->uv.y;
+                }
+                referenceSample(tex, u * tex->Width - 0.5, t * tex->Height - 0.5, texel);
+            }
+            double color[4];
+            for (int c = 0; c < 4; c++)
+            {
+                color[c] = 0.0;
+                for (int k = 0; k < 3; k++)
+                    color[c] += bary[k] * ((v[k]->col >> (c * 8)) & 0xFF);
+                color[c] *= texel[c];
+            }
+            ImU32& dst = image.pixels[py * image.width + px];
+            double alpha = color[3] / 255.0;
+            ImU32 out = 0;
+            for (int c = 0; c < 4; c++)
+            {
+                double d = (dst >> (c * 8)) & 0xFF;
+                double value = c < 3 ? color[c] * alpha + d * (1.0 - alpha) : color[c] + d * (1.0 - alpha);
+                out |= (ImU32)std::clamp((int)std::lround(value), 0, 255) << (c * 8);
+            }
+            dst = out;
+        }
+}
+
+static void referenceRender(ImDrawData const* drawData, Image& image)
+{
+    for (int n = 0; n < drawData->CmdListsCount; n++)
+    {
+        auto list = drawData->CmdLists[n];
+        for (auto const& cmd : list->CmdBuffer)
+        {
+            if (cmd.UserCallback)
+                continue;
+            int clip[4] = {
+                std::clamp((int)cmd.ClipRect.x, 0, image.width), std::clamp((int)cmd.ClipRect.y, 0, image.height),
+                std::clamp((int)cmd.ClipRect.z, 0, image.width), std::clamp((int)cmd.ClipRect.w, 0, image.height) };
+            if (clip[2] <= clip[0] || clip[3] <= clip[1])
+                continue;
+            auto tex = (ImGui_ImplSoft_Texture const*)cmd.GetTexID();
+            for (unsigned i = 0; i + 2 < cmd.ElemCount; i += 3)
+            {
+                ImDrawVert const* v[3];
+                for (int k = 0; k < 3; k++)
+                    v[k] = &list->VtxBuffer[cmd.VtxOffset + list->IdxBuffer[cmd.IdxOffset + i + k]];
+                referenceTriangle(image, v, tex, clip);
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------
+
+struct Difference
+{
+    int pixels = 0;     // any channel off by more than the tolerance
+    int maxChannel = 0;
+};
+
+static Difference compare(Image const& a, Image const& b, int tolerance)
+{
+    Difference diff;
+    for (size_t i = 0; i < a.pixels.size(); i++)
+    {
+        int worst = 0;
+        for (int c = 0; c < 4; c++)
+            worst = std::max(worst, std::abs((int)((a.pixels[i] >> (c * 8)) & 0xFF) - (int)((b.pixels[i] >> (c * 8)) & 0xFF)));
+        diff.maxChannel = std::max(diff.maxChannel, worst);
+        diff.pixels += worst > tolerance;
+    }
+    return diff;
+}
+
+static bool writePPM(char const* path, Image const& image)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+        return false;
+    fprintf(file, "P6\n%d %d\n255\n", image.width, image.height);
+    for (ImU32 pixel : image.pixels)
+    {
+        unsigned char rgb[3] = { (unsigned char)(pixel & 0xFF), (unsigned char)((pixel >> 8) & 0xFF), (unsigned char)((pixel >> 16) & 0xFF) };
+        fwrite(rgb, 1, 3, file);
+    }
+    return fclose(file) == 0;
+}
+
+static bool readPPM(char const* path, Image& image)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return false;
+    int width = 0, height = 0, max = 0;
+    bool read = fscanf(file, "P6 %d %d %d", &width, &height, &max) == 3 && fgetc(file) != EOF && width == image.width && height == image.height && max == 255;
+    for (size_t i = 0; read && i < image.pixels.size(); i++)
+    {
+        unsigned char rgb[3];
+        read = fread(rgb, 1, 3, file) == 3;
+        image.pixels[i] = IM_COL32(rgb[0], rgb[1], rgb[2], 255);
+    }
+    fclose(file);
+    return read;
+}
+
+// the RGB of an image, as a PPM stores it
+static Image opaque(Image image)
+{
+    for (auto& pixel : image.pixels)
+        pixel |= IM_COL32_A_MASK;
+    return image;
+}
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// a new context every time, so that every run renders the same frames
+static void initBackend(int threads)
+{
+    ImGui::CreateContext();
+    ImGui::GetIO().IniFilename = nullptr;
+    ImGui_ImplSoft_Init(threads);
+    // a few frames so that the windows are laid out and the demo is at a stable state
+    for (int f = 0; f < 3; f++)
+        buildGUI(f);
+}
+
+static void shutdownBackend()
+{
+    ImGui_ImplSoft_Shutdown();
+    ImGui::DestroyContext();
+}
+
+static Image render(int frame)
+{
+    buildGUI(frame);
+    Image image;
+    auto framebuffer = image.framebuffer();
+    ImGui_ImplSoft_RenderDrawData(ImGui::GetDrawData(), &framebuffer);
+    return image;
+}
+
+// two triangles of a quad at half alpha, with shared diagonals that cross pixel centers
+static void checkSharedEdges()
+{
+    ImGui::GetStyle().AntiAliasedFill = false;
+    buildGUI(0);
+    ImGui_ImplSoft_NewFrame();
+    ImGui::NewFrame();
+    auto drawList = ImGui::GetBackgroundDrawList();
+    drawList->AddRectFilled(ImVec2(10.0f, 10.0f), ImVec2(110.0f, 60.0f), IM_COL32(255, 255, 255, 128));
+    drawList->AddRectFilled(ImVec2(200.25f, 10.5f), ImVec2(300.75f, 81.5f), IM_COL32(255, 255, 255, 128));
+    drawList->AddQuadFilled(ImVec2(400, 10), ImVec2(500, 30), ImVec2(480, 120), ImVec2(390, 90), IM_COL32(255, 255, 255, 128));
+    // a fan, every triangle shares two edges
+    drawList->AddCircleFilled(ImVec2(700, 100), 80.0f, IM_COL32(255, 255, 255, 128), 48);
+    ImGui::Render();
+    ImGui::GetStyle().AntiAliasedFill = true;
+
+    Image image;
+    std::fill(image.pixels.begin(), image.pixels.end(), IM_COL32(0, 0, 0, 255));
+    auto framebuffer = image.framebuffer();
+    ImGui_ImplSoft_RenderDrawData(ImGui::GetDrawData(), &framebuffer);
+    bool once = true;
+    int covered = 0;
+    for (ImU32 pixel : image.pixels)
+        if (pixel != IM_COL32(0, 0, 0, 255))
+        {
+            once &= pixel == IM_COL32(128, 128, 128, 255);
+            covered++;
+        }
+    check(covered > 25000 && once, "shared edges are blended once");
+}
+
+int main(int argc, char* argv[])
+{
+    int frames = 60;
+    int maxThreads = (int)std::max(std::thread::hardware_concurrency(), 4u);
+    char const* writeGolden = nullptr;
+    char const* golden = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--frames") && i + 1 < argc)
+            frames = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+            maxThreads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--write-golden") && i + 1 < argc)
+            writeGolden = argv[++i];
+        else if (!strcmp(argv[i], "--golden") && i + 1 < argc)
+            golden = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: %s [--frames n] [--threads n] [--write-golden file.ppm] [--golden file.ppm]\n", argv[0]);
+            return 1;
+        }
+    }
+    frames = std::max(frames, 1);
+    maxThreads = std::max(maxThreads, 1);
+
+    // against the reference
+    initBackend(1);
+    Image soft = render(10);
+    ImGui_ImplSoft_Stats stats;
+    ImGui_ImplSoft_GetStats(&stats);
+    Image reference;
+    auto start = Clock::now();
+    referenceRender(ImGui::GetDrawData(), reference);
+    double referenceMs = elapsedMs(start);
+    auto diff = compare(soft, reference, 2);
+    printf("%d triangles, %d tile bins: %d single sample, %d texel-aligned glyphs\n",
+        stats.Triangles, stats.TileBins, stats.ConstTexelTriangles, stats.NearestTriangles);
+    printf("against the reference: %d pixels off by more than 2 (%.4f%%), max channel difference %d\n",
+        diff.pixels, 100.0 * diff.pixels / (Width * Height), diff.maxChannel);
+    check(diff.pixels <= Width * Height / 10000, "matches the reference");
+
+    if (writeGolden)
+        check(writePPM(writeGolden, soft), "golden image written");
+    if (golden)
+    {
+        Image expected;
+        check(readPPM(golden, expected), "golden image read");
+        auto goldenDiff = compare(opaque(soft), expected, 2);
+        printf("against %s: %d pixels off by more than 2\n", golden, goldenDiff.pixels);
+        check(goldenDiff.pixels == 0, "matches the golden image");
+    }
+    checkSharedEdges();
+    shutdownBackend();
+
+    printf("%dx%d, %d frames: reference %.2f ms\n", Width, Height, frames, referenceMs);
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        initBackend(threads);
+        check(render(10).pixels == soft.pixels, "every thread count gives the same image");
+        double best = 1e30, total = 0.0;
+        for (int f = 0; f < frames; f++)
+        {
+            buildGUI(f);
+            Image image;
+            auto framebuffer = image.framebuffer();
+            start = Clock::now();
+            ImGui_ImplSoft_RenderDrawData(ImGui::GetDrawData(), &framebuffer);
+            double ms = elapsedMs(start);
+            best = std::min(best, ms);
+            total += ms;
+        }
+        printf("  %2d threads: %6.2f ms/frame, best %6.2f ms\n", threads, total / frames, best);
+        shutdownBackend();
+    }
+
+    printf(ok ? "ok\n" : "failed\n");
+    return ok ? 0 : 1;
+}
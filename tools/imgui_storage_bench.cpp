@@ -0,0 +1,215 @@
+//--------------------------------------------------------------------------------------
+// Checks and benchmark of ImGuiStorage. Random Set/Get/GetRef sequences are compared
+// against std::unordered_map, plus bulk building through Data + BuildSortByKey(),
+// Clear() and SetAllInt(). Then 10k to 1M random IDs are inserted one at a time and in
+// bulk, and looked up (hits and misses). The storage backend is a compile time option,
+// build the tool once per backend and compare the two outputs.
+//
+// Build (Linux), sorted pairs with binary search (upstream default):
+//   g++ -std=c++17 -O2 -I.. imgui_storage_bench.cpp ../imgui.cpp ../imgui_draw.cpp ../imgui_widgets.cpp ../imgui_tables.cpp -o imgui_storage_bench
+// Open addressing hash index:
+//   g++ -std=c++17 -O2 -DIMGUI_USE_HASHED_STORAGE -I.. imgui_storage_bench.cpp ../imgui.cpp ../imgui_draw.cpp ../imgui_widgets.cpp ../imgui_tables.cpp -o imgui_storage_bench_hashed
+//
+// Usage:
+//   imgui_storage_bench [--max-keys n] [--max-incremental n]
+//   --max-incremental caps one by one insertion for the sorted backend (default 100000)
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+
+static bool ok = true;
+
+static void check(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+}
+
+static void checkAgainstMap()
+{
+    std::mt19937 rng(42);
+    // a small key range so sets hit existing keys often, 0 included
+    std::uniform_int_distribution<ImGuiID> key(0, 3000);
+    std::uniform_int_distribution<int> op(0, 5), value(-1000, 1000);
+
+    ImGuiStorage storage;
+    std::unordered_map<ImGuiID, int> expected;
+    bool same = true;
+    for (int i = 0; i < 200000 && same; i++)
+    {
+        auto k = key(rng);
+        auto v = value(rng);
+        auto it = expected.find(k);
+        switch (op(rng))
+        {
+        case 0:
+        case 1:
+            storage.SetInt(k, v);
+            expected[k] = v;
+            break;
+        case 2:
+            same = storage.GetInt(k, -7) == (it == expected.end() ? -7 : it->second);
+            break;
+        case 3:
+        {
+            int* ref = storage.GetIntRef(k, v);
+            if (it == expected.end())
+                expected[k] = v;
+            same = *ref == expected[k];
+            *ref = v + 1;
+            expected[k] = v + 1;
+            break;
+        }
+        case 4:
+            same = storage.GetBool(k, true) == (it == expected.end() ? true : it->second != 0);
+            break;
+        case 5:
+            // a key far outside the range is always missing
+            same = storage.GetVoidPtr(k + 0x80000000u) == NULL;
+            break;
+        }
+        if (i == 100000)
+        {
+            // sorting keeps every value reachable
+            storage.BuildSortByKey();
+            for (int n = 1; n < storage.Data.Size; n++)
+                same &= storage.Data[n - 1].key < storage.Data[n].key;
+        }
+    }
+    check(same, "random operations match std::unordered_map");
+    check(storage.Data.Size == (int)expected.size(), "one pair per key");
+
+    storage.SetAllInt(3);
+    bool all = true;
+    for (auto const& entry : expected)
+        all &= storage.GetInt(entry.first) == 3;
+    check(all, "SetAllInt reaches every key");
+
+    storage.Clear();
+    check(storage.GetInt(key(rng), -1) == -1 && storage.Data.Size == 0, "Clear empties the storage");
+    storage.SetFloat(5, 2.5f);
+    check(storage.GetFloat(5) == 2.5f, "usable after Clear");
+}
+
+static void checkBulkBuild()
+{
+    // the documented fast rebuild: fill Data directly, sort once
+    ImGuiStorage storage;
+    storage.SetInt(1000001, 1);
+    for (ImGuiID k = 0; k < 10000; k++)
+        storage.Data.push_back(ImGuiStorage::ImGuiStoragePair(k * 7919u, (int)k));
+    storage.BuildSortByKey();
+    bool same = storage.GetInt(1000001) == 1;
+    for (ImGuiID k = 0; k < 10000; k++)
+        same &= storage.GetInt(k * 7919u, -1) == (int)k;
+    check(same, "bulk built storage finds every key");
+
+    // pairs added outside the API are found without BuildSortByKey() as long as they are appended sorted
+    storage.Data.push_back(ImGuiStorage::ImGuiStoragePair(0xFFFFFFF0u, 9));
+    check(storage.GetInt(0xFFFFFFF0u) == 9, "appended pair is found");
+}
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static volatile int sink;
+
+static void benchmark(int count, int maxIncremental, std::mt19937& rng)
+{
+    std::vector<ImGuiID> keys(count), missing(count);
+    for (int i = 0; i < count; i++)
+    {
+        keys[i] = ImHashData(&i, sizeof(i), 1);
+        missing[i] = ImHashData(&i, sizeof(i), 2);
+    }
+
+    // sorted insertion is quadratic, 1M keys would take hours
+    char incremental[32] = "  skipped";
+#ifdef IMGUI_USE_HASHED_STORAGE
+    IM_UNUSED(maxIncremental);
+#else
+    if (count <= maxIncremental)
+#endif
+    {
+        ImGuiStorage storage;
+        auto start = Clock::now();
+        for (int i = 0; i < count; i++)
+            storage.SetInt(keys[i], i);
+        snprintf(incremental, sizeof(incremental), "%9.2f ms", elapsedMs(start));
+    }
+
+    ImGuiStorage storage;
+    auto start = Clock::now();
+    storage.Data.reserve(count);
+    for (int i = 0; i < count; i++)
+        storage.Data.push_back(ImGuiStorage::ImGuiStoragePair(keys[i], i));
+    storage.BuildSortByKey();
+    auto bulk = elapsedMs(start);
+
+    // random order, like tree nodes queried all over the storage
+    std::shuffle(keys.begin(), keys.end(), rng);
+    int total = 0;
+    start = Clock::now();
+    for (int i = 0; i < count; i++)
+        total += storage.GetInt(keys[i], -1);
+    auto hits = elapsedMs(start) * 1e6 / count;
+    start = Clock::now();
+    for (int i = 0; i < count; i++)
+        total += storage.GetInt(missing[i], -1);
+    auto misses = elapsedMs(start) * 1e6 / count;
+    sink = total;
+
+    printf("  %8d keys: insert one by one %s, bulk %8.2f ms, lookup hit %6.1f ns, miss %6.1f ns\n",
+        count, incremental, bulk, hits, misses);
+}
+
+int main(int argc, char* argv[])
+{
+    int maxKeys = 1000000;
+    int maxIncremental = 100000;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--max-keys") && i + 1 < argc)
+            maxKeys = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--max-incremental") && i + 1 < argc)
+            maxIncremental = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [--max-keys n] [--max-incremental n]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    checkAgainstMap();
+    checkBulkBuild();
+
+#ifdef IMGUI_USE_HASHED_STORAGE
+    printf("backend: open addressing hash index\n");
+#else
+    printf("backend: sorted pairs, binary search\n");
+#endif
+    std::mt19937 rng(7);
+    for (int count = 10000; count <= maxKeys; count *= 10)
+        benchmark(count, maxIncremental, rng);
+
+    printf(ok ? "ok\n" : "failed\n");
+    return ok ? 0 : 1;
+}
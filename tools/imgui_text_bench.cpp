@@ -0,0 +1,749 @@
+//--------------------------------------------------------------------------------------
+// Checks and benchmark of the ASCII fast path of ImFont::CalcTextSizeA(),
+// CalcWordWrapPositionA() and RenderText(). Every result is compared bit for bit against
+// a copy of the original byte-at-a-time versions (below): text sizes and remaining
+// pointers, wrap positions, and the vertex/index buffers RenderText() writes, with and
+// without wrapping, max_width and CPU fine clipping. 1 MB blocks of log lines, prose,
+// tab indented code and text with ~10% multi-byte UTF-8 are timed with both versions.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -I.. imgui_text_bench.cpp ../imgui.cpp ../imgui_draw.cpp ../imgui_widgets.cpp ../imgui_tables.cpp -o imgui_text_bench
+// Scalar run scan instead of SSE2:
+//   g++ -std=c++17 -O2 -DIMGUI_DISABLE_SSE -I.. imgui_text_bench.cpp ../imgui.cpp ../imgui_draw.cpp ../imgui_widgets.cpp ../imgui_tables.cpp -o imgui_text_bench_scalar
+//
+// Usage:
+//   imgui_text_bench [--font file.ttf] [--size mb] [--runs n]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cfloat>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+
+static bool ok = true;
+
+static void check(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+}
+
+static std::vector<unsigned char> readFile(char const* path)
+{
+    std::vector<unsigned char> data;
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return data;
+    fseek(file, 0, SEEK_END);
+    data.resize(static_cast<size_t>(ftell(file)));
+    fseek(file, 0, SEEK_SET);
+    if (fread(data.data(), 1, data.size(), file) != data.size())
+        data.clear();
+    fclose(file);
+    return data;
+}
+
+//--------------------------------------------------------------------------------------
+// Reference: the original ImFont functions, one codepoint at a time
+//--------------------------------------------------------------------------------------
+
+static char const* referenceWordWrapPosition(ImFont const* font, float scale, const char* text, const char* text_end, float wrap_width)
+{
+    // Simple word-wrapping for English, not full-featured. Please submit failing cases!
+    // FIXME: Much possible improvements (don't cut things like "word !", "word!!!" but cut within "word,,,,", more sensible support for punctuations, support for Unicode punctuations, etc.)
+
+    // For references, possible wrap point marked with ^
+    //  "aaa bbb, ccc,ddd. eee   fff. ggg!"
+    //      ^    ^    ^   ^   ^__    ^    ^
+
+    // List of hardcoded separators: .,;!?'"
+
+    // Skip extra blanks after a line returns (that includes not counting them in width computation)
+    // e.g. "Hello    world" --> "Hello" "World"
+
+    // Cut words that cannot possibly fit within one line.
+    // e.g.: "The tropical fish" with ~5 characters worth of width --> "The tr" "opical" "fish"
+
+    float line_width = 0.0f;
+    float word_width = 0.0f;
+    float blank_width = 0.0f;
+    wrap_width /= scale; // We work with unscaled widths to avoid scaling every characters
+
+    const char* word_end = text;
+    const char* prev_word_end = NULL;
+    bool inside_word = true;
+
+    const char* s = text;
+    while (s < text_end)
+    {
+        unsigned int c = (unsigned int)*s;
+        const char* next_s;
+        if (c < 0x80)
+            next_s = s + 1;
+        else
+            next_s = s + ImTextCharFromUtf8(&c, s, text_end);
+        if (c == 0)
+            break;
+
+        if (c < 32)
+        {
+            if (c == '\n')
+            {
+                line_width = word_width = blank_width = 0.0f;
+                inside_word = true;
+                s = next_s;
+                continue;
+            }
+            if (c == '\r')
+            {
+                s = next_s;
+                continue;
+            }
+        }
+
+        const float char_width = font->GetCharAdvance((ImWchar)c);
+        if (ImCharIsBlankW(c))
+        {
+            if (inside_word)
+            {
+                line_width += blank_width;
+                blank_width = 0.0f;
+                word_end = s;
+            }
+            blank_width += char_width;
+            inside_word = false;
+        }
+        else
+        {
+            word_width += char_width;
+            if (inside_word)
+            {
+                word_end = next_s;
+            }
+            else
+            {
+                prev_word_end = word_end;
+                line_width += word_width + blank_width;
+                word_width = blank_width = 0.0f;
+            }
+
+            // Allow wrapping after punctuation.
+            inside_word = (c != '.' && c != ',' && c != ';' && c != '!' && c != '?' && c != '\"');
+        }
+
+        // We ignore blank width at the end of the line (they can be skipped)
+        if (line_width + word_width > wrap_width)
+        {
+            // Words that cannot possibly fit within an entire line will be cut anywhere.
+            if (word_width < wrap_width)
+                s = prev_word_end ? prev_word_end : word_end;
+            break;
+        }
+
+        s = next_s;
+    }
+
+    return s;
+}
+
+static ImVec2 referenceCalcTextSize(ImFont const* font, float size, float max_width, float wrap_width, const char* text_begin, const char* text_end, const char** remaining)
+{
+    if (!text_end)
+        text_end = text_begin + strlen(text_begin); // FIXME-OPT: Need to avoid this.
+
+    const float line_height = size;
+    const float scale = size / font->FontSize;
+
+    ImVec2 text_size = ImVec2(0, 0);
+    float line_width = 0.0f;
+
+    const bool word_wrap_enabled = (wrap_width > 0.0f);
+    const char* word_wrap_eol = NULL;
+
+    const char* s = text_begin;
+    while (s < text_end)
+    {
+        if (word_wrap_enabled)
+        {
+            // Calculate how far we can render. Requires two passes on the string data but keeps the code simple and not intrusive for what's essentially an uncommon feature.
+            if (!word_wrap_eol)
+            {
+                word_wrap_eol = referenceWordWrapPosition(font, scale, s, text_end, wrap_width - line_width);
+                if (word_wrap_eol == s) // Wrap_width is too small to fit anything. Force displaying 1 character to minimize the height discontinuity.
+                    word_wrap_eol++;    // +1 may not be a character start point in UTF-8 but it's ok because we use s >= word_wrap_eol below
+            }
+
+            if (s >= word_wrap_eol)
+            {
+                if (text_size.x < line_width)
+                    text_size.x = line_width;
+                text_size.y += line_height;
+                line_width = 0.0f;
+                word_wrap_eol = NULL;
+
+                // Wrapping skips upcoming blanks
+                while (s < text_end)
+                {
+                    const char c = *s;
+                    if (ImCharIsBlankA(c)) { s++; } else if (c == '\n') { s++; break; } else { break; }
+                }
+                continue;
+            }
+        }
+
+        // Decode and advance source
+        const char* prev_s = s;
+        unsigned int c = (unsigned int)*s;
+        if (c < 0x80)
+        {
+            s += 1;
+        }
+        else
+        {
+            s += ImTextCharFromUtf8(&c, s, text_end);
+            if (c == 0) // Malformed UTF-8?
+                break;
+        }
+
+        if (c < 32)
+        {
+            if (c == '\n')
+            {
+                text_size.x = ImMax(text_size.x, line_width);
+                text_size.y += line_height;
+                line_width = 0.0f;
+                continue;
+            }
+            if (c == '\r')
+                continue;
+        }
+
+        const float char_width = font->GetCharAdvance((ImWchar)c) * scale;
+        if (line_width + char_width >= max_width)
+        {
+            s = prev_s;
+            break;
+        }
+
+        line_width += char_width;
+    }
+
+    if (text_size.x < line_width)
+        text_size.x = line_width;
+
+    if (line_width > 0 || text_size.y == 0.0f)
+        text_size.y += line_height;
+
+    if (remaining)
+        *remaining = s;
+
+    return text_size;
+}
+
+// Note: as with every ImDrawList drawing function, this expects that the font atlas texture is bound.
+static void referenceRenderText(ImFont const* font, ImDrawList* draw_list, float size, const ImVec2& pos, ImU32 col, const ImVec4& clip_rect, const char* text_begin, const char* text_end, float wrap_width, bool cpu_fine_clip)
+{
+    if (!text_end)
+        text_end = text_begin + strlen(text_begin); // ImGui:: functions generally already provides a valid text_end, so this is merely to handle direct calls.
+
+    // Align to be pixel perfect
+    float x = IM_FLOOR(pos.x);
+    float y = IM_FLOOR(pos.y);
+    if (y > clip_rect.w)
+        return;
+
+    const float start_x = x;
+    const float scale = size / font->FontSize;
+    const float line_height = font->FontSize * scale;
+    const bool word_wrap_enabled = (wrap_width > 0.0f);
+    const char* word_wrap_eol = NULL;
+
+    // Fast-forward to first visible line
+    const char* s = text_begin;
+    if (y + line_height < clip_rect.y && !word_wrap_enabled)
+        while (y + line_height < clip_rect.y && s < text_end)
+        {
+            s = (const char*)memchr(s, '\n', text_end - s);
+            s = s ? s + 1 : text_end;
+            y += line_height;
+        }
+
+    // For large text, scan for the last visible line in order to avoid over-reserving in the call to PrimReserve()
+    // Note that very large horizontal line will still be affected by the issue (e.g. a one megabyte string buffer without a newline will likely crash atm)
+    if (text_end - s > 10000 && !word_wrap_enabled)
+    {
+        const char* s_end = s;
+        float y_end = y;
+        while (y_end < clip_rect.w && s_end < text_end)
+        {
+            s_end = (const char*)memchr(s_end, '\n', text_end - s_end);
+            s_end = s_end ? s_end + 1 : text_end;
+            y_end += line_height;
+        }
+        text_end = s_end;
+    }
+    if (s == text_end)
+        return;
+
+    // Reserve vertices for remaining worse case (over-reserving is useful and easily amortized)
+    const int vtx_count_max = (int)(text_end - s) * 4;
+    const int idx_count_max = (int)(text_end - s) * 6;
+    const int idx_expected_size = draw_list->IdxBuffer.Size + idx_count_max;
+    draw_list->PrimReserve(idx_count_max, vtx_count_max);
+
+    ImDrawVert* vtx_write = draw_list->_VtxWritePtr;
+    ImDrawIdx* idx_write = draw_list->_IdxWritePtr;
+    unsigned int vtx_current_idx = draw_list->_VtxCurrentIdx;
+
+    const ImU32 col_untinted = col | ~IM_COL32_A_MASK;
+
+    while (s < text_end)
+    {
+        if (word_wrap_enabled)
+        {
+            // Calculate how far we can render. Requires two passes on the string data but keeps the code simple and not intrusive for what's essentially an uncommon feature.
+            if (!word_wrap_eol)
+            {
+                word_wrap_eol = referenceWordWrapPosition(font, scale, s, text_end, wrap_width - (x - start_x));
+                if (word_wrap_eol == s) // Wrap_width is too small to fit anything. Force displaying 1 character to minimize the height discontinuity.
+                    word_wrap_eol++;    // +1 may not be a character start point in UTF-8 but it's ok because we use s >= word_wrap_eol below
+            }
+
+            if (s >= word_wrap_eol)
+            {
+                x = start_x;
+                y += line_height;
+                word_wrap_eol = NULL;
+
+                // Wrapping skips upcoming blanks
+                while (s < text_end)
+                {
+                    const char c = *s;
+                    if (ImCharIsBlankA(c)) { s++; } else if (c == '\n') { s++; break; } else { break; }
+                }
+                continue;
+            }
+        }
+
+        // Decode and advance source
+        unsigned int c = (unsigned int)*s;
+        if (c < 0x80)
+        {
+            s += 1;
+        }
+        else
+        {
+            s += ImTextCharFromUtf8(&c, s, text_end);
+            if (c == 0) // Malformed UTF-8?
+                break;
+        }
+
+        if (c < 32)
+        {
+            if (c == '\n')
+            {
+                x = start_x;
+                y += line_height;
+                if (y > clip_rect.w)
+                    break; // break out of main loop
+                continue;
+            }
+            if (c == '\r')
+                continue;
+        }
+
+        const ImFontGlyph* glyph = font->FindGlyph((ImWchar)c);
+        if (glyph == NULL)
+            continue;
+
+        float char_width = glyph->AdvanceX * scale;
+        if (glyph->Visible)
+        {
+            // We don't do a second finer clipping test on the Y axis as we've already skipped anything before clip_rect.y and exit once we pass clip_rect.w
+            float x1 = x + glyph->X0 * scale;
+            float x2 = x + glyph->X1 * scale;
+            float y1 = y + glyph->Y0 * scale;
+            float y2 = y + glyph->Y1 * scale;
+            if (x1 <= clip_rect.z && x2 >= clip_rect.x)
+            {
+                // Render a character
+                float u1 = glyph->U0;
+                float v1 = glyph->V0;
+                float u2 = glyph->U1;
+                float v2 = glyph->V1;
+
+                // CPU side clipping used to fit text in their frame when the frame is too small. Only does clipping for axis aligned quads.
+                if (cpu_fine_clip)
+                {
+                    if (x1 < clip_rect.x)
+                    {
+                        u1 = u1 + (1.0f - (x2 - clip_rect.x) / (x2 - x1)) * (u2 - u1);
+                        x1 = clip_rect.x;
+                    }
+                    if (y1 < clip_rect.y)
+                    {
+                        v1 = v1 + (1.0f - (y2 - clip_rect.y) / (y2 - y1)) * (v2 - v1);
+                        y1 = clip_rect.y;
+                    }
+                    if (x2 > clip_rect.z)
+                    {
+                        u2 = u1 + ((clip_rect.z - x1) / (x2 - x1)) * (u2 - u1);
+                        x2 = clip_rect.z;
+                    }
+                    if (y2 > clip_rect.w)
+                    {
+                        v2 = v1 + ((clip_rect.w - y1) / (y2 - y1)) * (v2 - v1);
+                        y2 = clip_rect.w;
+                    }
+                    if (y1 >= y2)
+                    {
+                        x += char_width;
+                        continue;
+                    }
+                }
+
+                // Support for untinted glyphs
+                ImU32 glyph_col = glyph->Colored ? col_untinted : col;
+
+                // We are NOT calling PrimRectUV() here because non-inlined causes too much overhead in a debug builds. Inlined here:
+                {
+                    idx_write[0] = (ImDrawIdx)(vtx_current_idx); idx_write[1] = (ImDrawIdx)(vtx_current_idx+1); idx_write[2] = (ImDrawIdx)(vtx_current_idx+2);
+                    idx_write[3] = (ImDrawIdx)(vtx_current_idx); idx_write[4] = (ImDrawIdx)(vtx_current_idx+2); idx_write[5] = (ImDrawIdx)(vtx_current_idx+3);
+                    vtx_write[0].pos.x = x1; vtx_write[0].pos.y = y1; vtx_write[0].col = glyph_col; vtx_write[0].uv.x = u1; vtx_write[0].uv.y = v1;
+                    vtx_write[1].pos.x = x2; vtx_write[1].pos.y = y1; vtx_write[1].col = glyph_col; vtx_write[1].uv.x = u2; vtx_write[1].uv.y = v1;
+                    vtx_write[2].pos.x = x2; vtx_write[2].pos.y = y2; vtx_write[2].col = glyph_col; vtx_write[2].uv.x = u2; vtx_write[2].uv.y = v2;
+                    vtx_write[3].pos.x = x1; vtx_write[3].pos.y = y2; vtx_write[3].col = glyph_col; vtx_write[3].uv.x = u1; vtx_write[3].uv.y = v2;
+                    vtx_write += 4;
+                    vtx_current_idx += 4;
+                    idx_write += 6;
+                }
+            }
+        }
+        x += char_width;
+    }
+
+    // Give back unused vertices (clipped ones, blanks) ~ this is essentially a PrimUnreserve() action.
+    draw_list->VtxBuffer.Size = (int)(vtx_write - draw_list->VtxBuffer.Data); // Same as calling shrink()
+    draw_list->IdxBuffer.Size = (int)(idx_write - draw_list->IdxBuffer.Data);
+    draw_list->CmdBuffer[draw_list->CmdBuffer.Size - 1].ElemCount -= (idx_expected_size - draw_list->IdxBuffer.Size);
+    draw_list->_VtxWritePtr = vtx_write;
+    draw_list->_IdxWritePtr = idx_write;
+    draw_list->_VtxCurrentIdx = vtx_current_idx;
+}
+
+//--------------------------------------------------------------------------------------
+// Text blocks
+//--------------------------------------------------------------------------------------
+
+static char const* const Words[] = {
+    "the", "frame", "graph", "render", "pass", "texture", "upload", "shader", "buffer", "queue", "a", "of", "to", "in",
+    "descriptor", "allocation", "swapchain", "present", "latency", "budget", "material", "mip", "cache", "job", "worker",
+};
+static char const* const Punctuation[] = { ".", ",", ";", "!", "?", "\"", ":", "'", "(", ")" };
+static char const* const NonAscii[] = { "\xC3\xA9", "\xC3\xBC", "\xE2\x80\x94", "\xC2\xB0", "\xE2\x80\xA6", "\xE6\x97\xA5", "\xC3\x9F" };
+
+static std::string makeText(char const* kind, size_t bytes)
+{
+    std::mt19937 rng(1234);
+    auto pick = [&rng](int n) { return static_cast<int>(rng() % static_cast<unsigned>(n)); };
+    std::string text;
+    text.reserve(bytes + 256);
+    char line[64];
+    for (int lineIndex = 0; text.size() < bytes; lineIndex++)
+    {
+        if (!strcmp(kind, "log"))
+        {
+            snprintf(line, sizeof(line), "[%02d:%02d:%02d.%03d] [%s] ", lineIndex / 3600 % 24, lineIndex / 60 % 60, lineIndex % 60, pick(1000),
+                pick(4) == 0 ? "warn" : "info");
+            text += line;
+            for (int n = 4 + pick(16); n > 0; n--)
+            {
+                text += Words[pick(IM_ARRAYSIZE(Words))];
+                text += pick(5) == 0 ? "=" + std::to_string(pick(100000)) : "";
+                text += n > 1 ? " " : "";
+            }
+            text += "\n";
+        }
+        else if (!strcmp(kind, "prose"))
+        {
+            // paragraphs, wrapped by the renderer
+            for (int n = 40 + pick(120); n > 0; n--)
+            {
+                text += Words[pick(IM_ARRAYSIZE(Words))];
+                if (pick(8) == 0)
+                    text += Punctuation[pick(IM_ARRAYSIZE(Punctuation))];
+                text += n > 1 ? " " : "";
+            }
+            text += "\n\n";
+        }
+        else if (!strcmp(kind, "code"))
+        {
+            text.append(static_cast<size_t>(pick(4)), '\t');
+            text += Words[pick(IM_ARRAYSIZE(Words))];
+            text += "(";
+            text += Words[pick(IM_ARRAYSIZE(Words))];
+            text += ", 0x" + std::to_string(pick(65536)) + ");\r\n";
+        }
+        else // mixed
+        {
+            for (int n = 6 + pick(20); n > 0; n--)
+            {
+                std::string word = Words[pick(IM_ARRAYSIZE(Words))];
+                if (pick(3) == 0)
+                    word.insert(static_cast<size_t>(pick(static_cast<int>(word.size()) + 1)), NonAscii[pick(IM_ARRAYSIZE(NonAscii))]);
+                text += word;
+                text += n > 1 ? " " : "";
+            }
+            text += "\n";
+        }
+    }
+    return text;
+}
+
+static std::vector<std::pair<size_t, size_t>> splitLines(std::string const& text)
+{
+    std::vector<std::pair<size_t, size_t>> lines;
+    for (size_t begin = 0; begin < text.size();)
+    {
+        size_t end = text.find('\n', begin);
+        end = end == std::string::npos ? text.size() : end + 1;
+        lines.emplace_back(begin, end);
+        begin = end;
+    }
+    return lines;
+}
+
+//--------------------------------------------------------------------------------------
+// Checks
+//--------------------------------------------------------------------------------------
+
+static bool sameVec2(ImVec2 a, ImVec2 b)
+{
+    return memcmp(&a, &b, sizeof(ImVec2)) == 0;
+}
+
+static void resetDrawList(ImDrawList& list, ImFont const* font)
+{
+    list._ResetForNewFrame();
+    list.PushClipRectFullScreen();
+    list.PushTextureID(font->ContainerAtlas->TexID);
+}
+
+static bool sameDrawList(ImDrawList const& a, ImDrawList const& b)
+{
+    return a.VtxBuffer.Size == b.VtxBuffer.Size && a.IdxBuffer.Size == b.IdxBuffer.Size &&
+        memcmp(a.VtxBuffer.Data, b.VtxBuffer.Data, (size_t)a.VtxBuffer.size_in_bytes()) == 0 &&
+        memcmp(a.IdxBuffer.Data, b.IdxBuffer.Data, (size_t)a.IdxBuffer.size_in_bytes()) == 0 &&
+        a.CmdBuffer.back().ElemCount == b.CmdBuffer.back().ElemCount;
+}
+
+// Renders chunks of about chunkBytes (whole lines) so that a chunk stays under 64K vertices
+template<typename Render>
+static void renderChunks(ImDrawList& list, ImFont const* font, std::string const& text, size_t chunkBytes, Render render)
+{
+    for (size_t begin = 0; begin < text.size();)
+    {
+        size_t end = std::min(text.size(), begin + chunkBytes);
+        size_t newline = text.find('\n', end);
+        end = newline == std::string::npos ? text.size() : newline + 1;
+        resetDrawList(list, font);
+        render(text.data() + begin, text.data() + end);
+        begin = end;
+    }
+}
+
+struct RenderCase
+{
+    char const* name;
+    float wrapWidth;
+    ImVec4 clipRect;
+    bool cpuFineClip;
+};
+
+static void checkText(ImFont const* font, char const* kind, std::string const& text)
+{
+    float const size = font->FontSize;
+    char const* begin = text.data();
+    char const* end = begin + text.size();
+    int failures = 0;
+
+    // whole block, wrapped or not
+    for (float wrapWidth : { 0.0f, 600.0f, 37.0f })
+    {
+        char const* remainingRef = nullptr;
+        char const* remaining = nullptr;
+        ImVec2 ref = referenceCalcTextSize(font, size, FLT_MAX, wrapWidth, begin, end, &remainingRef);
+        ImVec2 fast = font->CalcTextSizeA(size, FLT_MAX, wrapWidth, begin, end, &remaining);
+        failures += (!sameVec2(ref, fast) || remaining != remainingRef) ? 1 : 0;
+    }
+
+    // every line, with a max_width and at another size; every wrap position
+    for (auto const& line : splitLines(text))
+    {
+        char const* lineBegin = begin + line.first;
+        char const* lineEnd = begin + line.second;
+        for (float maxWidth : { FLT_MAX, 300.0f, 11.0f })
+        {
+            char const* remainingRef = nullptr;
+            char const* remaining = nullptr;
+            ImVec2 ref = referenceCalcTextSize(font, size * 1.3f, maxWidth, 0.0f, lineBegin, lineEnd, &remainingRef);
+            ImVec2 fast = font->CalcTextSizeA(size * 1.3f, maxWidth, 0.0f, lineBegin, lineEnd, &remaining);
+            failures += (!sameVec2(ref, fast) || remaining != remainingRef) ? 1 : 0;
+        }
+        for (float wrapWidth : { 200.0f, 45.0f })
+            failures += referenceWordWrapPosition(font, 1.0f, lineBegin, lineEnd, wrapWidth) != font->CalcWordWrapPositionA(1.0f, lineBegin, lineEnd, wrapWidth) ? 1 : 0;
+    }
+
+    // vertices, chunked to stay within 16-bit indices
+    RenderCase const cases[] = {
+        { "plain", 0.0f, ImVec4(0, 0, 1e6f, 1e6f), false },
+        { "clipped", 0.0f, ImVec4(30.5f, 40.0f, 330.25f, 700.0f), false },
+        { "fine clip", 0.0f, ImVec4(30.5f, 40.0f, 330.25f, 700.0f), true },
+        { "wrapped", 500.0f, ImVec4(0, 0, 1e6f, 1e6f), false },
+    };
+    ImDrawList listRef(ImGui::GetDrawListSharedData());
+    ImDrawList list(ImGui::GetDrawListSharedData());
+    for (RenderCase const& c : cases)
+    {
+        std::vector<ImDrawVert> vtxRef, vtx;
+        renderChunks(listRef, font, text, 2000, [&](char const* b, char const* e) {
+            referenceRenderText(font, &listRef, size, ImVec2(10.3f, 20.7f), IM_COL32(200, 210, 220, 255), c.clipRect, b, e, c.wrapWidth, c.cpuFineClip);
+            resetDrawList(list, font);
+            font->RenderText(&list, size, ImVec2(10.3f, 20.7f), IM_COL32(200, 210, 220, 255), c.clipRect, b, e, c.wrapWidth, c.cpuFineClip);
+            if (!sameDrawList(listRef, list))
+            {
+                if (failures++ == 0)
+                    printf("  %s: RenderText %s differs\n", kind, c.name);
+            }
+        });
+    }
+    listRef._ClearFreeMemory();
+    list._ClearFreeMemory();
+
+    printf("  %-6s %zu bytes checked, %d differences\n", kind, text.size(), failures);
+    check(failures == 0, "fast path gives the same sizes, wrap positions and vertices");
+}
+
+//--------------------------------------------------------------------------------------
+// Benchmark
+//--------------------------------------------------------------------------------------
+
+template<typename Fn>
+static double bestMs(int runs, Fn fn)
+{
+    double best = 1e30;
+    for (int i = 0; i < runs; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+static volatile float sink;
+
+static void benchText(ImFont const* font, char const* kind, std::string const& text, int runs)
+{
+    float const size = font->FontSize;
+    char const* begin = text.data();
+    char const* end = begin + text.size();
+    double const mb = text.size() / (1024.0 * 1024.0);
+    auto report = [mb](char const* what, double refMs, double fastMs) {
+        printf("    %-26s %8.2f ms %7.0f MB/s -> %8.2f ms %7.0f MB/s  x%.2f\n", what, refMs, mb * 1000.0 / refMs, fastMs, mb * 1000.0 / fastMs, refMs / fastMs);
+    };
+
+    printf("  %s:\n", kind);
+    report("CalcTextSizeA",
+        bestMs(runs, [&] { sink = referenceCalcTextSize(font, size, FLT_MAX, 0.0f, begin, end, nullptr).x; }),
+        bestMs(runs, [&] { sink = font->CalcTextSizeA(size, FLT_MAX, 0.0f, begin, end, nullptr).x; }));
+    report("CalcTextSizeA wrapped",
+        bestMs(runs, [&] { sink = referenceCalcTextSize(font, size, FLT_MAX, 600.0f, begin, end, nullptr).y; }),
+        bestMs(runs, [&] { sink = font->CalcTextSizeA(size, FLT_MAX, 600.0f, begin, end, nullptr).y; }));
+
+    ImDrawList list(ImGui::GetDrawListSharedData());
+    ImVec4 const clip(0, 0, 1e6f, 1e6f);
+    report("RenderText",
+        bestMs(runs, [&] { renderChunks(list, font, text, 2000, [&](char const* b, char const* e) { referenceRenderText(font, &list, size, ImVec2(0, 0), IM_COL32_WHITE, clip, b, e, 0.0f, false); }); }),
+        bestMs(runs, [&] { renderChunks(list, font, text, 2000, [&](char const* b, char const* e) { font->RenderText(&list, size, ImVec2(0, 0), IM_COL32_WHITE, clip, b, e, 0.0f, false); }); }));
+    report("RenderText wrapped",
+        bestMs(runs, [&] { renderChunks(list, font, text, 2000, [&](char const* b, char const* e) { referenceRenderText(font, &list, size, ImVec2(0, 0), IM_COL32_WHITE, clip, b, e, 600.0f, false); }); }),
+        bestMs(runs, [&] { renderChunks(list, font, text, 2000, [&](char const* b, char const* e) { font->RenderText(&list, size, ImVec2(0, 0), IM_COL32_WHITE, clip, b, e, 600.0f, false); }); }));
+    list._ClearFreeMemory();
+}
+
+int main(int argc, char** argv)
+{
+    char const* fontPath = nullptr;
+    double sizeMB = 1.0;
+    int runs = 5;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--font") && i + 1 < argc)
+            fontPath = argv[++i];
+        else if (!strcmp(argv[i], "--size") && i + 1 < argc)
+            sizeMB = std::max(0.01, atof(argv[++i]));
+        else if (!strcmp(argv[i], "--runs") && i + 1 < argc)
+            runs = std::max(1, atoi(argv[++i]));
+    }
+
+    std::vector<unsigned char> fontData;
+    if (fontPath && (fontData = readFile(fontPath)).empty())
+    {
+        printf("can't read %s\n", fontPath);
+        return 1;
+    }
+
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    ImFontConfig config;
+    config.FontDataOwnedByAtlas = false;
+    static ImWchar const ranges[] = { 0x0020, 0x00FF, 0x2000, 0x206F, 0x3000, 0x30FF, 0x4E00, 0x9FAF, 0 };
+    ImFont* font = fontPath ? io.Fonts->AddFontFromMemoryTTF(fontData.data(), static_cast<int>(fontData.size()), 16.0f, &config, ranges) : io.Fonts->AddFontDefault();
+    ImFontConfig dynamicConfig = config;
+    dynamicConfig.DynamicGlyphs = true;
+    ImFont* dynamicFont = fontPath ? io.Fonts->AddFontFromMemoryTTF(fontData.data(), static_cast<int>(fontData.size()), 16.0f, &dynamicConfig, ranges) : nullptr;
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    ImGui::GetDrawListSharedData()->Font = font;
+    ImGui::GetDrawListSharedData()->TexUvWhitePixel = io.Fonts->TexUvWhitePixel;
+
+    char const* const kinds[] = { "log", "prose", "code", "mixed" };
+    std::vector<std::string> texts;
+    for (char const* kind : kinds)
+        texts.push_back(makeText(kind, static_cast<size_t>(sizeMB * 1024 * 1024)));
+
+    printf("%s, %.0f px\n", fontPath ? fontPath : "ProggyClean", font->FontSize);
+    for (size_t i = 0; i < texts.size(); i++)
+        checkText(font, kinds[i], texts[i]);
+    if (dynamicFont)
+    {
+        printf("ImFontConfig::DynamicGlyphs (second pass, glyphs loaded):\n");
+        for (size_t i = 0; i < texts.size(); i++)
+        {
+            dynamicFont->CalcTextSizeA(16.0f, FLT_MAX, 0.0f, texts[i].data(), texts[i].data() + texts[i].size());
+            checkText(dynamicFont, kinds[i], texts[i]);
+        }
+    }
+
+    printf("reference -> fast path, best of %d:\n", runs);
+    for (size_t i = 0; i < texts.size(); i++)
+        benchText(font, kinds[i], texts[i], runs);
+
+    ImGui::DestroyContext();
+    printf(ok ? "ok\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
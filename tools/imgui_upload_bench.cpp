@@ -0,0 +1,338 @@
+//--------------------------------------------------------------------------------------
+// Checks and benchmark of the DX11 backend's vertex/index upload planning
+// (imgui_impl_dx11_upload.h), on headless frames of a GUI like the app's: a settings
+// window and a profiler whose numbers change every frame, and a static help window.
+// Buffers are plain memory here: on every frame each draw list's region must hold its
+// current vertices and indices, and a NO_OVERWRITE upload must not touch a region the
+// last two frames drew from. Reports bytes uploaded, reallocations and wrap arounds for
+// the upstream discard-every-frame mode, the ring and the ring skipping unchanged lists,
+// and the reallocations of growing draw data against the old fixed +5000/+10000 slack.
+// The copies go to cached memory, not write-combined upload heaps, so their times only
+// compare the modes with each other.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -I.. imgui_upload_bench.cpp ../imgui.cpp ../imgui_draw.cpp ../imgui_widgets.cpp ../imgui_tables.cpp -o imgui_upload_bench
+//
+// Usage:
+//   imgui_upload_bench [--frames n]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+#include "imgui_impl_dx11_upload.h"
+
+static bool ok = true;
+
+static void check(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+}
+
+struct AppState
+{
+    float stats[16] = {};
+    float history[120] = {};
+    int helpLines = 40;
+    int extraRects = 0;
+};
+
+static void buildGUI(AppState const& app)
+{
+    ImGui::NewFrame();
+
+    ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_Always);
+    ImGui::SetNextWindowSize(ImVec2(420, 640), ImGuiCond_Always);
+    ImGui::Begin("PBR Setting");
+    for (int h = 0; h < 8; h++)
+        ImGui::Text("Value %d: %.2f ms, p95 %.2f ms", h, app.stats[h * 2], app.stats[h * 2 + 1]);
+    ImGui::End();
+
+    ImGui::SetNextWindowPos(ImVec2(450, 10), ImGuiCond_Always);
+    ImGui::SetNextWindowSize(ImVec2(700, 300), ImGuiCond_Always);
+    ImGui::Begin("Profiler");
+    ImGui::PlotLines("Frame", app.history, 120, 0, NULL, 0.0f, 20.0f, ImVec2(0, 120));
+    ImGui::End();
+
+    // long and static, grows in the growth run
+    ImGui::SetNextWindowPos(ImVec2(450, 320), ImGuiCond_Always);
+    ImGui::SetNextWindowSize(ImVec2(700, 380), ImGuiCond_Always);
+    ImGui::Begin("Help");
+    for (int i = 0; i < app.helpLines; i++)
+        ImGui::Text("Line %d: WASD moves the camera, the mouse looks around, F1 toggles this help.", i);
+    auto drawList = ImGui::GetWindowDrawList();
+    for (int i = 0; i < app.extraRects; i++)
+        drawList->AddRectFilled(ImVec2(460.0f + i % 600, 330.0f + i % 300), ImVec2(470.0f + i % 600, 340.0f + i % 300), IM_COL32(255, 0, 0, 64));
+    ImGui::End();
+
+    ImGui::Render();
+}
+
+static void tick(AppState& app, int frame)
+{
+    for (int i = 0; i < 16; i++)
+        app.stats[i] = 5.0f + (float)((frame * 7 + i * 13) % 100) * 0.01f;
+    app.history[frame % 120] = 5.0f + (float)(frame % 17);
+}
+
+struct Range
+{
+    int vtxBegin, vtxEnd, idxBegin, idxEnd;
+};
+
+// what the backend does with D3D buffers, on memory
+struct FakeBuffers
+{
+    std::vector<ImDrawVert> vtx;
+    std::vector<ImDrawIdx> idx;
+    // regions drawn by the last two frames, still in flight on a GPU
+    std::vector<Range> inFlight[2];
+    bool safe = true;
+    bool intact = true;
+
+    // before the timed copy
+    void map(ImGui_ImplDX11_UploadPlan const& plan)
+    {
+        if (plan.Reallocate)
+        {
+            vtx.assign(plan.VtxCapacity, ImDrawVert());
+            idx.assign(plan.IdxCapacity, 0);
+        }
+        if (plan.Stats.FrameUploadedBytes != 0 && plan.Discard)
+        {
+            // a renamed buffer has undefined contents, and what the GPU reads is in the old one
+            std::fill(vtx.begin(), vtx.end(), ImDrawVert{ ImVec2(-1, -1), ImVec2(-1, -1), 0xCDCDCDCD });
+            std::fill(idx.begin(), idx.end(), (ImDrawIdx)0xCDCD);
+            inFlight[0].clear();
+            inFlight[1].clear();
+        }
+        for (auto const& placement : plan.Lists)
+            if (placement.Upload)
+                for (auto const& frame : inFlight)
+                    for (auto const& range : frame)
+                    {
+                        safe &= placement.VtxCount == 0 || placement.VtxOffset + placement.VtxCount <= range.vtxBegin || placement.VtxOffset >= range.vtxEnd;
+                        safe &= placement.IdxCount == 0 || placement.IdxOffset + placement.IdxCount <= range.idxBegin || placement.IdxOffset >= range.idxEnd;
+                    }
+    }
+
+    // what the backend does between Map and Unmap
+    void copy(ImGui_ImplDX11_UploadPlan const& plan)
+    {
+        for (auto const& placement : plan.Lists)
+        {
+            if (!placement.Upload)
+                continue;
+            memcpy(vtx.data() + placement.VtxOffset, placement.List->VtxBuffer.Data, placement.VtxCount * sizeof(ImDrawVert));
+            memcpy(idx.data() + placement.IdxOffset, placement.List->IdxBuffer.Data, placement.IdxCount * sizeof(ImDrawIdx));
+        }
+    }
+
+    // after the frame is drawn
+    void verify(ImGui_ImplDX11_UploadPlan const& plan)
+    {
+        inFlight[1].swap(inFlight[0]);
+        inFlight[0].clear();
+        for (auto const& placement : plan.Lists)
+        {
+            inFlight[0].push_back({ placement.VtxOffset, placement.VtxOffset + placement.VtxCount, placement.IdxOffset, placement.IdxOffset + placement.IdxCount });
+            intact &= placement.VtxOffset + placement.VtxCount <= (int)vtx.size() && placement.IdxOffset + placement.IdxCount <= (int)idx.size() &&
+                !memcmp(vtx.data() + placement.VtxOffset, placement.List->VtxBuffer.Data, placement.VtxCount * sizeof(ImDrawVert)) &&
+                !memcmp(idx.data() + placement.IdxOffset, placement.List->IdxBuffer.Data, placement.IdxCount * sizeof(ImDrawIdx));
+        }
+    }
+
+    void apply(ImGui_ImplDX11_UploadPlan const& plan)
+    {
+        map(plan);
+        copy(plan);
+        verify(plan);
+    }
+};
+
+struct Mode
+{
+    char const* name;
+    bool ring;
+    bool skipUnchanged;
+};
+
+using Clock = std::chrono::steady_clock;
+
+static void run(Mode const& mode, int frames)
+{
+    AppState app;
+    ImGui_ImplDX11_UploadPlan plan;
+    plan.Ring = mode.ring;
+    plan.SkipUnchanged = mode.skipUnchanged;
+    FakeBuffers buffers;
+    double us = 0.0;
+    int skipped = 0;
+    for (int f = 0; f < frames; f++)
+    {
+        tick(app, f);
+        buildGUI(app);
+        auto start = Clock::now();
+        plan.Plan(ImGui::GetDrawData());
+        auto planned = Clock::now();
+        buffers.map(plan);
+        auto mapped = Clock::now();
+        buffers.copy(plan);
+        us += std::chrono::duration<double, std::micro>(planned - start + Clock::now() - mapped).count();
+        buffers.verify(plan);
+        skipped += plan.Stats.FrameSkippedLists;
+    }
+    auto const& stats = plan.Stats;
+    printf("  %-12s %6.1f KB/frame, %4.2f of %d lists skipped, %d reallocations, %4d wraps, %6.1f us/frame\n",
+        mode.name, stats.TotalUploadedBytes / 1024.0 / frames, (double)skipped / frames,
+        stats.FrameUploadedLists + stats.FrameSkippedLists, stats.Reallocations, stats.Discards, us / frames);
+    check(buffers.intact, "every list's region holds its data");
+    check(buffers.safe, "no write to a region in flight");
+}
+
+// draw data growing by 40 vertices every frame
+static void growth(int frames)
+{
+    AppState app;
+    ImGui_ImplDX11_UploadPlan plan;
+    plan.Ring = true;
+    FakeBuffers buffers;
+    int oldVtxSize = 5000, oldIdxSize = 10000, oldReallocations = 0;
+    for (int f = 0; f < frames; f++)
+    {
+        tick(app, f);
+        app.extraRects = f * 10;
+        buildGUI(app);
+        auto drawData = ImGui::GetDrawData();
+        plan.Plan(drawData);
+        buffers.apply(plan);
+        // the backend before the ring
+        if (oldVtxSize < drawData->TotalVtxCount)
+        {
+            oldVtxSize = drawData->TotalVtxCount + 5000;
+            oldReallocations++;
+        }
+        if (oldIdxSize < drawData->TotalIdxCount)
+        {
+            oldIdxSize = drawData->TotalIdxCount + 10000;
+            oldReallocations++;
+        }
+    }
+    auto drawData = ImGui::GetDrawData();
+    printf("  growing to %d vertices: %d buffer creations with fixed slack, %d with geometric growth\n",
+        drawData->TotalVtxCount, oldReallocations, plan.Stats.Reallocations);
+    check(buffers.intact, "growing lists keep their data");
+    check(buffers.safe, "growing lists don't overwrite in flight regions");
+}
+
+static void checkEdges()
+{
+    AppState app;
+    ImGui_ImplDX11_UploadPlan plan;
+    plan.Ring = plan.SkipUnchanged = true;
+    FakeBuffers buffers;
+
+    tick(app, 0);
+    buildGUI(app);
+    plan.Plan(ImGui::GetDrawData());
+    buffers.apply(plan);
+    check(plan.Reallocate && plan.Discard, "first frame creates the buffers");
+    // windows are hidden on their first frame
+    for (int f = 0; f < 3; f++)
+    {
+        buildGUI(app);
+        plan.Plan(ImGui::GetDrawData());
+        buffers.apply(plan);
+    }
+
+    // the same frame again: only the lists that changed are copied, after the previous data
+    buildGUI(app);
+    int cursor = plan.VtxCursor;
+    plan.Plan(ImGui::GetDrawData());
+    buffers.apply(plan);
+    check(!plan.Discard && plan.Stats.FrameUploadedLists < plan.Lists.Size, "unchanged lists are skipped");
+    bool appended = true;
+    for (auto const& placement : plan.Lists)
+        appended &= !placement.Upload || placement.VtxOffset >= cursor;
+    check(appended, "uploads are appended");
+
+    // a window going away and coming back
+    app.helpLines = 0;
+    buildGUI(app);
+    plan.Plan(ImGui::GetDrawData());
+    buffers.apply(plan);
+    app.helpLines = 40;
+    buildGUI(app);
+    plan.Plan(ImGui::GetDrawData());
+    buffers.apply(plan);
+
+    // losing the device
+    plan.Reset();
+    buildGUI(app);
+    plan.Plan(ImGui::GetDrawData());
+    buffers.apply(plan);
+    check(plan.Reallocate, "buffers are created again after a reset");
+
+    // an empty frame
+    ImGui::NewFrame();
+    ImGui::Render();
+    plan.Plan(ImGui::GetDrawData());
+    buffers.apply(plan);
+    check(plan.Stats.FrameUploadedBytes == 0, "nothing to upload");
+
+    check(buffers.intact, "edge cases keep every region intact");
+    check(buffers.safe, "edge cases don't overwrite in flight regions");
+}
+
+int main(int argc, char* argv[])
+{
+    int frames = 2000;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--frames") && i + 1 < argc)
+            frames = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [--frames n]\n", argv[0]);
+            return 1;
+        }
+    }
+    frames = std::max(frames, 1);
+
+    ImGui::CreateContext();
+    auto& io = ImGui::GetIO();
+    io.IniFilename = NULL;
+    io.DisplaySize = ImVec2(1280, 720);
+    io.DeltaTime = 1.0f / 60.0f;
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    checkEdges();
+
+    printf("%d frames, stats changing every frame:\n", frames);
+    Mode const modes[] = {
+        { "discard", false, false },
+        { "ring", true, false },
+        { "ring + skip", true, true },
+    };
+    for (auto const& mode : modes)
+        run(mode, frames);
+    growth(std::min(frames, 1500));
+
+    ImGui::DestroyContext();
+    printf(ok ? "ok\n" : "failed\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+//--------------------------------------------------------------------------------------
+// Headless check of input recording: a random input stream drives a copy of the
+// camera/light simulation live while being recorded, then the file is replayed into a
+// fresh simulation and both end states must match bit for bit. Also checks that
+// truncated and foreign files are rejected.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -I.. input_replay_check.cpp ../input_recording.cpp -o input_replay_check
+//
+// Usage:
+//   input_replay_check [recording.bin]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <cstdint>
+#include <climits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "input_recording.h"
+
+constexpr double fixedStep = 1.0 / 120.0;
+constexpr uint64_t stepCount = 20000;
+
+// the state Graphics::applyInput and Graphics::update touch, with the same arithmetic
+struct Simulation
+{
+    float position[3] = { 0.0f, 0.0f, -50.0f };
+    float yaw = 90.0f;
+    float pitch = 0.0f;
+    float intensity[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    bool move[6] = {};
+
+    void apply(InputEvent const& e)
+    {
+        auto type = static_cast<int>(e.type);
+        if (type <= static_cast<int>(InputEventType::MoveDown))
+            move[type] = e.value != 0;
+        else if (e.type == InputEventType::Rotate)
+        {
+            yaw += e.value * 0.1f;
+            pitch = std::min(std::max(pitch + e.value2 * 0.1f, -89.0f), 89.0f);
+        }
+        else if (e.value >= 0 && e.value < 4)
+        {
+            auto& i = intensity[e.value];
+            if (e.type == InputEventType::ResetLightIntensity)
+                i = 1.0f;
+            else if (e.type == InputEventType::IncreaseLightIntensity)
+                i = std::min(i + 10.0f, 10000.0f);
+            else
+                i = std::max(i - 10.0f, 0.0f);
+        }
+    }
+
+    void update(float step)
+    {
+        const float toRad = 3.14159265f / 180.0f;
+        float d[3] = { std::cos(yaw * toRad) * std::cos(pitch * toRad), std::sin(pitch * toRad),
+            std::sin(yaw * toRad) * std::cos(pitch * toRad) };
+        float r[3] = { d[2], 0.0f, -d[0] };
+        float delta[3] = {};
+        for (int c = 0; c < 3; c++)
+        {
+            if (move[0]) delta[c] -= r[c];
+            if (move[1]) delta[c] += r[c];
+            if (move[2]) delta[c] += d[c];
+            if (move[3]) delta[c] -= d[c];
+        }
+        if (move[4]) delta[1] += 1.0f;
+        if (move[5]) delta[1] -= 1.0f;
+        for (int c = 0; c < 3; c++)
+            position[c] += delta[c] * 15.0f * step;
+    }
+
+    bool operator==(Simulation const& o) const
+    {
+        return !memcmp(position, o.position, sizeof(position)) && !memcmp(&yaw, &o.yaw, sizeof(yaw)) &&
+            !memcmp(&pitch, &o.pitch, sizeof(pitch)) && !memcmp(intensity, o.intensity, sizeof(intensity));
+    }
+};
+
+static std::vector<uint8_t> readFile(char const* path)
+{
+    std::vector<uint8_t> data;
+    FILE* in = fopen(path, "rb");
+    if (!in)
+        return data;
+    int c;
+    while ((c = fgetc(in)) != EOF)
+        data.push_back(static_cast<uint8_t>(c));
+    fclose(in);
+    return data;
+}
+
+int main(int argc, char* argv[])
+{
+    auto path = argc > 1 ? argv[1] : "input_replay_check.bin";
+    bool ok = true;
+
+    // live run, recorded
+    std::mt19937 random(1234);
+    std::vector<InputEvent> live;
+    Simulation recorded;
+    InputRecorder recorder;
+    if (!recorder.open(path, fixedStep))
+    {
+        printf("FAIL: could not open %s\n", path);
+        return 1;
+    }
+    for (uint64_t step = 0; step < stepCount; step++)
+    {
+        // bursts of mouse movement, occasional keys
+        auto count = random() % 8 == 0 ? random() % 6 : 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            InputEvent e;
+            e.step = step;
+            e.type = static_cast<InputEventType>(random() % static_cast<uint32_t>(InputEventType::Count));
+            e.value = e.type == InputEventType::Rotate ? static_cast<int32_t>(random() % 81) - 40 :
+                e.type <= InputEventType::MoveDown ? random() % 2 : random() % 5;
+            e.value2 = e.type == InputEventType::Rotate ? static_cast<int32_t>(random() % 81) - 40 : 0;
+            live.push_back(e);
+            recorder.record(e);
+            recorded.apply(e);
+        }
+        recorded.update(static_cast<float>(fixedStep));
+    }
+    // extremes must survive the varint encoding
+    InputEvent extreme;
+    extreme.step = stepCount;
+    extreme.type = InputEventType::Rotate;
+    extreme.value = INT32_MIN;
+    extreme.value2 = INT32_MAX;
+    live.push_back(extreme);
+    recorder.record(extreme);
+    if (!recorder.close())
+    {
+        printf("FAIL: could not write %s\n", path);
+        return 1;
+    }
+
+    // replay
+    InputPlayer player;
+    std::string error;
+    if (!player.load(path, error))
+    {
+        printf("FAIL: %s\n", error.c_str());
+        return 1;
+    }
+    if (player.fixedStep() != fixedStep)
+    {
+        printf("FAIL: fixed step %.17g, recorded %.17g\n", player.fixedStep(), fixedStep);
+        ok = false;
+    }
+
+    auto const& events = player.allEvents();
+    size_t mismatches = events.size() == live.size() ? 0 : 1;
+    for (size_t i = 0; i < std::min(events.size(), live.size()); i++)
+    {
+        auto const& a = events[i];
+        auto const& b = live[i];
+        if (a.step != b.step || a.type != b.type || a.value != b.value || a.value2 != b.value2)
+            mismatches++;
+    }
+    if (mismatches)
+    {
+        printf("FAIL: %zu of %zu events differ after the round trip\n", mismatches, live.size());
+        ok = false;
+    }
+
+    Simulation replayed;
+    InputEvent e;
+    for (uint64_t step = 0; step < stepCount; step++)
+    {
+        while (player.next(step, e))
+            replayed.apply(e);
+        replayed.update(static_cast<float>(player.fixedStep()));
+    }
+    if (!(replayed == recorded))
+    {
+        printf("FAIL: replayed state differs: (%.9g %.9g %.9g) vs (%.9g %.9g %.9g)\n",
+            replayed.position[0], replayed.position[1], replayed.position[2],
+            recorded.position[0], recorded.position[1], recorded.position[2]);
+        ok = false;
+    }
+    if (!player.next(stepCount, e) || e.value != INT32_MIN || e.value2 != INT32_MAX || !player.done())
+    {
+        printf("FAIL: extreme values did not round trip\n");
+        ok = false;
+    }
+
+    // corrupt inputs
+    auto data = readFile(path);
+    printf("%zu events in %zu bytes (%.2f bytes/event)\n", live.size(), data.size(),
+        static_cast<double>(data.size() - 14) / live.size());
+    InputPlayer broken;
+    auto truncated = data;
+    truncated.pop_back();
+    if (broken.parse(truncated, error))
+    {
+        printf("FAIL: truncated recording accepted\n");
+        ok = false;
+    }
+    auto foreign = data;
+    foreign[0] = 'X';
+    if (broken.parse(foreign, error))
+    {
+        printf("FAIL: file without the magic accepted\n");
+        ok = false;
+    }
+
+    printf("final camera (%.4f %.4f %.4f) yaw %.2f pitch %.2f\n",
+        replayed.position[0], replayed.position[1], replayed.position[2], replayed.yaw, replayed.pitch);
+    printf(ok ? "ok\n" : "failed\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,272 @@
+//--------------------------------------------------------------------------------------
+// Stress test and scaling benchmark of the job system: the Chase-Lev deque with
+// concurrent stealers, nested jobs waiting on counters, parallelFor coverage, and
+// the per-sphere constant packing Graphics does, timed with 1..N threads.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -pthread -I.. job_system_check.cpp ../job_system.cpp ../profiler.cpp -o job_system_check
+//
+// Usage:
+//   job_system_check [--iterations n] [--max-threads n]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "job_system.h"
+
+static bool ok = true;
+
+static void fail(char const* what)
+{
+    printf("FAIL: %s\n", what);
+    ok = false;
+}
+
+// owner pushes and pops while thieves steal, every item must come out exactly once
+static void checkDeque()
+{
+    constexpr uint32_t itemCount = 1 << 20;
+    constexpr int thiefCount = 3;
+
+    WorkStealingDeque deque(1024);
+    std::vector<std::atomic<uint8_t>> taken(itemCount + 1);
+    std::atomic<bool> done = false;
+    std::atomic<uint64_t> stolen = 0;
+
+    auto take = [&taken](Job* job) { taken[reinterpret_cast<uintptr_t>(job)].fetch_add(1); };
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < thiefCount; t++)
+        thieves.emplace_back([&]() {
+            while (!done.load())
+            {
+                if (auto job = deque.steal())
+                {
+                    take(job);
+                    stolen++;
+                }
+            }
+        });
+
+    uint32_t next = 1;
+    while (next <= itemCount)
+    {
+        // bursts of pushes, then pop some back
+        for (int i = 0; i < 64 && next <= itemCount; i++)
+        {
+            auto job = reinterpret_cast<Job*>(static_cast<uintptr_t>(next));
+            if (!deque.push(job))
+                break;
+            next++;
+        }
+        for (int i = 0; i < 40; i++)
+            if (auto job = deque.pop())
+                take(job);
+    }
+    while (auto job = deque.pop())
+        take(job);
+    done = true;
+    for (auto& t : thieves)
+        t.join();
+
+    uint32_t missing = 0, duplicated = 0;
+    for (uint32_t i = 1; i <= itemCount; i++)
+    {
+        auto n = taken[i].load();
+        missing += n == 0;
+        duplicated += n > 1;
+    }
+    printf("deque: %u items, %llu stolen, %u missing, %u duplicated\n", itemCount,
+        static_cast<unsigned long long>(stolen.load()), missing, duplicated);
+    if (missing || duplicated)
+        fail("deque lost or duplicated items");
+}
+
+// binary tree of jobs, every inner job waits on its children
+static uint64_t spawnTree(JobSystem& jobs, int depth)
+{
+    if (depth == 0)
+        return 1;
+
+    uint64_t left = 0, right = 0;
+    JobCounter children;
+    jobs.run([&]() { left = spawnTree(jobs, depth - 1); }, children);
+    jobs.run([&]() { right = spawnTree(jobs, depth - 1); }, children);
+    jobs.wait(children);
+    return left + right + 1;
+}
+
+static void checkJobs(uint32_t threads, int iterations)
+{
+    JobSystem jobs(threads - 1);
+    const int depth = 12;
+    const uint64_t treeSize = (1ull << (depth + 1)) - 1;
+
+    for (int it = 0; it < iterations; it++)
+    {
+        if (spawnTree(jobs, depth) != treeSize)
+        {
+            fail("nested jobs returned the wrong count");
+            break;
+        }
+
+        // parallelFor must visit every index exactly once
+        const uint32_t count = 100003;
+        std::vector<uint8_t> visits(count);
+        jobs.parallelFor(count, 97 + it % 300, [&visits](uint32_t begin, uint32_t end) {
+            for (auto i = begin; i < end; i++)
+                visits[i]++;
+        });
+        if (std::any_of(visits.begin(), visits.end(), [](uint8_t v) { return v != 1; }))
+        {
+            fail("parallelFor skipped or repeated indices");
+            break;
+        }
+
+        // a second stage only starts once the counter of the first one is done
+        std::vector<uint32_t> stage(4096);
+        JobCounter first;
+        for (uint32_t j = 0; j < 64; j++)
+            jobs.run([&stage, j]() {
+                for (uint32_t i = j * 64; i < j * 64 + 64; i++)
+                    stage[i] = i * 3;
+            }, first);
+        jobs.wait(first);
+        std::atomic<uint64_t> sum = 0;
+        JobCounter second;
+        for (uint32_t j = 0; j < 64; j++)
+            jobs.run([&stage, &sum, j]() {
+                uint64_t s = 0;
+                for (uint32_t i = j * 64; i < j * 64 + 64; i++)
+                    s += stage[i];
+                sum += s;
+            }, second);
+        jobs.wait(second);
+        if (sum != 3ull * 4095 * 4096 / 2)
+        {
+            fail("dependent stage saw incomplete data");
+            break;
+        }
+    }
+
+    // threads without a deque run their jobs inline
+    std::thread outsider([&jobs]() {
+        JobCounter counter;
+        int value = 0;
+        jobs.run([&value]() { value = 42; }, counter);
+        jobs.wait(counter);
+        if (value != 42)
+            fail("job started from a foreign thread didn't run");
+    });
+    outsider.join();
+
+    auto stats = jobs.stats();
+    printf("%u threads: %d iterations, %llu jobs, %llu stolen, %llu inlined\n", threads, iterations,
+        static_cast<unsigned long long>(stats.executed), static_cast<unsigned long long>(stats.stolen),
+        static_cast<unsigned long long>(stats.inlined));
+}
+
+// the per-sphere work of Graphics::prepareScene: world matrix, world-view-projection,
+// frustum test and material parameters
+struct PackedObject
+{
+    float world[16];
+    float wvp[16];
+    float roughness, metalness;
+    bool visible;
+};
+
+static void packObjects(std::vector<PackedObject>& objects, uint32_t gridSize, float const viewProj[16],
+    uint32_t begin, uint32_t end)
+{
+    const float step = (1 - 0.01f) / std::max<int>(gridSize - 1, 1);
+    for (auto i = begin; i < end; i++)
+    {
+        auto& o = objects[i];
+        auto row = i / gridSize, column = i % gridSize;
+        float x = 6.0f * (static_cast<int>(column) - static_cast<int>(gridSize / 2));
+        float y = 6.0f * (static_cast<int>(row) - static_cast<int>(gridSize / 2));
+        float world[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, x, y, 30.0f, 1 };
+        memcpy(o.world, world, sizeof(world));
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 4; c++)
+            {
+                float s = 0.0f;
+                for (int k = 0; k < 4; k++)
+                    s += world[r * 4 + k] * viewProj[k * 4 + c];
+                o.wvp[r * 4 + c] = s;
+            }
+        // sphere center in clip space against the frustum, with a radius margin
+        float cx = o.wvp[12], cy = o.wvp[13], cw = o.wvp[15];
+        o.visible = std::fabs(cx) <= cw + 2.0f && std::fabs(cy) <= cw + 2.0f && cw > 0.0f;
+        o.roughness = 0.01f + column * step;
+        o.metalness = 0.01f + row * step;
+    }
+}
+
+static void benchmarkScaling(uint32_t maxThreads)
+{
+    const uint32_t gridSize = 512;
+    const uint32_t count = gridSize * gridSize;
+    const int repetitions = 20;
+    float viewProj[16] = { 1.2f, 0, 0, 0, 0, 1.2f, 0, 0, 0, 0, 1.0f, 1.0f, 0, 0, 50.0f, 50.0f };
+    std::vector<PackedObject> objects(count);
+
+    printf("\nscaling, %u objects packed per frame:\n", count);
+    double single = 0.0;
+    for (uint32_t threads = 1; threads <= maxThreads; threads++)
+    {
+        JobSystem jobs(threads - 1);
+        double best = 1e30;
+        for (int r = 0; r < repetitions; r++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            jobs.parallelFor(count, 1024, [&](uint32_t begin, uint32_t end) {
+                packObjects(objects, gridSize, viewProj, begin, end);
+            });
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+        if (threads == 1)
+            single = best;
+        printf("  %2u threads: %7.3f ms, %.2fx\n", threads, best, single / best);
+    }
+
+    auto visible = std::count_if(objects.begin(), objects.end(), [](PackedObject const& o) { return o.visible; });
+    printf("  %lld of %u visible\n", static_cast<long long>(visible), count);
+}
+
+int main(int argc, char* argv[])
+{
+    int iterations = 200;
+    uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--iterations") && i + 1 < argc)
+            iterations = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--max-threads") && i + 1 < argc)
+            maxThreads = static_cast<uint32_t>(atoi(argv[++i]));
+        else
+        {
+            fprintf(stderr, "usage: %s [--iterations n] [--max-threads n]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    checkDeque();
+    for (uint32_t threads : { 1u, 2u, std::max(maxThreads, 2u), 2 * std::max(maxThreads, 2u) })
+        checkJobs(threads, iterations);
+    benchmarkScaling(maxThreads);
+
+    printf(ok ? "ok\n" : "failed\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+//--------------------------------------------------------------------------------------
+// Headless soak run of the fixed-timestep loop with a jittery fake renderer.
+// Checks that simulated time matches elapsed time, interpolation stays in [0, 1)
+// and the frame cap holds, then prints frame-time percentiles.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -pthread -I.. loop_soak.cpp ../game_loop.cpp -o loop_soak
+//
+// Usage:
+//   loop_soak [--seconds <s>] [--fps-cap <fps>] [--step <hz>] [--real-clock]
+//
+// The default simulated clock runs hours of frames in a second; --real-clock
+// sleeps for real to measure the pacing on the host.
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+#include "game_loop.h"
+
+int main(int argc, char* argv[])
+{
+    double seconds = 3600.0;
+    double fpsCap = 0.0;
+    double stepHz = 120.0;
+    bool realClock = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--seconds") && i + 1 < argc)
+            seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--fps-cap") && i + 1 < argc)
+            fpsCap = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--step") && i + 1 < argc)
+            stepHz = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--real-clock"))
+            realClock = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [--seconds <s>] [--fps-cap <fps>] [--step <hz>] [--real-clock]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (realClock && seconds > 60.0)
+        seconds = 10.0;
+
+    double simulatedNow = 0.0;
+    std::mt19937 rng(1234);
+    // mostly 2-8 ms frames with an occasional long hitch
+    std::uniform_real_distribution<double> frameCost(0.002, 0.008);
+    std::uniform_int_distribution<int> hitch(0, 999);
+
+    auto spend = [&](double cost) {
+        if (realClock)
+            std::this_thread::sleep_for(std::chrono::duration<double>(cost));
+        else
+            simulatedNow += cost;
+    };
+
+    GameLoopSettings settings;
+    settings.fixedStep = 1.0 / stepHz;
+    settings.maxFps = fpsCap;
+
+    uint64_t badInterpolations = 0;
+    GameLoop loop(
+        [&](double step) { spend(step * 0.01); },
+        [&](double interpolation, double) {
+            if (interpolation < 0.0 || interpolation >= 1.0)
+                badInterpolations++;
+            spend(hitch(rng) == 0 ? 0.25 : frameCost(rng));
+        },
+        settings);
+
+    if (!realClock)
+        loop.setTimeSource([&]() { return simulatedNow; },
+            [&](double s) { simulatedNow += std::max(s, 1e-5); });
+
+    auto start = realClock ? GameLoop::clockNow() : simulatedNow;
+    auto elapsed = [&]() { return (realClock ? GameLoop::clockNow() : simulatedNow) - start; };
+
+    loop.tick();
+    while (elapsed() < seconds)
+        loop.tick();
+    // the last frame time the loop sees ends here
+    auto covered = elapsed();
+    loop.tick();
+
+    auto simulated = loop.updateCount() * settings.fixedStep + loop.droppedTime();
+    // what is left in the accumulator is less than a step
+    auto drift = covered - simulated;
+
+    auto p = loop.history().percentiles();
+    printf("%llu frames, %llu updates, %.3f s simulated, %.3f s dropped\n",
+        static_cast<unsigned long long>(loop.frameCount()), static_cast<unsigned long long>(loop.updateCount()),
+        loop.updateCount() * settings.fixedStep, loop.droppedTime());
+    printf("frame time (last %u): p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, mean %.3f ms, max %.3f ms\n",
+        p.count, p.p50 * 1e3, p.p95 * 1e3, p.p99 * 1e3, p.mean * 1e3, p.max * 1e3);
+
+    bool ok = true;
+    if (std::fabs(drift) > settings.fixedStep)
+    {
+        printf("FAIL: simulation drifted %.6f s from wall time\n", drift);
+        ok = false;
+    }
+    if (badInterpolations)
+    {
+        printf("FAIL: %llu interpolation factors outside [0, 1)\n", static_cast<unsigned long long>(badInterpolations));
+        ok = false;
+    }
+    // real sleeps overshoot, allow a little slack there
+    if (fpsCap > 0.0 && p.p50 < (realClock ? 0.95 : 0.999) / fpsCap)
+    {
+        printf("FAIL: median frame %.3f ms is faster than the %.1f fps cap\n", p.p50 * 1e3, fpsCap);
+        ok = false;
+    }
+
+    printf(ok ? "ok\n" : "failed\n");
+    return ok ? 0 : 1;
+}
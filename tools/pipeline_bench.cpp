@@ -0,0 +1,240 @@
+//--------------------------------------------------------------------------------------
+// Headless harness for the frame pipeline: runs a simulated frame (CPU simulation work,
+// CPU submission work and a blocking present) serially and split across a simulation
+// and a render thread, and reports throughput and input-to-present latency for each
+// queue depth. Every snapshot carries a frame-stamped payload that the render side
+// checks for tearing, and the window resize pause is exercised while frames flow.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -pthread -I.. pipeline_bench.cpp ../game_loop.cpp -o pipeline_bench
+//
+// Usage:
+//   pipeline_bench [--frames n] [--sim ms] [--submit ms] [--present ms]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "game_loop.h"
+#include "frame_pipeline.h"
+
+struct Snapshot
+{
+    uint64_t frame = 0;
+    // stands in for the per-instance data
+    std::vector<uint64_t> payload;
+};
+
+constexpr size_t payloadSize = 1 << 14;
+
+struct Workload
+{
+    uint32_t frames = 600;
+    // milliseconds
+    double sim = 2.0;
+    double submit = 2.0;
+    double present = 4.0;
+};
+
+// CPU work that can't be overlapped on one thread
+static void spin(double ms)
+{
+    auto end = GameLoop::clockNow() + ms * 1e-3;
+    while (GameLoop::clockNow() < end)
+        ;
+}
+
+// waiting on the GPU / vblank
+static void block(double ms)
+{
+    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(ms));
+}
+
+static void fill(Snapshot& s, uint64_t frame)
+{
+    s.frame = frame;
+    s.payload.resize(payloadSize);
+    for (size_t i = 0; i < payloadSize; i++)
+        s.payload[i] = frame * payloadSize + i;
+}
+
+static bool intact(Snapshot const& s)
+{
+    if (s.payload.size() != payloadSize)
+        return false;
+    for (size_t i = 0; i < payloadSize; i++)
+        if (s.payload[i] != s.frame * payloadSize + i)
+            return false;
+    return true;
+}
+
+struct Result
+{
+    double fps = 0.0;
+    FrameTimePercentiles latency;
+    uint64_t dropped = 0;
+    double producerWait = 0.0;
+    double consumerWait = 0.0;
+    uint64_t torn = 0;
+    uint64_t pauseViolations = 0;
+};
+
+static Result runSerial(Workload const& w)
+{
+    Result result;
+    FrameTimeHistory latency(w.frames);
+    Snapshot snapshot;
+    auto start = GameLoop::clockNow();
+    for (uint32_t f = 1; f <= w.frames; f++)
+    {
+        auto input = GameLoop::clockNow();
+        spin(w.sim);
+        fill(snapshot, f);
+        spin(w.submit);
+        result.torn += !intact(snapshot);
+        block(w.present);
+        latency.add(GameLoop::clockNow() - input);
+    }
+    result.fps = w.frames / (GameLoop::clockNow() - start);
+    result.latency = latency.percentiles();
+    return result;
+}
+
+static Result runPipelined(Workload const& w, uint32_t maxQueued)
+{
+    Result result;
+    FramePipeline<Snapshot> pipeline(maxQueued, w.frames);
+    std::atomic<bool> building = false;
+    std::atomic<uint64_t> pauseViolations = 0;
+
+    std::thread simulation([&]() {
+        for (uint64_t f = 1;; f++)
+        {
+            pipeline.waitForRoom();
+            auto input = GameLoop::clockNow();
+            spin(w.sim);
+            auto snapshot = pipeline.beginFrame();
+            if (!snapshot)
+                break;
+            building = true;
+            fill(*snapshot, f);
+            building = false;
+            pipeline.publish(input);
+        }
+    });
+
+    // a resize every now and then, the producer must be parked while it lasts
+    std::atomic<bool> done = false;
+    std::thread resizer([&]() {
+        while (!done)
+        {
+            block(7.0);
+            pipeline.pause();
+            if (building)
+                pauseViolations++;
+            block(0.5);
+            if (building)
+                pauseViolations++;
+            pipeline.resume();
+        }
+    });
+
+    auto start = GameLoop::clockNow();
+    uint32_t rendered = 0;
+    while (rendered < w.frames)
+    {
+        auto snapshot = pipeline.acquire(1.0);
+        if (!snapshot)
+            continue;
+        spin(w.submit);
+        result.torn += !intact(*snapshot);
+        block(w.present);
+        pipeline.presented();
+        rendered++;
+    }
+    result.fps = w.frames / (GameLoop::clockNow() - start);
+
+    done = true;
+    resizer.join();
+    pipeline.stop();
+    simulation.join();
+
+    auto stats = pipeline.stats();
+    result.latency = stats.latency;
+    result.dropped = stats.dropped;
+    result.producerWait = stats.producerWait;
+    result.consumerWait = stats.consumerWait;
+    result.pauseViolations = pauseViolations;
+    return result;
+}
+
+static void print(char const* name, Result const& r)
+{
+    printf("%-12s %7.1f fps  latency p50 %6.2f p95 %6.2f p99 %6.2f ms  dropped %5llu  wait sim %6.3f s render %6.3f s\n",
+        name, r.fps, r.latency.p50 * 1e3, r.latency.p95 * 1e3, r.latency.p99 * 1e3,
+        static_cast<unsigned long long>(r.dropped), r.producerWait, r.consumerWait);
+}
+
+int main(int argc, char* argv[])
+{
+    Workload w;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--frames") && i + 1 < argc)
+            w.frames = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--sim") && i + 1 < argc)
+            w.sim = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--submit") && i + 1 < argc)
+            w.submit = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--present") && i + 1 < argc)
+            w.present = atof(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [--frames n] [--sim ms] [--submit ms] [--present ms]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (w.frames == 0)
+        w.frames = 1;
+
+    printf("%u frames, sim %.2f ms, submit %.2f ms, present %.2f ms, %u hardware threads\n",
+        w.frames, w.sim, w.submit, w.present, std::thread::hardware_concurrency());
+
+    auto serial = runSerial(w);
+    auto queued = runPipelined(w, 1);
+    auto mailbox = runPipelined(w, 0);
+    print("serial", serial);
+    print("pipelined", queued);
+    print("newest-only", mailbox);
+    printf("pipelined: %.2fx throughput, %+.2f ms p50 latency\n",
+        queued.fps / serial.fps, (queued.latency.p50 - serial.latency.p50) * 1e3);
+
+    bool ok = true;
+    for (auto const* r : { &serial, &queued, &mailbox })
+    {
+        if (r->torn)
+        {
+            printf("FAIL: %llu snapshots torn\n", static_cast<unsigned long long>(r->torn));
+            ok = false;
+        }
+        if (r->pauseViolations)
+        {
+            printf("FAIL: producer built a snapshot while paused %llu times\n",
+                static_cast<unsigned long long>(r->pauseViolations));
+            ok = false;
+        }
+    }
+    if (queued.dropped)
+    {
+        printf("FAIL: a queue depth of 1 dropped %llu frames\n", static_cast<unsigned long long>(queued.dropped));
+        ok = false;
+    }
+
+    printf(ok ? "ok\n" : "failed\n");
+    return ok ? 0 : 1;
+}
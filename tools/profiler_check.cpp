@@ -0,0 +1,123 @@
+//--------------------------------------------------------------------------------------
+// Headless check of the CPU profiler: worker threads record nested scopes while the
+// main thread collects frames, then the nesting and event counts are verified and
+// the history is exported as a Chrome trace.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -pthread -I.. profiler_check.cpp ../profiler.cpp -o profiler_check
+//
+// Usage:
+//   profiler_check [trace.json]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+#include "profiler.h"
+
+constexpr int threadCount = 4;
+constexpr int iterations = 2000;
+// every iteration records Outer, two Inner and one Leaf per Inner
+constexpr int eventsPerIteration = 5;
+
+static void work(int thread, std::atomic<int>& finished)
+{
+    Profiler::get().setThreadName("Worker " + std::to_string(thread));
+    for (int i = 0; i < iterations; i++)
+    {
+        PROFILE_SCOPE("Outer");
+        for (int j = 0; j < 2; j++)
+        {
+            PROFILE_SCOPE("Inner");
+            PROFILE_SCOPE(Profiler::get().intern("Leaf " + std::to_string(j)));
+        }
+    }
+    finished++;
+}
+
+int main(int argc, char* argv[])
+{
+    auto& profiler = Profiler::get();
+    profiler.setHistorySize(1 << 20);
+
+    std::atomic<int> finished = 0;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++)
+        workers.emplace_back(work, t, std::ref(finished));
+
+    // collect while the workers are still recording
+    while (finished < threadCount)
+    {
+        PROFILE_SCOPE("Collect");
+        std::this_thread::yield();
+        profiler.endFrame();
+    }
+    for (auto& w : workers)
+        w.join();
+    profiler.endFrame();
+
+    // a scope and its parent may end up in different frames, check them all at once
+    std::vector<ProfileEvent> events;
+    for (auto const& frame : profiler.history())
+        events.insert(events.end(), frame.cpu.begin(), frame.cpu.end());
+    std::sort(events.begin(), events.end(), [](ProfileEvent const& a, ProfileEvent const& b) {
+        return a.thread != b.thread ? a.thread < b.thread :
+            a.start != b.start ? a.start < b.start : a.depth < b.depth;
+    });
+
+    size_t workerEvents = 0, mainEvents = 0, badNesting = 0;
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        auto const& e = events[i];
+        if (e.end < e.start)
+            badNesting++;
+        if (!strcmp(e.name, "Collect"))
+        {
+            mainEvents++;
+            continue;
+        }
+        workerEvents++;
+
+        // the parent is the closest earlier scope one level up on the same thread
+        if (e.depth > 0)
+        {
+            auto parent = std::find_if(events.rbegin() + (events.size() - i), events.rend(),
+                [&e](ProfileEvent const& p) { return p.thread == e.thread && p.depth == e.depth - 1; });
+            if (parent == events.rend() || parent->start > e.start || parent->end < e.end)
+                badNesting++;
+        }
+    }
+
+    auto expected = static_cast<size_t>(threadCount) * iterations * eventsPerIteration;
+    auto dropped = profiler.droppedEvents();
+    printf("%zu frames, %zu worker events (%zu expected, %llu dropped), %zu collect scopes\n",
+        profiler.history().size(), workerEvents, expected, static_cast<unsigned long long>(dropped), mainEvents);
+
+    bool ok = true;
+    if (workerEvents + dropped != expected)
+    {
+        printf("FAIL: events lost without being counted as dropped\n");
+        ok = false;
+    }
+    if (badNesting)
+    {
+        printf("FAIL: %zu events outside their parent scope\n", badNesting);
+        ok = false;
+    }
+
+    auto path = argc > 1 ? argv[1] : "profile.json";
+    if (!profiler.exportChromeTrace(path))
+    {
+        printf("FAIL: could not write %s\n", path);
+        ok = false;
+    }
+    else
+        printf("trace written to %s\n", path);
+
+    printf(ok ? "ok\n" : "failed\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+//--------------------------------------------------------------------------------------
+// Benchmark and checks of the render queue: sort key encoding, stability and order of
+// the radix sort against std::stable_sort, and timings for 1M keys with random bits
+// and with keys shaped like a frame's draws (few passes and shaders, many depths).
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -I.. render_queue_bench.cpp ../render_queue.cpp -o render_queue_bench
+//
+// Usage:
+//   render_queue_bench [--keys n] [--runs n]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include "render_queue.h"
+
+static bool ok = true;
+
+static void check(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+}
+
+static void checkKeys()
+{
+    auto key = RenderKey::make(RenderPass::Sky, 3, 12345, 7.5f);
+    check(RenderKey::pass(key) == RenderPass::Sky && RenderKey::shader(key) == 3 && RenderKey::material(key) == 12345,
+        "fields round trip");
+    check(RenderKey::shader(RenderKey::make(RenderPass::Opaque, 1000, 0, 0.0f)) == RenderKey::MaxShader &&
+        RenderKey::material(RenderKey::make(RenderPass::Opaque, 0, ~0u, 0.0f)) == RenderKey::MaxMaterial,
+        "ids clamp to their field");
+
+    // opaque front to back, transparent back to front, including depths behind the eye
+    float depths[] = { -100.0f, -1.0f, -0.0f, 0.0f, 0.5f, 1.0f, 30.0f, 1e6f };
+    for (size_t i = 1; i < sizeof(depths) / sizeof(depths[0]); i++)
+    {
+        check(RenderKey::make(RenderPass::Opaque, 0, 0, depths[i - 1]) <= RenderKey::make(RenderPass::Opaque, 0, 0, depths[i]),
+            "opaque depth ascends");
+        check(RenderKey::make(RenderPass::Transparent, 0, 0, depths[i - 1]) >= RenderKey::make(RenderPass::Transparent, 0, 0, depths[i]),
+            "transparent depth descends");
+    }
+
+    // the field order decides before depth
+    check(RenderKey::make(RenderPass::Opaque, 9, 9, 1e6f) < RenderKey::make(RenderPass::Sky, 0, 0, 0.0f), "pass first");
+    check(RenderKey::make(RenderPass::Opaque, 1, 9, 1e6f) < RenderKey::make(RenderPass::Opaque, 2, 0, 0.0f), "then shader");
+    check(RenderKey::make(RenderPass::Opaque, 1, 1, 1e6f) < RenderKey::make(RenderPass::Opaque, 1, 2, 0.0f), "then material");
+}
+
+// a frame: mostly opaque draws of a few shaders and many materials, one sky, some transparent
+static std::vector<RenderItem> frameKeys(size_t count, std::mt19937& rng)
+{
+    std::uniform_int_distribution<uint32_t> shader(0, 7), material(0, 511), kind(0, 99);
+    std::uniform_real_distribution<float> depth(0.1f, 500.0f);
+    std::vector<RenderItem> items(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        auto pass = i == 0 ? RenderPass::Sky : kind(rng) < 90 ? RenderPass::Opaque : RenderPass::Transparent;
+        items[i] = { RenderKey::make(pass, shader(rng), material(rng), depth(rng)), static_cast<uint32_t>(i) };
+    }
+    return items;
+}
+
+static std::vector<RenderItem> randomKeys(size_t count, std::mt19937& rng)
+{
+    std::uniform_int_distribution<uint64_t> bits;
+    std::vector<RenderItem> items(count);
+    for (size_t i = 0; i < count; i++)
+        items[i] = { bits(rng), static_cast<uint32_t>(i) };
+    return items;
+}
+
+static bool byKey(RenderItem const& a, RenderItem const& b)
+{
+    return a.key < b.key;
+}
+
+static void checkSort(std::vector<RenderItem> items, char const* name)
+{
+    // duplicates make stability visible
+    for (size_t i = 0; i < items.size(); i += 3)
+        items[i].key = items[i / 2].key;
+
+    auto expected = items;
+    std::stable_sort(expected.begin(), expected.end(), byKey);
+    std::vector<RenderItem> scratch(items.size());
+    radixSort(items.data(), scratch.data(), items.size());
+
+    bool same = true;
+    for (size_t i = 0; i < items.size() && same; i++)
+        same = items[i].key == expected[i].key && items[i].index == expected[i].index;
+    check(same, name);
+}
+
+static double best(int runs, std::vector<RenderItem> const& input, std::function<void(std::vector<RenderItem>&)> const& sort)
+{
+    using Clock = std::chrono::steady_clock;
+    double result = 1e30;
+    for (int r = 0; r < runs; r++)
+    {
+        auto items = input;
+        auto start = Clock::now();
+        sort(items);
+        result = std::min(result, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return result;
+}
+
+static void benchmark(char const* name, std::vector<RenderItem> const& input, int runs)
+{
+    std::vector<RenderItem> scratch(input.size());
+    auto radix = best(runs, input, [&scratch](std::vector<RenderItem>& items) {
+        radixSort(items.data(), scratch.data(), items.size());
+    });
+    auto stable = best(runs, input, [](std::vector<RenderItem>& items) {
+        std::stable_sort(items.begin(), items.end(), byKey);
+    });
+    auto unstable = best(runs, input, [](std::vector<RenderItem>& items) {
+        std::sort(items.begin(), items.end(), byKey);
+    });
+    printf("  %-14s radix %8.2f ms   std::stable_sort %8.2f ms (%.1fx)   std::sort %8.2f ms (%.1fx)\n",
+        name, radix, stable, stable / radix, unstable, unstable / radix);
+}
+
+int main(int argc, char* argv[])
+{
+    size_t keys = 1000000;
+    int runs = 5;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--keys") && i + 1 < argc)
+            keys = static_cast<size_t>(atoll(argv[++i]));
+        else if (!strcmp(argv[i], "--runs") && i + 1 < argc)
+            runs = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [--keys n] [--runs n]\n", argv[0]);
+            return 1;
+        }
+    }
+    keys = std::max<size_t>(keys, 2);
+    runs = std::max(runs, 1);
+
+    std::mt19937 rng(5);
+    checkKeys();
+    checkSort(randomKeys(100000, rng), "random keys sort like std::stable_sort");
+    checkSort(frameKeys(100000, rng), "frame keys sort like std::stable_sort");
+
+    // the queue groups state: a handful of shader switches instead of one per draw
+    RenderQueue queue;
+    for (auto const& item : frameKeys(10000, rng))
+        queue.push(item.key, item.index);
+    auto unsorted = queue.measure();
+    queue.sort();
+    auto sorted = queue.measure();
+    printf("10000 draws: %u -> %u shader changes, %u -> %u material changes\n", unsorted.shaderChanges,
+        sorted.shaderChanges, unsorted.materialChanges, sorted.materialChanges);
+    // at most every shader once per pass
+    check(sorted.shaderChanges <= 3 * 8, "sorted draws group shaders");
+
+    printf("\n%zu keys, best of %d runs:\n", keys, runs);
+    benchmark("random bits", randomKeys(keys, rng), runs);
+    benchmark("frame keys", frameKeys(keys, rng), runs);
+    // a realistic frame stays in cache
+    printf("\n10000 keys, best of %d runs:\n", runs * 20);
+    benchmark("frame keys", frameKeys(10000, rng), runs * 20);
+
+    printf(ok ? "ok\n" : "failed\n");
+    return ok ? 0 : 1;
+}
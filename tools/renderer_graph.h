@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <algorithm>
+
+#include "frame_graph.h"
+
+// The frame graph Graphics::render declares, without the draw calls, shared by
+// the headless tools. Keep it in sync with Graphics::addHDRPasses and render.
+
+// DXGI_FORMAT values used by the renderer
+constexpr uint32_t FORMAT_R32G32B32A32_FLOAT = 2;
+constexpr uint32_t FORMAT_R8G8B8A8_UNORM_SRGB = 29;
+constexpr uint32_t FORMAT_R32_FLOAT = 41;
+
+inline void buildRendererGraph(FrameGraph& graph, uint32_t width, uint32_t height, int drawMask)
+{
+    static int backBufferTexture;
+    auto backBuffer = graph.import("Backbuffer", { width, height, FORMAT_R8G8B8A8_UNORM_SRGB }, &backBufferTexture);
+
+    auto scene = graph.addPass("Scene");
+    auto hdr = scene.write(scene.create("HDR", { width, height, FORMAT_R32G32B32A32_FLOAT }));
+
+    auto brightness = graph.addPass("EvalBrightness");
+    brightness.read(hdr);
+    auto level = brightness.write(brightness.create("Brightness", { width, height, FORMAT_R32_FLOAT }));
+
+    auto n = static_cast<int>(std::max<double>(std::ceil(std::log2(width)), std::ceil(std::log(height))));
+    for (auto size = 1u << n; n >= 0; n--, size >>= 1)
+    {
+        auto reduce = graph.addPass("Reduce 2^" + std::to_string(n));
+        reduce.read(level);
+        level = reduce.write(reduce.create("Brightness 2^" + std::to_string(n), { size, size, FORMAT_R32_FLOAT }));
+    }
+
+    auto tonemap = graph.addPass("Tonemap");
+    tonemap.read(hdr);
+    tonemap.read(level);
+    auto tonemapped = tonemap.write(backBuffer);
+
+    auto brightWindow = graph.addPass("BrightWindow");
+    brightWindow.read(level);
+    tonemapped = brightWindow.write(tonemapped);
+
+    auto debug = graph.addPass("DebugScene");
+    auto debugScene = debug.write(backBuffer);
+
+    auto gui = graph.addPass("GUI");
+    graph.setOutput(gui.write(drawMask == 0 ? tonemapped : debugScene));
+}
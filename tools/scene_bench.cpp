@@ -0,0 +1,339 @@
+//--------------------------------------------------------------------------------------
+// Transform benchmark of the scene container: a forest of 100k nodes updated every
+// frame with nothing, a few leaves, every root or every node changed, against the
+// per-object rebuild of all matrices the renderer used to do. World matrices are
+// checked against a scalar reference after random edits.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -I.. scene_bench.cpp ../scene.cpp -o scene_bench
+//
+// Usage:
+//   scene_bench [--nodes n] [--frames n]
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include "scene.h"
+
+static bool ok = true;
+
+static void fail(char const* what)
+{
+    printf("FAIL: %s\n", what);
+    ok = false;
+}
+
+// array of structures with the same data, rebuilt from scratch every frame
+struct ReferenceNode
+{
+    float position[3];
+    float rotation[4];
+    float scale[3];
+    SceneNode parent;
+};
+
+static SceneMatrix referenceLocal(ReferenceNode const& n)
+{
+    float x = n.rotation[0], y = n.rotation[1], z = n.rotation[2], w = n.rotation[3];
+    SceneMatrix m = {};
+    m.m[0][0] = n.scale[0] * (1 - 2 * (y * y + z * z));
+    m.m[0][1] = n.scale[0] * 2 * (x * y + z * w);
+    m.m[0][2] = n.scale[0] * 2 * (x * z - y * w);
+    m.m[1][0] = n.scale[1] * 2 * (x * y - z * w);
+    m.m[1][1] = n.scale[1] * (1 - 2 * (x * x + z * z));
+    m.m[1][2] = n.scale[1] * 2 * (y * z + x * w);
+    m.m[2][0] = n.scale[2] * 2 * (x * z + y * w);
+    m.m[2][1] = n.scale[2] * 2 * (y * z - x * w);
+    m.m[2][2] = n.scale[2] * (1 - 2 * (x * x + y * y));
+    m.m[3][0] = n.position[0];
+    m.m[3][1] = n.position[1];
+    m.m[3][2] = n.position[2];
+    m.m[3][3] = 1;
+    return m;
+}
+
+static SceneMatrix referenceMultiply(SceneMatrix const& a, SceneMatrix const& b)
+{
+    SceneMatrix out = {};
+    for (int r = 0; r < 4; r++)
+        for (int c = 0; c < 4; c++)
+            for (int k = 0; k < 4; k++)
+                out.m[r][c] += a.m[r][k] * b.m[k][c];
+    return out;
+}
+
+// transposed world matrices of all nodes
+static void referenceUpdate(std::vector<ReferenceNode> const& nodes, std::vector<SceneMatrix>& worlds,
+    std::vector<SceneMatrix>& gpuWorlds)
+{
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        auto local = referenceLocal(nodes[i]);
+        worlds[i] = nodes[i].parent == InvalidSceneNode ? local : referenceMultiply(local, worlds[nodes[i].parent]);
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 4; c++)
+                gpuWorlds[i].m[c][r] = worlds[i].m[r][c];
+    }
+}
+
+struct Forest
+{
+    Scene scene;
+    std::vector<ReferenceNode> reference;
+    std::vector<SceneNode> roots;
+    std::vector<SceneNode> leaves;
+};
+
+static void randomRotation(std::mt19937& rng, float q[4])
+{
+    std::normal_distribution<float> normal;
+    float length = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        q[i] = normal(rng);
+        length += q[i] * q[i];
+    }
+    length = std::sqrt(length);
+    for (int i = 0; i < 4; i++)
+        q[i] /= length;
+}
+
+static void setNode(Forest& forest, SceneNode node, float const p[3], float const q[4], float const s[3])
+{
+    forest.scene.setPosition(node, p[0], p[1], p[2]);
+    forest.scene.setRotation(node, q[0], q[1], q[2], q[3]);
+    forest.scene.setScale(node, s[0], s[1], s[2]);
+    auto& r = forest.reference[node];
+    memcpy(r.position, p, sizeof(r.position));
+    memcpy(r.rotation, q, sizeof(r.rotation));
+    memcpy(r.scale, s, sizeof(r.scale));
+}
+
+static void randomize(Forest& forest, SceneNode node, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> offset(-10.0f, 10.0f), scale(0.5f, 1.5f);
+    float p[3] = { offset(rng), offset(rng), offset(rng) };
+    float q[4];
+    randomRotation(rng, q);
+    float s[3] = { scale(rng), scale(rng), scale(rng) };
+    setNode(forest, node, p, q, s);
+}
+
+// roots with 9 groups of 10 leaves each, 100 nodes per root
+static void buildForest(Forest& forest, uint32_t nodeCount, std::mt19937& rng)
+{
+    auto add = [&forest, &rng](SceneNode parent) {
+        auto node = forest.scene.create(parent);
+        forest.reference.push_back({ {}, {}, {}, parent });
+        randomize(forest, node, rng);
+        return node;
+    };
+    while (forest.scene.size() + 100 <= nodeCount)
+    {
+        auto root = add(InvalidSceneNode);
+        forest.roots.push_back(root);
+        for (int g = 0; g < 9; g++)
+        {
+            auto group = add(root);
+            for (int l = 0; l < 10; l++)
+                forest.leaves.push_back(add(group));
+        }
+    }
+}
+
+static float maxError(Forest const& forest, std::vector<SceneMatrix> const& gpuWorlds)
+{
+    float error = 0;
+    for (SceneNode i = 0; i < forest.scene.size(); i++)
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 4; c++)
+            {
+                auto expected = gpuWorlds[i].m[r][c];
+                auto diff = std::fabs(forest.scene.gpuWorld(i).m[r][c] - expected) / std::max(1.0f, std::fabs(expected));
+                error = std::max(error, diff);
+            }
+    return error;
+}
+
+static void checkBatches()
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+    std::vector<SceneMatrix> a(33), b(33), out(33), transposed(33);
+    for (uint32_t i = 0; i < a.size(); i++)
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 4; c++)
+            {
+                a[i].m[r][c] = value(rng);
+                b[i].m[r][c] = value(rng);
+            }
+
+    multiplyMatrices(a.data(), b.data(), out.data(), static_cast<uint32_t>(a.size()));
+    transposeMatrices(out.data(), transposed.data(), static_cast<uint32_t>(out.size()));
+    float error = 0;
+    for (uint32_t i = 0; i < a.size(); i++)
+    {
+        auto expected = referenceMultiply(a[i], b[i]);
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 4; c++)
+            {
+                error = std::max(error, std::fabs(out[i].m[r][c] - expected.m[r][c]));
+                if (transposed[i].m[c][r] != out[i].m[r][c])
+                    error = 1;
+            }
+    }
+    // in place
+    multiplyMatrices(a.data(), b.data(), a.data(), static_cast<uint32_t>(a.size()));
+    for (uint32_t i = 0; i < a.size(); i++)
+        if (memcmp(&a[i], &out[i], sizeof(SceneMatrix)))
+            error = 1;
+
+    printf("batches: max error %g\n", error);
+    if (error > 1e-5f)
+        fail("batched multiply/transpose");
+}
+
+static void checkHierarchy(uint32_t nodeCount)
+{
+    std::mt19937 rng(11);
+    Forest forest;
+    buildForest(forest, nodeCount, rng);
+    std::vector<SceneMatrix> worlds(forest.reference.size()), gpuWorlds(forest.reference.size());
+
+    auto stats = forest.scene.updateTransforms();
+    referenceUpdate(forest.reference, worlds, gpuWorlds);
+    if (stats.localUpdates != forest.scene.size() || stats.worldUpdates != forest.scene.size())
+        fail("first update covers every node");
+    auto error = maxError(forest, gpuWorlds);
+
+    // random edits at every level, then no edits at all
+    std::uniform_int_distribution<uint32_t> pick(0, forest.scene.size() - 1);
+    for (int round = 0; round < 20; round++)
+    {
+        for (int i = 0; i < 50; i++)
+            randomize(forest, pick(rng), rng);
+        forest.scene.updateTransforms();
+        referenceUpdate(forest.reference, worlds, gpuWorlds);
+        error = std::max(error, maxError(forest, gpuWorlds));
+    }
+    stats = forest.scene.updateTransforms();
+    if (stats.localUpdates || stats.worldUpdates)
+        fail("unchanged scene updates nothing");
+
+    // one root moves its 100 nodes, nothing else
+    float p[3] = { 1, 2, 3 }, q[4] = { 0, 0, 0, 1 }, s[3] = { 1, 1, 1 };
+    setNode(forest, forest.roots[3], p, q, s);
+    stats = forest.scene.updateTransforms();
+    referenceUpdate(forest.reference, worlds, gpuWorlds);
+    error = std::max(error, maxError(forest, gpuWorlds));
+    if (stats.localUpdates != 1 || stats.worldUpdates != 100)
+        fail("a moved root updates its subtree only");
+
+    printf("hierarchy: %u nodes, max relative error %g\n", forest.scene.size(), error);
+    if (error > 1e-4f)
+        fail("world matrices match the reference");
+}
+
+static double timeFrames(int frames, std::function<void(int)> const& frame)
+{
+    using Clock = std::chrono::steady_clock;
+    double best = 1e30;
+    for (int f = 0; f < frames; f++)
+    {
+        auto start = Clock::now();
+        frame(f);
+        best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+static void benchmark(uint32_t nodeCount, int frames)
+{
+    std::mt19937 rng(3);
+    Forest forest;
+    buildForest(forest, nodeCount, rng);
+    forest.scene.updateTransforms();
+    auto count = forest.scene.size();
+    std::vector<SceneMatrix> worlds(count), gpuWorlds(count);
+
+    printf("\n%u nodes, best of %d frames:\n", count, frames);
+    auto reference = timeFrames(frames, [&](int) { referenceUpdate(forest.reference, worlds, gpuWorlds); });
+    printf("  %-28s %8.3f ms\n", "rebuild all, scalar AoS", reference);
+
+    // changes are made outside the timed part, the renderer's input comes from the simulation
+    struct Case
+    {
+        char const* name;
+        std::function<void()> change;
+    };
+    float p[3] = { 0, 0, 0 }, q[4] = { 0, 0, 0, 1 }, s[3] = { 1, 1, 1 };
+    Case cases[] = {
+        { "static", []() {} },
+        { "1% of leaves moved", [&]() {
+            for (size_t i = 0; i < forest.leaves.size(); i += 100)
+                setNode(forest, forest.leaves[i], p, q, s);
+        } },
+        { "every root moved", [&]() {
+            for (auto root : forest.roots)
+                setNode(forest, root, p, q, s);
+        } },
+        { "every node moved", [&]() {
+            for (SceneNode i = 0; i < count; i++)
+                setNode(forest, i, p, q, s);
+        } },
+    };
+    for (auto& c : cases)
+    {
+        using Clock = std::chrono::steady_clock;
+        double best = 1e30;
+        SceneUpdateStats stats;
+        for (int f = 0; f < frames; f++)
+        {
+            p[0] = static_cast<float>(f);
+            c.change();
+            auto start = Clock::now();
+            stats = forest.scene.updateTransforms();
+            best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        printf("  %-28s %8.3f ms  %6u local, %6u world, %.1fx\n", c.name, best, stats.localUpdates,
+            stats.worldUpdates, reference / std::max(best, 1e-6));
+    }
+
+    referenceUpdate(forest.reference, worlds, gpuWorlds);
+    if (maxError(forest, gpuWorlds) > 1e-4f)
+        fail("benchmark results match the reference");
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t nodes = 100000;
+    int frames = 50;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--nodes") && i + 1 < argc)
+            nodes = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--frames") && i + 1 < argc)
+            frames = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [--nodes n] [--frames n]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    checkBatches();
+    checkHierarchy(10000);
+    benchmark(std::max(nodes, 100u), std::max(frames, 1));
+
+    printf(ok ? "ok\n" : "failed\n");
+    return ok ? 0 : 1;
+}
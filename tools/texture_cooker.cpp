@@ -0,0 +1,717 @@
+//--------------------------------------------------------------------------------------
+// Offline texture cooker: source image(s) -> mip chain -> BC1/BC7/BC6H -> DDS
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -pthread -I.. texture_cooker.cpp bc_encoder.cpp ../dds.cpp -o texture_cooker
+//
+// Usage:
+//   texture_cooker [options] <input> <output.dds>
+//   texture_cooker [options] --cube <+x> <-x> <+y> <-y> <+z> <-z> <output.dds>
+//
+// Inputs: Radiance .hdr and .pfm (HDR), binary .ppm (P6) and .pam (P7, RGBA) (LDR).
+// Options:
+//   --format bc1|bc7|bc6h   default: bc6h for HDR sources, bc7 for LDR
+//   --linear                LDR data is not sRGB encoded
+//   --no-mips               write only the top level
+//   -j <threads>            encoder threads, default: all cores
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+#include "dds.h"
+#include "bc_encoder.h"
+
+
+namespace {
+
+// DXGI_FORMAT values written by the cooker
+const uint32_t FORMAT_BC1_UNORM = 71;
+const uint32_t FORMAT_BC1_UNORM_SRGB = 72;
+const uint32_t FORMAT_BC6H_UF16 = 95;
+const uint32_t FORMAT_BC7_UNORM = 98;
+const uint32_t FORMAT_BC7_UNORM_SRGB = 99;
+
+enum class Codec { None, BC1, BC7, BC6H };
+
+struct Image
+{
+    uint32_t width = 0, height = 0;
+    bool hdr = false;
+    // linear RGBA
+    std::vector<float> pixels;
+
+    float* at(uint32_t x, uint32_t y) { return &pixels[(static_cast<size_t>(y) * width + x) * 4]; }
+    float const* at(uint32_t x, uint32_t y) const { return &pixels[(static_cast<size_t>(y) * width + x) * 4]; }
+};
+
+//--------------------------------------------------------------------------------------
+// Image readers
+//--------------------------------------------------------------------------------------
+
+std::vector<uint8_t> readFile(std::string const& path)
+{
+    std::vector<uint8_t> data;
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f)
+        return data;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size > 0) {
+        data.resize(static_cast<size_t>(size));
+        if (fread(data.data(), 1, data.size(), f) != data.size())
+            data.clear();
+    }
+    fclose(f);
+    return data;
+}
+
+// reads a whitespace separated token of a PNM/PFM header, skipping comments
+bool readToken(std::vector<uint8_t> const& data, size_t& pos, std::string& token)
+{
+    token.clear();
+    while (pos < data.size()) {
+        if (data[pos] == '#') {
+            while (pos < data.size() && data[pos] != '\n')
+                pos++;
+        }
+        else if (isspace(data[pos])) {
+            pos++;
+        }
+        else {
+            break;
+        }
+    }
+    while (pos < data.size() && !isspace(data[pos]))
+        token += static_cast<char>(data[pos++]);
+    return !token.empty();
+}
+
+float srgbToLinear(float c)
+{
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSrgb(float c)
+{
+    c = std::min(std::max(c, 0.0f), 1.0f);
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+bool loadPNM(std::vector<uint8_t> const& data, bool srgb, Image& img)
+{
+    size_t pos = 0;
+    std::string magic, token;
+    if (!readToken(data, pos, magic))
+        return false;
+
+    uint32_t channels = 3, maxval = 0;
+    if (magic == "P6") {
+        if (!readToken(data, pos, token)) return false;
+        img.width = static_cast<uint32_t>(atoi(token.c_str()));
+        if (!readToken(data, pos, token)) return false;
+        img.height = static_cast<uint32_t>(atoi(token.c_str()));
+        if (!readToken(data, pos, token)) return false;
+        maxval = static_cast<uint32_t>(atoi(token.c_str()));
+    }
+    else if (magic == "P7") {
+        while (readToken(data, pos, token) && token != "ENDHDR") {
+            std::string value;
+            if (!readToken(data, pos, value))
+                return false;
+            if (token == "WIDTH") img.width = static_cast<uint32_t>(atoi(value.c_str()));
+            else if (token == "HEIGHT") img.height = static_cast<uint32_t>(atoi(value.c_str()));
+            else if (token == "DEPTH") channels = static_cast<uint32_t>(atoi(value.c_str()));
+            else if (token == "MAXVAL") maxval = static_cast<uint32_t>(atoi(value.c_str()));
+        }
+    }
+    else {
+        return false;
+    }
+    pos++; // single whitespace before the raster
+
+    if (maxval != 255 || (channels != 3 && channels != 4) || img.width == 0 || img.height == 0)
+        return false;
+    if (data.size() < pos + static_cast<size_t>(img.width) * img.height * channels)
+        return false;
+
+    img.hdr = false;
+    img.pixels.resize(static_cast<size_t>(img.width) * img.height * 4);
+    for (size_t i = 0; i < static_cast<size_t>(img.width) * img.height; i++) {
+        uint8_t const* src = &data[pos + i * channels];
+        for (uint32_t c = 0; c < 3; c++) {
+            float v = src[c] / 255.0f;
+            img.pixels[i * 4 + c] = srgb ? srgbToLinear(v) : v;
+        }
+        img.pixels[i * 4 + 3] = channels == 4 ? src[3] / 255.0f : 1.0f;
+    }
+    return true;
+}
+
+bool loadPFM(std::vector<uint8_t> const& data, Image& img)
+{
+    size_t pos = 0;
+    std::string token;
+    if (!readToken(data, pos, token) || (token != "PF" && token != "Pf"))
+        return false;
+    uint32_t channels = token == "PF" ? 3 : 1;
+
+    if (!readToken(data, pos, token)) return false;
+    img.width = static_cast<uint32_t>(atoi(token.c_str()));
+    if (!readToken(data, pos, token)) return false;
+    img.height = static_cast<uint32_t>(atoi(token.c_str()));
+    if (!readToken(data, pos, token)) return false;
+    bool bigEndian = atof(token.c_str()) > 0;
+    pos++;
+
+    size_t count = static_cast<size_t>(img.width) * img.height;
+    if (count == 0 || data.size() < pos + count * channels * sizeof(float))
+        return false;
+
+    img.hdr = true;
+    img.pixels.resize(count * 4);
+    for (uint32_t y = 0; y < img.height; y++) {
+        // PFM scanlines are stored bottom to top
+        uint32_t row = img.height - 1 - y;
+        for (uint32_t x = 0; x < img.width; x++) {
+            float* dst = img.at(x, row);
+            for (uint32_t c = 0; c < 3; c++) {
+                uint8_t b[4];
+                memcpy(b, &data[pos + ((static_cast<size_t>(y) * img.width + x) * channels + (channels == 3 ? c : 0)) * 4], 4);
+                if (bigEndian) {
+                    std::swap(b[0], b[3]);
+                    std::swap(b[1], b[2]);
+                }
+                memcpy(&dst[c], b, 4);
+            }
+            dst[3] = 1.0f;
+        }
+    }
+    return true;
+}
+
+bool loadHDR(std::vector<uint8_t> const& data, Image& img)
+{
+    size_t pos = 0;
+    auto readLine = [&](std::string& line) {
+        line.clear();
+        while (pos < data.size() && data[pos] != '\n')
+            line += static_cast<char>(data[pos++]);
+        pos++;
+        return pos <= data.size();
+    };
+
+    std::string line;
+    if (!readLine(line) || (line.rfind("#?RADIANCE", 0) != 0 && line.rfind("#?RGBE", 0) != 0))
+        return false;
+    do {
+        if (!readLine(line))
+            return false;
+        if (line.rfind("FORMAT=", 0) == 0 && line != "FORMAT=32-bit_rle_rgbe")
+            return false;
+    } while (!line.empty());
+
+    // only the standard orientation is supported
+    char ySign, xSign;
+    int h, w;
+    if (!readLine(line) || sscanf(line.c_str(), "%cY %d %cX %d", &ySign, &h, &xSign, &w) != 4 ||
+        ySign != '-' || xSign != '+' || w <= 0 || h <= 0)
+        return false;
+
+    img.width = static_cast<uint32_t>(w);
+    img.height = static_cast<uint32_t>(h);
+    img.hdr = true;
+    img.pixels.resize(static_cast<size_t>(w) * h * 4);
+
+    std::vector<uint8_t> scanline(static_cast<size_t>(w) * 4);
+    for (uint32_t y = 0; y < img.height; y++) {
+        if (pos + 4 > data.size())
+            return false;
+
+        bool rle = w >= 8 && w < 32768 && data[pos] == 2 && data[pos + 1] == 2 &&
+            ((data[pos + 2] << 8) | data[pos + 3]) == w;
+        if (rle) {
+            pos += 4;
+            for (int c = 0; c < 4; c++) {
+                int x = 0;
+                while (x < w) {
+                    if (pos >= data.size())
+                        return false;
+                    int count = data[pos++];
+                    if (count > 128) {
+                        count -= 128;
+                        if (x + count > w || pos >= data.size())
+                            return false;
+                        uint8_t value = data[pos++];
+                        for (int i = 0; i < count; i++)
+                            scanline[(x++) * 4 + c] = value;
+                    }
+                    else {
+                        if (count == 0 || x + count > w || pos + count > data.size())
+                            return false;
+                        for (int i = 0; i < count; i++)
+                            scanline[(x++) * 4 + c] = data[pos++];
+                    }
+                }
+            }
+        }
+        else {
+            if (pos + scanline.size() > data.size())
+                return false;
+            memcpy(scanline.data(), &data[pos], scanline.size());
+            pos += scanline.size();
+        }
+
+        for (uint32_t x = 0; x < img.width; x++) {
+            uint8_t const* rgbe = &scanline[x * 4];
+            float* dst = img.at(x, y);
+            float scale = rgbe[3] ? std::ldexp(1.0f, rgbe[3] - (128 + 8)) : 0.0f;
+            for (int c = 0; c < 3; c++)
+                dst[c] = (rgbe[c] + 0.5f) * scale;
+            dst[3] = 1.0f;
+        }
+    }
+    return true;
+}
+
+bool loadImage(std::string const& path, bool srgb, Image& img)
+{
+    auto data = readFile(path);
+    if (data.empty())
+        return false;
+
+    auto ext = path.substr(path.find_last_of('.') + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    if (ext == "hdr")
+        return loadHDR(data, img);
+    if (ext == "pfm")
+        return loadPFM(data, img);
+    if (ext == "ppm" || ext == "pam")
+        return loadPNM(data, srgb, img);
+    return false;
+}
+
+//--------------------------------------------------------------------------------------
+// Mip generation: separable Kaiser-windowed sinc in linear space
+//--------------------------------------------------------------------------------------
+
+double besselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+float kaiserSinc(float x)
+{
+    const float radius = 3.0f, alpha = 4.0f;
+    if (std::fabs(x) >= radius)
+        return 0.0f;
+    float sinc = std::fabs(x) < 1e-6f ? 1.0f :
+        std::sin(3.14159265f * x) / (3.14159265f * x);
+    float t = x / radius;
+    float window = static_cast<float>(besselI0(alpha * std::sqrt(1.0 - t * t)) / besselI0(alpha));
+    return sinc * window;
+}
+
+struct FilterTap
+{
+    int first;
+    std::vector<float> weights;
+};
+
+std::vector<FilterTap> buildFilter(uint32_t srcSize, uint32_t dstSize)
+{
+    std::vector<FilterTap> taps(dstSize);
+    float scale = static_cast<float>(srcSize) / dstSize;
+    float support = 3.0f * scale;
+
+    for (uint32_t i = 0; i < dstSize; i++) {
+        float center = (i + 0.5f) * scale;
+        int first = static_cast<int>(std::floor(center - support));
+        int last = static_cast<int>(std::ceil(center + support));
+
+        taps[i].first = first;
+        float sum = 0;
+        for (int j = first; j <= last; j++) {
+            float w = kaiserSinc((j + 0.5f - center) / scale);
+            taps[i].weights.push_back(w);
+            sum += w;
+        }
+        for (auto& w : taps[i].weights)
+            w /= sum;
+    }
+    return taps;
+}
+
+Image downsample(Image const& src)
+{
+    Image dst;
+    dst.width = std::max<uint32_t>(1, src.width / 2);
+    dst.height = std::max<uint32_t>(1, src.height / 2);
+    dst.hdr = src.hdr;
+
+    auto hTaps = buildFilter(src.width, dst.width);
+    auto vTaps = buildFilter(src.height, dst.height);
+
+    // horizontal pass into a temporary of size dst.width x src.height
+    std::vector<float> tmp(static_cast<size_t>(dst.width) * src.height * 4, 0.0f);
+    for (uint32_t y = 0; y < src.height; y++)
+        for (uint32_t x = 0; x < dst.width; x++) {
+            float* out = &tmp[(static_cast<size_t>(y) * dst.width + x) * 4];
+            auto const& tap = hTaps[x];
+            for (size_t k = 0; k < tap.weights.size(); k++) {
+                int sx = std::min<int>(std::max<int>(tap.first + static_cast<int>(k), 0), src.width - 1);
+                float const* in = src.at(sx, y);
+                for (int c = 0; c < 4; c++)
+                    out[c] += in[c] * tap.weights[k];
+            }
+        }
+
+    dst.pixels.assign(static_cast<size_t>(dst.width) * dst.height * 4, 0.0f);
+    for (uint32_t y = 0; y < dst.height; y++)
+        for (uint32_t x = 0; x < dst.width; x++) {
+            float* out = dst.at(x, y);
+            auto const& tap = vTaps[y];
+            for (size_t k = 0; k < tap.weights.size(); k++) {
+                int sy = std::min<int>(std::max<int>(tap.first + static_cast<int>(k), 0), src.height - 1);
+                float const* in = &tmp[(static_cast<size_t>(sy) * dst.width + x) * 4];
+                for (int c = 0; c < 4; c++)
+                    out[c] += in[c] * tap.weights[k];
+            }
+            // negative lobes can ring below zero
+            for (int c = 0; c < 4; c++)
+                out[c] = std::max(out[c], 0.0f);
+            if (!dst.hdr)
+                out[3] = std::min(out[3], 1.0f);
+        }
+
+    return dst;
+}
+
+//--------------------------------------------------------------------------------------
+// Encoding
+//--------------------------------------------------------------------------------------
+
+struct Surface
+{
+    Image image;
+    std::vector<uint8_t> encoded;
+    uint32_t blocksWide = 0, blocksHigh = 0;
+};
+
+int blockBytes(Codec codec)
+{
+    return codec == Codec::BC1 ? BC1_BLOCK_BYTES : BC7_BLOCK_BYTES;
+}
+
+void fetchBlockLDR(Image const& img, uint32_t bx, uint32_t by, bool srgb, uint8_t rgba[16][4])
+{
+    for (uint32_t i = 0; i < 16; i++) {
+        // replicate edge pixels for surfaces smaller than a block
+        uint32_t x = std::min(bx * 4 + i % 4, img.width - 1);
+        uint32_t y = std::min(by * 4 + i / 4, img.height - 1);
+        float const* p = img.at(x, y);
+        for (int c = 0; c < 4; c++) {
+            float v = (c < 3 && srgb) ? linearToSrgb(p[c]) : std::min(std::max(p[c], 0.0f), 1.0f);
+            rgba[i][c] = static_cast<uint8_t>(std::lround(v * 255.0f));
+        }
+    }
+}
+
+void fetchBlockHDR(Image const& img, uint32_t bx, uint32_t by, float rgb[16][3])
+{
+    for (uint32_t i = 0; i < 16; i++) {
+        uint32_t x = std::min(bx * 4 + i % 4, img.width - 1);
+        uint32_t y = std::min(by * 4 + i / 4, img.height - 1);
+        float const* p = img.at(x, y);
+        for (int c = 0; c < 3; c++)
+            rgb[i][c] = p[c];
+    }
+}
+
+void encodeSurfaces(std::vector<Surface>& surfaces, Codec codec, bool srgb, unsigned threadCount)
+{
+    // a job is one row of blocks of one surface
+    struct Job { size_t surface; uint32_t row; };
+    std::vector<Job> jobs;
+    for (size_t s = 0; s < surfaces.size(); s++) {
+        auto& surf = surfaces[s];
+        surf.blocksWide = std::max<uint32_t>(1, (surf.image.width + 3) / 4);
+        surf.blocksHigh = std::max<uint32_t>(1, (surf.image.height + 3) / 4);
+        surf.encoded.resize(static_cast<size_t>(surf.blocksWide) * surf.blocksHigh * blockBytes(codec));
+        for (uint32_t row = 0; row < surf.blocksHigh; row++)
+            jobs.push_back({ s, row });
+    }
+
+    std::atomic<size_t> next = 0;
+    auto worker = [&]() {
+        for (size_t j = next++; j < jobs.size(); j = next++) {
+            auto& surf = surfaces[jobs[j].surface];
+            uint32_t by = jobs[j].row;
+            for (uint32_t bx = 0; bx < surf.blocksWide; bx++) {
+                uint8_t* out = &surf.encoded[(static_cast<size_t>(by) * surf.blocksWide + bx) * blockBytes(codec)];
+                if (codec == Codec::BC6H) {
+                    float rgb[16][3];
+                    fetchBlockHDR(surf.image, bx, by, rgb);
+                    encodeBC6HBlock(rgb, out);
+                }
+                else {
+                    uint8_t rgba[16][4];
+                    fetchBlockLDR(surf.image, bx, by, srgb, rgba);
+                    if (codec == Codec::BC1)
+                        encodeBC1Block(rgba, out);
+                    else
+                        encodeBC7Block(rgba, out);
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threadCount; t++)
+        pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool)
+        t.join();
+}
+
+// PSNR of the decoded surfaces against the (quantized) encoder input.
+// LDR is measured on 8-bit RGB, HDR on linear RGB with the source peak as signal.
+double measurePSNR(std::vector<Surface> const& surfaces, Codec codec, bool srgb)
+{
+    double sqErr = 0, peak = 0;
+    size_t samples = 0;
+
+    for (auto const& surf : surfaces)
+        for (uint32_t by = 0; by < surf.blocksHigh; by++)
+            for (uint32_t bx = 0; bx < surf.blocksWide; bx++) {
+                uint8_t const* in = &surf.encoded[(static_cast<size_t>(by) * surf.blocksWide + bx) * blockBytes(codec)];
+                for (uint32_t i = 0; i < 16; i++) {
+                    uint32_t x = bx * 4 + i % 4, y = by * 4 + i / 4;
+                    if (x >= surf.image.width || y >= surf.image.height)
+                        continue;
+
+                    if (codec == Codec::BC6H) {
+                        float src[16][3], dec[16][3];
+                        fetchBlockHDR(surf.image, bx, by, src);
+                        decodeBC6HBlock(in, dec);
+                        for (int c = 0; c < 3; c++) {
+                            double s = std::min(std::max(src[i][c], 0.0f), 65504.0f);
+                            sqErr += (s - dec[i][c]) * (s - dec[i][c]);
+                            peak = std::max(peak, s);
+                        }
+                    }
+                    else {
+                        uint8_t src[16][4], dec[16][4];
+                        fetchBlockLDR(surf.image, bx, by, srgb, src);
+                        if (codec == Codec::BC1)
+                            decodeBC1Block(in, dec);
+                        else
+                            decodeBC7Block(in, dec);
+                        for (int c = 0; c < 3; c++) {
+                            double d = static_cast<double>(src[i][c]) - dec[i][c];
+                            sqErr += d * d;
+                        }
+                        peak = 255.0;
+                    }
+                    samples += 3;
+                }
+            }
+
+    if (samples == 0 || sqErr == 0)
+        return INFINITY;
+    return 10.0 * std::log10(peak * peak / (sqErr / samples));
+}
+
+bool writeDDS(std::string const& path, std::vector<Surface> const& surfaces,
+    uint32_t faces, uint32_t mipCount, uint32_t format)
+{
+    auto const& top = surfaces[0].image;
+
+    DDSFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.size = sizeof(DDSFileHeader);
+    // CAPS | HEIGHT | WIDTH | PIXELFORMAT | MIPMAPCOUNT | LINEARSIZE
+    header.flags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;
+    header.width = top.width;
+    header.height = top.height;
+    header.pitchOrLinearSize = static_cast<uint32_t>(surfaces[0].encoded.size());
+    header.mipMapCount = mipCount;
+    header.ddspf.size = sizeof(DDSPixelFormat);
+    header.ddspf.flags = DDS_FOURCC;
+    header.ddspf.fourCC = makeFourCC('D', 'X', '1', '0');
+    // TEXTURE | MIPMAP | COMPLEX
+    header.caps = 0x1000 | (mipCount > 1 ? 0x400000 | 0x8 : 0);
+    if (faces == 6) {
+        header.caps |= 0x8;
+        header.caps2 = DDS_CUBEMAP | DDS_CUBEMAP_ALLFACES;
+    }
+
+    DDSFileHeaderDXT10 dx10;
+    memset(&dx10, 0, sizeof(dx10));
+    dx10.dxgiFormat = format;
+    dx10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+    dx10.miscFlag = faces == 6 ? DDS_RESOURCE_MISC_TEXTURECUBE : 0;
+    dx10.arraySize = 1;
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f)
+        return false;
+
+    bool ok = fwrite(&DDS_MAGIC, sizeof(DDS_MAGIC), 1, f) == 1 &&
+        fwrite(&header, sizeof(header), 1, f) == 1 &&
+        fwrite(&dx10, sizeof(dx10), 1, f) == 1;
+
+    // surfaces are already in face-major, mip-minor order
+    for (auto const& surf : surfaces)
+        ok = ok && fwrite(surf.encoded.data(), 1, surf.encoded.size(), f) == surf.encoded.size();
+
+    fclose(f);
+    return ok;
+}
+
+void usage()
+{
+    fprintf(stderr,
+        "usage: texture_cooker [--format bc1|bc7|bc6h] [--linear] [--no-mips] [-j N]\n"
+        "                      (<input> | --cube <+x> <-x> <+y> <-y> <+z> <-z>) <output.dds>\n");
+}
+
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+    Codec codec = Codec::None;
+    bool srgb = true;
+    bool mips = true;
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> inputs;
+    bool cube = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc) {
+            std::string fmt = argv[++i];
+            codec = fmt == "bc1" ? Codec::BC1 : fmt == "bc7" ? Codec::BC7 : fmt == "bc6h" ? Codec::BC6H : Codec::None;
+            if (codec == Codec::None) {
+                usage();
+                return 1;
+            }
+        }
+        else if (arg == "--linear") {
+            srgb = false;
+        }
+        else if (arg == "--no-mips") {
+            mips = false;
+        }
+        else if (arg == "-j" && i + 1 < argc) {
+            threadCount = std::max(1, atoi(argv[++i]));
+        }
+        else if (arg == "--cube") {
+            cube = true;
+        }
+        else {
+            inputs.push_back(arg);
+        }
+    }
+
+    size_t faceCount = cube ? 6 : 1;
+    if (inputs.size() != faceCount + 1) {
+        usage();
+        return 1;
+    }
+    std::string output = inputs.back();
+    inputs.pop_back();
+
+    std::vector<Image> faces(faceCount);
+    for (size_t f = 0; f < faceCount; f++) {
+        if (!loadImage(inputs[f], srgb, faces[f])) {
+            fprintf(stderr, "failed to load %s\n", inputs[f].c_str());
+            return 1;
+        }
+        if (faces[f].width != faces[0].width || faces[f].height != faces[0].height ||
+            faces[f].hdr != faces[0].hdr) {
+            fprintf(stderr, "cube faces must share size and type\n");
+            return 1;
+        }
+    }
+
+    bool hdr = faces[0].hdr;
+    if (codec == Codec::None)
+        codec = hdr ? Codec::BC6H : Codec::BC7;
+    if (codec != Codec::BC6H && hdr)
+        fprintf(stderr, "warning: HDR source clamped to [0, 1] for an LDR format\n");
+
+    // D3D11 requires the top level of a BC texture to be block aligned
+    if (faces[0].width % 4 || faces[0].height % 4) {
+        fprintf(stderr, "source size must be a multiple of 4 (%ux%u)\n", faces[0].width, faces[0].height);
+        return 1;
+    }
+    if (cube && faces[0].width != faces[0].height) {
+        fprintf(stderr, "cube faces must be square\n");
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    uint32_t mipCount = 1;
+    if (mips)
+        for (uint32_t d = std::max(faces[0].width, faces[0].height); d > 1; d >>= 1)
+            mipCount++;
+
+    std::vector<Surface> surfaces;
+    surfaces.reserve(faceCount * mipCount);
+    for (auto& face : faces) {
+        Surface top;
+        top.image = std::move(face);
+        surfaces.push_back(std::move(top));
+        for (uint32_t mip = 1; mip < mipCount; mip++) {
+            Surface s;
+            s.image = downsample(surfaces.back().image);
+            surfaces.push_back(std::move(s));
+        }
+    }
+
+    auto mipsDone = std::chrono::steady_clock::now();
+    encodeSurfaces(surfaces, codec, srgb, threadCount);
+    auto encodeDone = std::chrono::steady_clock::now();
+
+    uint32_t format = codec == Codec::BC6H ? FORMAT_BC6H_UF16 :
+        codec == Codec::BC1 ? (srgb ? FORMAT_BC1_UNORM_SRGB : FORMAT_BC1_UNORM) :
+        (srgb ? FORMAT_BC7_UNORM_SRGB : FORMAT_BC7_UNORM);
+
+    if (!writeDDS(output, surfaces, static_cast<uint32_t>(faceCount), mipCount, format)) {
+        fprintf(stderr, "failed to write %s\n", output.c_str());
+        return 1;
+    }
+
+    double pixels = 0;
+    for (auto const& s : surfaces)
+        pixels += static_cast<double>(s.image.width) * s.image.height;
+
+    double mipSeconds = std::chrono::duration<double>(mipsDone - start).count();
+    double encodeSeconds = std::chrono::duration<double>(encodeDone - mipsDone).count();
+    const char* codecName = codec == Codec::BC1 ? "BC1" : codec == Codec::BC7 ? "BC7" : "BC6H";
+
+    printf("%s: %zu face(s), %u mip(s), %s%s, %u thread(s)\n", output.c_str(), faceCount, mipCount,
+        codecName, codec != Codec::BC6H && srgb ? " sRGB" : "", threadCount);
+    printf("  mips:   %.3f s\n", mipSeconds);
+    printf("  encode: %.3f s, %.2f MPix/s\n", encodeSeconds, pixels / 1e6 / std::max(encodeSeconds, 1e-9));
+    printf("  PSNR:   %.2f dB\n", measurePSNR(surfaces, codec, srgb));
+
+    return 0;
+}
@@ -0,0 +1,360 @@
+//--------------------------------------------------------------------------------------
+// Checks of the texture residency policy against a fake allocator: deduplication by
+// path, budget enforcement by dropping detailed mips down to the minimum resident
+// size, textures used in the current frame left alone, eviction of unreferenced
+// textures only, mip restores once the budget allows, block aligned mips for BC
+// textures, and the reported statistics.
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -I.. texture_residency_check.cpp ../texture_residency.cpp ../dds.cpp -o texture_residency_check
+//
+// Usage:
+//   texture_residency_check
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "texture_residency.h"
+
+static bool ok = true;
+
+static void check(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+}
+
+// DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_BC1_UNORM
+constexpr uint32_t formatRGBA8 = 28;
+constexpr uint32_t formatBC1 = 71;
+
+// 256x256 RGBA8 with a full chain, and the same with mips finer than 1 and 2 dropped
+constexpr uint64_t fullBytes = 4 * 87381;
+constexpr uint64_t mip1Bytes = 4 * 21845;
+constexpr uint64_t mip2Bytes = 4 * 5461;
+
+// Resources live in a map keyed by id; paths not registered fail to load
+struct FakeAllocator : TextureAllocator
+{
+    std::map<std::wstring, TextureDesc> files;
+    std::map<TextureId, uint32_t> live;    // id -> first mip
+    std::map<TextureId, TextureDesc> descs;
+    uint32_t creates = 0;
+    uint32_t destroys = 0;
+    uint32_t mipChanges = 0;
+    // requests TextureManager would refuse, StreamedTexture can't start a BC texture there
+    uint32_t unalignedMips = 0;
+    bool failMipChanges = false;
+
+    void addFile(std::wstring const& path, uint32_t size = 256, uint32_t format = formatRGBA8)
+    {
+        TextureDesc desc;
+        desc.width = size;
+        desc.height = size;
+        desc.format = format;
+        while ((size >> desc.mipCount) > 0)
+            desc.mipCount++;
+        files[path] = desc;
+    }
+
+    bool create(TextureId id, std::wstring const& path, TextureDesc& desc) override
+    {
+        auto found = files.find(path);
+        if (found == files.end())
+            return false;
+        desc = found->second;
+        descs[id] = desc;
+        live[id] = 0;
+        creates++;
+        return true;
+    }
+
+    bool setFirstMip(TextureId id, uint32_t firstMip) override
+    {
+        if (failMipChanges || !live.count(id))
+            return false;
+        if (!isValidFirstMip(descs[id], firstMip))
+        {
+            unalignedMips++;
+            return false;
+        }
+        live[id] = firstMip;
+        mipChanges++;
+        return true;
+    }
+
+    void destroy(TextureId id) override
+    {
+        live.erase(id);
+        destroys++;
+    }
+};
+
+// the residency view of a texture matches the resource the allocator holds
+static bool matches(FakeAllocator const& allocator, TextureResidency const& residency, TextureId id)
+{
+    auto found = allocator.live.find(id);
+    if (found == allocator.live.end())
+        return !residency.isResident(id);
+    return residency.isResident(id) && residency.firstMip(id) == found->second;
+}
+
+static void checkEstimate()
+{
+    TextureDesc desc;
+    desc.width = 256;
+    desc.height = 256;
+    desc.mipCount = 9;
+    desc.format = formatRGBA8;
+    check(estimateTextureBytes(desc) == fullBytes, "estimate of a full chain");
+    check(estimateTextureBytes(desc, 1) == mip1Bytes, "estimate from mip 1");
+    check(estimateTextureBytes(desc, 2) == mip2Bytes, "estimate from mip 2");
+    check(estimateTextureBytes(desc, 9) == 0, "estimate past the chain");
+    desc.arraySize = 6;
+    check(estimateTextureBytes(desc) == 6 * fullBytes, "estimate counts every slice");
+}
+
+static void checkBlockAlignment()
+{
+    // 200x200 BC1: mips 0, 1 and 4 (200, 100, 12) are whole blocks, 2 and 3 (50, 25) are not
+    FakeAllocator allocator;
+    allocator.addFile(L"bc.dds", 200, formatBC1);
+    TextureDesc desc = allocator.files[L"bc.dds"];
+    check(isValidFirstMip(desc, 0) && isValidFirstMip(desc, 1) && isValidFirstMip(desc, 4), "aligned BC mips");
+    check(!isValidFirstMip(desc, 2) && !isValidFirstMip(desc, 3) && !isValidFirstMip(desc, 5), "unaligned BC mips");
+    desc.format = formatRGBA8;
+    check(isValidFirstMip(desc, 3), "uncompressed mips are always valid");
+
+    TextureResidency residency(allocator, UINT64_MAX);
+    TextureId bc = residency.acquire(L"bc.dds");
+    residency.update();
+
+    // the 64 pixel minimum would be mip 2, the closest aligned mip above it is 1
+    residency.setBudget(1);
+    residency.update();
+    check(residency.firstMip(bc) == 1 && matches(allocator, residency, bc), "trim stops at an aligned mip");
+    uint32_t changes = allocator.mipChanges;
+    residency.update();
+    residency.update();
+    check(allocator.mipChanges == changes, "aligned trim is not requested again");
+
+    // with a 12 pixel minimum the trim can skip the unaligned mips
+    residency.setMinResidentSize(12);
+    residency.update();
+    check(residency.firstMip(bc) == 4 && matches(allocator, residency, bc), "trim skips unaligned mips");
+
+    // room for mip 2 but not mip 1: stays at 4 rather than asking for 2
+    residency.setBudget(estimateTextureBytes(allocator.files[L"bc.dds"], 2));
+    residency.touch(bc);
+    residency.update();
+    check(residency.firstMip(bc) == 4, "restore skips unaligned mips");
+    residency.setBudget(estimateTextureBytes(allocator.files[L"bc.dds"], 1));
+    residency.touch(bc);
+    residency.update();
+    check(residency.firstMip(bc) == 1 && matches(allocator, residency, bc), "restore to an aligned mip");
+    check(allocator.unalignedMips == 0, "no unaligned mip requested");
+}
+
+static void checkDedup()
+{
+    FakeAllocator allocator;
+    allocator.addFile(L"a.dds");
+    allocator.addFile(L"b.dds");
+    TextureResidency residency(allocator, UINT64_MAX);
+
+    TextureId a = residency.acquire(L"a.dds");
+    TextureId a2 = residency.acquire(L"a.dds");
+    TextureId b = residency.acquire(L"b.dds");
+    check(a != InvalidTextureId && a == a2, "same path gives the same texture");
+    check(b != InvalidTextureId && b != a, "other path gives another texture");
+    check(allocator.creates == 2, "deduplicated load does not create");
+    check(residency.stats().loads == 2 && residency.stats().dedupedLoads == 1, "load counters");
+
+    check(residency.acquire(L"missing.dds") == InvalidTextureId, "failed load returns an invalid id");
+    check(residency.stats().loads == 2 && residency.stats().textureCount == 2, "failed load is not counted");
+    allocator.addFile(L"missing.dds");
+    check(residency.acquire(L"missing.dds") != InvalidTextureId, "failed load is retried");
+}
+
+static void checkBudget()
+{
+    FakeAllocator allocator;
+    allocator.addFile(L"a.dds");
+    allocator.addFile(L"b.dds");
+    TextureResidency residency(allocator, UINT64_MAX);
+
+    // a last used in frame 1, b in frame 2
+    TextureId a = residency.acquire(L"a.dds");
+    residency.update();
+    TextureId b = residency.acquire(L"b.dds");
+    residency.update();
+    check(residency.stats().residentBytes == 2 * fullBytes, "full chains within budget");
+    check(residency.stats().trimmedCount == 0 && allocator.mipChanges == 0, "nothing trimmed within budget");
+
+    // room for one full texture and one without its top mip: the older one loses it
+    residency.setBudget(fullBytes + mip1Bytes);
+    residency.update();
+    check(residency.firstMip(a) == 1 && residency.firstMip(b) == 0, "oldest texture is trimmed first");
+    check(matches(allocator, residency, a) && matches(allocator, residency, b), "allocator sees the trimmed mips");
+    check(residency.stats().residentBytes == fullBytes + mip1Bytes, "trimmed to the budget");
+    check(residency.stats().trimmedCount == 1 && residency.stats().mipEvictions == 1, "trim counters");
+
+    // no room at all: both stop at the 64 pixel mip and stay resident while referenced
+    residency.setBudget(1);
+    residency.update();
+    check(residency.firstMip(a) == 2 && residency.firstMip(b) == 2, "trim stops at the minimum resident size");
+    check(residency.isResident(a) && residency.isResident(b), "referenced textures are not evicted");
+    check(matches(allocator, residency, a) && matches(allocator, residency, b), "allocator sees the minimum mips");
+    check(residency.stats().residentBytes == 2 * mip2Bytes, "resident bytes over budget");
+    check(residency.stats().requestedBytes == 2 * fullBytes, "requested bytes keep the full chains");
+    check(residency.stats().mipEvictions == 4 && residency.stats().trimmedCount == 2, "trim counters over budget");
+
+    uint32_t changes = allocator.mipChanges;
+    residency.update();
+    check(allocator.mipChanges == changes, "textures at their minimum are left alone");
+
+    // a smaller minimum lets the trim go further
+    residency.setMinResidentSize(16);
+    residency.update();
+    check(residency.firstMip(a) == 4 && residency.firstMip(b) == 4, "trim follows the minimum resident size");
+    check(matches(allocator, residency, a) && matches(allocator, residency, b), "allocator sees the smaller mips");
+}
+
+static void checkTouchedThisFrame()
+{
+    FakeAllocator allocator;
+    allocator.addFile(L"a.dds");
+    allocator.addFile(L"b.dds");
+    TextureResidency residency(allocator, UINT64_MAX);
+
+    TextureId a = residency.acquire(L"a.dds");
+    TextureId b = residency.acquire(L"b.dds");
+    residency.update();
+
+    residency.setBudget(1);
+    residency.touch(a);
+    residency.update();
+    check(residency.firstMip(a) == 0, "texture touched this frame is not trimmed");
+    check(residency.firstMip(b) == 2, "untouched texture is trimmed");
+
+    residency.update();
+    check(residency.firstMip(a) == 2, "texture is trimmed once no longer touched");
+
+    // unreferenced but drawn this frame: kept until the next update without a touch
+    residency.release(a);
+    residency.touch(a);
+    residency.update();
+    check(residency.isResident(a), "unreferenced texture touched this frame is not evicted");
+    residency.update();
+    check(!residency.isResident(a) && matches(allocator, residency, a), "unreferenced texture is evicted later");
+}
+
+static void checkEviction()
+{
+    FakeAllocator allocator;
+    allocator.addFile(L"a.dds");
+    allocator.addFile(L"b.dds");
+    TextureResidency residency(allocator, UINT64_MAX);
+
+    TextureId a = residency.acquire(L"a.dds");
+    residency.acquire(L"a.dds");
+    TextureId b = residency.acquire(L"b.dds");
+    residency.update();
+
+    // unreferenced textures stay cached while within budget
+    residency.release(b);
+    residency.update();
+    check(residency.isResident(b) && allocator.destroys == 0, "unreferenced texture is cached within budget");
+    check(residency.acquire(L"b.dds") == b && allocator.creates == 2, "cached texture is reused");
+    residency.release(b);
+    // the acquire counts as use in this frame
+    residency.update();
+
+    residency.setBudget(mip2Bytes);
+    residency.release(a);
+    residency.update();
+    check(residency.isResident(a), "texture with references left is not evicted");
+    check(!residency.isResident(b) && allocator.destroys == 1, "unreferenced texture is evicted");
+    check(matches(allocator, residency, a) && matches(allocator, residency, b), "allocator sees the eviction");
+    check(residency.stats().textureEvictions == 1 && residency.stats().textureCount == 1, "eviction counters");
+    check(residency.stats().residentBytes == mip2Bytes, "evicted bytes are released");
+
+    residency.release(a);
+    residency.release(a);
+    residency.setBudget(0);
+    residency.update();
+    check(!residency.isResident(a) && allocator.live.empty(), "extra release does not keep or break eviction");
+    check(residency.stats().textureEvictions == 2 && residency.stats().residentBytes == 0, "all evicted");
+
+    // path is free again after eviction
+    residency.setBudget(UINT64_MAX);
+    TextureId again = residency.acquire(L"b.dds");
+    check(again != InvalidTextureId && again != b && allocator.creates == 3, "evicted path loads a new texture");
+    check(residency.stats().loads == 3, "reload is counted as a load");
+}
+
+static void checkRestore()
+{
+    FakeAllocator allocator;
+    allocator.addFile(L"a.dds");
+    allocator.addFile(L"b.dds");
+    TextureResidency residency(allocator, UINT64_MAX);
+
+    TextureId a = residency.acquire(L"a.dds");
+    TextureId b = residency.acquire(L"b.dds");
+    residency.update();
+    residency.setBudget(1);
+    residency.update();
+    check(residency.firstMip(a) == 2 && residency.firstMip(b) == 2, "both trimmed before restore");
+
+    // budget grows but nobody draws them: mips stay dropped
+    residency.setBudget(UINT64_MAX);
+    residency.update();
+    check(residency.firstMip(a) == 2 && residency.firstMip(b) == 2, "untouched textures are not restored");
+
+    // room for one more mip of a only
+    residency.setBudget(mip1Bytes + mip2Bytes);
+    residency.touch(a);
+    residency.update();
+    check(residency.firstMip(a) == 1 && residency.firstMip(b) == 2, "restore stops at the budget");
+    check(residency.stats().mipRestores == 1, "partial restore counter");
+
+    residency.setBudget(UINT64_MAX);
+    residency.touch(a);
+    residency.touch(b);
+    residency.update();
+    check(residency.firstMip(a) == 0 && residency.firstMip(b) == 0, "touched textures are fully restored");
+    check(matches(allocator, residency, a) && matches(allocator, residency, b), "allocator sees the restored mips");
+    check(residency.stats().mipRestores == 4, "restore counter");
+    check(residency.stats().trimmedCount == 0 && residency.stats().residentBytes == 2 * fullBytes, "restored stats");
+
+    // allocator refusing to recreate leaves the texture as it was
+    residency.setBudget(1);
+    allocator.failMipChanges = true;
+    residency.update();
+    check(residency.firstMip(a) == 0 && residency.stats().mipEvictions == 4, "failed trim keeps the mips");
+    check(residency.stats().residentBytes == 2 * fullBytes, "failed trim keeps the bytes");
+    allocator.failMipChanges = false;
+    residency.update();
+    check(residency.firstMip(a) == 2 && residency.stats().mipEvictions == 8, "trim succeeds once the allocator does");
+}
+
+int main()
+{
+    checkEstimate();
+    checkBlockAlignment();
+    checkDedup();
+    checkBudget();
+    checkTouchedThisFrame();
+    checkEviction();
+    checkRestore();
+
+    printf(ok ? "ok\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,244 @@
+//--------------------------------------------------------------------------------------
+// Checks of the transient resource pool with fake create/destroy functions: reuse for
+// an equal key and a miss for any differing field, reuse in the same frame after a
+// release, eviction exactly after maxIdleFrames and never while in use, the frame
+// hit/miss counters, entry counts and clear().
+//
+// Build (Linux):
+//   g++ -std=c++17 -O2 -I.. transient_pool_check.cpp -o transient_pool_check
+//
+// Usage:
+//   transient_pool_check
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdint>
+#include <set>
+
+#include "transient_pool.h"
+
+static bool ok = true;
+
+static void check(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        ok = false;
+    }
+}
+
+struct FakeResource
+{
+    int id = 0;
+    RenderTargetKey key = {};
+};
+
+// Hands out increasing ids and tracks which ones are alive
+struct FakeDevice
+{
+    std::set<int> live;
+    int nextId = 1;
+    int creates = 0;
+    int destroys = 0;
+    bool failCreates = false;
+
+    bool create(RenderTargetKey const& key, FakeResource& resource)
+    {
+        if (failCreates)
+            return false;
+        resource.id = nextId++;
+        resource.key = key;
+        live.insert(resource.id);
+        creates++;
+        return true;
+    }
+
+    void destroy(FakeResource& resource)
+    {
+        live.erase(resource.id);
+        destroys++;
+    }
+};
+
+using Pool = TransientPool<RenderTargetKey, FakeResource, RenderTargetKeyHash>;
+
+static Pool makePool(FakeDevice& device, uint32_t maxIdleFrames)
+{
+    return Pool(
+        [&device](RenderTargetKey const& key, FakeResource& resource) { return device.create(key, resource); },
+        [&device](FakeResource& resource) { device.destroy(resource); },
+        maxIdleFrames);
+}
+
+// DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE
+constexpr RenderTargetKey baseKey = { 1280, 720, 28, 0x20 | 0x8 };
+
+static void checkKeys()
+{
+    FakeDevice device;
+    Pool pool = makePool(device, 4);
+
+    FakeResource* first = pool.acquire(baseKey);
+    check(first && first->id == 1 && first->key == baseKey, "first acquire creates");
+    pool.release(first);
+    check(pool.acquire(baseKey) == first && device.creates == 1, "equal key reuses the released resource");
+    pool.release(first);
+
+    RenderTargetKey keys[4] = { baseKey, baseKey, baseKey, baseKey };
+    keys[0].width = 640;
+    keys[1].height = 360;
+    keys[2].format = 10;
+    keys[3].bindFlags = 0;
+    char const* names[4] = { "width differs", "height differs", "format differs", "bind flags differ" };
+    for (int i = 0; i < 4; i++)
+    {
+        FakeResource* other = pool.acquire(keys[i]);
+        check(other && other != first && other->key == keys[i], names[i]);
+    }
+    check(device.creates == 5, "each differing key creates");
+
+    pool.endFrame();
+    check(pool.stats().hits == 1 && pool.stats().misses == 5, "total counters");
+    check(pool.stats().entryCount == 5 && pool.stats().inUseCount == 4, "entry counts");
+    pool.clear();
+}
+
+static void checkSameFrame()
+{
+    FakeDevice device;
+    Pool pool = makePool(device, 4);
+
+    // two live at once need two resources
+    FakeResource* a = pool.acquire(baseKey);
+    FakeResource* b = pool.acquire(baseKey);
+    check(a && b && a != b && device.creates == 2, "resources in use are not shared");
+
+    // a pass releasing its target lets the next pass reuse it in the same frame
+    pool.release(a);
+    FakeResource* c = pool.acquire(baseKey);
+    check(c == a && device.creates == 2, "released resource is reused in the same frame");
+    check(pool.acquire(baseKey) != a && device.creates == 3, "no idle resource left creates");
+
+    // unknown or repeated releases are ignored
+    FakeResource stranger;
+    pool.release(&stranger);
+    pool.release(nullptr);
+    pool.release(b);
+    pool.release(b);
+    check(pool.acquire(baseKey) == b && pool.acquire(baseKey) != b, "double release hands out once");
+
+    pool.endFrame();
+    check(pool.stats().frameHits == 2 && pool.stats().frameMisses == 4, "frame counters");
+    check(pool.stats().entryCount == 4 && pool.stats().inUseCount == 4, "frame entry counts");
+
+    // counters are per frame
+    pool.endFrame();
+    check(pool.stats().frameHits == 0 && pool.stats().frameMisses == 0, "frame counters reset");
+    check(pool.stats().hits == 2 && pool.stats().misses == 4, "totals kept");
+    pool.clear();
+}
+
+static void checkEviction()
+{
+    FakeDevice device;
+    const uint32_t maxIdle = 3;
+    Pool pool = makePool(device, maxIdle);
+
+    FakeResource* idle = pool.acquire(baseKey);
+    RenderTargetKey heldKey = baseKey;
+    heldKey.width = 64;
+    FakeResource* held = pool.acquire(heldKey);
+    int idleId = idle->id;
+    pool.release(idle);
+
+    // released in this frame: survives maxIdle frame ends, goes on the next one
+    for (uint32_t i = 0; i < maxIdle; i++)
+    {
+        pool.endFrame();
+        check(device.live.count(idleId) == 1, "idle resource kept before maxIdleFrames");
+    }
+    check(pool.stats().entryCount == 2 && pool.stats().evictions == 0, "nothing evicted before maxIdleFrames");
+    pool.endFrame();
+    check(device.live.count(idleId) == 0, "idle resource evicted after maxIdleFrames");
+    check(pool.stats().evictions == 1 && pool.stats().entryCount == 1, "eviction counters");
+
+    // a resource held for many frames is never evicted
+    for (int i = 0; i < 20; i++)
+        pool.endFrame();
+    check(device.live.count(held->id) == 1 && pool.stats().inUseCount == 1, "resource in use is never evicted");
+
+    // its idle time starts at the release
+    pool.release(held);
+    for (uint32_t i = 0; i < maxIdle; i++)
+        pool.endFrame();
+    check(pool.stats().entryCount == 1, "held resource idle time starts at release");
+    pool.endFrame();
+    check(pool.stats().entryCount == 0 && device.live.empty(), "held resource evicted after release");
+
+    // reuse resets the idle time
+    FakeResource* reused = pool.acquire(baseKey);
+    pool.release(reused);
+    pool.endFrame();
+    pool.endFrame();
+    check(pool.acquire(baseKey) == reused, "resource reused before eviction");
+    pool.release(reused);
+    for (uint32_t i = 0; i < maxIdle; i++)
+        pool.endFrame();
+    check(pool.stats().entryCount == 1, "reuse restarts the idle time");
+
+    // 0 keeps nothing past the end of the frame it was released in
+    pool.setMaxIdleFrames(0);
+    pool.endFrame();
+    check(pool.stats().entryCount == 0, "max idle 0 evicts at the next frame end");
+    check(device.creates == device.destroys, "every created resource destroyed");
+}
+
+static void checkFailureAndClear()
+{
+    FakeDevice device;
+    Pool pool = makePool(device, 4);
+
+    device.failCreates = true;
+    check(pool.acquire(baseKey) == nullptr, "failed create returns nullptr");
+    device.failCreates = false;
+    pool.endFrame();
+    check(pool.stats().misses == 0 && pool.stats().entryCount == 0, "failed create is not pooled");
+
+    FakeResource* a = pool.acquire(baseKey);
+    FakeResource* b = pool.acquire(baseKey);
+    pool.release(b);
+    pool.endFrame();
+    check(pool.stats().entryCount == 2 && pool.stats().inUseCount == 1, "counts before clear");
+
+    int visited = 0, visitedInUse = 0;
+    pool.forEach([&](RenderTargetKey const& key, FakeResource const&, bool inUse) {
+        visited++;
+        visitedInUse += inUse ? 1 : 0;
+        check(key == baseKey, "forEach key");
+    });
+    check(visited == 2 && visitedInUse == 1, "forEach visits every entry");
+
+    pool.clear();
+    check(device.live.empty() && device.destroys == 2, "clear destroys resources in use too");
+    check(pool.stats().entryCount == 0 && pool.stats().inUseCount == 0, "counts after clear");
+
+    // stale pointers from before the clear are ignored
+    pool.release(a);
+    FakeResource* fresh = pool.acquire(baseKey);
+    check(fresh && device.creates == 3, "acquire after clear creates");
+    pool.endFrame();
+    check(pool.stats().entryCount == 1 && pool.stats().inUseCount == 1, "counts after reuse of the pool");
+    pool.clear();
+}
+
+int main()
+{
+    checkKeys();
+    checkSameFrame();
+    checkEviction();
+    checkFailureAndClear();
+
+    printf(ok ? "ok\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+
+// Portable pool of transient GPU resources: resources released during a frame
+// are handed out again for the same key, entries idle for more than
+// maxIdleFrames are destroyed at the end of a frame.
+
+struct RenderTargetKey
+{
+    uint32_t width;
+    uint32_t height;
+    // DXGI_FORMAT value
+    uint32_t format;
+    // D3D11_BIND_FLAG mask, 0 for CPU readable staging textures
+    uint32_t bindFlags;
+
+    bool operator==(RenderTargetKey const& other) const
+    {
+        return width == other.width && height == other.height &&
+            format == other.format && bindFlags == other.bindFlags;
+    }
+};
+
+struct RenderTargetKeyHash
+{
+    size_t operator()(RenderTargetKey const& key) const
+    {
+        uint64_t h = 1469598103934665603ull;
+        for (uint32_t v : { key.width, key.height, key.format, key.bindFlags })
+            h = (h ^ v) * 1099511628211ull;
+        return static_cast<size_t>(h);
+    }
+};
+
+struct TransientPoolStats
+{
+    // totals since creation
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    // last finished frame
+    uint32_t frameHits = 0;
+    uint32_t frameMisses = 0;
+    // current state
+    uint32_t entryCount = 0;
+    uint32_t inUseCount = 0;
+};
+
+template<typename Key, typename Resource, typename KeyHash = std::hash<Key>>
+class TransientPool
+{
+public:
+    using CreateFunc = std::function<bool(Key const&, Resource&)>;
+    using DestroyFunc = std::function<void(Resource&)>;
+
+    TransientPool(CreateFunc create, DestroyFunc destroy, uint32_t maxIdleFrames = 60) :
+        create(create), destroy(destroy), maxIdleFrames(maxIdleFrames) {}
+
+    TransientPool(TransientPool const&) = delete;
+    TransientPool& operator=(TransientPool const&) = delete;
+
+    // reuse an idle resource with the same key or create one, nullptr on failure
+    Resource* acquire(Key const& key)
+    {
+        auto& bucket = buckets[key];
+        for (auto& entry : bucket)
+        {
+            if (!entry->inUse)
+            {
+                entry->inUse = true;
+                entry->lastUsedFrame = frame;
+                _stats.hits++;
+                currentHits++;
+                return &entry->resource;
+            }
+        }
+
+        auto entry = std::make_unique<Entry>();
+        entry->key = key;
+        if (!create(key, entry->resource))
+            return nullptr;
+
+        entry->inUse = true;
+        entry->lastUsedFrame = frame;
+        _stats.misses++;
+        currentMisses++;
+
+        Resource* resource = &entry->resource;
+        owners[resource] = entry.get();
+        bucket.push_back(std::move(entry));
+        return resource;
+    }
+
+    // give the resource back, it may be handed out again in the same frame
+    void release(Resource const* resource)
+    {
+        auto found = owners.find(resource);
+        if (found != owners.end())
+        {
+            found->second->inUse = false;
+            found->second->lastUsedFrame = frame;
+        }
+    }
+
+    // destroy entries that were idle for too long and advance the frame counter
+    void endFrame()
+    {
+        for (auto bucket = buckets.begin(); bucket != buckets.end();)
+        {
+            auto& entries = bucket->second;
+            for (size_t i = 0; i < entries.size();)
+            {
+                auto& entry = entries[i];
+                if (!entry->inUse && frame - entry->lastUsedFrame >= maxIdleFrames)
+                {
+                    destroy(entry->resource);
+                    owners.erase(&entry->resource);
+                    entries.erase(entries.begin() + i);
+                    _stats.evictions++;
+                }
+                else
+                {
+                    i++;
+                }
+            }
+            bucket = entries.empty() ? buckets.erase(bucket) : std::next(bucket);
+        }
+
+        _stats.frameHits = currentHits;
+        _stats.frameMisses = currentMisses;
+        currentHits = currentMisses = 0;
+        frame++;
+        updateCounts();
+    }
+
+    // destroy every entry, resources still in use included
+    void clear()
+    {
+        for (auto& bucket : buckets)
+            for (auto& entry : bucket.second)
+                destroy(entry->resource);
+        buckets.clear();
+        owners.clear();
+        updateCounts();
+    }
+
+    void setMaxIdleFrames(uint32_t frames) { maxIdleFrames = frames; }
+
+    TransientPoolStats const& stats() const { return _stats; }
+
+    // visit every pooled resource, e.g. to sum memory
+    template<typename Func>
+    void forEach(Func func) const
+    {
+        for (auto const& bucket : buckets)
+            for (auto const& entry : bucket.second)
+                func(entry->key, entry->resource, entry->inUse);
+    }
+
+private:
+    struct Entry
+    {
+        Key key;
+        Resource resource;
+        bool inUse = false;
+        uint64_t lastUsedFrame = 0;
+    };
+
+    void updateCounts()
+    {
+        _stats.entryCount = 0;
+        _stats.inUseCount = 0;
+        for (auto const& bucket : buckets)
+            for (auto const& entry : bucket.second)
+            {
+                _stats.entryCount++;
+                if (entry->inUse)
+                    _stats.inUseCount++;
+            }
+    }
+
+    CreateFunc create;
+    DestroyFunc destroy;
+    uint32_t maxIdleFrames;
+
+    std::unordered_map<Key, std::vector<std::unique_ptr<Entry>>, KeyHash> buckets;
+    std::unordered_map<Resource const*, Entry*> owners;
+
+    uint64_t frame = 0;
+    uint32_t currentHits = 0;
+    uint32_t currentMisses = 0;
+    TransientPoolStats _stats;
+};
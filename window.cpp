@@ -2,9 +2,14 @@
 #include <windowsx.h>
 #include <d3d11_1.h>
 #include <tchar.h>
+#include <cstring>
+#include <cstdlib>
 #include "imgui_impl_win32.h"
 #include "window.h"
 #include "graphics.h"
+#include "game_loop.h"
+#include "profiler.h"
+#include "frame_pipeline.h"
 
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
@@ -14,7 +19,7 @@ std::shared_ptr<Graphics> Window::graphics;
 
 bool Window::onCreate(HWND hWnd, std::shared_ptr<Graphics>& graphics) {
     // init directx
-    graphics = Graphics::init(hWnd);
+    graphics = Graphics::init(hWnd, waitableSwapChain);
     if (!graphics) {
         MessageBox(NULL,
             _T("Could not initialize DirectX"),
@@ -22,6 +27,7 @@ bool Window::onCreate(HWND hWnd, std::shared_ptr<Graphics>& graphics) {
             NULL);
         return false;
     }
+    graphics->setDepthPrepass(depthPrepass);
     return true;
 }
 
@@ -46,65 +52,66 @@ LRESULT CALLBACK Window::WndProc(
         ShowCursor(TRUE);
         break;
     case WM_PAINT:
-        graphics->render();
+        // frames are rendered by the main loop
+        ValidateRect(hWnd, nullptr);
         break;
     case WM_KEYDOWN:
     {
         auto vkCode = LOWORD(wParam);
         switch (vkCode) {
         case 0x41: // A
-            graphics->setMoveLeft(true);
+            inst->queueInput(InputEventType::MoveLeft, 1);
             break;
         case 0x44: // D
-            graphics->setMoveRight(true);
+            inst->queueInput(InputEventType::MoveRight, 1);
             break;
         case 0x53: // S
-            graphics->setMoveBackward(true);
+            inst->queueInput(InputEventType::MoveBackward, 1);
             break;
         case 0x57: // W
-            graphics->setMoveForward(true);
+            inst->queueInput(InputEventType::MoveForward, 1);
             break;
         case VK_SPACE:
-            graphics->setMoveUp(true);
+            inst->queueInput(InputEventType::MoveUp, 1);
             break;
         case 0x43: // C
-            graphics->setMoveDown(true);
+            inst->queueInput(InputEventType::MoveDown, 1);
             break;
         case 0x51: // Q
             PostMessage(hWnd, WM_CLOSE, 0, 0);
             break;
         case 0x30: // 0
-            graphics->resetLightIntensity(0);
-            graphics->resetLightIntensity(1);
-            graphics->resetLightIntensity(2);
+            inst->queueInput(InputEventType::ResetLightIntensity, 0);
+            inst->queueInput(InputEventType::ResetLightIntensity, 1);
+            inst->queueInput(InputEventType::ResetLightIntensity, 2);
             break;
         case 0x31: // 1
-            graphics->increaseLightIntensity(0);
+            inst->queueInput(InputEventType::IncreaseLightIntensity, 0);
             break;
         case 0x32: // 2
-            graphics->decreaseLightIntensity(0);
+            inst->queueInput(InputEventType::DecreaseLightIntensity, 0);
             break;
         case 0x33: // 3
-            graphics->increaseLightIntensity(1);
+            inst->queueInput(InputEventType::IncreaseLightIntensity, 1);
             break;
         case 0x34: // 4
-            graphics->decreaseLightIntensity(1);
+            inst->queueInput(InputEventType::DecreaseLightIntensity, 1);
             break;
         case 0x35: // 5
-            graphics->increaseLightIntensity(2);
+            inst->queueInput(InputEventType::IncreaseLightIntensity, 2);
             break;
         case 0x36: // 6
-            graphics->decreaseLightIntensity(2);
+            inst->queueInput(InputEventType::DecreaseLightIntensity, 2);
             break;
         case VK_OEM_PLUS: // +
-            graphics->increaseLightIntensity(0);
-            graphics->increaseLightIntensity(1);
-            graphics->increaseLightIntensity(2);
+            inst->queueInput(InputEventType::IncreaseLightIntensity, 0);
+            inst->queueInput(InputEventType::IncreaseLightIntensity, 1);
+            inst->queueInput(InputEventType::IncreaseLightIntensity, 2);
             break;
         case VK_OEM_MINUS: // -
-            graphics->decreaseLightIntensity(0);
-            graphics->decreaseLightIntensity(1);
-            graphics->decreaseLightIntensity(2);
+            inst->queueInput(InputEventType::DecreaseLightIntensity, 0);
+            inst->queueInput(InputEventType::DecreaseLightIntensity, 1);
+            inst->queueInput(InputEventType::DecreaseLightIntensity, 2);
             break;
         }
         break;
@@ -114,22 +121,22 @@ LRESULT CALLBACK Window::WndProc(
         auto vkCode = LOWORD(wParam);
         switch (vkCode) {
         case 0x41: // A
-            graphics->setMoveLeft(false);
+            inst->queueInput(InputEventType::MoveLeft, 0);
             break;
         case 0x44: // D
-            graphics->setMoveRight(false);
+            inst->queueInput(InputEventType::MoveRight, 0);
             break;
         case 0x53: // S
-            graphics->setMoveBackward(false);
+            inst->queueInput(InputEventType::MoveBackward, 0);
             break;
         case 0x57: // W
-            graphics->setMoveForward(false);
+            inst->queueInput(InputEventType::MoveForward, 0);
             break;
         case VK_SPACE:
-            graphics->setMoveUp(false);
+            inst->queueInput(InputEventType::MoveUp, 0);
             break;
         case 0x43: // C
-            graphics->setMoveDown(false);
+            inst->queueInput(InputEventType::MoveDown, 0);
             break;
         }
         break;
@@ -162,7 +169,7 @@ LRESULT CALLBACK Window::WndProc(
             dx = newCursorX - inst->cursorX;
             dy = newCursorY - inst->cursorY;
 
-            graphics->rotate(dx, dy);
+            inst->queueInput(InputEventType::Rotate, dx, dy);
         }
 
         inst->cursorX = newCursorX;
@@ -174,11 +181,17 @@ LRESULT CALLBACK Window::WndProc(
     {
         UINT width = LOWORD(lParam);
         UINT height = HIWORD(lParam);
+        // the simulation thread reads the projection while it builds a snapshot
+        if (inst->pipeline)
+            inst->pipeline->pause();
         if (FAILED(graphics->resizeBackbuffer(width, height)))
             MessageBox(nullptr, L"Failed to resize buffer", L"Critical error", MB_OK);
+        if (inst->pipeline)
+            inst->pipeline->resume();
         break;
     }
     case WM_CLOSE:
+        inst->stopSimulation();
         graphics->cleanup();
         DestroyWindow(hWnd);
         break;
@@ -191,12 +204,135 @@ LRESULT CALLBACK Window::WndProc(
     return 0;
 }
 
+bool Window::parseCommandLine(LPSTR lpCmdLine) {
+    if (!lpCmdLine)
+        return true;
+
+    auto args = splitCommandLine(lpCmdLine);
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--waitable-swapchain")
+            waitableSwapChain = true;
+        else if (args[i] == "--fps-cap" && i + 1 < args.size())
+            fpsCap = atof(args[++i].c_str());
+        else if (args[i] == "--record" && i + 1 < args.size())
+            recordPath = args[++i];
+        else if (args[i] == "--replay" && i + 1 < args.size())
+            replayPath = args[++i];
+        else if (args[i] == "--pipeline")
+            pipelined = true;
+        else if (args[i] == "--no-depth-prepass")
+            depthPrepass = false;
+    }
+
+    std::string error;
+    if (!parseBenchmarkArgs(args, benchmark, error)) {
+        MessageBoxA(NULL, error.c_str(), "graphics-labs", MB_OK);
+        return false;
+    }
+    return true;
+}
+
+bool Window::runBenchmarkFrame(Benchmark& run, HWND hWnd) {
+    CameraPose pose;
+    if (!run.nextFrame(pose)) {
+        run.collect();
+        bool written = run.writeCSV(benchmark.csvPath) && run.writeJSON(benchmark.jsonPath);
+        if (!written)
+            MessageBox(NULL, _T("Could not write the benchmark report"), _T("graphics-labs"), MB_OK);
+        run.print(stdout);
+        PostMessage(hWnd, WM_CLOSE, 0, 0);
+        return false;
+    }
+
+    // no input and no simulation steps, the camera path alone decides the frame
+    graphics->setCameraPose(pose);
+    graphics->render(0.0f, 1.0f / 60.0f);
+    run.frameDone();
+    return true;
+}
+
+void Window::queueInput(InputEventType type, int32_t value, int32_t value2) {
+    InputEvent event;
+    event.type = type;
+    event.value = value;
+    event.value2 = value2;
+    std::lock_guard<std::mutex> lock(inputMutex);
+    pendingInput.push_back(event);
+}
+
+void Window::simulate(double step) {
+    std::vector<InputEvent> input;
+    {
+        std::lock_guard<std::mutex> lock(inputMutex);
+        input.swap(pendingInput);
+    }
+    lastInputTime = GameLoop::clockNow();
+
+    if (replaying) {
+        // live input is ignored, the recording alone drives the camera and lights
+        InputEvent event;
+        while (player.next(inputStep, event))
+            graphics->applyInput(event);
+    }
+    else {
+        for (auto& event : input) {
+            event.step = inputStep;
+            recorder.record(event);
+            graphics->applyInput(event);
+        }
+    }
+
+    graphics->update(static_cast<float>(step));
+    inputStep++;
+}
+
+void Window::stopSimulation() {
+    if (!pipeline)
+        return;
+    pipeline->stop();
+    if (simulation.joinable())
+        simulation.join();
+}
+
+bool Window::runReplayFrame(HWND hWnd) {
+    if (player.done() && inputStep > player.lastStep()) {
+        PostMessage(hWnd, WM_CLOSE, 0, 0);
+        return false;
+    }
+
+    // exactly one step of the recorded length per frame, whatever the frame time is
+    simulate(player.fixedStep());
+    graphics->render(0.0f, static_cast<float>(player.fixedStep()));
+    return true;
+}
+
 int Window::init(_In_ HINSTANCE hInstance,
     _In_opt_ HINSTANCE hPrevInstance,
     _In_ LPSTR lpCmdLine,
     _In_ int nCmdShow) {
     const TCHAR szWindowClass[] = _T("graphics-labs");
 
+    if (!parseCommandLine(lpCmdLine))
+        return 1;
+
+    CameraPath cameraPath;
+    if (benchmark.enabled && !benchmark.cameraPath.empty()) {
+        std::string error;
+        if (!cameraPath.load(benchmark.cameraPath, error)) {
+            MessageBoxA(NULL, error.c_str(), "graphics-labs", MB_OK);
+            return 1;
+        }
+    }
+
+    if (!replayPath.empty()) {
+        std::string error;
+        if (!player.load(replayPath, error) || player.fixedStep() <= 0.0) {
+            MessageBoxA(NULL, error.empty() ? "invalid fixed step in the recording" : error.c_str(), "graphics-labs", MB_OK);
+            return 1;
+        }
+        replaying = true;
+    }
+
     WNDCLASSEX wc{ 0 };
     wc.cbSize = sizeof(WNDCLASSEX);
     wc.style = 0;
@@ -222,13 +358,20 @@ int Window::init(_In_ HINSTANCE hInstance,
     const TCHAR szTitle[] = _T("graphics-labs");
     const unsigned int WIDTH = 800;
     const unsigned int HEIGHT = 800;
+    // the benchmark resolution is the client area, not the window
+    RECT windowRect = { 0, 0, (LONG)WIDTH, (LONG)HEIGHT };
+    if (benchmark.enabled) {
+        windowRect.right = benchmark.width;
+        windowRect.bottom = benchmark.height;
+        AdjustWindowRectEx(&windowRect, WS_OVERLAPPEDWINDOW, FALSE, WS_EX_OVERLAPPEDWINDOW);
+    }
     HWND hWnd = CreateWindowEx(
         WS_EX_OVERLAPPEDWINDOW,
         szWindowClass,
         szTitle,
         WS_OVERLAPPEDWINDOW,
         CW_USEDEFAULT, CW_USEDEFAULT,
-        WIDTH, HEIGHT,
+        windowRect.right - windowRect.left, windowRect.bottom - windowRect.top,
         NULL,
         NULL,
         hInstance,
@@ -246,13 +389,94 @@ int Window::init(_In_ HINSTANCE hInstance,
     UpdateWindow(hWnd);
     ShowWindow(hWnd, nCmdShow);
 
+    // 1 ms sleep granularity for the frame cap
+    timeBeginPeriod(1);
+
+    // scripted runs stay serial so every frame matches its input
+    FramePipeline<FrameSnapshot> framePipeline;
+    if (pipelined && !benchmark.enabled && !replaying) {
+        pipeline = &framePipeline;
+        graphics->setFramePipeline(pipeline);
+    }
+
+    GameLoopSettings settings;
+    settings.maxFps = fpsCap;
+    GameLoop loop(
+        [](double step) { inst->simulate(step); },
+        [](double interpolation, double frameTime) {
+            if (!inst->pipeline) {
+                graphics->render(static_cast<float>(interpolation), static_cast<float>(frameTime));
+                return;
+            }
+            // the window thread renders it while the next steps run
+            auto snapshot = inst->pipeline->beginFrame();
+            if (!snapshot)
+                return;
+            graphics->buildSnapshot(static_cast<float>(interpolation), static_cast<float>(frameTime), *snapshot);
+            inst->pipeline->publish(inst->lastInputTime);
+        },
+        settings);
+    if (pipeline) {
+        // the window thread waits on the swapchain, the simulation on the queue
+        loop.setWaitFunc([]() { inst->pipeline->waitForRoom(); });
+        simulation = std::thread([&loop]() {
+            Profiler::get().setThreadName("Simulation");
+            while (!inst->pipeline->stopped())
+                loop.tick();
+        });
+    }
+    else {
+        loop.setWaitFunc([]() { graphics->waitForFrame(); });
+        graphics->setGameLoop(&loop);
+    }
+
+    if (!recordPath.empty() && !replaying && !recorder.open(recordPath, settings.fixedStep))
+        MessageBox(NULL, _T("Could not open the input recording"), _T("graphics-labs"), MB_OK);
+
+    std::unique_ptr<Benchmark> run;
+    if (benchmark.enabled) {
+        graphics->setSceneParams(benchmark.gridSize, benchmark.lightCount);
+        run = std::make_unique<Benchmark>(benchmark, cameraPath);
+    }
+
     MSG msg{ 0 };
-    
-    while (GetMessage(&msg, NULL, 0, 0)) {
-        TranslateMessage(&msg);
-        DispatchMessage(&msg);
+
+    // drain all pending messages, then run one frame
+    while (msg.message != WM_QUIT) {
+        if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
+            TranslateMessage(&msg);
+            DispatchMessage(&msg);
+            continue;
+        }
+        if (run) {
+            if (!runBenchmarkFrame(*run, hWnd))
+                run.reset();
+            continue;
+        }
+        if (replaying) {
+            replaying = runReplayFrame(hWnd);
+            continue;
+        }
+        if (pipeline) {
+            graphics->waitForFrame();
+            // short timeout, messages keep flowing while the simulation is behind
+            if (auto snapshot = pipeline->acquire(0.002)) {
+                graphics->render(*snapshot);
+                pipeline->presented();
+            }
+            continue;
+        }
+        loop.tick();
     }
 
+    stopSimulation();
+    pipeline = nullptr;
+    graphics->setFramePipeline(nullptr);
+    graphics->setGameLoop(nullptr);
+    if (!recorder.close())
+        MessageBox(NULL, _T("Could not write the input recording"), _T("graphics-labs"), MB_OK);
+    timeEndPeriod(1);
+
     return (int)msg.wParam;
 }
 
@@ -1,8 +1,16 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <thread>
+
+#include "benchmark.h"
+#include "input_recording.h"
 
 class Graphics;
+struct FrameSnapshot;
+template<typename T>
+class FramePipeline;
 
 class Window
 {
@@ -20,6 +28,17 @@ private:
         _In_ int nCmdShow);
 
     bool onCreate(HWND hWnd, std::shared_ptr<Graphics>& graphics);
+    bool parseCommandLine(LPSTR lpCmdLine);
+    // render the scripted frames back to back, false once the report is written
+    bool runBenchmarkFrame(Benchmark& run, HWND hWnd);
+    // one recorded step per frame, false once the recording ran out
+    bool runReplayFrame(HWND hWnd);
+
+    // input is applied at the start of the next simulation step, so it can be recorded per step
+    void queueInput(InputEventType type, int32_t value, int32_t value2 = 0);
+    void simulate(double step);
+    // stop the simulation thread of a pipelined run, no-op otherwise
+    void stopSimulation();
 
     static LRESULT CALLBACK WndProc(
         _In_ HWND hWnd,
@@ -34,5 +53,28 @@ private:
     static std::shared_ptr<Graphics> graphics;
     int cursorX, cursorY;
     bool first = true;
+
+    // command line options
+    bool waitableSwapChain = false;
+    double fpsCap = 0.0;
+    BenchmarkSettings benchmark;
+    std::string recordPath;
+    std::string replayPath;
+    bool pipelined = false;
+    bool depthPrepass = true;
+
+    // queued by the window thread, taken by the simulation
+    std::mutex inputMutex;
+    std::vector<InputEvent> pendingInput;
+    // when the last step sampled input, the start of the input to present latency
+    double lastInputTime = 0.0;
+    uint64_t inputStep = 0;
+    InputRecorder recorder;
+    InputPlayer player;
+    bool replaying = false;
+
+    // --pipeline: the game loop runs on its own thread and hands frames over
+    FramePipeline<FrameSnapshot>* pipeline = nullptr;
+    std::thread simulation;
 };
 